@@ -28,7 +28,6 @@
 #include "airfield.h"
 
 extern MapContents *_globalMapContents;
-extern MapConfig   *_globalMapConfig;
 
 AirfieldListWidget::AirfieldListWidget( QVector<enum MapContents::ListID> &itemList,
                                         QWidget *parent,
@@ -64,7 +63,15 @@ void AirfieldListWidget::fillItemList()
 
   for ( int item = 0; item < m_itemList.size(); item++ )
     {
-      int nr = _globalMapContents->getListLength( m_itemList.at(item) );
+      // The item texts are taken from the columns of the point store.
+      const PointStore* store = _globalMapContents->getPointStore( m_itemList.at(item) );
+
+      if( store == 0 )
+        {
+          continue;
+        }
+
+      int nr = store->size();
 
       for ( int i = 0; i < nr; i++ )
         {
@@ -75,7 +82,8 @@ void AirfieldListWidget::fillItemList()
 	      continue;
 	    }
 
-          filter->addListItem( new AirfieldItem(site) );
+          filter->addListItem( new AirfieldItem( site, *store, i,
+                                                 typeIcon( store->type(i) ) ) );
         }
     }
 
@@ -122,27 +130,27 @@ Waypoint* AirfieldListWidget::getCurrentWaypoint()
   return &m_wp;
 }
 
-AirfieldListWidget::AirfieldItem::AirfieldItem(Airfield* site) :
+AirfieldListWidget::AirfieldItem::AirfieldItem( Airfield* site,
+                                                const PointStore& store,
+                                                const int index,
+                                                const QIcon& icon ) :
   QTreeWidgetItem(), airfield(site)
 {
-  QString name = site->getWPName();
   // Limitation for name is set in Welt2000 to 8 characters
-  setText(0, name);
-  setText(1, site->getName());
-  setText(2, site->getCountry());
+  setText(0, store.text( index, PointStore::ShortName ));
+  setText(1, store.text( index, PointStore::Name ));
+  setText(2, store.text( index, PointStore::Country ));
   setTextAlignment(2, Qt::AlignCenter);
 
-  if( site->getTypeID() != BaseMapElement::Outlanding )
+  if( store.type( index ) != BaseMapElement::Outlanding )
     {
-      setText(3, site->getICAO());
+      setText(3, store.text( index, PointStore::Icao ));
     }
   else
     {
-      setText(3, site->getComment());
+      setText(3, store.text( index, PointStore::Comment ));
     }
 
   // set type icon
-  QPixmap afPm = _globalMapConfig->getPixmap(site->getTypeID(), false);
-
-  setIcon( 0, QIcon( afPm) );
+  setIcon( 0, icon );
 }
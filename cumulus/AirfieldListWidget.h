@@ -34,6 +34,7 @@
 #include "waypoint.h"
 #include "listwidgetparent.h"
 #include "mapcontents.h"
+#include "pointstore.h"
 
 class AirfieldListWidget : public ListWidgetParent
 {
@@ -74,7 +75,10 @@ class AirfieldItem : public QTreeWidgetItem
   {
     public:
 
-      AirfieldItem(Airfield* item);
+      AirfieldItem( Airfield* item,
+                    const PointStore& store,
+                    const int index,
+                    const QIcon& icon );
       Airfield* airfield;
   };
 };
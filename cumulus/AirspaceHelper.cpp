@@ -35,6 +35,90 @@ QSet<int> AirspaceHelper::m_airspaceDictionary;
 
 QMutex AirspaceHelper::m_mutex;
 
+namespace
+{
+  /**
+   * Loading of one airspace file, used by AirspaceHelper::loadAirspaces.
+   */
+  struct LoadTask
+  {
+    enum Action { ParseSource, ReadCompiled };
+
+    LoadTask() :
+      action(ParseSource),
+      ok(false),
+      msecs(0)
+    {
+    };
+
+    LoadTask( const QString& name, const Action what ) :
+      fileName(name),
+      action(what),
+      ok(false),
+      msecs(0)
+    {
+    };
+
+    /** The file to be read. */
+    QString fileName;
+
+    /** Parse and compile a source file or read a compiled file. */
+    Action action;
+
+    /** The read airspaces, not yet checked for duplicates. */
+    QList<Airspace*> list;
+
+    /** Result of the file reading. */
+    bool ok;
+
+    /** Needed time in milli seconds. */
+    int msecs;
+  };
+
+  /**
+   * Executes a load task in a thread of a thread pool. The parsers are
+   * members, so that they are constructed in the calling thread. Their
+   * constructors change global settings.
+   */
+  class LoadRunnable : public QRunnable
+  {
+   public:
+
+    LoadRunnable( LoadTask* task ) :
+      m_task(task)
+    {
+    };
+
+    virtual void run()
+    {
+      QTime t;
+      t.start();
+
+      if( m_task->action == LoadTask::ReadCompiled )
+        {
+          m_task->ok = AirspaceHelper::readCompiledFile( m_task->fileName, m_task->list );
+        }
+      else if( m_task->fileName.endsWith( QString(".txt") ) )
+        {
+          m_task->ok = m_oap.parse( m_task->fileName, m_task->list, true );
+        }
+      else
+        {
+          QString errorInfo;
+          m_task->ok = m_oaip.readAirspaces( m_task->fileName, m_task->list, errorInfo, true );
+        }
+
+      m_task->msecs = t.elapsed();
+    };
+
+   private:
+
+    LoadTask* m_task;
+    OpenAirParser m_oap;
+    OpenAip m_oaip;
+  };
+}
+
 int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
 {
   // Set a global lock during execution to avoid calls in parallel.
@@ -116,41 +200,29 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
         }
     }
 
-  OpenAirParser oap;
-  OpenAip oaip;
-  QString errorInfo;
+  // The type mapping is shared by all parser threads, it must be
+  // initialized before they are started.
+  if( m_airspaceTypeMap.isEmpty() )
+    {
+      loadAirspaceTypeMapping();
+    }
+
+  // Every file to be loaded gets its own task. The decision, if a source or
+  // a compiled file has to be read, is made here, the reading is done later
+  // in parallel.
+  QVector<LoadTask> tasks;
 
   while( ! preselect.isEmpty() )
     {
       QString srcName;
       QString binName;
 
-      if( preselect.first().endsWith(QString(".txt")) )
-        {
-          // there can't be the same name txc after this txt
-          // parse found txt file
-          srcName = preselect.first();
-
-          if( oap.parse(srcName, list, true) )
-            {
-              loadCounter++;
-            }
-
-          preselect.removeAt(0);
-          continue;
-        }
-
-      if( preselect.first().endsWith(QString(".aip")) )
+      if( preselect.first().endsWith(QString(".txt")) ||
+          preselect.first().endsWith(QString(".aip")) )
         {
-          // there can't be the same name aic after this aip
-          // parse found aip file
-          srcName = preselect.first();
-
-          if( oaip.readAirspaces(srcName, list, errorInfo, true) )
-            {
-              loadCounter++;
-            }
-
+          // there can't be the same name txc or aic after this txt or aip
+          // parse found source file
+          tasks.append( LoadTask( preselect.first(), LoadTask::ParseSource ) );
           preselect.removeAt(0);
           continue;
         }
@@ -187,40 +259,37 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
       // Now we have to check if there's to find a source file with
       // the related extension after the binary file
       preselect.removeAt(0);
-      QFileInfo binFi(binName);
 
-      if( srcName == preselect.first() )
+      if( preselect.isEmpty() || srcName != preselect.first() )
         {
-          preselect.removeAt(0);
-          // We found the related source file and will do some checks to
-          // decide which type of file will be read in.
+          // We will read the compiled file, because a source file is not
+          // to find after it.
+          tasks.append( LoadTask( binName, LoadTask::ReadCompiled ) );
+          continue;
+        }
+
+      preselect.removeAt(0);
 
-          // Lets check, if we can read the header of the compiled file
-          if( ! AirspaceHelper::readHeaderData( binName,
+      // We found the related source file and will do some checks to
+      // decide which type of file will be read in.
+
+      // Lets check, if we can read the header of the compiled file
+      bool ok = AirspaceHelper::readHeaderData( binName,
                                                 h_creationDateTime,
-                                                &h_projection ) )
-            {
-              // Compiled file format is not the expected one, remove
-              // wrong file and start a reparsing of source file.
-              QFile::remove(binName);
+                                                &h_projection );
 
-              if (srcSuffix == "txt")
-                {
-                  if (oap.parse(srcName, list, true))
-                    {
-                      loadCounter++;
-                    }
-                }
-              else if (srcSuffix == "aip")
-                {
-                  if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                    {
-                      loadCounter++;
-                    }
-                }
+      // The compiled file contains WGS84 coordinates, the stored
+      // projection does not matter.
+      delete h_projection;
+      h_projection = 0;
 
-              continue;
-            }
+      if( ok == false )
+        {
+          // Compiled file format is not the expected one, remove
+          // wrong file and start a reparsing of source file.
+          QFile::remove(binName);
+          tasks.append( LoadTask( srcName, LoadTask::ParseSource ) );
+          continue;
         }
 
       // Do a date-time check. If the source file is younger in its
@@ -235,22 +304,7 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
           // compiled file. Therefore we do start a reparsing of the
           // source file.
           QFile::remove(binName);
-
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
-            {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
-            }
-
+          tasks.append( LoadTask( srcName, LoadTask::ParseSource ) );
           continue;
         }
 
@@ -270,66 +324,65 @@ int AirspaceHelper::loadAirspaces( QList<Airspace*>& list, bool readSource )
           // in the assumption that a configuration file will not be changed
           // every minute.
           QFile::remove(binName);
-
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
-            {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
-            }
-
+          tasks.append( LoadTask( srcName, LoadTask::ParseSource ) );
           continue;
         }
 
-      // Check, if the projection has been changed in the meantime
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
+      // We will read the compiled file, because all checks were
+      // successfully passed
+      tasks.append( LoadTask( binName, LoadTask::ReadCompiled ) );
+    } // End of While
 
-      if( ! MapContents::compareProjections(h_projection, currentProjection) )
-        {
-          // Projection has changed in the meantime
-          if( h_projection )
-            {
-              delete h_projection;
-              h_projection = 0;
-            }
+  // The files are read in parallel. Every task uses its own parser and
+  // collects its airspaces in its own list.
+  QThreadPool pool;
+  pool.setMaxThreadCount( qMax( 1, QThread::idealThreadCount() ) );
 
-          QFile::remove(binName);
+  for( int i = 0; i < tasks.size(); i++ )
+    {
+      pool.start( new LoadRunnable( &tasks[i] ) );
+    }
 
-          if (srcSuffix == "txt")
-            {
-              if (oap.parse(srcName, list, true))
-                {
-                  loadCounter++;
-                }
-            }
-          else if (srcSuffix == "aip")
+  pool.waitForDone();
+
+  // The results are merged in the order of the file names, so that the
+  // first file wins, if an airspace is contained in several files.
+  for( int i = 0; i < tasks.size(); i++ )
+    {
+      const LoadTask& task = tasks.at(i);
+
+      int duplicates = 0;
+
+      for( int j = 0; j < task.list.size(); j++ )
+        {
+          Airspace* as = task.list.at(j);
+
+          if( as->getId() >= 0 && addAirspaceIdentifier( as->getId() ) == false )
             {
-              if (oaip.readAirspaces(srcName, list, errorInfo, true))
-                {
-                  loadCounter++;
-                }
+              // Airspace is already known. Ignore object.
+              delete as;
+              duplicates++;
+              continue;
             }
 
-          continue;
+          list.append( as );
         }
 
-      // We will read the compiled file, because a source file is not to
-      // find after it or all checks were successfully passed
-      if (AirspaceHelper::readCompiledFile( binName, list ) )
+      if( task.ok )
         {
           loadCounter++;
         }
-    } // End of While
 
-  qDebug("ASH: %d Airspace file(s) loaded in %dms", loadCounter, t.elapsed());
+      qDebug( "ASH: %s %s in %dms, %d airspaces, %d duplicates ignored",
+              QFileInfo(task.fileName).fileName().toLatin1().data(),
+              task.ok ? "loaded" : "failed",
+              task.msecs,
+              task.list.size() - duplicates,
+              duplicates );
+    }
+
+  qDebug("ASH: %d Airspace file(s) loaded in %dms using %d thread(s)",
+         loadCounter, t.elapsed(), pool.maxThreadCount() );
 
 //    for(int i=0; i < list.size(); i++ )
 //      {
@@ -406,7 +459,7 @@ bool AirspaceHelper::createCompiledFile( QString& fileName,
       out << float( lAlt );
       out << quint8( as->getUpperT() );
       out << float( uAlt );
-      ShortSave( out, as->getProjectedPolygon() );
+      ShortSave( out, as->getWgsPolygon() );
     }
 
   file.close();
@@ -500,6 +553,8 @@ bool AirspaceHelper::readCompiledFile( QString &path, QList<Airspace*>& list )
 
   uint counter = 0;
 
+  ProjectionBase* projection = _globalMapMatrix->getProjection();
+
   QString name;
   qint32 id;
   quint8 type;
@@ -526,20 +581,18 @@ bool AirspaceHelper::readCompiledFile( QString &path, QList<Airspace*>& list )
       in >> upper;
       ShortLoad( in, pa );
 
-      if( id >= 0 && addAirspaceIdentifier(id) == false )
-        {
-          // Airspace is already known. Ignore object.
-          qDebug() << "ASH::readCompiledFile: Known Airspace" << name << "ignored!";
-          continue;
-        }
+      // The file contains WGS84 coordinates, they are projected here.
+      QPolygon projPa( pa.size() );
+      MapMatrix::wgsToMap( projection, pa.constData(), projPa.data(), pa.size() );
 
       Airspace *a = new Airspace( name,
                                   (BaseMapElement::objectType) type,
-                                  pa,
+                                  projPa,
                                   upper, (BaseMapElement::elevationType) upperType,
                                   lower, (BaseMapElement::elevationType) lowerType,
                                   id,
                                   QString(country) );
+      a->setWgsPolygon( pa );
       list.append(a);
       counter++;
     }
@@ -72,7 +72,10 @@ class AirspaceHelper
 
   /**
    * Searches on default places for OpenAir and OpenAip airspace files.
-   * That can be source files or compiled versions of them.
+   * That can be source files or compiled versions of them. The files are
+   * read in parallel, the airspaces are appended in the order of the file
+   * names. An airspace, which is contained in several files, is taken from
+   * the first one.
    *
    * @returns The number of successfully loaded files
    *
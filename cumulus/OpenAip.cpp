@@ -26,7 +26,10 @@ extern MapMatrix* _globalMapMatrix;
 
 OpenAip::OpenAip() :
   m_filterRadius(0.0),
-  m_filterRunwayLength(0.0)
+  m_filterRunwayLength(0.0),
+  m_useFiltering(false),
+  m_recordCounter(0),
+  m_rejectedCounter(0)
 {
   m_supportedDataFormats << "1.0" << "1.1";
 }
@@ -48,6 +51,32 @@ void OpenAip::loadUserFilterValues()
   m_filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
 }
 
+bool OpenAip::isOutsideFilterRadius( SinglePoint& sp )
+{
+  if( m_useFiltering == false || m_filterRadius <= 0.0 )
+    {
+      return false;
+    }
+
+  return MapCalc::dist( &m_homePosition, sp.getWGSPositionPtr() ) > m_filterRadius;
+}
+
+void OpenAip::printStatistics( const QString& fileName,
+                               const int accepted,
+                               const int elapsed )
+{
+  qDebug( "OAIP: %s parsed in %dms, %d records, %d accepted, %d rejected early, "
+          "string pool %d entries, %d hits, %lldKB shared",
+          QFileInfo(fileName).fileName().toLatin1().data(),
+          elapsed,
+          m_recordCounter,
+          accepted,
+          m_rejectedCounter,
+          m_stringPool.size(),
+          m_stringPool.hits(),
+          m_stringPool.sharedBytes() / 1024 );
+}
+
 bool OpenAip::getRootElement( QString fileName,
                               QString& dataFormat,
                               QString& dataItem )
@@ -179,6 +208,13 @@ bool OpenAip::readNavAids( QString fileName,
                            QString& errorInfo,
                            bool useFiltering )
 {
+  QTime t;
+  t.start();
+
+  m_useFiltering    = useFiltering;
+  m_recordCounter   = 0;
+  m_rejectedCounter = 0;
+
   if( useFiltering )
     {
       // Load the user's defined filter data.
@@ -206,6 +242,9 @@ bool OpenAip::readNavAids( QString fileName,
   int elementCounter   = 0;
   bool oaipFormatOk = false;
 
+  // Start index in navAidList
+  int startIdx = navAidList.size();
+
   // Reset version and data format variable
   m_oaipVersion.clear();
   m_oaipDataFormat.clear();
@@ -258,23 +297,17 @@ bool OpenAip::readNavAids( QString fileName,
               RadioPoint rp;
 
               // read navAid record
-              if( ! readNavAidRecord( xml, rp ) )
+              RecordState state = readNavAidRecord( xml, rp );
+
+              if( state == RecordError )
                 {
                   break;
                 }
 
-              if( useFiltering == true )
+              if( state == RecordRejected )
                 {
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = MapCalc::dist( &m_homePosition, rp.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
+                  // The radius filter said no. To far away from home.
+                  continue;
                 }
 
               navAidList.append( rp );
@@ -303,11 +336,23 @@ bool OpenAip::readNavAids( QString fileName,
     }
 
   file.close();
+
+  // The positions are projected for all accepted records together.
+  SinglePoint::projectPositions( navAidList, startIdx, _globalMapMatrix->getProjection() );
+
+  printStatistics( fileName, navAidList.size() - startIdx, t.elapsed() );
   return true;
 }
 
-bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
+OpenAip::RecordState OpenAip::readNavAidRecord( QXmlStreamReader& xml,
+                                                RadioPoint& rp )
 {
+  m_recordCounter++;
+
+  // The name is converted only, if the record is accepted.
+  QString name;
+  bool located = false;
+
   // Read navaid type
   QXmlStreamAttributes attributes = xml.attributes();
 
@@ -354,7 +399,15 @@ bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
           if( xml.name() == "NAVAID" )
             {
               // All record data have been read.
-              return true;
+              if( located == false && isOutsideFilterRadius( rp ) )
+                {
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
+
+              upperLowerName( name );
+              rp.setName( name );
+              return RecordAccepted;
             }
         }
 
@@ -365,13 +418,11 @@ bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
 
           if( elementName == "COUNTRY" )
             {
-              rp.setCountry( xml.readElementText().left(2).toUpper() );
+              rp.setCountry( m_stringPool.intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
-              QString name = xml.readElementText();
-              upperLowerName( name );
-              rp.setName( name );
+              name = xml.readElementText();
             }
           else if ( elementName == "ID" )
             {
@@ -382,6 +433,15 @@ bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
           else if ( elementName == "GEOLOCATION" )
             {
               readGeoLocation( xml, rp );
+              located = true;
+
+              if( isOutsideFilterRadius( rp ) )
+                {
+                  // Skip the rest of the record without reading it.
+                  xml.skipCurrentElement();
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
             }
           else if ( elementName == "RADIO" )
             {
@@ -394,7 +454,7 @@ bool OpenAip::readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp )
         }
     }
 
-  return true;
+  return RecordError;
 }
 
 bool OpenAip::readGeoLocation( QXmlStreamReader& xml, SinglePoint& sp )
@@ -423,8 +483,8 @@ bool OpenAip::readGeoLocation( QXmlStreamReader& xml, SinglePoint& sp )
                   WGSPoint wgsPoint( ilat, ilon );
                   sp.setWGSPosition( wgsPoint );
 
-                  // Map WGS point to map projection
-                  sp.setPosition( _globalMapMatrix->wgsToMap(wgsPoint) );
+                  // The map projection is done by the caller for the
+                  // whole point list.
                 }
 
               if( elev != INT_MIN )
@@ -522,7 +582,7 @@ bool OpenAip::readRadio( QXmlStreamReader& xml, RadioPoint& rp )
              }
           else if ( elementName == "CHANNEL" )
             {
-              rp.setChannel( xml.readElementText() );
+              rp.setChannel( m_stringPool.intern( xml.readElementText() ) );
             }
         }
     }
@@ -618,6 +678,13 @@ bool OpenAip::readHotspots( QString fileName,
                             QString& errorInfo,
                             bool useFiltering )
 {
+  QTime t;
+  t.start();
+
+  m_useFiltering    = useFiltering;
+  m_recordCounter   = 0;
+  m_rejectedCounter = 0;
+
   QFile file( fileName );
 
   if( file.exists() && file.size() == 0 )
@@ -700,7 +767,9 @@ bool OpenAip::readHotspots( QString fileName,
               sp.setTypeID( BaseMapElement::Thermal );
 
               // read hotspot record
-              if( ! readHotspotRecord( xml, sp ) )
+              RecordState state = readHotspotRecord( xml, sp );
+
+              if( state == RecordError )
                 {
                   break;
                 }
@@ -708,18 +777,10 @@ bool OpenAip::readHotspots( QString fileName,
               // Increment name counter for the hotspot.
               hsno++;
 
-              if( useFiltering == true )
+              if( state == RecordRejected )
                 {
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = MapCalc::dist( &m_homePosition, sp.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
+                  // The radius filter said no. To far away from home.
+                  continue;
                 }
 
               // Set record number as WP name
@@ -766,11 +827,23 @@ bool OpenAip::readHotspots( QString fileName,
     }
 
   file.close();
+
+  // The positions are projected for all accepted records together.
+  SinglePoint::projectPositions( hotspotList, startIdx, _globalMapMatrix->getProjection() );
+
+  printStatistics( fileName, hotspotList.size() - startIdx, t.elapsed() );
   return true;
 }
 
-bool OpenAip::readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp )
+OpenAip::RecordState OpenAip::readHotspotRecord( QXmlStreamReader& xml,
+                                                 SinglePoint& sp )
 {
+  m_recordCounter++;
+
+  // The name is converted only, if the record is accepted.
+  QString name;
+  bool located = false;
+
   while( !xml.atEnd() && ! xml.hasError() )
     {
       /* Read the next element from the stream.*/
@@ -781,7 +854,20 @@ bool OpenAip::readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp )
           if( xml.name() == "HOTSPOT" )
             {
               // All record data have been read.
-              return true;
+              if( located == false && isOutsideFilterRadius( sp ) )
+                {
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
+
+              upperLowerName( name );
+
+              // Long name
+              sp.setName( name );
+
+              // Short name only 8 characters long
+              sp.setWPName( name.left(8) );
+              return RecordAccepted;
             }
         }
 
@@ -792,32 +878,34 @@ bool OpenAip::readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp )
 
           if( elementName == "COUNTRY" )
             {
-              sp.setCountry( xml.readElementText().left(2).toUpper() );
+              sp.setCountry( m_stringPool.intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
-              QString name = xml.readElementText();
-
-              upperLowerName( name );
-
-              // Long name
-              sp.setName( name );
-
-              // Short name only 8 characters long
-              sp.setWPName( name.left(8) );
+              name = xml.readElementText();
             }
           else if ( elementName == "COMMENT" )
             {
-              sp.setComment( xml.readElementText() );
+              // Hotspot comments are mostly generic texts.
+              sp.setComment( m_stringPool.intern( xml.readElementText() ) );
             }
           else if ( elementName == "GEOLOCATION" )
             {
               readGeoLocation( xml, sp );
+              located = true;
+
+              if( isOutsideFilterRadius( sp ) )
+                {
+                  // Skip the rest of the record without reading it.
+                  xml.skipCurrentElement();
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
             }
         }
     }
 
-  return true;
+  return RecordError;
 }
 
 bool OpenAip::readAirfields( QString fileName,
@@ -825,6 +913,13 @@ bool OpenAip::readAirfields( QString fileName,
                              QString& errorInfo,
                              bool useFiltering )
 {
+  QTime t;
+  t.start();
+
+  m_useFiltering    = useFiltering;
+  m_recordCounter   = 0;
+  m_rejectedCounter = 0;
+
   if( useFiltering )
     {
       // Load the user's defined filter data.
@@ -854,6 +949,9 @@ bool OpenAip::readAirfields( QString fileName,
   int elementCounter   = 0;
   bool oaipFormatOk = false;
 
+  // Start index in airfieldList
+  int startIdx = airfieldList.size();
+
   // Reset version and data format variable
   m_oaipVersion.clear();
   m_oaipDataFormat.clear();
@@ -906,31 +1004,21 @@ bool OpenAip::readAirfields( QString fileName,
               Airfield af;
 
               // read airfield record
-              if( ! readAirfieldRecord( xml, af ) )
+              RecordState state = readAirfieldRecord( xml, af );
+
+              if( state == RecordError )
                 {
                   break;
                 }
 
-              if( useFiltering == true )
+              if( state == RecordRejected )
                 {
-                  if( af.getTypeID() == BaseMapElement::CivHeliport ||
-                      af.getTypeID() == BaseMapElement::MilHeliport )
-                    {
-                      // Filter out heli ports.
-                      continue;
-                    }
-
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = MapCalc::dist( &m_homePosition, af.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
+                  // Heli port or to far away from home.
+                  continue;
+                }
 
+              if( useFiltering == true )
+                {
                   if( m_filterRunwayLength > 0.0 )
                     {
                       QList<Runway>& rl = af.getRunwayList();
@@ -997,11 +1085,19 @@ bool OpenAip::readAirfields( QString fileName,
     }
 
   file.close();
+
+  // The positions are projected for all accepted records together.
+  SinglePoint::projectPositions( airfieldList, startIdx, _globalMapMatrix->getProjection() );
+
+  printStatistics( fileName, airfieldList.size() - startIdx, t.elapsed() );
   return true;
 }
 
-bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
+OpenAip::RecordState OpenAip::readAirfieldRecord( QXmlStreamReader& xml,
+                                                  Airfield& af )
 {
+  m_recordCounter++;
+
   // Read airport type
   QXmlStreamAttributes attributes = xml.attributes();
 
@@ -1073,8 +1169,22 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
           af.setTypeID( BaseMapElement::NotSelected );
           qWarning() << "OpenAip::readNavAidRecord: unknown airfield type" << type;
         }
+
+      if( m_useFiltering &&
+          ( af.getTypeID() == BaseMapElement::CivHeliport ||
+            af.getTypeID() == BaseMapElement::MilHeliport ) )
+        {
+          // Filter out heli ports without reading the record.
+          xml.skipCurrentElement();
+          m_rejectedCounter++;
+          return RecordRejected;
+        }
     }
 
+  // The name is converted only, if the record is accepted.
+  QString name;
+  bool located = false;
+
   while( !xml.atEnd() && ! xml.hasError() )
     {
       /* Read the next element from the stream.*/
@@ -1085,7 +1195,21 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
           if( xml.name() == "AIRPORT" )
             {
               // All record data have been read.
-              return true;
+              if( located == false && isOutsideFilterRadius( af ) )
+                {
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
+
+              // Convert airfield name to upper-lower cases
+              upperLowerName( name );
+
+              // Long name
+              af.setName( name );
+
+              // Short name is only 8 characters long
+              af.setWPName( name.left(8) );
+              return RecordAccepted;
             }
         }
 
@@ -1096,21 +1220,11 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
 
           if( elementName == "COUNTRY" )
             {
-              af.setCountry( xml.readElementText().left(2).toUpper() );
+              af.setCountry( m_stringPool.intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
-              // Airfield name lowered.
-              QString name = xml.readElementText().toLower();
-
-              // Convert airfield name to upper-lower cases
-              upperLowerName( name );
-
-              // Long name
-              af.setName( name );
-
-              // Short name is only 8 characters long
-              af.setWPName( name.left(8) );
+              name = xml.readElementText();
             }
           else if ( elementName == "ICAO" )
             {
@@ -1119,6 +1233,15 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
           else if ( elementName == "GEOLOCATION" )
             {
               readGeoLocation( xml, af );
+              located = true;
+
+              if( isOutsideFilterRadius( af ) )
+                {
+                  // Skip the radio and runway data of the record.
+                  xml.skipCurrentElement();
+                  m_rejectedCounter++;
+                  return RecordRejected;
+                }
             }
           else if ( elementName == "RADIO" )
             {
@@ -1138,7 +1261,7 @@ bool OpenAip::readAirfieldRecord( QXmlStreamReader& xml, Airfield& af )
         }
     }
 
-  return true;
+  return RecordError;
 }
 
 bool OpenAip::readAirfieldRadio( QXmlStreamReader& xml, Airfield& af )
@@ -1596,20 +1719,14 @@ void OpenAip::upperLowerName( QString& name )
 {
   name = name.toLower();
 
-  QSet<QChar> set;
-  set.insert( ' ' );
-  set.insert( '/' );
-  set.insert( '-' );
-  set.insert( '(' );
-
   QChar lastChar(' ');
 
-  // Convert name to upper-lower cases
+  // Convert name to upper-lower cases in place
   for( int i=0; i < name.size(); i++ )
     {
-      if( set.contains(lastChar) )
+      if( lastChar == ' ' || lastChar == '/' || lastChar == '-' || lastChar == '(' )
         {
-          name.replace( i, 1, name.mid(i,1).toUpper() );
+          name[i] = name[i].toUpper();
         }
 
       lastChar = name[i];
@@ -1782,18 +1899,10 @@ bool OpenAip::readAirspaces( QString fileName,
                       continue;
                     }
 
-                  if( AirspaceHelper::addAirspaceIdentifier(as.getId()) )
-                    {
-                      Airspace* elem = as.createAirspaceObject();
-                      airspaceList.append( elem );
-                    }
-                  else
-                    {
-                      // Airspace is already known. Ignore object.
-                      qDebug() << "QIAP:: Known Airspace"
-                               << as.getName()
-                               << "ignored!";
-                    }
+                  // Duplicates of other files are removed by the caller,
+                  // see AirspaceHelper::loadAirspaces.
+                  Airspace* elem = as.createAirspaceObject();
+                  airspaceList.append( elem );
                 }
             }
 
@@ -1920,7 +2029,7 @@ bool OpenAip::readAirspaceRecord( QXmlStreamReader& xml, Airspace& as )
             }
           else if( elementName == "COUNTRY" )
             {
-              as.setCountry( xml.readElementText().left(2).toUpper() );
+              as.setCountry( m_stringPool.intern( xml.readElementText().left(2).toUpper() ) );
             }
           else if ( elementName == "NAME" )
             {
@@ -2157,8 +2266,7 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
       int latInt = static_cast<int> (rint(600000.0 * lat));
       int lonInt = static_cast<int> (rint(600000.0 * lon));
 
-      // Project coordinates to map datum and store them in a polygon
-      asPolygon.setPoint( i/2, _globalMapMatrix->wgsToMap( latInt, lonInt ) );
+      asPolygon.setPoint( i/2, latInt, lonInt );
     }
 
   if( asPolygon.count() < 2 )
@@ -2177,6 +2285,8 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
       asPolygon.remove(asPolygon.count()-1);
     }
 
-  as.setProjectedPolygon( asPolygon );
+  // Project coordinates to map datum
+  as.setWgsPolygon( asPolygon );
+  as.setProjectedPolygon( _globalMapMatrix->wgsToMap( asPolygon ) );
   return true;
 }
@@ -43,6 +43,7 @@
 #include "airspace.h"
 #include "altitude.h"
 #include "radiopoint.h"
+#include "stringpool.h"
 
 class OpenAip
 {
@@ -161,6 +162,17 @@ class OpenAip
 
  private:
 
+  /**
+   * Result of a point record read. A record is rejected by the user's
+   * filter as soon as possible, the rest of it is skipped then.
+   */
+  enum RecordState
+  {
+    RecordAccepted,
+    RecordRejected,
+    RecordError
+  };
+
   /**
    * Read version and format attribute from OPENAIP tag. Returns true in case
    * of success otherwise false.
@@ -169,7 +181,7 @@ class OpenAip
                              QString& version,
                              QString& format );
 
-  bool readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp );
+  RecordState readNavAidRecord( QXmlStreamReader& xml, RadioPoint& rp );
 
   bool readGeoLocation( QXmlStreamReader& xml, SinglePoint& sp );
 
@@ -177,9 +189,9 @@ class OpenAip
 
   bool readParams( QXmlStreamReader& xml, RadioPoint& rp );
 
-  bool readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp );
+  RecordState readHotspotRecord( QXmlStreamReader& xml, SinglePoint& sp );
 
-  bool readAirfieldRecord( QXmlStreamReader& xml, Airfield& af );
+  RecordState readAirfieldRecord( QXmlStreamReader& xml, Airfield& af );
 
   bool readAirfieldRadio( QXmlStreamReader& xml, Airfield& af );
 
@@ -238,6 +250,17 @@ class OpenAip
    */
   void loadUserFilterValues();
 
+  /**
+   * \return True, if filtering is enabled and the WGS84 position of the
+   *         point is outside of the filter radius around the home position.
+   */
+  bool isOutsideFilterRadius( SinglePoint& sp );
+
+  /**
+   * Prints the parser statistics of the last read file.
+   */
+  void printStatistics( const QString& fileName, const int accepted, const int elapsed );
+
   /**
    * Containing all supported OpenAip data formats.
    */
@@ -259,6 +282,27 @@ class OpenAip
    */
   float m_filterRunwayLength;
 
+  /**
+   * Set, if the filter rules are applied during the current file read.
+   */
+  bool m_useFiltering;
+
+  /**
+   * Number of read point records of the current file.
+   */
+  int m_recordCounter;
+
+  /**
+   * Number of point records of the current file, which have been rejected
+   * by the filter before they were read completely.
+   */
+  int m_rejectedCounter;
+
+  /**
+   * Pool for the string values, which are repeated in many records.
+   */
+  StringPool m_stringPool;
+
   /**
    * Value of VERSION attribute from OPENAIP tag of the current read file.
    */
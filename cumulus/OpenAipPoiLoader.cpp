@@ -22,6 +22,7 @@
 #include "OpenAip.h"
 #include "OpenAipPoiLoader.h"
 #include "resource.h"
+#include "stringpool.h"
 
 #ifdef BOUNDING_BOX
 extern MapContents*  _globalMapContents;
@@ -164,41 +165,28 @@ int OpenAipPoiLoader::load( QList<Airfield>& airfieldList, bool readSource )
               continue;
             }
 
-          // Check, if the projection has been changed in the meantime
-          ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
+          // A changed projection requires no reparse, because the compiled
+          // file contains WGS84 coordinates.
+          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
 
-          if( ! MapContents::compareProjections( m_hd.h_projection, currentProjection ) )
+          if( m_hd.h_homeRadius != filterRadius )
             {
-              // Projection has changed in the meantime. That requires a reparse
+              // Home radius has been changed. That requires a reparse
               // of the source files.
-              if( m_hd.h_projection )
-                {
-                  delete m_hd.h_projection;
-                  m_hd.h_projection = 0;
-                }
-
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Projection mismatch";
+              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
               continue;
             }
 
-          if( m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
+          if( filterRadius > 0.0 &&
+              m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
             {
-              // Home position has been changed. That requires a reparse
-              // of the source files.
+              // Home position has been changed and the points are filtered
+              // by their distance to it. That requires a reparse of the
+              // source files.
               qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Home mismatch";
               continue;
             }
 
-          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
-
-          if( m_hd.h_homeRadius != filterRadius )
-            {
-              // Home radius has been changed. That requires a reparse
-              // of the source files.
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
-              continue;
-            }
-
           float filterRunwayLength = GeneralConfig::instance()->getAirfieldRunwayLengthFilter();
 
           if( m_hd.h_runwayLengthFilter != filterRunwayLength )
@@ -347,41 +335,28 @@ int OpenAipPoiLoader::load( QList<RadioPoint>& navAidList, bool readSource )
               continue;
             }
 
-          // Check, if the projection has been changed in the meantime
-          ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
+          // A changed projection requires no reparse, because the compiled
+          // file contains WGS84 coordinates.
+          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
 
-          if( ! MapContents::compareProjections( m_hd.h_projection, currentProjection ) )
+          if( m_hd.h_homeRadius != filterRadius )
             {
-              // Projection has changed in the meantime. That requires a reparse
+              // Home radius has been changed. That requires a reparse
               // of the source files.
-              if( m_hd.h_projection )
-                {
-                  delete m_hd.h_projection;
-                  m_hd.h_projection = 0;
-                }
-
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Projection mismatch";
+              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
               continue;
             }
 
-          if( m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
+          if( filterRadius > 0.0 &&
+              m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
             {
-              // Home position has been changed. That requires a reparse
-              // of the source files.
+              // Home position has been changed and the points are filtered
+              // by their distance to it. That requires a reparse of the
+              // source files.
               qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Home mismatch";
               continue;
             }
 
-          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
-
-          if( m_hd.h_homeRadius != filterRadius )
-            {
-              // Home radius has been changed. That requires a reparse
-              // of the source files.
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
-              continue;
-            }
-
           // All checks passed, there is no need to read the source file and
           // we can remove it from the list.
           preselect.removeAt( 0 );
@@ -520,41 +495,28 @@ int OpenAipPoiLoader::load( QList<SinglePoint>& spList, bool readSource )
               continue;
             }
 
-          // Check, if the projection has been changed in the meantime
-          ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
+          // A changed projection requires no reparse, because the compiled
+          // file contains WGS84 coordinates.
+          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
 
-          if( ! MapContents::compareProjections( m_hd.h_projection, currentProjection ) )
+          if( m_hd.h_homeRadius != filterRadius )
             {
-              // Projection has changed in the meantime. That requires a reparse
+              // Home radius has been changed. That requires a reparse
               // of the source files.
-              if( m_hd.h_projection )
-                {
-                  delete m_hd.h_projection;
-                  m_hd.h_projection = 0;
-                }
-
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Projection mismatch";
+              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
               continue;
             }
 
-          if( m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
+          if( filterRadius > 0.0 &&
+              m_hd.h_homeCoord != _globalMapMatrix->getHomeCoord() )
             {
-              // Home position has been changed. That requires a reparse
-              // of the source files.
+              // Home position has been changed and the points are filtered
+              // by their distance to it. That requires a reparse of the
+              // source files.
               qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Home mismatch";
               continue;
             }
 
-          float filterRadius = GeneralConfig::instance()->getAirfieldHomeRadius();
-
-          if( m_hd.h_homeRadius != filterRadius )
-            {
-              // Home radius has been changed. That requires a reparse
-              // of the source files.
-              qDebug() << "OAIP:" << QFileInfo(aicName).fileName() << "Radius mismatch";
-              continue;
-            }
-
           // All checks passed, there is no need to read the source file and
           // we can remove it from the list.
           preselect.removeAt( 0 );
@@ -643,8 +605,6 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       ShortSave(out, af.getComment().toUtf8());
       // WGS84 coordinates
       out << af.getWGSPosition();
-      // projected WGS84 coordinates
-      out << af.getPosition();
       // elevation in meters
       out << af.getElevation();
 
@@ -751,8 +711,6 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       ShortSave(out, rp.getComment().toUtf8());
       // WGS84 coordinates
       out << rp.getWGSPosition();
-      // projected WGS84 coordinates
-      out << rp.getPosition();
       // elevation in meters
       out << rp.getElevation();
       // frequency is save in MHz
@@ -839,8 +797,6 @@ bool OpenAipPoiLoader::createCompiledFile( QString& fileName,
       ShortSave(out, sp.getComment().toUtf8());
       // WGS84 coordinates
       out << sp.getWGSPosition();
-      // projected WGS84 coordinates
-      out << sp.getPosition();
       // elevation in meters
       out << sp.getElevation();
     }
@@ -886,12 +842,16 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
   quint8 afType;
   QByteArray utf8_temp;
   WGSPoint wgsPos;
-  QPoint position;
   float elevation;
   quint16 inFrequency;
 
   uint counter = 0;
 
+  // Country codes, comments and channels are repeated in many records.
+  StringPool pool;
+
+  const int listStart = airfieldList.size();
+
   while( ! in.atEnd() )
     {
       counter++;
@@ -910,7 +870,7 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // read the 2 letter country code
       ShortLoad(in, utf8_temp);
-      af.setCountry(QString::fromUtf8(utf8_temp));
+      af.setCountry(pool.intern(QString::fromUtf8(utf8_temp)));
 
       // read ICAO
       ShortLoad(in, utf8_temp);
@@ -918,12 +878,10 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // read comment
       ShortLoad(in, utf8_temp);
-      af.setComment(QString::fromUtf8(utf8_temp));
+      af.setComment(pool.intern(QString::fromUtf8(utf8_temp)));
 
       in >> wgsPos; af.setWGSPosition(wgsPos);
 
-      in >> position; af.setPosition(position);
-
       in >> elevation; af.setElevation(elevation);
 
       in >> inFrequency;
@@ -967,8 +925,12 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
   inFile.close();
 
-  qDebug( "OAIP: %d airfields read from %s in %dms",
-          counter, fileName.toLatin1().data(), t.elapsed() );
+  // The file contains only WGS84 coordinates, the projection is done here.
+  SinglePoint::projectPositions( airfieldList, listStart, _globalMapMatrix->getProjection() );
+
+  qDebug( "OAIP: %d airfields read from %s in %dms, string pool %d entries, %d hits",
+          counter, fileName.toLatin1().data(), t.elapsed(),
+          pool.size(), pool.hits() );
 
   return true;
 }
@@ -1010,7 +972,6 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
   quint8 type;
   QByteArray utf8_temp;
   WGSPoint wgsPos;
-  QPoint position;
   float elevation;
   float inFrequency;
   float range;
@@ -1019,6 +980,11 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
   uint counter = 0;
 
+  // Country codes, comments and channels are repeated in many records.
+  StringPool pool;
+
+  const int listStart = navAidList.size();
+
   while( ! in.atEnd() )
     {
       counter++;
@@ -1037,7 +1003,7 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // read the 2 letter country code
       ShortLoad(in, utf8_temp);
-      rp.setCountry(QString::fromUtf8(utf8_temp));
+      rp.setCountry(pool.intern(QString::fromUtf8(utf8_temp)));
 
       // read ICAO
       ShortLoad(in, utf8_temp);
@@ -1045,12 +1011,10 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // read comment
       ShortLoad(in, utf8_temp);
-      rp.setComment(QString::fromUtf8(utf8_temp));
+      rp.setComment(pool.intern(QString::fromUtf8(utf8_temp)));
 
       in >> wgsPos; rp.setWGSPosition(wgsPos);
 
-      in >> position; rp.setPosition(position);
-
       in >> elevation; rp.setElevation(elevation);
 
       // Frequency in MHz
@@ -1058,7 +1022,7 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // Channel info
       ShortLoad(in, utf8_temp);
-      rp.setChannel(QString::fromUtf8(utf8_temp));
+      rp.setChannel(pool.intern(QString::fromUtf8(utf8_temp)));
 
       // Service range as float
       in >> range; rp.setRange(range);
@@ -1075,8 +1039,12 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
   inFile.close();
 
-  qDebug( "OAIP: %d navAids read from %s in %dms",
-          counter, fileName.toLatin1().data(), t.elapsed() );
+  // The file contains only WGS84 coordinates, the projection is done here.
+  SinglePoint::projectPositions( navAidList, listStart, _globalMapMatrix->getProjection() );
+
+  qDebug( "OAIP: %d navAids read from %s in %dms, string pool %d entries, %d hits",
+          counter, fileName.toLatin1().data(), t.elapsed(),
+          pool.size(), pool.hits() );
 
   return true;
 }
@@ -1118,11 +1086,15 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
   quint8 type;
   QByteArray utf8_temp;
   WGSPoint wgsPos;
-  QPoint position;
   float elevation;
 
   uint counter = 0;
 
+  // Country codes, comments and channels are repeated in many records.
+  StringPool pool;
+
+  const int listStart = spList.size();
+
   while( ! in.atEnd() )
     {
       counter++;
@@ -1141,14 +1113,13 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
       // read the 2 letter country code
       ShortLoad(in, utf8_temp);
-      sp.setCountry(QString::fromUtf8(utf8_temp));
+      sp.setCountry(pool.intern(QString::fromUtf8(utf8_temp)));
 
       // read comment
       ShortLoad(in, utf8_temp);
-      sp.setComment(QString::fromUtf8(utf8_temp));
+      sp.setComment(pool.intern(QString::fromUtf8(utf8_temp)));
 
       in >> wgsPos;    sp.setWGSPosition(wgsPos);
-      in >> position;  sp.setPosition(position);
       in >> elevation; sp.setElevation(elevation);
 
       // Add the single point element to the list.
@@ -1157,8 +1128,12 @@ bool OpenAipPoiLoader::readCompiledFile( QString &fileName,
 
   inFile.close();
 
-  qDebug( "OAIP: %d single points read from %s in %dms",
-          counter, fileName.toLatin1().data(), t.elapsed() );
+  // The file contains only WGS84 coordinates, the projection is done here.
+  SinglePoint::projectPositions( spList, listStart, _globalMapMatrix->getProjection() );
+
+  qDebug( "OAIP: %d single points read from %s in %dms, string pool %d entries, %d hits",
+          counter, fileName.toLatin1().data(), t.elapsed(),
+          pool.size(), pool.hits() );
 
   return true;
 }
@@ -26,7 +26,6 @@
 #include "calculator.h"
 
 extern MapContents *_globalMapContents;
-extern MapConfig   *_globalMapConfig;
 
 RadioPointListWidget::RadioPointListWidget( QVector<enum MapContents::ListID> &itemList,
 					    QWidget *parent,
@@ -58,7 +57,15 @@ void RadioPointListWidget::fillItemList()
 
   for ( int item = 0; item < m_itemList.size(); item++ )
     {
-      int nr = _globalMapContents->getListLength( m_itemList.at(item) );
+      // The item texts are taken from the columns of the point store.
+      const PointStore* store = _globalMapContents->getPointStore( m_itemList.at(item) );
+
+      if( store == 0 )
+        {
+          continue;
+        }
+
+      int nr = store->size();
 
       for (int i = 0; i < nr; i++ )
         {
@@ -69,7 +76,8 @@ void RadioPointListWidget::fillItemList()
 	      continue;
 	    }
 
-          filter->addListItem( new RadioPointItem(site) );
+          filter->addListItem( new RadioPointItem( site, *store, i,
+                                                   typeIcon( store->type(i) ) ) );
         }
     }
 
@@ -116,16 +124,18 @@ Waypoint* RadioPointListWidget::getCurrentWaypoint()
   return &m_wp;
 }
 
-RadioPointListWidget::RadioPointItem::RadioPointItem(RadioPoint* site) :
+RadioPointListWidget::RadioPointItem::RadioPointItem( RadioPoint* site,
+                                                      const PointStore& store,
+                                                      const int index,
+                                                      const QIcon& icon ) :
   QTreeWidgetItem(), m_radioPoint(site)
 {
-  setText(0, site->getWPName());
-  setText(1, site->getName());
-  setText(2, site->getCountry());
+  setText(0, store.text( index, PointStore::ShortName ));
+  setText(1, store.text( index, PointStore::Name ));
+  setText(2, store.text( index, PointStore::Country ));
   setTextAlignment(2, Qt::AlignCenter);
   setText(3, site->getAdditionalText());
 
   // set type icon
-  QPixmap pm = _globalMapConfig->getPixmap(site->getTypeID(), false);
-  setIcon( 0, QIcon( pm) );
+  setIcon( 0, icon );
 }
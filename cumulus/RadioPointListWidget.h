@@ -35,6 +35,7 @@
 #include "waypoint.h"
 #include "listwidgetparent.h"
 #include "mapcontents.h"
+#include "pointstore.h"
 
 class RadioPointListWidget : public ListWidgetParent
 {
@@ -85,7 +86,10 @@ private:
     {
       public:
 
-      RadioPointItem(RadioPoint *);
+      RadioPointItem( RadioPoint* site,
+                      const PointStore& store,
+                      const int index,
+                      const QIcon& icon );
       RadioPoint* m_radioPoint;
     };
 };
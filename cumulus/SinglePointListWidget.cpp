@@ -26,7 +26,6 @@
 #include "calculator.h"
 
 extern MapContents *_globalMapContents;
-extern MapConfig   *_globalMapConfig;
 
 SinglePointListWidget::SinglePointListWidget( QVector<enum MapContents::ListID> &itemList,
 					      QWidget *parent,
@@ -58,7 +57,15 @@ void SinglePointListWidget::fillItemList()
 
   for ( int item = 0; item < m_itemList.size(); item++ )
     {
-      int nr = _globalMapContents->getListLength( m_itemList.at(item) );
+      // The item texts are taken from the columns of the point store.
+      const PointStore* store = _globalMapContents->getPointStore( m_itemList.at(item) );
+
+      if( store == 0 )
+        {
+          continue;
+        }
+
+      int nr = store->size();
 
       for (int i = 0; i < nr; i++ )
         {
@@ -69,7 +76,8 @@ void SinglePointListWidget::fillItemList()
               continue;
             }
 
-          filter->addListItem( new SinglePointItem(site) );
+          filter->addListItem( new SinglePointItem( site, *store, i,
+                                                    typeIcon( store->type(i) ) ) );
         }
     }
 
@@ -114,16 +122,18 @@ Waypoint* SinglePointListWidget::getCurrentWaypoint()
   return &m_wp;
 }
 
-SinglePointListWidget::SinglePointItem::SinglePointItem(SinglePoint* site) :
+SinglePointListWidget::SinglePointItem::SinglePointItem( SinglePoint* site,
+                                                         const PointStore& store,
+                                                         const int index,
+                                                         const QIcon& icon ) :
   QTreeWidgetItem(), m_singlePoint(site)
 {
-  setText(0, site->getWPName());
-  setText(1, site->getName());
-  setText(2, site->getCountry());
+  setText(0, store.text( index, PointStore::ShortName ));
+  setText(1, store.text( index, PointStore::Name ));
+  setText(2, store.text( index, PointStore::Country ));
   setTextAlignment(2, Qt::AlignCenter);
-  setText(3, site->getComment());
+  setText(3, store.text( index, PointStore::Comment ));
 
   // set type icon
-  QPixmap pm = _globalMapConfig->getPixmap(site->getTypeID(), false);
-  setIcon( 0, QIcon( pm) );
+  setIcon( 0, icon );
 }
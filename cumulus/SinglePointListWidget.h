@@ -35,6 +35,7 @@
 #include "waypoint.h"
 #include "listwidgetparent.h"
 #include "mapcontents.h"
+#include "pointstore.h"
 
 class SinglePointListWidget : public ListWidgetParent
 {
@@ -85,7 +86,10 @@ private:
     {
       public:
 
-      SinglePointItem( SinglePoint *sp );
+      SinglePointItem( SinglePoint* site,
+                       const PointStore& store,
+                       const int index,
+                       const QIcon& icon );
 
       SinglePoint* m_singlePoint;
     };
@@ -0,0 +1,1658 @@
+/***********************************************************************
+**
+**   TileLoaderThread.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2000      by Heiner Lamprecht, Florian Ehinger
+**                   2008-2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+#include <csignal>
+#include <unistd.h>
+
+#include <QtCore>
+
+#include "basemapelement.h"
+#include "filetools.h"
+#include "generalconfig.h"
+#include "mapcontents.h"
+#include "mapmatrix.h"
+#include "resource.h"
+#include "TileLoaderThread.h"
+
+#define FILE_FORMAT_ID 100 // used to handle a previous version
+
+// Byte order mark of the coordinate table in compiled files
+#define COORDINATE_TABLE_BYTE_ORDER 0x01020304
+
+#define READ_POINT_LIST\
+  if (compiling) {\
+    in >> locLength;\
+    all.resize(locLength);\
+    for(uint i = 0; i < locLength; i++) { \
+      in >> lat_temp; \
+      in >> lon_temp; \
+      all.setPoint(i, lat_temp, lon_temp); \
+    }\
+    MapMatrix::wgsToMap(m_projection, all.constData(), all.data(), all.size()); \
+    out << quint32(lines.size());\
+    lines.append(all);\
+  } else {\
+    in >> locLength;\
+    if (locLength >= table->entries) {\
+      tableError = true;\
+      break;\
+    }\
+    copyTableLine(table, locLength, all);\
+  }\
+
+TileLoaderThread::TileLoaderThread( QObject *parent,
+                                    const QHash<short, uchar>& isoHash ) :
+  QThread( parent ),
+  m_shutdown(false),
+  m_projection(0),
+  m_isoHash(isoHash)
+{
+  setObjectName( "TileLoaderThread" );
+}
+
+TileLoaderThread::~TileLoaderThread()
+{
+  stop();
+
+  qDeleteAll( m_queue );
+  delete m_projection;
+}
+
+void TileLoaderThread::setProjection( ProjectionBase* projection )
+{
+  if( projection == 0 )
+    {
+      return;
+    }
+
+  // Make a private copy of the projection via its stream representation.
+  // The projection classes are not reentrant, the Lambert projection caches
+  // its last arguments.
+  QByteArray buffer;
+  QDataStream out( &buffer, QIODevice::WriteOnly );
+  SaveProjection( out, projection );
+
+  QDataStream in( buffer );
+  ProjectionBase* copy = LoadProjection( in );
+
+  QMutexLocker locker( &m_decodeMutex );
+
+  delete m_projection;
+  m_projection = copy;
+}
+
+bool TileLoaderThread::loadTile( MapTile& tile )
+{
+  QMutexLocker locker( &m_decodeMutex );
+
+  if( m_projection == 0 )
+    {
+      qWarning() << "TileLoaderThread::loadTile: no projection set!";
+      return false;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  if( (tile.requestedParts & TILE_PART_GROUND) &&
+      readTerrainFile( tile, FILE_TYPE_GROUND ) )
+    {
+      tile.loadedParts |= TILE_PART_GROUND;
+    }
+
+  if( (tile.requestedParts & TILE_PART_TERRAIN) &&
+      readTerrainFile( tile, FILE_TYPE_TERRAIN ) )
+    {
+      tile.loadedParts |= TILE_PART_TERRAIN;
+    }
+
+  if( (tile.requestedParts & TILE_PART_MAP) && readBinaryFile( tile ) )
+    {
+      tile.loadedParts |= TILE_PART_MAP;
+    }
+
+  tile.decodeTime = timer.elapsed();
+
+  return tile.loadedParts == tile.requestedParts;
+}
+
+void TileLoaderThread::requestTile( const int secID,
+                                    const char parts,
+                                    const int generation )
+{
+  QMutexLocker locker( &m_queueMutex );
+
+  if( m_requested.contains( secID ) )
+    {
+      return;
+    }
+
+  MapTile* tile = new MapTile( secID, generation );
+  tile->requestedParts = parts;
+
+  m_requested.insert( secID );
+  m_queue.append( tile );
+
+  if( ! isRunning() )
+    {
+      m_shutdown = false;
+      start( QThread::LowPriority );
+    }
+
+  m_queueCondition.wakeOne();
+}
+
+void TileLoaderThread::clearRequests()
+{
+  QMutexLocker locker( &m_queueMutex );
+
+  for( int i = 0; i < m_queue.size(); i++ )
+    {
+      m_requested.remove( m_queue.at(i)->secID );
+    }
+
+  qDeleteAll( m_queue );
+  m_queue.clear();
+}
+
+void TileLoaderThread::stop()
+{
+  m_queueMutex.lock();
+  m_shutdown = true;
+  m_queueCondition.wakeAll();
+  m_queueMutex.unlock();
+
+  wait();
+}
+
+void TileLoaderThread::run()
+{
+  sigset_t sigset;
+  sigfillset( &sigset );
+
+  // deactivate all signals in this thread
+  pthread_sigmask( SIG_SETMASK, &sigset, 0 );
+
+  while( true )
+    {
+      m_queueMutex.lock();
+
+      while( m_queue.isEmpty() && m_shutdown == false )
+        {
+          m_queueCondition.wait( &m_queueMutex );
+        }
+
+      if( m_shutdown )
+        {
+          m_queueMutex.unlock();
+          return;
+        }
+
+      MapTile* tile = m_queue.takeFirst();
+      m_queueMutex.unlock();
+
+      loadTile( *tile );
+
+      m_queueMutex.lock();
+      m_requested.remove( tile->secID );
+      m_queueMutex.unlock();
+
+      /* It is expected that a receiver slot is connected to this signal. The
+       * receiver is responsible to delete the passed tile. Otherwise a big
+       * memory leak will occur.
+       */
+      emit tileLoaded( tile );
+    }
+}
+
+QPoint TileLoaderThread::wgsToMap( int lat, int lon )
+{
+  return MapMatrix::wgsToMap( m_projection, lat, lon );
+}
+
+/**
+ * This method reads in the ground and terrain files from the original
+ * kflog source or from the own compiled source. Compiled sources are
+ * created from the original kflog source to have a faster access to the
+ * single data items. If the map projection is changed the compiled source
+ * must be renewed.
+ *
+ * Ground files describe the surface at level 0m. They are always read in.
+ * Terrain files describe the surface above level 0m. If isoline drawing
+ * is switched off, terrain files are never read in.
+ *
+ * Thanks to Josua Dietze for his contribution of precomputed map files.
+ *
+ */
+bool TileLoaderThread::readTerrainFile( MapTile& tile, const int fileTypeID )
+{
+  bool kflExists, kfcExists;
+  bool compiling = false;
+
+  if ( fileTypeID != FILE_TYPE_TERRAIN && fileTypeID != FILE_TYPE_GROUND )
+    {
+      qWarning( "Requested terrain file type 0x%X is unsupported!", fileTypeID );
+      return false;
+    }
+
+  // First check if we need to load terrain files.
+  if ( fileTypeID == FILE_TYPE_TERRAIN &&
+       ( !GeneralConfig::instance()->getMapLoadIsoLines() ))
+    {
+      // loading of terrain files is switched off by the user
+      return true;
+    }
+
+  QString kflPathName, kfcPathName, pathName;
+  QString kflName, kfcName;
+
+  kflName.sprintf("%c_%.5d.kfl", fileTypeID, tile.secID);
+  kflExists = MapContents::locateFile("landscape/" + kflName, kflPathName);
+
+  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, tile.secID);
+  kfcExists = MapContents::locateFile(kfcName, kfcPathName);
+
+  if ( ! (kflExists || kfcExists) )
+    {
+      // The caller is responsible to check the file existence and to
+      // trigger a download of missing files.
+      qWarning( "no map files (%s or %s) found!",
+                kflName.toLatin1().data(), kfcName.toLatin1().data() );
+
+      return false; // file could not be located in any of the possible map directories.
+    }
+
+  if ( kflExists )
+    {
+      if ( kfcExists )
+        {
+          // kfl file newer than kfc ? Then compile it
+          if (MapContents::getDateFromMapFile( kflPathName ) > MapContents::getDateFromMapFile( kfcPathName ))
+            {
+              compiling = true;
+              qDebug("Map file %s has a newer date! Recompiling it from source.",
+                     kflPathName.toLatin1().data() );
+            }
+        }
+      else
+        {
+          // no kfc file, we compile anyway
+          compiling = true;
+        }
+    }
+
+  // what file do we read after all ?
+  if ( compiling )
+    {
+      pathName = kflPathName;
+      kfcPathName = kflPathName;
+      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
+    }
+  else
+    {
+      pathName = kfcPathName;
+      kflPathName = kfcPathName;
+      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
+    }
+
+  QFile mapfile(pathName);
+
+  if( mapfile.size() == 0 )
+    {
+      // qWarning() << "Map file" << pathName << "is empty!";
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  mapfile.remove();
+	}
+
+      return false;
+    }
+
+  if ( !mapfile.open(QIODevice::ReadOnly) )
+    {
+      qWarning("Can't open map file %s for reading", pathName.toLatin1().data() );
+
+      if ( ! compiling && kflExists )
+        {
+          qDebug("Try to use file %s", kflPathName.toLatin1().data());
+          // try to remove unopenable file, not sure if this works.
+          mapfile.remove();
+          return readTerrainFile( tile, fileTypeID );
+        }
+
+      return false;
+    }
+
+  emit loadingFile(pathName);
+
+  QDataStream in(&mapfile);
+
+  if( compiling )
+    {
+      in.setVersion(QDataStream::Qt_3_3);
+    }
+  else
+    {
+      in.setVersion(QDataStream::Qt_4_7);
+    }
+
+  // qDebug("reading file %s", pathName.toLatin1().data());
+
+  qint8 loadTypeID;
+  quint16 loadSecID, formatID;
+  quint32 magic;
+  QDateTime createDateTime;
+  ProjectionBase *projectionFromFile = 0;
+
+  in >> magic;
+  in >> loadTypeID;
+  in >> formatID;
+  in >> loadSecID;
+  in >> createDateTime;
+
+  if( in.status() != QDataStream::Ok )
+    {
+      qWarning() << "Data stream status of" << pathName
+	         << "is NOK! Status=" << in.status();
+      mapfile.close();
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  unlink( pathName.toLatin1().data() );
+	}
+
+      return false;
+    }
+
+  if ( magic != KFLOG_FILE_MAGIC )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
+                   magic, kflPathName.toLatin1().data());
+          mapfile.remove();
+          return readTerrainFile( tile, fileTypeID );
+        }
+
+      qWarning( "Wrong magic key %x read from %s! Removing content.",
+                 magic, pathName.toLatin1().data() );
+      // Some map file does not exists on the server. But if they have
+      // been downloaded, the map server has sent some http page content.
+      // That content makes no sense, therefore the map file content is cleared.
+      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
+      mapfile.close();
+      return false;
+    }
+
+  if (loadTypeID != fileTypeID) // wrong type
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong load type identifier %x read! "
+                   "Retry to compile %s",
+                   loadTypeID, kflPathName.toLatin1().data() );
+          mapfile.remove();
+          return readTerrainFile( tile, fileTypeID );
+        }
+
+      qWarning("%s wrong load type identifier %x read! ",
+                pathName.toLatin1().data(), loadTypeID );
+
+      return false;
+    }
+
+  // Determine, which file format id is expected
+  int expFormatID, expComFormatID;
+
+  if ( fileTypeID == FILE_TYPE_TERRAIN )
+    {
+      expFormatID = FILE_VERSION_TERRAIN;
+      expComFormatID = FILE_VERSION_TERRAIN_C;
+    }
+  else
+    {
+      expFormatID = FILE_VERSION_GROUND;
+      expComFormatID = FILE_VERSION_GROUND_C;
+    }
+
+  QFileInfo fi( pathName );
+
+  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, formatId=%d, Date=%s",
+         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
+         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+
+  if ( compiling )
+    {
+      // Check map file
+      if ( formatID < expFormatID )
+        {
+          // too old ...
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expFormatID );
+          return false;
+        }
+      else if (formatID > expFormatID )
+        {
+          // too new ...
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID,expFormatID );
+          return false;
+        }
+    }
+  else
+    {
+      // Check compiled file
+      if ( formatID < expComFormatID )
+        {
+          // too old ...
+          if ( kflExists )
+            {
+              qWarning("File format too old! (version %d, expecting: %d) "
+                       "Retry to compile %s",
+                       formatID, expComFormatID, kflPathName.toLatin1().data() );
+              mapfile.close();
+              unlink( pathName.toLatin1().data() );
+              return readTerrainFile( tile, fileTypeID );
+            }
+
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expFormatID );
+          return false;
+        }
+      else if (formatID > expComFormatID )
+        {
+          // too new ...
+          if ( kflExists )
+            {
+              qWarning( "File format too new! (version %d, expecting: %d) "
+                        "Retry to compile %s",
+                        formatID, expComFormatID, kflPathName.toLatin1().data() );
+              mapfile.close();
+              unlink( pathName.toLatin1().data() );
+              return readTerrainFile( tile, fileTypeID );
+            }
+
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, expFormatID );
+          return false;
+        }
+    }
+
+  if ( loadSecID != tile.secID )
+    {
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s: wrong section, bogus file name!"
+                    "\n Retry to compile %s",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          mapfile.close();
+          unlink( pathName.toLatin1().data() );
+          return readTerrainFile( tile, fileTypeID );
+        }
+
+      qWarning("%s: wrong section, bogus file name! Arborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  if ( ! compiling )
+    {
+      // check projection parameters from file against current used values
+      projectionFromFile = LoadProjection(in);
+      ProjectionBase *currentProjection = m_projection;
+
+      if ( ! MapContents::compareProjections( projectionFromFile, currentProjection ) )
+        {
+          delete projectionFromFile;
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning( "%s, can't use file, compiled for another projection!"
+                        "\n Retry to compile %s",
+                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+
+              unlink( pathName.toLatin1().data() );
+              return readTerrainFile( tile, fileTypeID );
+            }
+
+          qWarning( "%s, can't use file, compiled for another projection!"
+                    " Please install %s file and restart.",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          return false;
+        }
+      else
+        {
+          // Must be deleted after use to avoid memory leak
+          delete projectionFromFile;
+        }
+    }
+
+  // Got to initialize "out" stream properly, even if write file is not needed
+  QFile ausgabe(kfcPathName);
+  QDataStream out(&ausgabe);
+
+  if( compiling )
+    {
+      out.setDevice(&ausgabe);
+      out.setVersion(QDataStream::Qt_4_7);
+
+      if (!ausgabe.open(QIODevice::WriteOnly))
+        {
+          mapfile.close();
+          qWarning("Can't open compiled map file %s for writing!"
+                   " Arborting...",
+                   kfcPathName.toLatin1().data() );
+          return false;
+        }
+
+      qDebug("Writing file %s", kfcPathName.toLatin1().data());
+
+      out << magic;
+      out << loadTypeID;
+      out << quint16(expComFormatID);
+      out << loadSecID;
+
+      //set time one second later than the time of the original file;
+      out << createDateTime.addSecs(1);
+
+      // save current projection data
+      SaveProjection(out, m_projection );
+    }
+
+  // Check in which list the isohypses have to be stored. We do use two
+  // different lists, one for Ground and another for Terrain.
+  QList<Isohypse>& isoList = ( fileTypeID == FILE_TYPE_GROUND ) ?
+                               tile.groundList : tile.terrainList;
+
+  if ( ! compiling )
+    {
+      // The compiled file contains the projected isolines as flat coordinate
+      // arrays, which are read via a memory mapping of the file.
+      bool ok = readTerrainTable( mapfile, tile, fileTypeID, isoList );
+
+      mapfile.close();
+
+      if ( ! ok && kflExists )
+        {
+          qWarning( "%s: corrupted coordinate table!"
+                    "\n Retry to compile %s",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+
+          unlink( pathName.toLatin1().data() );
+          return readTerrainFile( tile, fileTypeID );
+        }
+
+      return ok;
+    }
+
+  const int firstItem = isoList.size();
+  int loop = 0;
+
+  while ( !in.atEnd() )
+    {
+      qint16 elevation;
+      qint32 pointNumber, lat, lon;
+      QPolygon isoline;
+
+      in >> elevation;
+      in >> pointNumber;
+      isoline.resize( pointNumber );
+
+      for (int i = 0; i < pointNumber; i++)
+        {
+          in >> lat;
+          in >> lon;
+
+          isoline.setPoint( i, lat, lon );
+        }
+
+      // This is what causes the long delays, lots of floating point calculations.
+      // All points are projected at once to keep the overhead per point low.
+      MapMatrix::wgsToMap( m_projection, isoline.constData(), isoline.data(), isoline.size() );
+
+      // Check, if first point and last point of the isoline identical. In this
+      // case we can remove the last point and repeat the check.
+      for( int i = isoline.size() - 1; i >= 0; i-- )
+        {
+          if( isoline.point(0) == isoline.point(i) )
+             {
+               //qWarning( "Isoline Tile=%d has same start and end point. Remove end point.",
+               //           loadSecID );
+
+               // remove last point and check again
+               isoline.remove(i);
+               continue;
+             }
+
+          break;
+        }
+
+      if( isoline.size() < 3)
+        {
+          // ignore to small isolines
+          qWarning( "Isoline Tile=%d, elevation=%dm has to less points!",
+                     loadSecID, elevation );
+          continue;
+        }
+
+      // determine elevation index, 0 is returned as default for not existing values
+      uchar elevationIdx = m_isoHash.value( elevation, 0 );
+
+      isoList.append( Isohypse(isoline, elevation, elevationIdx, tile.secID, fileTypeID) );
+
+      // qDebug("Isohypse added: Size=%d, Elevation=%d, FileTypeID=%c",
+      //       isoline.size(), elevation, fileTypeID );
+
+      // AP: Performance brake! emit progress calls wait screen and
+      // this steps into main loop
+      if ( (++loop % 100) == 0 )
+        {
+          emit progress(2);
+        }
+    }
+
+  // qDebug("loop=%d", loop);
+  mapfile.close();
+
+  // And that is the whole trick: saving the computed result as flat
+  // coordinate table.
+  QList<QPolygon> isolines;
+  QVector<qint32> elevations;
+
+  for ( int i = firstItem; i < isoList.size(); i++ )
+    {
+      isolines.append( isoList.at(i).getProjectedPolygon() );
+      elevations.append( isoList.at(i).getElevation() );
+    }
+
+  if ( ! writeCoordinateTable( ausgabe, isolines, elevations ) )
+    {
+      qWarning( "Writing of compiled map file %s failed!",
+                kfcPathName.toLatin1().data() );
+      ausgabe.close();
+      ausgabe.remove();
+      return true;
+    }
+
+  ausgabe.close();
+  return true;
+}
+
+/**
+ * Reads the coordinate table of a compiled terrain file. The file is mapped
+ * into memory and the coordinates are taken over from the flat arrays
+ * without any stream decoding.
+ */
+bool TileLoaderThread::readTerrainTable( QFile& mapfile,
+                                         MapTile& tile,
+                                         const int fileTypeID,
+                                         QList<Isohypse>& isoList )
+{
+  const quint64 size  = mapfile.size();
+  const quint64 start = (mapfile.pos() + 7) & ~Q_INT64_C(7);
+
+  if ( start + sizeof(CoordinateTableHeader) > size )
+    {
+      return false;
+    }
+
+  uchar* base = mapfile.map( 0, size );
+
+  if ( base == 0 )
+    {
+      qWarning( "Can't map file %s into memory!",
+                mapfile.fileName().toLatin1().data() );
+      return false;
+    }
+
+  const CoordinateTableHeader* header = checkCoordinateTable( base, size, start );
+
+  if ( header == 0 )
+    {
+      mapfile.unmap( base );
+      return false;
+    }
+
+  const CoordinateTableEntry* entries =
+      reinterpret_cast<const CoordinateTableEntry *> (header + 1);
+
+  isoList.reserve( isoList.size() + header->entries );
+
+  for ( quint32 i = 0; i < header->entries; i++ )
+    {
+      QPolygon isoline;
+      copyTableLine( header, i, isoline );
+
+      const short elevation = static_cast<short> (entries[i].elevation);
+
+      // determine elevation index, 0 is returned as default for not existing values
+      uchar elevationIdx = m_isoHash.value( elevation, 0 );
+
+      isoList.append( Isohypse(isoline, elevation, elevationIdx, tile.secID, fileTypeID) );
+    }
+
+  mapfile.unmap( base );
+  return true;
+}
+
+/**
+ * Checks the coordinate table of a mapped compiled file. The table starts
+ * at an 8 byte boundary:
+ *
+ * CoordinateTableHeader
+ * CoordinateTableEntry[entries]
+ * qint32[2 * points] as x, y pairs
+ *
+ * All values are stored in the native byte order of the writer.
+ */
+const CoordinateTableHeader*
+TileLoaderThread::checkCoordinateTable( const uchar* base,
+                                        const quint64 size,
+                                        const quint64 start )
+{
+  if ( (start & 7) != 0 || start + sizeof(CoordinateTableHeader) > size )
+    {
+      return 0;
+    }
+
+  const CoordinateTableHeader* header =
+      reinterpret_cast<const CoordinateTableHeader *> (base + start);
+
+  const quint64 entriesStart = start + sizeof(CoordinateTableHeader);
+  const quint64 pointsStart  = entriesStart +
+                               quint64(header->entries) * sizeof(CoordinateTableEntry);
+
+  if ( header->byteOrder != COORDINATE_TABLE_BYTE_ORDER ||
+       pointsStart + quint64(header->points) * 2 * sizeof(qint32) > size )
+    {
+      // Wrong byte order or truncated file.
+      return 0;
+    }
+
+  const CoordinateTableEntry* entries =
+      reinterpret_cast<const CoordinateTableEntry *> (base + entriesStart);
+
+  // Validate the table before anything is taken over.
+  for ( quint32 i = 0; i < header->entries; i++ )
+    {
+      if ( quint64(entries[i].firstPoint) + entries[i].pointCount > header->points )
+        {
+          return 0;
+        }
+    }
+
+  return header;
+}
+
+void TileLoaderThread::copyTableLine( const CoordinateTableHeader* header,
+                                      const quint32 index,
+                                      QPolygon& line )
+{
+  const CoordinateTableEntry* entries =
+      reinterpret_cast<const CoordinateTableEntry *> (header + 1);
+
+  const qint32* points = reinterpret_cast<const qint32 *> (entries + header->entries);
+
+  const CoordinateTableEntry& entry = entries[index];
+  const qint32* src = points + 2 * quint64(entry.firstPoint);
+
+  line.resize( entry.pointCount );
+  QPoint* dst = line.data();
+
+  for ( quint32 j = 0; j < entry.pointCount; j++ )
+    {
+      dst[j].setX( src[2 * j] );
+      dst[j].setY( src[2 * j + 1] );
+    }
+}
+
+/**
+ * Writes the passed lines as coordinate table into a compiled file.
+ */
+bool TileLoaderThread::writeCoordinateTable( QFile& file,
+                                             const QList<QPolygon>& lines,
+                                             const QVector<qint32>& elevations )
+{
+  // Align the table start to 8 bytes.
+  const qint64 pos = file.pos();
+  const QByteArray padding( int(((pos + 7) & ~Q_INT64_C(7)) - pos), '\0' );
+
+  QVector<CoordinateTableEntry> entries;
+  entries.reserve( lines.size() );
+
+  quint32 points = 0;
+
+  for ( int i = 0; i < lines.size(); i++ )
+    {
+      CoordinateTableEntry entry;
+      entry.elevation  = elevations.isEmpty() ? 0 : elevations.at(i);
+      entry.firstPoint = points;
+      entry.pointCount = lines.at(i).size();
+
+      entries.append( entry );
+      points += entry.pointCount;
+    }
+
+  QVector<qint32> coordinates( 2 * points );
+  qint32* dst = coordinates.data();
+
+  for ( int i = 0; i < lines.size(); i++ )
+    {
+      const QPolygon& line = lines.at(i);
+
+      for ( int j = 0; j < line.size(); j++ )
+        {
+          *dst++ = line.at(j).x();
+          *dst++ = line.at(j).y();
+        }
+    }
+
+  CoordinateTableHeader header;
+  header.byteOrder = COORDINATE_TABLE_BYTE_ORDER;
+  header.entries   = entries.size();
+  header.points    = points;
+  header.reserved  = 0;
+
+  const qint64 entriesSize = qint64(entries.size()) * sizeof(CoordinateTableEntry);
+  const qint64 pointsSize  = qint64(coordinates.size()) * sizeof(qint32);
+
+  if ( file.write( padding ) != padding.size() ||
+       file.write( reinterpret_cast<const char *> (&header), sizeof(header) ) != sizeof(header) ||
+       file.write( reinterpret_cast<const char *> (entries.constData()), entriesSize ) != entriesSize ||
+       file.write( reinterpret_cast<const char *> (coordinates.constData()), pointsSize ) != pointsSize )
+    {
+      return false;
+    }
+
+  return true;
+}
+
+/**
+ * This method reads in the map files from the original kflog source or from
+ * the own compiled source. If the map projection is changed the compiled
+ * source must be renewed.
+ *
+ * A compiled map file contains the element records as stream behind the
+ * header, preceded by their size. The projected lines of the elements are
+ * stored as coordinate table behind the records, a record refers to its
+ * line by the table index.
+ */
+bool TileLoaderThread::readBinaryFile( MapTile& tile )
+{
+  const char fileTypeID = FILE_TYPE_MAP;
+  bool kflExists, kfcExists;
+  bool compiling = false;
+
+  QString kflPathName, kfcPathName, pathName;
+  QString kflName, kfcName;
+
+  kflName.sprintf("%c_%.5d.kfl", fileTypeID, tile.secID);
+  kflExists = MapContents::locateFile("landscape/" + kflName, kflPathName);
+
+  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, tile.secID);
+  kfcExists = MapContents::locateFile(kfcName, kfcPathName);
+
+  if ( ! (kflExists || kfcExists) )
+    {
+      // The caller is responsible to check the file existence and to
+      // trigger a download of missing files.
+      qWarning( "no map files (%s or %s) found!",
+                kflName.toLatin1().data(), kfcName.toLatin1().data() );
+
+      return false; // file could not be located in any of the possible map directories.
+    }
+
+  if ( kflExists )
+    {
+      if ( kfcExists )
+        // kfl file newer than kfc ? Then compile it
+        {
+          if ( MapContents::getDateFromMapFile( kflPathName ) > MapContents::getDateFromMapFile( kfcPathName ) )
+            {
+              compiling = true;
+              qDebug("Map file %s has a newer date! Recompiling it from source.",
+                     kflPathName.toLatin1().data() );
+            }
+        }
+      else
+        {
+          // no kfc file, we compile anyway
+          compiling = true;
+        }
+    }
+
+  // what file do we read after all ?
+  if ( compiling )
+    {
+      pathName = kflPathName;
+      kfcPathName = kflPathName;
+      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
+    }
+  else
+    {
+      pathName = kfcPathName;
+      kflPathName = kfcPathName;
+      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
+    }
+
+  QFile mapfile(pathName);
+
+  if( mapfile.size() == 0 )
+    {
+      // qWarning() << "Map file" << pathName << "is empty!";
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  mapfile.remove();
+	}
+
+      return false;
+    }
+
+  if (!mapfile.open(QIODevice::ReadOnly))
+    {
+      if ( ! compiling && kflExists )
+        {
+          qDebug("Can't open map file %s for reading!"
+                 " Try to use file %s",
+                 pathName.toLatin1().data(), kflPathName.toLatin1().data());
+          // try to remove unopenable file, not sure if this works.
+          mapfile.remove();
+          return readBinaryFile( tile );
+        }
+
+      qWarning("Can't open map file %s for reading! Aborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  emit loadingFile(pathName);
+
+  QDataStream in(&mapfile);
+
+  if( compiling )
+    {
+      in.setVersion( QDataStream::Qt_2_0 );
+    }
+  else
+    {
+      in.setVersion( QDataStream::Qt_4_7 );
+    }
+
+  // qDebug("reading file %s", pathName.toLatin1().data());
+
+  qint8 loadTypeID;
+  quint16 loadSecID, formatID;
+  quint32 magic;
+  QDateTime createDateTime;
+  ProjectionBase *projectionFromFile = 0;
+
+  in >> magic;
+
+  if ( magic != KFLOG_FILE_MAGIC )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
+                   magic, kflPathName.toLatin1().data());
+
+          mapfile.remove();
+          return readBinaryFile( tile );
+        }
+
+      qWarning( "Wrong magic key %x read from %s! Removing content.",
+                 magic, pathName.toLatin1().data() );
+      // Some map file does not exists on the server. But if they have
+      // been downloaded, the map server has sent some http page content.
+      // That content makes no sense, therefore the map file content is cleared.
+      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
+      mapfile.close();
+      return false;
+    }
+
+  in >> loadTypeID;
+
+  /** Originally, the binary files were mend to come in different flavors.
+   * Now, they are all of type 'm'. Use that fact to do check for the
+   * compiled or the uncompiled version. */
+  if (compiling)
+    {
+      // uncompiled maps have a different format identifier than compiled
+      // maps
+      if (loadTypeID != FILE_TYPE_MAP)
+        {
+          qWarning("Wrong load type identifier %x read! Aborting ...",
+                   loadTypeID );
+          mapfile.close();
+          return false;
+        }
+    }
+  else
+    {
+      if ( loadTypeID != FILE_TYPE_MAP_C) // wrong type
+        {
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning("Wrong load type identifier %x read! "
+                       "Retry to compile %s",
+                       loadTypeID, kflPathName.toLatin1().data() );
+              mapfile.remove();
+              return readBinaryFile( tile );
+            }
+
+          qWarning("%s wrong load type identifier %x read!",
+                   pathName.toLatin1().data(), loadTypeID );
+          return false;
+        }
+    }
+
+  // Check the version of the subtype. This can be different for the
+  // compiled and the uncompiled version.
+  in >> formatID;
+  in >> loadSecID;
+  in >> createDateTime;
+
+  if( in.status() != QDataStream::Ok )
+    {
+      qWarning() << "Data stream status of" << pathName
+	         << "is NOK! Status=" << in.status();
+      mapfile.close();
+
+      if( ! compiling )
+	{
+	  // Remove corrupted compiled file
+	  unlink( pathName.toLatin1().data() );
+	}
+
+      return false;
+    }
+
+  QFileInfo fi( pathName );
+
+  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, FormatId=%d, Date=%s",
+         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
+         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+
+  if (compiling)
+    {
+      if ( formatID < FILE_VERSION_MAP)
+        {
+          // to old ...
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP );
+          mapfile.close();
+          return false;
+        }
+      else if (formatID > FILE_VERSION_MAP)
+        {
+          // to new ...
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP );
+          mapfile.close();
+          return false;
+        }
+    }
+  else
+    {
+      if ( formatID < FILE_VERSION_MAP_C)
+        {
+          // to old ...
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning("File format too old! (version %d, expecting: %d) "
+                       "Retry to compile %s",
+                       formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          qWarning("File format too old! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
+          return false;
+        }
+      else if (formatID > FILE_VERSION_MAP_C)
+        {
+          // to new ...
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning( "File format too new! (version %d, expecting: %d) "
+                        "Retry to compile %s",
+                        formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          qWarning("File format too new! (version %d, expecting: %d) "
+                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
+
+          return false;
+        }
+    }
+
+  // check if this section really covers the area we want to deal with
+  if ( loadSecID != tile.secID )
+    {
+      mapfile.close();
+
+      if ( ! compiling && kflExists )
+        {
+          qWarning( "%s: wrong section, bogus file name!"
+                    "\n Retry to compile %s",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          unlink( pathName.toLatin1().data() );
+          return readBinaryFile( tile );
+        }
+
+      qWarning("%s: wrong section, bogus file name! Aborting ...",
+               pathName.toLatin1().data() );
+      return false;
+    }
+
+  if ( ! compiling )
+    {
+      // check projection parameters from file against current used values
+      projectionFromFile = LoadProjection(in);
+      ProjectionBase *currentProjection = m_projection;
+
+      if ( ! MapContents::compareProjections( projectionFromFile, currentProjection ) )
+        {
+          delete projectionFromFile;
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning( "%s, can't use file, compiled for another projection!"
+                        "\n Retry to compile %s",
+                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          qWarning( "%s, can't use file, compiled for another projection!"
+                    " Please install %s file and restart.",
+                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+          return false;
+        }
+      else
+        {
+          // Must be deleted after use to avoid memory leak
+          delete projectionFromFile;
+        }
+    }
+
+  QFile ausgabe(kfcPathName);
+  QDataStream out(&ausgabe);
+
+  // Element records and coordinate table of the compiled file
+  QBuffer recordBuffer;
+  QByteArray records;
+  QList<QPolygon> lines;
+  uchar* mapBase = 0;
+  const CoordinateTableHeader* table = 0;
+  bool tableError = false;
+
+  if ( compiling )
+    {
+      out.setDevice( &ausgabe );
+      out.setVersion( QDataStream::Qt_4_7 );
+
+      if (!ausgabe.open(QIODevice::WriteOnly))
+        {
+          qWarning("Can't open compiled map file %s for writing!"
+                   " Aborting ...",
+                   kfcPathName.toLatin1().data() );
+          mapfile.close();
+          return false;
+        }
+
+      qDebug("Writing file %s", kfcPathName.toLatin1().data());
+
+      out << magic;
+      loadTypeID = FILE_TYPE_MAP_C;
+      formatID   = FILE_VERSION_MAP_C;
+      out << loadTypeID;
+      out << formatID;
+      out << loadSecID;
+      out << createDateTime.addSecs(1);   //set time one second later than the time of the original file;
+      SaveProjection(out, m_projection);
+
+      // The element records are collected in a buffer. Their size is
+      // written in front of them and the coordinate table of the lines
+      // behind them.
+      recordBuffer.open( QIODevice::WriteOnly );
+      out.setDevice( &recordBuffer );
+    }
+  else
+    {
+      // The element records are decoded from the stream, the lines are taken
+      // over from the coordinate table behind them via a memory mapping.
+      quint32 recordSize = 0;
+      in >> recordSize;
+
+      const quint64 size = mapfile.size();
+      const quint64 recordStart = mapfile.pos();
+      const quint64 tableStart = (recordStart + recordSize + 7) & ~Q_INT64_C(7);
+
+      if ( in.status() == QDataStream::Ok && tableStart < size )
+        {
+          mapBase = mapfile.map( 0, size );
+        }
+
+      if ( mapBase != 0 )
+        {
+          table = checkCoordinateTable( mapBase, size, tableStart );
+        }
+
+      if ( table == 0 )
+        {
+          if ( mapBase != 0 )
+            {
+              mapfile.unmap( mapBase );
+            }
+
+          mapfile.close();
+
+          if ( kflExists )
+            {
+              qWarning( "%s: corrupted coordinate table!"
+                        "\n Retry to compile %s",
+                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
+
+              unlink( pathName.toLatin1().data() );
+              return readBinaryFile( tile );
+            }
+
+          qWarning( "%s: corrupted coordinate table! Aborting ...",
+                    pathName.toLatin1().data() );
+          return false;
+        }
+
+      records = QByteArray::fromRawData( reinterpret_cast<const char *> (mapBase + recordStart),
+                                         recordSize );
+      recordBuffer.setBuffer( &records );
+      recordBuffer.open( QIODevice::ReadOnly );
+      in.setDevice( &recordBuffer );
+    }
+
+  quint8 lm_typ;
+  qint8 sort, elev;
+  qint32 lat_temp, lon_temp;
+  quint32 locLength = 0;
+  QString name = "";
+
+  unsigned int gesamt_elemente = 0;
+  uint loop = 0;
+
+  while ( ! in.atEnd() )
+    {
+      BaseMapElement::objectType typeIn = BaseMapElement::NotSelected;
+      in >> (quint8&)typeIn;
+
+      if ( compiling )
+        out << (quint8&)typeIn;
+
+      locLength = 0;
+      name = "";
+
+      QPolygon all;
+      QPoint single;
+
+      gesamt_elemente++;
+
+      switch (typeIn)
+        {
+        case BaseMapElement::Motorway:
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadMotorways() ) break;
+
+          tile.motorwayList.append( LineElement("", typeIn, all, false, tile.secID) );
+          tile.motorwayList.last().createDetailLevels();
+          break;
+
+        case BaseMapElement::Road:
+        case BaseMapElement::Trail:
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadRoads() ) break;
+
+          tile.roadList.append( LineElement("", typeIn, all, false, tile.secID) );
+          tile.roadList.last().createDetailLevels();
+          break;
+
+        case BaseMapElement::Aerial_Cable:
+        case BaseMapElement::Railway:
+        case BaseMapElement::Railway_D:
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadRailways() ) break;
+
+          tile.railList.append( LineElement("", typeIn, all, false, tile.secID) );
+          tile.railList.last().createDetailLevels();
+          break;
+
+        case BaseMapElement::Canal:
+        case BaseMapElement::River:
+        case BaseMapElement::River_T:
+
+          typeIn = BaseMapElement::River; //don't use different river types internally
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              if ( compiling )
+                {
+                  in >> name;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadWaterways() ) break;
+
+          tile.hydroList.append( LineElement(name, typeIn, all, false, tile.secID) );
+          tile.hydroList.last().createDetailLevels();
+          break;
+
+        case BaseMapElement::City:
+          in >> sort;
+          if ( compiling )
+            out << sort;
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              if ( compiling )
+                {
+                  in >> name;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+
+          tile.cityList.append( LineElement(name, typeIn, all, sort, tile.secID) );
+          tile.cityList.last().createDetailLevels();
+          // qDebug("added city '%s'", name.toLatin1().data());
+          break;
+
+        case BaseMapElement::Lake:
+        case BaseMapElement::Lake_T:
+
+          typeIn=BaseMapElement::Lake; // don't use different lake type internally
+          in >> sort;
+
+          if ( compiling )
+            out << sort;
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              if ( compiling )
+                {
+                  in >> name;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+
+          READ_POINT_LIST
+
+          tile.lakeList.append(LineElement(name, typeIn, all, sort, tile.secID));
+          tile.lakeList.last().createDetailLevels();
+          // qDebug("appended lake, name='%s', pointCount=%d", name.toLatin1().data(), all.count());
+          break;
+
+        case BaseMapElement::Forest:
+        case BaseMapElement::Glacier:
+        case BaseMapElement::PackIce:
+          in >> sort;
+          if ( compiling )
+            out << sort;
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              if ( compiling )
+                {
+                  in >> name;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+
+          READ_POINT_LIST
+
+          if ( !GeneralConfig::instance()->getMapLoadForests() ||
+               typeIn == BaseMapElement::Glacier ||
+               typeIn == BaseMapElement::PackIce )
+            {
+              // Cumulus ignores Glacier and PackIce items
+              break;
+            }
+
+          tile.topoList.append( LineElement(name, typeIn, all, sort, tile.secID) );
+          tile.topoList.last().createDetailLevels();
+          break;
+
+        case BaseMapElement::Village:
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              if ( compiling )
+                {
+                  in >> name;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+          in >> lat_temp;
+          in >> lon_temp;
+
+          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+
+          if ( compiling )
+            {
+              single = wgsToMap(lat_temp, lon_temp);
+              out << single;
+            }
+          else
+            {
+              in >> single;
+            }
+
+          tile.villageList.append( SinglePoint( name,
+                                           "",
+                                           typeIn,
+                                           WGSPoint(lat_temp, lon_temp),
+                                           single,
+                                           0,
+                                           "",
+                                           "",
+                                           tile.secID ) );
+          // qDebug("added village '%s'", name.toLatin1().data());
+          break;
+
+        case BaseMapElement::Spot:
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              in >> elev;
+              if ( compiling )
+                out << elev;
+            }
+
+          in >> lat_temp;
+          in >> lon_temp;
+
+          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+
+          if ( compiling )
+            {
+              single = wgsToMap(lat_temp, lon_temp);
+              out << single;
+            }
+          else
+            {
+              in >> single;
+            }
+
+          tile.obstacleList.append( SinglePoint( "Spot",
+                                            "",
+                                            typeIn,
+                                            WGSPoint(lat_temp, lon_temp),
+                                            single,
+                                            0,
+                                            "",
+                                            "",
+                                            tile.secID ) );
+          break;
+
+        case BaseMapElement::Landmark:
+
+          if (formatID >= FILE_FORMAT_ID)
+            {
+              in >> lm_typ;
+              if ( compiling )
+                {
+                  in >> name;
+                  out << lm_typ;
+                  ShortSave(out, name);
+                }
+              else
+                {
+                  ShortLoad(in, name);
+                }
+            }
+
+          in >> lat_temp;
+          in >> lon_temp;
+
+          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+
+          if ( compiling )
+            {
+              single = wgsToMap(lat_temp, lon_temp);
+              out << single;
+            }
+          else
+            {
+              in >> single;
+            }
+
+          tile.landmarkList.append( SinglePoint( name,
+                               "",
+                               typeIn,
+                               WGSPoint(lat_temp, lon_temp),
+                               single,
+                               0,
+                               "",
+                               "",
+                               tile.secID ) );
+
+          // qDebug("added landmark '%s'", name.toLatin1().data());
+          break;
+        default:
+          qWarning ("TileLoaderThread::readBinaryFile; type not handled in switch: %d", typeIn);
+          break;
+        }
+
+      // @AP: Performance brake! emit progress calls waitscreen and
+      // this steps into main loop
+      if ( compiling && (++loop % 100) == 0 )
+        {
+          emit progress(2);
+        }
+    }
+
+  // qDebug("loop=%d", loop);
+  in.setDevice( 0 );
+
+  if ( mapBase != 0 )
+    {
+      mapfile.unmap( mapBase );
+    }
+
+  mapfile.close();
+
+  if ( tableError )
+    {
+      // A line refers to a not existing table entry. The elements read so
+      // far are kept, the file is recompiled at the next load.
+      qWarning( "%s: corrupted coordinate table, lines skipped!",
+                pathName.toLatin1().data() );
+
+      if ( kflExists )
+        {
+          unlink( pathName.toLatin1().data() );
+        }
+    }
+
+  if ( compiling )
+    {
+      out.setDevice( &ausgabe );
+      out << quint32( recordBuffer.size() );
+
+      if ( ausgabe.write( recordBuffer.data() ) != recordBuffer.size() ||
+           ! writeCoordinateTable( ausgabe, lines, QVector<qint32>() ) )
+        {
+          qWarning( "Writing of compiled map file %s failed!",
+                    kfcPathName.toLatin1().data() );
+          ausgabe.close();
+          ausgabe.remove();
+          return true;
+        }
+
+      ausgabe.close();
+    }
+
+  return true;
+}
@@ -0,0 +1,267 @@
+/***********************************************************************
+**
+**   TileLoaderThread.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class TileLoaderThread
+*
+* \author Axel Pauli
+*
+* \brief Class to decode map tile files in an extra thread.
+*
+* This class reads the ground, terrain and map files (kfl/kfc) of a 2x2
+* degree map tile and decodes them into a \ref MapTile container. If a
+* source file is newer than its compiled version, the compiled file is
+* recreated.
+*
+* The decoding can be called synchronously via \ref loadTile or it can be
+* requested asynchronously via \ref requestTile. In the latter case the
+* request is queued and processed by the thread. The decoded tile is
+* returned via the signal \ref tileLoaded to the GUI thread, where it can
+* be swapped into the map element lists in one step.
+*
+* The thread uses its own copy of the map projection, the global map matrix
+* is never touched from it.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef TILE_LOADER_THREAD_H
+#define TILE_LOADER_THREAD_H
+
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QPoint>
+#include <QPolygon>
+#include <QSet>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "datatypes.h"
+#include "maptile.h"
+#include "projectionbase.h"
+
+/** Header of the coordinate table in compiled ground/terrain/map files. */
+struct CoordinateTableHeader
+{
+  /** Byte order mark, written in the native byte order. */
+  quint32 byteOrder;
+  /** Number of table entries. */
+  quint32 entries;
+  /** Number of points in the coordinate array. */
+  quint32 points;
+  quint32 reserved;
+};
+
+/** One isoline or map line of the coordinate table. */
+struct CoordinateTableEntry
+{
+  /** Elevation of an isoline, not used by map lines. */
+  qint32  elevation;
+  /** Index of the first point in the coordinate array. */
+  quint32 firstPoint;
+  quint32 pointCount;
+};
+
+class TileLoaderThread : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( TileLoaderThread )
+
+ public:
+
+  /**
+   * Constructor
+   *
+   * \param parent The parent object.
+   * \param isoHash Hash with elevation in meters as key and the related
+   *                elevation index as value.
+   */
+  TileLoaderThread( QObject *parent, const QHash<short, uchar>& isoHash );
+
+  virtual ~TileLoaderThread();
+
+  /**
+   * Takes over a copy of the passed projection. It is used for the
+   * compilation of map files and for the validation of compiled files.
+   */
+  void setProjection( ProjectionBase* projection );
+
+  /**
+   * Decodes the requested parts of the passed tile synchronously in the
+   * calling thread.
+   *
+   * \param tile The tile to be loaded. Its requested parts must be set.
+   *
+   * \return True, if all requested parts could be loaded.
+   */
+  bool loadTile( MapTile& tile );
+
+  /**
+   * Queues a tile load request for the thread. A tile already queued is
+   * ignored.
+   *
+   * \param secID The tile section identifier.
+   * \param parts The tile parts to be loaded, see TILE_PART_* flags.
+   * \param generation The load generation of the requester.
+   */
+  void requestTile( const int secID, const char parts, const int generation );
+
+  /**
+   * Removes all not yet started tile requests.
+   */
+  void clearRequests();
+
+  /**
+   * Stops the thread and waits for its termination.
+   */
+  void stop();
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+ signals:
+
+  /**
+   * This signal emits a decoded tile, which was requested via
+   * \ref requestTile. The receiver slot is responsible to delete the passed
+   * tile in every case.
+   *
+   * \param tile The decoded map tile.
+   */
+  void tileLoaded( MapTilePtr tile );
+
+  /**
+   * Emitted if a new file is being loaded.
+   */
+  void loadingFile( const QString& );
+
+  /**
+   * Emitted during compiling of a map file.
+   */
+  void progress( int );
+
+ private:
+
+  /**
+   * Reads a binary ground/terrain file.
+   *
+   * @param  tile  The tile to be filled.
+   * @param  fileTypeID  The typeID of the map file ("G" for ground-data,
+   *                     and "T" for terrain data)
+   *
+   * @return "true", when the file has successfully been loaded
+   */
+  bool readTerrainFile( MapTile& tile, const int fileTypeID );
+
+  /**
+   * Reads the coordinate table of a compiled ground/terrain file via a
+   * memory mapping of the file. The file position must be behind the
+   * stream header.
+   *
+   * @return "true", when the table is valid and has been taken over
+   */
+  bool readTerrainTable( QFile& mapfile,
+                         MapTile& tile,
+                         const int fileTypeID,
+                         QList<Isohypse>& isoList );
+
+  /**
+   * Checks the coordinate table starting at the passed offset of a mapped
+   * compiled file.
+   *
+   * @return The table header or 0, if the table is invalid
+   */
+  static const CoordinateTableHeader* checkCoordinateTable( const uchar* base,
+                                                            const quint64 size,
+                                                            const quint64 start );
+
+  /**
+   * Copies the line with the passed index of a checked coordinate table
+   * into the passed polygon.
+   */
+  static void copyTableLine( const CoordinateTableHeader* header,
+                             const quint32 index,
+                             QPolygon& line );
+
+  /**
+   * Writes the passed lines as coordinate table into a compiled file.
+   *
+   * @param  file  The compiled file.
+   * @param  lines  The projected lines.
+   * @param  elevations  The elevations of the lines or an empty vector.
+   *
+   * @return "true", when all data could be written
+   */
+  static bool writeCoordinateTable( QFile& file,
+                                    const QList<QPolygon>& lines,
+                                    const QVector<qint32>& elevations );
+
+  /**
+   * Reads a binary map file.
+   *
+   * @param  tile  The tile to be filled.
+   *
+   * @return "true", when the file has successfully been loaded
+   */
+  bool readBinaryFile( MapTile& tile );
+
+  /**
+   * Converts the given geographic coordinates into the projection of this
+   * thread.
+   */
+  QPoint wgsToMap( int lat, int lon );
+
+  /** Mutex to protect the request queue and the shutdown flag. */
+  QMutex m_queueMutex;
+
+  /** Used to wake up the thread, if a new request is available. */
+  QWaitCondition m_queueCondition;
+
+  /** Pending tile requests in request order. */
+  QList<MapTile *> m_queue;
+
+  /** Section identifiers of all queued tiles and the tile in work. */
+  QSet<int> m_requested;
+
+  /** Flag to request the thread termination. */
+  bool m_shutdown;
+
+  /**
+   * Mutex to serialize the decoding. The projection is not reentrant and
+   * the same compiled file may not be written twice at the same time.
+   */
+  QMutex m_decodeMutex;
+
+  /** The projection used for compiling. */
+  ProjectionBase* m_projection;
+
+  /** Copy of the elevation to elevation index mapping. */
+  QHash<short, uchar> m_isoHash;
+};
+
+#endif /* TILE_LOADER_THREAD_H */
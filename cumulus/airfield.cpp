@@ -59,7 +59,6 @@ Airfield::Airfield( const QString& name,
                     bool landable,
                     const float atis ) :
   SinglePoint(name, shortName, typeId, wgsPos, pos, elevation, country, comment),
-  m_icao(icao),
   m_frequency(frequency),
   m_atis(atis),
   m_rwList(rwList),
@@ -68,6 +67,8 @@ Airfield::Airfield( const QString& name,
   m_rwShift(0),
   m_landable(landable)
 {
+  m_icao = icao;
+
   createStaticIcons();
   calculateRunwayShift();
 }
@@ -166,15 +167,17 @@ QString Airfield::getInfoString() const
   QString text, elev;
   QString path = "cumulus/";
 
-  elev = Altitude::getText(elevation, true, 0).replace(QRegExp("\\s"),"&nbsp;");
+  elev = Altitude::getText(getElevation(), true, 0).replace(QRegExp("\\s"),"&nbsp;");
 
   text = "<HTML><TABLE BORDER=0><TR><TD>"
-         "<IMG SRC=" + path + "/" + glConfig->getPixmapName(typeID) + "></TD>"
-         "<TD>" + name;
+         "<IMG SRC=" + path + "/" + glConfig->getPixmapName(getTypeID()) + "></TD>"
+         "<TD>" + getName();
+
+  const QString icao = getICAO();
 
-  if (!m_icao.isEmpty())
+  if (!icao.isEmpty())
     {
-      text += " (" + m_icao + ")";
+      text += " (" + icao + ")";
     }
 
   text += "<FONT SIZE=-1><BR><BR>" + elev;
@@ -198,9 +201,11 @@ bool Airfield::drawMapElement( QPainter* targetP )
     }
 
   //qDebug("Airfield::drawMapElement(): scale: %d %d",scale, _globalMapMatrix->getScaleRatio()  );
-  QColor col = ReachableList::getReachColor( wgsPosition );
+  QColor col = ReachableList::getReachColor( getWGSPosition() );
+
+  curPos = glMapMatrix->map( getPosition() );
 
-  curPos = glMapMatrix->map(position);
+  const objectType type = getTypeID();
 
   // draw also the small dot's in reachability color
   targetP->setPen(QPen(col, 2));
@@ -224,10 +229,10 @@ bool Airfield::drawMapElement( QPainter* targetP )
                            glConfig->getMagentaCircle(iconSize) );
     }
 
-  if( glConfig->isRotatable( typeID ) )
+  if( glConfig->isRotatable( type ) )
     {
-      if( typeID == BaseMapElement::UltraLight ||
-	  typeID == BaseMapElement::Outlanding )
+      if( type == BaseMapElement::UltraLight ||
+	  type == BaseMapElement::Outlanding )
 	{
 	  QPixmap& pm = glConfig->useSmallIcons() ? m_smallFields[m_rwShift] : m_bigFields[m_rwShift];
 
@@ -246,12 +251,12 @@ bool Airfield::drawMapElement( QPainter* targetP )
     }
   else
     {
-      QPixmap image( glConfig->getPixmap(typeID) );
+      QPixmap image( glConfig->getPixmap(type) );
 
       int xOffset = image.width() / 2;
       int yOffset = image.height() / 2;
 
-      if( typeID == BaseMapElement::Outlanding )
+      if( type == BaseMapElement::Outlanding )
        {
          // The lower end of the beacon shall directly point to the point at the map.
          yOffset = image.height();
@@ -133,22 +133,6 @@ class Airfield : public SinglePoint
       m_atis = value;
     };
 
-  /**
-   * @return ICAO name
-   */
-  QString getICAO() const
-    {
-      return m_icao;
-    };
-
-  /**
-   * @param value The ICAO name of the airfield
-   */
-  void setICAO( const QString& value )
-    {
-      m_icao = value;
-    };
-
   /**
    * @return The runway list, containing the data of all runways.
    */
@@ -295,11 +279,6 @@ class Airfield : public SinglePoint
       }
   };
 
-  /**
-  * The ICAO name
-  */
-  QString m_icao;
-
   /**
   * The speech frequency
   */
@@ -122,6 +122,7 @@ Airspace* Airspace::createAirspaceObject()
                                getCountry() );
 
   as->setFlarmAlertZone( m_flarmAlertZone );
+  as->setWgsPolygon( m_wgsPolygon );
   return as;
 }
 
@@ -549,6 +550,110 @@ Airspace::ConflictType Airspace::conflicts( const AltitudeCollection& alt,
   return none;
 }
 
+/**
+ * Restricts the time window to the times, where value + vario * t fulfills
+ * the passed limit as lower (atLeast=true) or upper limit.
+ */
+static void restrictWindow( const double value,
+                            const double vario,
+                            const double limit,
+                            const bool atLeast,
+                            double& tIn,
+                            double& tOut )
+{
+  if( vario == 0.0 )
+    {
+      if( (atLeast && value < limit) || (! atLeast && value > limit) )
+        {
+          // never fulfilled
+          tIn = tOut + 1.0;
+        }
+
+      return;
+    }
+
+  // time, at which the limit is reached
+  double t = (limit - value) / vario;
+
+  if( atLeast == (vario > 0.0) )
+    {
+      // fulfilled from t on
+      tIn = qMax( tIn, t );
+    }
+  else
+    {
+      // fulfilled until t
+      tOut = qMin( tOut, t );
+    }
+}
+
+/**
+ * Calculates the time window, in which the altitude is inside of the
+ * vertical limits of the airspace. The altitude references are selected
+ * in the same way as in conflicts().
+ */
+bool Airspace::verticalWindow( const AltitudeCollection& alt,
+                               const double vario,
+                               const double horizon,
+                               double& tIn,
+                               double& tOut ) const
+{
+  tIn  = 0.0;
+  tOut = horizon;
+
+  double lowerAlt = 0.0;
+  double upperAlt = 0.0;
+
+  switch (m_lLimitType)
+    {
+      case NotSet:
+        break;
+      case MSL:
+        lowerAlt = alt.gpsAltitude.getMeters();
+        break;
+      case GND:
+        lowerAlt = alt.gndAltitude.getMeters() + alt.gndAltitudeError.getMeters();
+        if (m_lLimit == 0)
+          lowerAlt = qMax( lowerAlt, 1.0 ); // we're always above ground
+        break;
+      case FL:
+      case STD:
+        lowerAlt = alt.stdAltitude.getMeters();
+        break;
+      case UNLTD:
+        return false;
+    }
+
+  switch (m_uLimitType)
+    {
+      case NotSet:
+        upperAlt = 100000.0;
+        break;
+      case MSL:
+        upperAlt = alt.gpsAltitude.getMeters();
+        break;
+      case GND:
+        upperAlt = alt.gndAltitude.getMeters() - alt.gndAltitudeError.getMeters();
+        break;
+      case FL:
+      case STD:
+        upperAlt = alt.stdAltitude.getMeters();
+        break;
+      case UNLTD:
+        upperAlt = m_uLimit.getMeters() - 1.0;
+        break;
+    }
+
+  // Altitudes without a reference do not change with the vario.
+  restrictWindow( lowerAlt, m_lLimitType == NotSet ? 0.0 : vario,
+                  m_lLimit.getMeters(), true, tIn, tOut );
+
+  restrictWindow( upperAlt, (m_uLimitType == NotSet || m_uLimitType == UNLTD) ? 0.0 : vario,
+                  m_uLimit.getMeters(), false, tIn, tOut );
+
+  return tIn <= tOut;
+}
+
 bool Airspace::operator < (const Airspace& other) const
 {
   int a1C = getUpperL(), a2C = other.getUpperL();
@@ -228,6 +228,25 @@ public:
   ConflictType conflicts (const AltitudeCollection& alt,
                           const AirspaceWarningDistance& dist) const;
 
+  /**
+   * Calculates the time window, in which the altitude is inside of the
+   * vertical limits of the airspace, if it changes linear with the passed
+   * vertical speed.
+   *
+   * @param alt The current altitudes.
+   * @param vario The vertical speed in m/s.
+   * @param horizon The end of the time window to be checked in seconds.
+   * @param tIn Set to the begin of the window in seconds.
+   * @param tOut Set to the end of the window in seconds.
+   *
+   * @return True, if the altitude is inside within the horizon.
+   */
+  bool verticalWindow( const AltitudeCollection& alt,
+                       const double vario,
+                       const double horizon,
+                       double& tIn,
+                       double& tOut ) const;
+
   /**
    * Returns the last vertical conflict type
    */
@@ -339,6 +358,28 @@ public:
     m_flarmAlertZone = faz;
   };
 
+  /**
+   * Get the outline of the airspace as WGS84 coordinates.
+   *
+   * \return Outline polygon, x is latitude, y is longitude in KFLog units.
+   */
+  const QPolygon& getWgsPolygon() const
+  {
+    return m_wgsPolygon;
+  };
+
+  /**
+   * Set the outline of the airspace as WGS84 coordinates. The projected
+   * polygon is not touched.
+   *
+   * \param polygon Outline polygon, x is latitude, y is longitude in KFLog
+   *                units.
+   */
+  void setWgsPolygon( const QPolygon& polygon )
+  {
+    m_wgsPolygon = polygon;
+  };
+
   /**
    * Prints out all relevant airspace data.
    */
@@ -387,6 +428,12 @@ private:
    * Flarm Alert Zone object.
    */
   FlarmBase::FlarmAlertZone m_flarmAlertZone;
+
+  /**
+   * The outline as WGS84 coordinates. It is stored in the compiled files, so
+   * that they do not depend on the map projection.
+   */
+  QPolygon m_wgsPolygon;
 };
 
 /**
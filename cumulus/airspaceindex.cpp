@@ -0,0 +1,422 @@
+/***********************************************************************
+**
+**   airspaceindex.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include <QtAlgorithms>
+
+#include "airspaceindex.h"
+#include "mapcalc.h"
+#include "mapmatrix.h"
+
+// Meters of one KFLog unit (1/10000 minute) along a meridian
+#define METER_PER_UNIT (RADIUS * M_PI / (180.0 * 600000.0))
+
+namespace
+{
+  /** Orders boxed elements by the longitude of their box center. */
+  template<class T> struct LonCenterLess
+  {
+    bool operator()( const T& a, const T& b ) const
+    {
+      return ( qint64(a.box.minLon) + a.box.maxLon ) <
+             ( qint64(b.box.minLon) + b.box.maxLon );
+    };
+  };
+
+  /** Orders boxed elements by the latitude of their box center. */
+  template<class T> struct LatCenterLess
+  {
+    bool operator()( const T& a, const T& b ) const
+    {
+      return ( qint64(a.box.minLat) + a.box.maxLat ) <
+             ( qint64(b.box.minLat) + b.box.maxLat );
+    };
+  };
+}
+
+AirspaceIndex::AirspaceIndex() :
+  m_dirty(true),
+  m_generation(0)
+{
+}
+
+AirspaceIndex::~AirspaceIndex()
+{
+}
+
+void AirspaceIndex::clear()
+{
+  m_items.clear();
+  m_levels.clear();
+  m_dirty = true;
+  m_generation++;
+}
+
+template<class T> void AirspaceIndex::strSort( QVector<T>& elements )
+{
+  const int size = elements.size();
+
+  if( size <= NodeCapacity )
+    {
+      return;
+    }
+
+  // Number of nodes and vertical slices
+  const int nodes  = (size + NodeCapacity - 1) / NodeCapacity;
+  const int slices = int( ceil( sqrt( double(nodes) ) ) );
+  const int sliceSize = slices * NodeCapacity;
+
+  qSort( elements.begin(), elements.end(), LonCenterLess<T>() );
+
+  for( int start = 0; start < size; start += sliceSize )
+    {
+      qSort( elements.begin() + start,
+             elements.begin() + qMin( size, start + sliceSize ),
+             LatCenterLess<T>() );
+    }
+}
+
+void AirspaceIndex::build( const SortableAirspaceList& list,
+                           ProjectionBase* projection )
+{
+  clear();
+
+  m_items.reserve( list.size() );
+
+  for( int i = 0; i < list.size(); i++ )
+    {
+      Airspace* as = list.at(i);
+      const QPolygon& projPolygon = as->getProjectedPolygon();
+      const QPolygon& wgsPolygon  = as->getWgsPolygon();
+
+      if( projPolygon.size() < 3 )
+        {
+          continue;
+        }
+
+      // The original WGS84 outline is preferred, the inverse projection
+      // is only needed, if the airspace does not provide it.
+      const bool hasWgs = ( wgsPolygon.size() == projPolygon.size() );
+
+      Item item;
+      item.airspace = as;
+      item.polygon.resize( projPolygon.size() );
+
+      for( int k = 0; k < projPolygon.size(); k++ )
+        {
+          const QPoint& pp = projPolygon.at(k);
+
+          QPoint wgs = hasWgs ? wgsPolygon.at(k) :
+                                MapMatrix::mapToWgs( projection, pp.x(), pp.y() );
+          item.polygon[k] = wgs;
+
+          if( k == 0 )
+            {
+              item.box.minLat = item.box.maxLat = wgs.x();
+              item.box.minLon = item.box.maxLon = wgs.y();
+              continue;
+            }
+
+          item.box.minLat = qMin( item.box.minLat, wgs.x() );
+          item.box.maxLat = qMax( item.box.maxLat, wgs.x() );
+          item.box.minLon = qMin( item.box.minLon, wgs.y() );
+          item.box.maxLon = qMax( item.box.maxLon, wgs.y() );
+        }
+
+      m_items.append( item );
+    }
+
+  m_dirty = false;
+
+  if( m_items.isEmpty() )
+    {
+      return;
+    }
+
+  strSort( m_items );
+
+  // Build the leaf level over the items.
+  QVector<Node> level;
+
+  for( int i = 0; i < m_items.size(); i += NodeCapacity )
+    {
+      Node node;
+      node.first = i;
+      node.count = qMin( int(NodeCapacity), m_items.size() - i );
+      node.box   = m_items.at(i).box;
+
+      for( int j = i + 1; j < i + node.count; j++ )
+        {
+          node.box.unite( m_items.at(j).box );
+        }
+
+      level.append( node );
+    }
+
+  // Build the upper levels until the root is reached. A level is sorted
+  // before the next level is built on it.
+  while( true )
+    {
+      if( level.size() > 1 )
+        {
+          strSort( level );
+        }
+
+      m_levels.append( level );
+
+      if( level.size() == 1 )
+        {
+          break;
+        }
+
+      const QVector<Node>& lower = m_levels.last();
+      QVector<Node> upper;
+
+      for( int i = 0; i < lower.size(); i += NodeCapacity )
+        {
+          Node node;
+          node.first = i;
+          node.count = qMin( int(NodeCapacity), lower.size() - i );
+          node.box   = lower.at(i).box;
+
+          for( int j = i + 1; j < i + node.count; j++ )
+            {
+              node.box.unite( lower.at(j).box );
+            }
+
+          upper.append( node );
+        }
+
+      level = upper;
+    }
+}
+
+void AirspaceIndex::query( const QPoint& pos,
+                           const double radius,
+                           QList<Hit>& hits ) const
+{
+  if( m_levels.isEmpty() )
+    {
+      return;
+    }
+
+  // Extend the position by the search radius.
+  double cosLat = cos( double(pos.x()) / 600000.0 * M_PI / 180.0 );
+  double dLat   = radius / METER_PER_UNIT;
+  double dLon   = radius / (METER_PER_UNIT * qMax( cosLat, 0.01 ));
+
+  Box search;
+  search.minLat = int( qMax( pos.x() - dLat, -54000000.0 ) );
+  search.maxLat = int( qMin( pos.x() + dLat,  54000000.0 ) );
+  search.minLon = int( qMax( pos.y() - dLon, -108000000.0 ) );
+  search.maxLon = int( qMin( pos.y() + dLon,  108000000.0 ) );
+
+  QVector<int> items;
+  searchItems( search, items );
+
+  for( int i = 0; i < items.size(); i++ )
+    {
+      Hit hit;
+
+      if( checkItem( m_items.at(items.at(i)), pos, radius, hit ) )
+        {
+          hits.append( hit );
+        }
+    }
+}
+
+void AirspaceIndex::searchItems( const Box& search, QVector<int>& items ) const
+{
+  if( m_levels.isEmpty() )
+    {
+      return;
+    }
+
+  // Nodes to be visited as pairs of level and node index.
+  QVector< QPair<int, int> > stack;
+
+  const int top = m_levels.size() - 1;
+
+  for( int i = 0; i < m_levels.at(top).size(); i++ )
+    {
+      stack.append( qMakePair( top, i ) );
+    }
+
+  while( stack.isEmpty() == false )
+    {
+      QPair<int, int> entry = stack.last();
+      stack.pop_back();
+
+      const Node& node = m_levels.at(entry.first).at(entry.second);
+
+      if( node.box.intersects( search ) == false )
+        {
+          continue;
+        }
+
+      for( int i = node.first; i < node.first + node.count; i++ )
+        {
+          if( entry.first > 0 )
+            {
+              stack.append( qMakePair( entry.first - 1, i ) );
+            }
+          else if( m_items.at(i).box.intersects( search ) )
+            {
+              items.append( i );
+            }
+        }
+    }
+}
+
+void AirspaceIndex::trackCandidates( const QPoint& start,
+                                     const QPoint& end,
+                                     QVector<int>& items ) const
+{
+  Box search;
+  search.minLat = qMin( start.x(), end.x() );
+  search.maxLat = qMax( start.x(), end.x() );
+  search.minLon = qMin( start.y(), end.y() );
+  search.maxLon = qMax( start.y(), end.y() );
+
+  searchItems( search, items );
+}
+
+void AirspaceIndex::trackCrossings( const int item,
+                                    const QPoint& start,
+                                    const QPoint& end,
+                                    TrackHit& hit ) const
+{
+  const Item& it = m_items.at(item);
+
+  hit.airspace = it.airspace;
+  hit.insideAtStart = false;
+  hit.crossings.clear();
+
+  // Local plane in meters with the track start as origin.
+  const double ky = METER_PER_UNIT;
+  const double kx = METER_PER_UNIT * cos( double(start.x()) / 600000.0 * M_PI / 180.0 );
+
+  // The track vector
+  const double ex = (end.y() - start.y()) * kx;
+  const double ey = (end.x() - start.x()) * ky;
+
+  const QPoint* p = it.polygon.constData();
+  const int size  = it.polygon.size();
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      const double xi = (p[i].y() - start.y()) * kx;
+      const double yi = (p[i].x() - start.x()) * ky;
+      const double xj = (p[j].y() - start.y()) * kx;
+      const double yj = (p[j].x() - start.x()) * ky;
+
+      // Even odd test of the origin
+      if( (yi > 0.0) != (yj > 0.0) )
+        {
+          if( 0.0 < xi + (xj - xi) * (0.0 - yi) / (yj - yi) )
+            {
+              hit.insideAtStart = ! hit.insideAtStart;
+            }
+        }
+
+      // Intersection of the track with the edge from j to i
+      const double dx = xi - xj;
+      const double dy = yi - yj;
+      const double d  = ex * dy - ey * dx;
+
+      if( d == 0.0 )
+        {
+          // parallel
+          continue;
+        }
+
+      const double s = (xj * dy - yj * dx) / d;
+      const double u = (xj * ey - yj * ex) / d;
+
+      if( s >= 0.0 && s <= 1.0 && u >= 0.0 && u < 1.0 )
+        {
+          hit.crossings.append( s );
+        }
+    }
+
+  qSort( hit.crossings.begin(), hit.crossings.end() );
+}
+
+bool AirspaceIndex::checkItem( const Item& item,
+                               const QPoint& pos,
+                               const double radius,
+                               Hit& hit )
+{
+  // Local plane in meters with the position as origin.
+  const double ky = METER_PER_UNIT;
+  const double kx = METER_PER_UNIT * cos( double(pos.x()) / 600000.0 * M_PI / 180.0 );
+
+  const QPoint* p = item.polygon.constData();
+  const int size  = item.polygon.size();
+
+  bool inside = false;
+  double minDist2 = radius * radius;
+  bool near = false;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      const double xi = (p[i].y() - pos.y()) * kx;
+      const double yi = (p[i].x() - pos.x()) * ky;
+      const double xj = (p[j].y() - pos.y()) * kx;
+      const double yj = (p[j].x() - pos.x()) * ky;
+
+      // Even odd test of the origin
+      if( (yi > 0.0) != (yj > 0.0) )
+        {
+          if( 0.0 < xi + (xj - xi) * (0.0 - yi) / (yj - yi) )
+            {
+              inside = ! inside;
+            }
+        }
+
+      // Distance of the origin to the segment
+      const double dx = xj - xi;
+      const double dy = yj - yi;
+      const double len2 = dx * dx + dy * dy;
+
+      double t = 0.0;
+
+      if( len2 > 0.0 )
+        {
+          t = qBound( 0.0, -(xi * dx + yi * dy) / len2, 1.0 );
+        }
+
+      const double cx = xi + t * dx;
+      const double cy = yi + t * dy;
+      const double dist2 = cx * cx + cy * cy;
+
+      if( dist2 <= minDist2 )
+        {
+          minDist2 = dist2;
+          near = true;
+        }
+    }
+
+  if( inside == false && near == false )
+    {
+      return false;
+    }
+
+  hit.airspace = item.airspace;
+  hit.inside   = inside;
+  hit.distance = inside ? 0.0 : sqrt( minDist2 );
+  return true;
+}
@@ -0,0 +1,259 @@
+/***********************************************************************
+**
+**   airspaceindex.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class AirspaceIndex
+*
+* \author Axel Pauli
+*
+* \brief Geographic R-tree over the airspace outlines.
+*
+* The index stores the outline of every airspace in WGS84 coordinates
+* together with its bounding box. The boxes are bulk loaded into a packed
+* R-tree using the sort tile recursive method. A query returns all
+* airspaces, which are inside or nearer as a given distance to a position,
+* together with the true distance to their outline.
+*
+* The result does not depend on the map scale or the map center. It has
+* only to be rebuilt, if the airspace data are changed.
+*
+* Distances are calculated in a local plane around the queried position.
+* That is exact enough for warning distances of some kilometers. Airspaces
+* crossing the date line are not supported.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef AIRSPACE_INDEX_H
+#define AIRSPACE_INDEX_H
+
+#include <QList>
+#include <QPoint>
+#include <QPolygon>
+#include <QVector>
+
+#include "airspace.h"
+
+class ProjectionBase;
+
+class AirspaceIndex
+{
+ private:
+
+  Q_DISABLE_COPY ( AirspaceIndex )
+
+ public:
+
+  /** One query result. */
+  struct Hit
+  {
+    Airspace* airspace;
+
+    /** True, if the position is inside of the airspace outline. */
+    bool inside;
+
+    /** Distance in meters to the outline, 0 if inside. */
+    double distance;
+  };
+
+  AirspaceIndex();
+
+  virtual ~AirspaceIndex();
+
+  /**
+   * Builds the index over the passed airspaces. An existing index is
+   * replaced.
+   *
+   * \param list The airspace list to be indexed.
+   * \param projection The projection, in which the airspace polygons are
+   *                   stored.
+   */
+  void build( const SortableAirspaceList& list, ProjectionBase* projection );
+
+  /**
+   * Removes all index data.
+   */
+  void clear();
+
+  /**
+   * \return True, if the index has to be rebuilt before it can be used.
+   */
+  bool isDirty() const
+  {
+    return m_dirty;
+  };
+
+  /**
+   * Marks the index as outdated.
+   */
+  void setDirty()
+  {
+    m_dirty = true;
+  };
+
+  /** Result of a track crossing calculation. */
+  struct TrackHit
+  {
+    Airspace* airspace;
+
+    /** True, if the track start is inside of the airspace outline. */
+    bool insideAtStart;
+
+    /**
+     * Ascending positions along the track in the range 0...1, where the
+     * track crosses the airspace outline.
+     */
+    QVector<double> crossings;
+  };
+
+  /**
+   * \return The build generation of the index. It is changed, whenever the
+   *         item numbering becomes invalid.
+   */
+  int generation() const
+  {
+    return m_generation;
+  };
+
+  /**
+   * Searches all airspaces, whose bounding box intersects the bounding box
+   * of the straight track from start to end. Only the bounding boxes are
+   * checked, that is cheap.
+   *
+   * \param start The track start as WGS84 coordinate in KFLog units.
+   * \param end The track end as WGS84 coordinate in KFLog units.
+   * \param items The numbers of the found items are appended to this list.
+   */
+  void trackCandidates( const QPoint& start,
+                        const QPoint& end,
+                        QVector<int>& items ) const;
+
+  /**
+   * \return The airspace of an item number.
+   */
+  Airspace* itemAirspace( const int item ) const
+  {
+    return m_items.at(item).airspace;
+  };
+
+  /**
+   * Calculates, where the straight track from start to end crosses the
+   * outline of an indexed airspace.
+   *
+   * \param item The item number as returned by \ref trackCandidates.
+   * \param start The track start as WGS84 coordinate in KFLog units.
+   * \param end The track end as WGS84 coordinate in KFLog units.
+   * \param hit The calculation result.
+   */
+  void trackCrossings( const int item,
+                       const QPoint& start,
+                       const QPoint& end,
+                       TrackHit& hit ) const;
+
+  /**
+   * Searches all airspaces, which contain the passed position or which
+   * are nearer as the passed distance to it.
+   *
+   * \param pos The position as WGS84 coordinate in KFLog units.
+   * \param radius The search radius in meters.
+   * \param hits The found airspaces are appended to this list.
+   */
+  void query( const QPoint& pos, const double radius, QList<Hit>& hits ) const;
+
+ private:
+
+  /** Bounding box in KFLog units. */
+  struct Box
+  {
+    int minLat;
+    int minLon;
+    int maxLat;
+    int maxLon;
+
+    bool intersects( const Box& other ) const
+    {
+      return ( minLat <= other.maxLat && maxLat >= other.minLat &&
+               minLon <= other.maxLon && maxLon >= other.minLon );
+    };
+
+    void unite( const Box& other )
+    {
+      minLat = qMin( minLat, other.minLat );
+      minLon = qMin( minLon, other.minLon );
+      maxLat = qMax( maxLat, other.maxLat );
+      maxLon = qMax( maxLon, other.maxLon );
+    };
+  };
+
+  /** An indexed airspace. */
+  struct Item
+  {
+    Box box;
+    Airspace* airspace;
+
+    /** The outline as WGS84 points, x is latitude, y is longitude. */
+    QPolygon polygon;
+  };
+
+  /** A tree node, which covers a range of entries of the level below. */
+  struct Node
+  {
+    Box box;
+    int first;
+    int count;
+  };
+
+  /** Maximum number of children of a node. */
+  enum { NodeCapacity = 16 };
+
+  /**
+   * Sorts the passed elements into sort tile recursive order.
+   */
+  template<class T> static void strSort( QVector<T>& elements );
+
+  /**
+   * Calculates the hit data of an item for the passed position.
+   *
+   * \return True, if the item is inside or nearer as radius.
+   */
+  static bool checkItem( const Item& item,
+                         const QPoint& pos,
+                         const double radius,
+                         Hit& hit );
+
+  /**
+   * Collects the items, whose box intersects the search box.
+   */
+  void searchItems( const Box& search, QVector<int>& items ) const;
+
+  /** All indexed airspaces in tree order. */
+  QVector<Item> m_items;
+
+  /**
+   * The tree levels. Level 0 covers the items, every further level covers
+   * the nodes of the level below. The last level contains the root node.
+   */
+  QList< QVector<Node> > m_levels;
+
+  /** Set, if the airspace data have been changed. */
+  bool m_dirty;
+
+  /** Build generation of the index. */
+  int m_generation;
+};
+
+#endif /* AIRSPACE_INDEX_H */
@@ -0,0 +1,209 @@
+/***********************************************************************
+**
+**   airspacepredictor.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QSet>
+
+#include "airspacepredictor.h"
+#include "mapcalc.h"
+
+AirspacePredictor::AirspacePredictor() :
+  m_cursor(0)
+{
+}
+
+AirspacePredictor::~AirspacePredictor()
+{
+}
+
+void AirspacePredictor::clear()
+{
+  m_candidates.clear();
+  m_incursions.clear();
+  m_generations.clear();
+  m_cursor = 0;
+  m_lastUpdate.invalidate();
+}
+
+void AirspacePredictor::update( const QList<const AirspaceIndex *>& indexes,
+                                const QPoint& pos,
+                                const int track,
+                                const double speed,
+                                const double vario,
+                                const AltitudeCollection& alt,
+                                const int horizon,
+                                const int budget )
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  // Item numbers are only valid for the same index generations.
+  QVector<int> generations;
+
+  for( int i = 0; i < indexes.size(); i++ )
+    {
+      generations.append( indexes.at(i)->generation() );
+    }
+
+  if( generations != m_generations )
+    {
+      clear();
+      m_generations = generations;
+    }
+
+  // Age the existing predictions.
+  if( m_lastUpdate.isValid() )
+    {
+      const double dt = m_lastUpdate.elapsed() / 1000.0;
+
+      QMutableHashIterator<Airspace*, Incursion> it(m_incursions);
+
+      while( it.hasNext() )
+        {
+          it.next();
+
+          Incursion& inc = it.value();
+          inc.time         = qMax( 0.0, inc.time - dt );
+          inc.lateralTime  = qMax( 0.0, inc.lateralTime - dt );
+          inc.verticalTime = qMax( 0.0, inc.verticalTime - dt );
+        }
+    }
+
+  m_lastUpdate.start();
+
+  // Predicted position at the end of the look ahead time
+  const QPoint end = MapCalc::getPosition( pos, speed * horizon, track );
+
+  // Fetch the candidates touched by the predicted track.
+  m_candidates.clear();
+
+  QSet<Airspace*> candidates;
+  QVector<int> items;
+
+  for( int i = 0; i < indexes.size(); i++ )
+    {
+      items.clear();
+      indexes.at(i)->trackCandidates( pos, end, items );
+
+      for( int j = 0; j < items.size(); j++ )
+        {
+          Candidate c;
+          c.index = i;
+          c.item  = items.at(j);
+          m_candidates.append( c );
+
+          candidates.insert( indexes.at(i)->itemAirspace( c.item ) );
+        }
+    }
+
+  // Remove the predictions of airspaces, which are not touched anymore.
+  QMutableHashIterator<Airspace*, Incursion> it(m_incursions);
+
+  while( it.hasNext() )
+    {
+      it.next();
+
+      if( ! candidates.contains( it.key() ) )
+        {
+          it.remove();
+        }
+    }
+
+  if( m_candidates.isEmpty() )
+    {
+      m_cursor = 0;
+      return;
+    }
+
+  // Calculate the candidates round robin until the budget is exhausted.
+  // The remaining ones are calculated during the next updates.
+  const int count = m_candidates.size();
+  m_cursor = m_cursor % count;
+
+  AirspaceIndex::TrackHit hit;
+
+  for( int i = 0; i < count; i++ )
+    {
+      const Candidate& c = m_candidates.at(m_cursor);
+      m_cursor = (m_cursor + 1) % count;
+
+      indexes.at(c.index)->trackCrossings( c.item, pos, end, hit );
+
+      Incursion incursion;
+
+      if( calculate( hit, vario, alt, horizon, incursion ) )
+        {
+          m_incursions.insert( hit.airspace, incursion );
+        }
+      else
+        {
+          m_incursions.remove( hit.airspace );
+        }
+
+      if( timer.elapsed() >= budget )
+        {
+          break;
+        }
+    }
+}
+
+bool AirspacePredictor::calculate( const AirspaceIndex::TrackHit& hit,
+                                   const double vario,
+                                   const AltitudeCollection& alt,
+                                   const double horizon,
+                                   Incursion& incursion ) const
+{
+  double vIn, vOut;
+
+  if( hit.airspace->verticalWindow( alt, vario, horizon, vIn, vOut ) == false )
+    {
+      return false;
+    }
+
+  // Walk along the lateral inside intervals of the track and search the
+  // first one overlapping the vertical window.
+  bool inside = hit.insideAtStart;
+  double begin = 0.0;
+  double lateralTime = -1.0;
+
+  for( int i = 0; i <= hit.crossings.size(); i++ )
+    {
+      const double t = ( i < hit.crossings.size() ) ?
+                         hit.crossings.at(i) * horizon : horizon;
+
+      if( inside )
+        {
+          if( lateralTime < 0.0 )
+            {
+              lateralTime = begin;
+            }
+
+          const double start = qMax( begin, vIn );
+
+          if( start <= qMin( t, vOut ) )
+            {
+              incursion.airspace     = hit.airspace;
+              incursion.lateralTime  = lateralTime;
+              incursion.verticalTime = vIn;
+              incursion.time         = start;
+              return true;
+            }
+        }
+
+      inside = ! inside;
+      begin  = t;
+    }
+
+  return false;
+}
@@ -0,0 +1,150 @@
+/***********************************************************************
+**
+**   airspacepredictor.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class AirspacePredictor
+*
+* \author Axel Pauli
+*
+* \brief Look ahead for airspace incursions.
+*
+* The predictor extrapolates the current position along the track with the
+* current ground speed and the altitude with the current vertical speed
+* over a look ahead time. For every airspace touched by the predicted
+* track, the time until its lateral border and its vertical limits are
+* reached is calculated.
+*
+* The candidates are fetched from the \ref AirspaceIndex by their bounding
+* boxes. The exact calculation is done incrementally. Per update only so
+* many candidates are calculated as fit into the passed time budget, the
+* next update continues with the remaining ones. Results not refreshed in
+* an update are aged by the elapsed time.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef AIRSPACE_PREDICTOR_H
+#define AIRSPACE_PREDICTOR_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QVector>
+
+#include "airspace.h"
+#include "airspaceindex.h"
+#include "altitude.h"
+
+class AirspacePredictor
+{
+ private:
+
+  Q_DISABLE_COPY ( AirspacePredictor )
+
+ public:
+
+  /** A predicted airspace incursion. */
+  struct Incursion
+  {
+    Airspace* airspace;
+
+    /** Seconds until the lateral border is reached, 0 if inside. */
+    double lateralTime;
+
+    /** Seconds until the vertical limits are reached, 0 if inside. */
+    double verticalTime;
+
+    /** Seconds until the airspace is entered, 0 if inside. */
+    double time;
+  };
+
+  AirspacePredictor();
+
+  virtual ~AirspacePredictor();
+
+  /**
+   * Removes all predictions.
+   */
+  void clear();
+
+  /**
+   * Updates the prediction for a new position.
+   *
+   * \param indexes The airspace indexes to be checked.
+   * \param pos The current position as WGS84 coordinate in KFLog units.
+   * \param track The current track in degrees.
+   * \param speed The current ground speed in m/s.
+   * \param vario The current vertical speed in m/s.
+   * \param alt The current altitudes.
+   * \param horizon The look ahead time in seconds.
+   * \param budget The maximum calculation time in milli seconds.
+   */
+  void update( const QList<const AirspaceIndex *>& indexes,
+               const QPoint& pos,
+               const int track,
+               const double speed,
+               const double vario,
+               const AltitudeCollection& alt,
+               const int horizon,
+               const int budget );
+
+  /**
+   * \return All predicted incursions within the look ahead time.
+   */
+  const QHash<Airspace*, Incursion>& incursions() const
+  {
+    return m_incursions;
+  };
+
+ private:
+
+  /** A candidate item of an airspace index. */
+  struct Candidate
+  {
+    int index;
+    int item;
+  };
+
+  /**
+   * Calculates the incursion of one candidate.
+   *
+   * \return True, if an incursion is predicted.
+   */
+  bool calculate( const AirspaceIndex::TrackHit& hit,
+                  const double vario,
+                  const AltitudeCollection& alt,
+                  const double horizon,
+                  Incursion& incursion ) const;
+
+  /** Candidates of the last update. */
+  QVector<Candidate> m_candidates;
+
+  /** Next candidate to be calculated. */
+  int m_cursor;
+
+  /** The current predictions. */
+  QHash<Airspace*, Incursion> m_incursions;
+
+  /** Build generations of the used indexes. */
+  QVector<int> m_generations;
+
+  /** Time of the last update, used for aging. */
+  QElapsedTimer m_lastUpdate;
+};
+
+#endif /* AIRSPACE_PREDICTOR_H */
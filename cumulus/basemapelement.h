@@ -185,7 +185,7 @@ public:
   /**
    * @return The name of the element.
    */
-  virtual const QString& getName() const
+  virtual QString getName() const
   {
     return name;
   };
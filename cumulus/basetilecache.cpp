@@ -0,0 +1,36 @@
+/***********************************************************************
+**
+**   basetilecache.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include "basetilecache.h"
+
+BaseTileCache::BaseTileCache() :
+  m_cache( 64 )
+{
+}
+
+BaseTileCache::~BaseTileCache()
+{
+}
+
+int BaseTileCache::tileOf( const int coordinate )
+{
+  // Round down also for negative coordinates.
+  if( coordinate >= 0 )
+    {
+      return coordinate / TileSize;
+    }
+
+  return -( (-coordinate + TileSize - 1) / TileSize );
+}
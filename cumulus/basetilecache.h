@@ -0,0 +1,162 @@
+/***********************************************************************
+**
+**   basetilecache.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class BaseTileCache
+*
+* \author Axel Pauli
+*
+* \brief Cache for prerendered raster tiles of the map base layer.
+*
+* The base layer is rendered in raster tiles of a fixed size. The tiles
+* are arranged in the scaled and rotated, but not translated map plane,
+* so that a tile can be reused at every map center as long as scale and
+* rotation are unchanged. A tile is identified by the scale, the rotation
+* step and its column and row in that plane.
+*
+* The least recently used tiles are removed, if the cache capacity is
+* exceeded.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef BASE_TILE_CACHE_H
+#define BASE_TILE_CACHE_H
+
+#include <QCache>
+#include <QList>
+#include <QPixmap>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+
+class BaseTileCache
+{
+ private:
+
+  Q_DISABLE_COPY ( BaseTileCache )
+
+ public:
+
+  /** Width and height of a tile in pixels. */
+  enum { TileSize = 256 };
+
+  /** Identifier of a tile. */
+  struct Key
+  {
+    int scale;
+    int rotation;
+    int col;
+    int row;
+
+    bool operator==( const Key& other ) const
+    {
+      return ( col == other.col && row == other.row &&
+               scale == other.scale && rotation == other.rotation );
+    };
+  };
+
+  /** City label of a tile. */
+  struct Label
+  {
+    QString name;
+
+    /** Label position in the map plane. */
+    QPoint pos;
+  };
+
+  /** A rendered tile. */
+  struct Tile
+  {
+    QPixmap pixmap;
+
+    /** Labels of the cities drawn into the tile. */
+    QList<Label> labels;
+  };
+
+  BaseTileCache();
+
+  virtual ~BaseTileCache();
+
+  /**
+   * \return The pixel rectangle of a tile in the map plane.
+   */
+  static QRect tileRect( const Key& key )
+  {
+    return QRect( key.col * TileSize, key.row * TileSize, TileSize, TileSize );
+  };
+
+  /**
+   * \return The number of the tile column or row containing the passed
+   *         map plane coordinate.
+   */
+  static int tileOf( const int coordinate );
+
+  /**
+   * \return The cached tile or 0, if the tile is not contained. The tile
+   *         becomes the most recently used one.
+   */
+  Tile* tile( const Key& key )
+  {
+    return m_cache.object( key );
+  };
+
+  /**
+   * \return True, if the tile is contained.
+   */
+  bool contains( const Key& key ) const
+  {
+    return m_cache.contains( key );
+  };
+
+  /**
+   * Takes over a rendered tile. The cache becomes the owner of it.
+   */
+  void insert( const Key& key, Tile* tile )
+  {
+    m_cache.insert( key, tile );
+  };
+
+  /**
+   * Sets the maximum number of cached tiles.
+   */
+  void setCapacity( const int tiles )
+  {
+    m_cache.setMaxCost( tiles );
+  };
+
+  /**
+   * Removes all tiles. Must be called, if the content or the style of the
+   * base layer has been changed.
+   */
+  void clear()
+  {
+    m_cache.clear();
+  };
+
+ private:
+
+  QCache<Key, Tile> m_cache;
+};
+
+inline uint qHash( const BaseTileCache::Key& key )
+{
+  return uint( key.col * 73856093 ) ^ uint( key.row * 19349663 ) ^
+         uint( key.scale * 83492791 ) ^ uint( key.rotation );
+}
+
+#endif /* BASE_TILE_CACHE_H */
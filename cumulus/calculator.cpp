@@ -35,6 +35,7 @@
 #include "mainwindow.h"
 #include "mapcalc.h"
 #include "mapmatrix.h"
+#include "nmeabenchmark.h"
 #include "reachablelist.h"
 #include "tpinfowidget.h"
 #include "whatsthat.h"
@@ -43,6 +44,17 @@
 #define MAX_MCCREADY 10.0
 #define MAX_SAMPLECOUNT 600
 
+/*
+  We define an analysis time frame for the flight mode. This time frame
+  determines how far back we're going in history (in seconds) for our
+  analysis. Note that the actual time difference between the first
+  and the last sample used may differ from this time frame.
+*/
+#define TIMEFRAME 6
+
+// Time frame in seconds of the moving check.
+#define MOVING_TIMEFRAME 5
+
 Calculator *calculator = static_cast<Calculator *> (0);
 
 extern MainWindow  *_globalMainWindow;
@@ -51,7 +63,8 @@ extern MapMatrix   *_globalMapMatrix;
 
 Calculator::Calculator(QObject* parent) :
   QObject(parent),
-  samplelist( LimitedList<FlightSample>( MAX_SAMPLECOUNT ) )
+  samplelist( MAX_SAMPLECOUNT ),
+  m_statistics( MAX_SAMPLECOUNT )
 {
   setObjectName( "Calculator" );
   GeneralConfig *conf = GeneralConfig::instance();
@@ -101,6 +114,9 @@ Calculator::Calculator(QObject* parent) :
   m_taskEndReached = false;
   m_manualInFlight = false;
   m_cruiseDirection = -1;
+  m_flightModeWindow = m_statistics.addWindow( TIMEFRAME * 1000 );
+  m_movingWindow = m_statistics.addWindow( MOVING_TIMEFRAME * 1000 );
+  m_ldWindow = m_statistics.addWindow( conf->getLDCalculationTime() * 1000 );
   m_minimumAltitude = INT_MIN;
   m_lastTpPassageState = TaskPoint::Outside;
   m_lastZoomFactor = -1.0;
@@ -242,6 +258,8 @@ void Calculator::slot_Speed( Speed& newSpeedValue )
 /** called if a new position-fix has been established. */
 void Calculator::slot_Position( QPoint& newPositionValue )
 {
+  BENCHMARK_STAGE( NmeaBenchmark::Position );
+
   lastGPSPosition = newPositionValue;
 
   if( ! m_manualInFlight )
@@ -665,10 +683,6 @@ void Calculator::calcLD()
       return;
     }
 
-  const FlightSample *start = 0;
-  const FlightSample *end = &samplelist.at(0);
-  int timeDiff = 0;
-  double distance = 0.0;
   double newCurrentLD = -1.0;
   double newRequiredLD = -1.0;
   bool notify = false;
@@ -678,34 +692,26 @@ void Calculator::calcLD()
   // Get the configured calculation time span.
   int ldCalcTime = conf->getLDCalculationTime();
 
-  // first calculate current LD
-  for ( int i = 1; i < samplelist.count(); i++ )
+  if( m_statistics.window( m_ldWindow ).span() != ldCalcTime * 1000 )
     {
-
-      timeDiff = (samplelist.at(i).time).msecsTo(end->time);
-
-      if ( timeDiff >= ldCalcTime * 1000 )
-        {
-          break;
-        }
-
-      // summarize single distances from speed
-      distance += samplelist[i].vector.getSpeed().getMps();
-
-      // qDebug( "i=%d, dist=%f", i, distance );
-      // store start record
-      start = &samplelist[i];
+      m_statistics.setWindowSpan( m_ldWindow, ldCalcTime * 1000 );
     }
 
-  if ( ! start )
+  // first calculate current LD
+  const FlightStatistics::Window& ldWindow = m_statistics.window( m_ldWindow );
+
+  if ( ldWindow.samples() < 2 )
     {
       // time distance too short
       lastCurrentLD = -1.0;
     }
   else
     {
+      // the distance is summarized from the single distances of the samples
+      double distance = ldWindow.distance();
+
       // calculate altitude difference
-      double altDiff = start->altitude.getMeters() - end->altitude.getMeters();
+      double altDiff = -ldWindow.altitudeChange();
 
       if ( altDiff <= 0.2 )
         {
@@ -1217,6 +1223,8 @@ void Calculator::slot_settingsChanged()
 /** This slot is called by the NMEA interpreter if a new fix has been received.  */
 void Calculator::slot_newFix( const QDateTime& newFixTime )
 {
+  BENCHMARK_STAGE( NmeaBenchmark::Fix );
+
   // before we start making samples, let's be sure we have all the
   // data we need for that. So, we wait for the second Fix.
   if (!m_pastFirstFix)
@@ -1252,6 +1260,17 @@ void Calculator::slot_newFix( const QDateTime& newFixTime )
   // add to the samplelist
   samplelist.add(sample);
 
+  const qint64 fixTime = newFixTime.toMSecsSinceEpoch();
+
+  // extend the trail of the flight
+  m_flightTrail.add( sample.position, fixTime );
+
+  // update the rolling statistics of the flight
+  m_statistics.addSample( fixTime,
+                          sample.vector.getAngleDeg(),
+                          sample.vector.getSpeed().getMps(),
+                          sample.altitude.getMeters() );
+
   lastSample = sample;
 
   // Call variometer calculation derived from GPS altitude. Can be switched off,
@@ -1324,14 +1343,6 @@ void Calculator::determineFlightStatus()
   */
 #define MAXALTDRIFTAVG 2 //see above
 
-  /*
-    We define an analysis time frame. This time frame determines how
-    far back we're going in history (in seconds) for our
-    analysis. Note that the actual time difference between the first
-    and the last sample used may differ from this time frame.
-  */
-#define TIMEFRAME 6
-
   if( samplelist.count() < TIMEFRAME )
     {
       // We need to have some samples in order to be able to analyze anything.
@@ -1418,14 +1429,11 @@ void Calculator::determineFlightStatus()
     {
       // qDebug() << "Flight mode unknown --> Start Analysis";
 
-      // we need some real analysis
-      QDateTime refTime = samplelist[0].time.addSecs(-TIMEFRAME);
-      int samples = 1;
+      // we need some real analysis. The rolling statistics of the time frame
+      // provide all data we need to distinguish the flight modes.
+      const FlightStatistics::Window& frame = m_statistics.window( m_flightModeWindow );
 
-      while ((samplelist[samples].time > refTime) && ( samples < samplelist.count() - 1) )
-        {
-          samples++;
-        }
+      const int samples = frame.samples();
 
       if( samples < 2 )
         {
@@ -1433,76 +1441,24 @@ void Calculator::determineFlightStatus()
           return;
         }
 
-      // samples now contains the index of the oldest sample we will use for this analysis.
-      // Newer samples have lower indices!
-
-      //initialize some values we will be needing...
-      bool mayBeL = true;     //this may be a left turn (that is, no big dir change to the right)
-      bool mayBeR = true;     //this may be a right turn (that is, no big dir change to the left)
-      int totalDirChange = 0; //total heading change. If cruising, this will be low, if turning, it will be high
-      double maxSpeed = 0.0;  //maximum speed obtained in this set of samples
-      int angDiff = 0;        //difference in heading between two samples
-      int totalAltChange = 0; //total change in altitude (absolute)
-      int maxAltChange = 0;   //maximum change of altitude between samples.
-      int altChange = 0;
-      bool break_analysis = false; //flag to indicate we can stop further analysis.
-
-      // loop through the samples to get some basic data we can use to distinguish flight modes
-      for (int i = 0; i < samples; i++)
-        {
-          if( i < (samples - 1) )
-            {
-              // angDiff can be positive or negative according to the turn direction
-              angDiff = (int) rint(MapCalc::angleDiff( samplelist[i].vector.getAngleDeg(), samplelist[i+1].vector.getAngleDeg() ));
-
-              altChange = int( samplelist[i].altitude.getMeters() - samplelist[i+1].altitude.getMeters() );
-              //qDebug("analysis: position=(%d, %d)", samplelist->at(i)->position.x(),samplelist->at(i)->position.y() );
-            }
-          else
-            {
-              angDiff = 0;
-              altChange = 0;
-            }
+      // A big heading change to the right excludes a left turn and vice versa.
+      bool mayBeL = ( frame.positiveTurns() == 0 );
+      bool mayBeR = ( frame.negativeTurns() == 0 );
 
-          // That is the average value of the direction change in degree.
-          // Can be positive or negation.
-          totalDirChange += angDiff;
+      // total heading change. If cruising, this will be low, if turning, it will be high
+      int totalDirChange = frame.turn();
 
-          maxSpeed = qMax( maxSpeed, samplelist[i].vector.getSpeed().getMps() );
-          totalAltChange += altChange;
-          maxAltChange = qMax(abs(altChange), maxAltChange);
+      // total change in altitude
+      int totalAltChange = (int) frame.altitudeChange();
 
-          if ( angDiff > MINTURNANGDIFF )
-            {
-              mayBeR = false;
-            }
-          else if ( angDiff < -MINTURNANGDIFF )
-            {
-              mayBeL = false;
-            }
-
-#if 0
-          qDebug("#Analysis(%d): angle1=%d, angle2=%d, angDiff=%d, speed=%f, alt1=%f, alt2=%f, altDiff=%d, tac=%d, tdc=%d, Vmax=%f",
-                 i,
-                 samplelist[i].vector.getAngleDeg(),
-                 (i < samples - 1) ? samplelist[i+1].vector.getAngleDeg() : 0,
-                 angDiff,
-                 samplelist[i].vector.getSpeed().getMps(),
-                 samplelist[i].altitude.getMeters(),
-                 (i < samples - 1) ? samplelist[i+1].altitude.getMeters() : 0,
-                 altChange,
-                 totalAltChange,
-                 totalDirChange,
-                 maxSpeed);
-#endif
-        }
+      bool break_analysis = false; //flag to indicate we can stop further analysis.
 
       // try standstill. We are using a value > 0 because of possible GPS errors.
       /*
         The detection of stand stills may be extended further by checking if the altitude matches the terrain altitude. If not
         (or no where near), we can not assume a standstill. This is probably wave flying.
       */
-      if ( maxSpeed < 0.5 ) // if we get under 0.5m/s for maximum speed, we may be standing still
+      if ( frame.movingSamples() == 0 ) // if we get under 0.5m/s for maximum speed, we may be standing still
         {
           // check if we had any significant altitude changes
           if ( (abs(totalAltChange) / (samples-1)) <= MAXALTDRIFTAVG )
@@ -1517,7 +1473,7 @@ void Calculator::determineFlightStatus()
         {
           // Get the time difference between the first and the last sample.
           // This might not be the 20 secs we were planning to use at all!
-          timediff = samplelist[samples-1].time.secsTo(samplelist[0].time);
+          timediff = int( frame.duration() / 1000 );
 
           // So, we are not standing still, nor are we cruising. Circling then maybe?
           if ( abs(totalDirChange) > (MINTURNANGDIFF * timediff) )
@@ -1868,23 +1824,15 @@ bool Calculator::moving()
 {
   // The speed limit is in m/s
   const double SpeedLimit = GeneralConfig::instance()->getAutoLoggerStartSpeed() * 1000.0 / 3600.0;
-  const int TimeLimit     = 5; // time limit in seconds
 
-  if( samplelist.size() <= TimeLimit )
+  if( samplelist.size() <= MOVING_TIMEFRAME )
     {
       // We need to have some samples in order to be able to analyze speed.
       return false;
     }
 
-  double speed = 0.0;
-
-  // Note, that the newest samples are inserted at the list beginning.
-  for( int i = 0; i < TimeLimit && samplelist.size(); i++ )
-    {
-      speed += samplelist[i].vector.getSpeed().getMps();
-    }
-
-  if( (speed / double(TimeLimit)) > SpeedLimit )
+  // The average speed of the last seconds is taken from the rolling statistics.
+  if( m_statistics.window( m_movingWindow ).averageSpeed() > SpeedLimit )
     {
       return true;
     }
@@ -27,13 +27,15 @@
 #include "altitude.h"
 #include "basemapelement.h"
 #include "distance.h"
+#include "flightstatistics.h"
+#include "flighttrail.h"
 #include "flighttask.h"
 #include "generalconfig.h"
 #include "glider.h"
 #include "gpsnmea.h"
-#include "limitedlist.h"
 #include "polar.h"
 #include "reachablelist.h"
+#include "ringbuffer.h"
 #include "speed.h"
 #include "taskpoint.h"
 #include "vario.h"
@@ -326,7 +328,7 @@ public:
   /**
    * Contains a list of samples from the flight
    */
-  LimitedList<FlightSample> samplelist;
+  RingBuffer<FlightSample> samplelist;
 
   /**
    * Returns the current flight mode
@@ -397,6 +399,7 @@ public:
    */
   void newSites()
     {
+      m_reachablelist->invalidateIndex();
       m_reachablelist->calculateNewList();
     };
 
@@ -465,6 +468,14 @@ public:
     return m_windStore;
   };
 
+  /**
+   * \return The trail of the whole flight
+   */
+  const FlightTrail& getFlightTrail() const
+  {
+    return m_flightTrail;
+  };
+
   /**
    * Sets a new waypoint as target. The old waypoint instance is
    * deleted and a new one allocated.
@@ -965,6 +976,16 @@ private: // Private attributes
   bool m_pastFirstFix;
   /** Direction of cruise if we are in cruising mode */
   int m_cruiseDirection;
+  /** Rolling statistics of the flight samples */
+  FlightStatistics m_statistics;
+  /** Statistics window of the flight mode analysis */
+  int m_flightModeWindow;
+  /** Statistics window of the moving check */
+  int m_movingWindow;
+  /** Statistics window of the current LD */
+  int m_ldWindow;
+  /** Geographic trail of the whole flight */
+  FlightTrail m_flightTrail;
   /** the index of the selected taskpoint in the flight task list. */
   int m_selectedWpInList;
   /** task end touch flag */
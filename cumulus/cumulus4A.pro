@@ -75,6 +75,8 @@ HEADERS = \
     airregion.h \
     airspace.h \
     AirspaceHelper.h \
+    airspaceindex.h \
+    airspacepredictor.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
     altitude.h \
@@ -82,6 +84,7 @@ HEADERS = \
     androidstyle.h \
     authdialog.h \
     basemapelement.h \
+    basetilecache.h \
     calculator.h \
     colordialog.h \
     configwidget.h \
@@ -89,8 +92,11 @@ HEADERS = \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationindex.h \
     filetools.h \
+    flightstatistics.h \
     flighttask.h \
+    flighttrail.h \
     fontdialog.h \
     generalconfig.h \
     gliderflightdialog.h \
@@ -99,6 +105,7 @@ HEADERS = \
     GliderSelectionList.h \
     gpsconandroid.h \
     gpsnmea.h \
+    gpsrecord.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
@@ -107,8 +114,8 @@ HEADERS = \
     isohypse.h \
     isolist.h \
     jnisupport.h \
+    landableindex.h \
     layout.h \
-    limitedlist.h \
     lineelement.h \
     listviewfilter.h \
     ListViewTabs.h \
@@ -122,15 +129,18 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptile.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
+    nmeatokenizer.h \
     OpenAip.h \
     OpenAipLoaderThread.h \
     OpenAipPoiLoader.h \
     openairparser.h \
     PointListView.h \
+    pointstore.h \
     polardialog.h \
     polar.h \
     preflightchecklistpage.h \
@@ -150,7 +160,9 @@ HEADERS = \
     reachablelist.h \
     reachablepoint.h \
     reachpointlistview.h \
+    redrawscheduler.h \
     resource.h \
+    ringbuffer.h \
     rowdelegate.h \
     runway.h \
     SinglePointListWidget.h \
@@ -175,6 +187,7 @@ HEADERS = \
     sound.h \
     speed.h \
     splash.h \
+    stringpool.h \
     target.h \
     taskeditor.h \
     taskfilemanager.h \
@@ -183,6 +196,7 @@ HEADERS = \
     taskpoint.h \
     taskpointeditor.h \
     taskpointtypes.h \
+    TileLoaderThread.h \
     time_cu.h \
     tpinfowidget.h \
     vario.h \
@@ -213,11 +227,14 @@ SOURCES = \
     airregion.cpp \
     airspace.cpp \
     AirspaceHelper.cpp \
+    airspaceindex.cpp \
+    airspacepredictor.cpp \
     altimeterdialog.cpp \
     altitude.cpp \
     androidstyle.cpp \
     authdialog.cpp \
     basemapelement.cpp \
+    basetilecache.cpp \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
@@ -225,8 +242,11 @@ SOURCES = \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationindex.cpp \
     filetools.cpp \
+    flightstatistics.cpp \
     flighttask.cpp \
+    flighttrail.cpp \
     fontdialog.cpp \
     generalconfig.cpp \
     glider.cpp \
@@ -242,6 +262,7 @@ SOURCES = \
     isohypse.cpp \
     isolist.cpp \
     jnisupport.cpp \
+    landableindex.cpp \
     layout.cpp \
     lineelement.cpp \
     listviewfilter.cpp \
@@ -259,11 +280,13 @@ SOURCES = \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
+    nmeatokenizer.cpp \
     OpenAip.cpp \
     OpenAipLoaderThread.cpp \
     OpenAipPoiLoader.cpp \
     openairparser.cpp \
     PointListView.cpp \
+    pointstore.cpp \
     polar.cpp \
     polardialog.cpp \
     preflightchecklistpage.cpp \
@@ -282,6 +305,7 @@ SOURCES = \
     reachablelist.cpp \
     reachablepoint.cpp \
     reachpointlistview.cpp \
+    redrawscheduler.cpp \
     rowdelegate.cpp \
     runway.cpp \
     SinglePointListWidget.cpp \
@@ -306,12 +330,14 @@ SOURCES = \
     sound.cpp \
     speed.cpp \
     splash.cpp \
+    stringpool.cpp \
     taskeditor.cpp \
     taskfilemanager.cpp \
     taskline.cpp \
     tasklistview.cpp \
     taskpoint.cpp \
     taskpointeditor.cpp \
+    TileLoaderThread.cpp \
     time_cu.cpp \
     tpinfowidget.cpp \
     vario.cpp \
@@ -53,11 +53,14 @@ HEADERS = \
     airregion.h \
     airspace.h \
     AirspaceHelper.h \
+    airspaceindex.h \
+    airspacepredictor.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
     altitude.h \
     authdialog.h \
     basemapelement.h \
+    basetilecache.h \
     calculator.h \
     colordialog.h \
     configwidget.h \
@@ -65,9 +68,13 @@ HEADERS = \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationindex.h \
     filetools.h \
+    flightstatistics.h \
     flighttask.h \
+    flighttrail.h \
     fontdialog.h \
+    forwardbatch.h \
     generalconfig.h \
     gliderflightdialog.h \
     glider.h \
@@ -75,6 +82,8 @@ HEADERS = \
     GliderSelectionList.h \
     gpscon.h \
     gpsnmea.h \
+    gpsrecord.h \
+    gpssensorthread.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
@@ -83,8 +92,8 @@ HEADERS = \
     ipc.h \
     isohypse.h \
     isolist.h \
+    landableindex.h \
     layout.h \
-    limitedlist.h \
     lineelement.h \
     listviewfilter.h \
     ListViewTabs.h \
@@ -99,15 +108,18 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptile.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
+    nmeatokenizer.h \
     OpenAip.h \
     OpenAipLoaderThread.h \
     OpenAipPoiLoader.h \
     openairparser.h \
     PointListView.h \
+    pointstore.h \
     polardialog.h \
     polar.h \
     preflightchecklistpage.h \
@@ -126,7 +138,9 @@ HEADERS = \
     reachablelist.h \
     reachablepoint.h \
     reachpointlistview.h \
+    redrawscheduler.h \
     resource.h \
+    ringbuffer.h \
     rowdelegate.h \
     runway.h \
     SinglePointListWidget.h \
@@ -151,6 +165,8 @@ HEADERS = \
     sound.h \
     speed.h \
     splash.h \
+    spscqueue.h \
+    stringpool.h \
     target.h \
     taskeditor.h \
     taskfilemanager.h \
@@ -159,6 +175,7 @@ HEADERS = \
     taskpointeditor.h \
     taskpointtypes.h \
     taskpoint.h \
+    TileLoaderThread.h \
     time_cu.h \
     tpinfowidget.h \
     vario.h \
@@ -189,10 +206,13 @@ SOURCES = \
     airregion.cpp \
     airspace.cpp \
     AirspaceHelper.cpp \    
+    airspaceindex.cpp \
+    airspacepredictor.cpp \
     altimeterdialog.cpp \
     altitude.cpp \
     authdialog.cpp \
     basemapelement.cpp \
+    basetilecache.cpp \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
@@ -200,9 +220,13 @@ SOURCES = \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationindex.cpp \
     filetools.cpp \
+    flightstatistics.cpp \
     flighttask.cpp \
+    flighttrail.cpp \
     fontdialog.cpp \
+    forwardbatch.cpp \
     generalconfig.cpp \
     glider.cpp \
     gliderflightdialog.cpp \
@@ -210,6 +234,7 @@ SOURCES = \
     GliderSelectionList.cpp \
     gpscon.cpp \
     gpsnmea.cpp \
+    gpssensorthread.cpp \
     gpsstatusdialog.cpp \
     helpbrowser.cpp \
     hwinfo.cpp \
@@ -217,6 +242,7 @@ SOURCES = \
     ipc.cpp \
     isohypse.cpp \
     isolist.cpp \
+    landableindex.cpp \
     layout.cpp \
     lineelement.cpp \
     listviewfilter.cpp \
@@ -235,11 +261,13 @@ SOURCES = \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
+    nmeatokenizer.cpp \
     OpenAip.cpp \
     OpenAipLoaderThread.cpp \
     OpenAipPoiLoader.cpp \
     openairparser.cpp \
     PointListView.cpp \
+    pointstore.cpp \
     polar.cpp \
     polardialog.cpp \
     preflightchecklistpage.cpp \
@@ -257,6 +285,7 @@ SOURCES = \
     reachablelist.cpp \
     reachablepoint.cpp \
     reachpointlistview.cpp \
+    redrawscheduler.cpp \
     rowdelegate.cpp \
     runway.cpp \
     SinglePointListWidget.cpp \
@@ -281,12 +310,14 @@ SOURCES = \
     sound.cpp \
     speed.cpp \
     splash.cpp \
+    stringpool.cpp \
     taskeditor.cpp \
     taskfilemanager.cpp \
     taskline.cpp \
     tasklistview.cpp \
     taskpoint.cpp \
     taskpointeditor.cpp \
+    TileLoaderThread.cpp \
     time_cu.cpp \
     tpinfowidget.cpp \
     vario.cpp \
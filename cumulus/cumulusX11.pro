@@ -55,6 +55,10 @@ CONFIG += bluetooth
 # Must be always enabled now otherwise you will get compile errors.
 CONFIG += numberpad
 
+# Enable the NMEA replay benchmark, if wanted remove the hash in the next line.
+# Start it with: cumulus --nmea-benchmark <NMEA or IGC file>
+# CONFIG += benchmark
+
 #version check for Qt 4.7 / Qt 5.x
 ! contains(QT_VERSION, ^4\\.[78]\\..*|^5\\..*) {
   message("Cannot build Cumulus with Qt version $${QT_VERSION}.")
@@ -69,11 +73,14 @@ HEADERS = \
     airregion.h \
     airspace.h \
     AirspaceHelper.h \
+    airspaceindex.h \
+    airspacepredictor.h \
     airspacewarningdistance.h \
     altimeterdialog.h \
     altitude.h \
     authdialog.h \
     basemapelement.h \
+    basetilecache.h \
     calculator.h \
     colordialog.h \
     configwidget.h \
@@ -81,9 +88,13 @@ HEADERS = \
     datatypes.h \
     distance.h \
     elevationcolorimage.h \
+    elevationindex.h \
     filetools.h \
+    flightstatistics.h \
     flighttask.h \
+    flighttrail.h \
     fontdialog.h \
+    forwardbatch.h \
     generalconfig.h \
     gliderflightdialog.h \
     glider.h \
@@ -91,6 +102,8 @@ HEADERS = \
     GliderSelectionList.h \
     gpscon.h \
     gpsnmea.h \
+    gpsrecord.h \
+    gpssensorthread.h \
     gpsstatusdialog.h \
     helpbrowser.h \
     hwinfo.h \
@@ -99,8 +112,8 @@ HEADERS = \
     ipc.h \
     isohypse.h \
     isolist.h \
+    landableindex.h \
     layout.h \
-    limitedlist.h \
     lineelement.h \
     listviewfilter.h \
     ListViewTabs.h \
@@ -114,15 +127,18 @@ HEADERS = \
     map.h \
     mapinfobox.h \
     mapmatrix.h \
+    maptile.h \
     mapview.h \
     messagehandler.h \
     messagewidget.h \
     multilayout.h \
+    nmeatokenizer.h \
     OpenAip.h \
     OpenAipPoiLoader.h \
     OpenAipLoaderThread.h \
     openairparser.h \
     PointListView.h \
+    pointstore.h \
     polardialog.h \
     polar.h \
     preflightchecklistpage.h \
@@ -141,7 +157,9 @@ HEADERS = \
     reachablelist.h \
     reachablepoint.h \
     reachpointlistview.h \
+    redrawscheduler.h \
     resource.h \
+    ringbuffer.h \
     rowdelegate.h \
     runway.h \
     SinglePointListWidget.h \
@@ -166,6 +184,8 @@ HEADERS = \
     sound.h \
     speed.h \
     splash.h \
+    spscqueue.h \
+    stringpool.h \
     target.h \
     taskeditor.h \
     taskfilemanager.h \
@@ -174,6 +194,7 @@ HEADERS = \
     taskpointeditor.h \
     taskpoint.h \
     taskpointtypes.h \
+    TileLoaderThread.h \
     time_cu.h \
     tpinfowidget.h \
     vario.h \
@@ -204,10 +225,13 @@ SOURCES = \
     airregion.cpp \
     airspace.cpp \
     AirspaceHelper.cpp \
+    airspaceindex.cpp \
+    airspacepredictor.cpp \
     altimeterdialog.cpp \
     altitude.cpp \
     authdialog.cpp \
     basemapelement.cpp \
+    basetilecache.cpp \
     builddate.cpp \
     calculator.cpp \
     colordialog.cpp \
@@ -215,9 +239,13 @@ SOURCES = \
     CuLabel.cpp \
     distance.cpp \
     elevationcolorimage.cpp \
+    elevationindex.cpp \
     filetools.cpp \
+    flightstatistics.cpp \
     flighttask.cpp \
+    flighttrail.cpp \
     fontdialog.cpp \
+    forwardbatch.cpp \
     generalconfig.cpp \
     glider.cpp \
     gliderflightdialog.cpp \
@@ -225,6 +253,7 @@ SOURCES = \
     GliderSelectionList.cpp \
     gpscon.cpp \
     gpsnmea.cpp \
+    gpssensorthread.cpp \
     gpsstatusdialog.cpp \
     helpbrowser.cpp \
     hwinfo.cpp \
@@ -232,6 +261,7 @@ SOURCES = \
     ipc.cpp \
     isohypse.cpp \
     isolist.cpp \
+    landableindex.cpp \
     layout.cpp \
     lineelement.cpp \
     listviewfilter.cpp \
@@ -249,11 +279,13 @@ SOURCES = \
     mapview.cpp \
     messagehandler.cpp \
     messagewidget.cpp \
+    nmeatokenizer.cpp \
     OpenAip.cpp \
     OpenAipPoiLoader.cpp \
     OpenAipLoaderThread.cpp \
     openairparser.cpp \
     PointListView.cpp \
+    pointstore.cpp \
     polar.cpp \
     polardialog.cpp \
     preflightchecklistpage.cpp \
@@ -271,6 +303,7 @@ SOURCES = \
     reachablelist.cpp \
     reachablepoint.cpp \
     reachpointlistview.cpp \
+    redrawscheduler.cpp \
     rowdelegate.cpp \
     runway.cpp \
     SinglePointListWidget.cpp \
@@ -295,12 +328,14 @@ SOURCES = \
     sound.cpp \
     speed.cpp \
     splash.cpp \
+    stringpool.cpp \
     taskeditor.cpp \
     taskfilemanager.cpp \
     taskline.cpp \
     tasklistview.cpp \
     taskpoint.cpp \
     taskpointeditor.cpp \
+    TileLoaderThread.cpp \
     time_cu.cpp \
     tpinfowidget.cpp \
     vario.cpp \
@@ -401,6 +436,14 @@ numberpad {
                settingspageairspacewarningsnumpad.cpp
 }
 
+benchmark {
+    DEFINES += BENCHMARK
+
+    HEADERS += nmeabenchmark.h
+
+    SOURCES += nmeabenchmark.cpp
+}
+
 TARGET = cumulus
 
 DESTDIR = .
@@ -53,6 +53,7 @@ Q_DECLARE_METATYPE(BtDeviceMap)
 
 #include "airfield.h"
 #include "airspace.h"
+#include "maptile.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
 
@@ -82,6 +83,13 @@ typedef QList<Airspace*>* AirspaceListPtr;
 
 Q_DECLARE_METATYPE(AirspaceListPtr)
 
+/**
+ * Special data type to return a decoded map tile to the GUI thread.
+ */
+typedef MapTile* MapTilePtr;
+
+Q_DECLARE_METATYPE(MapTilePtr)
+
 //------------------------------------------------------------------------------
 
 #endif // DATA_TYPES_H
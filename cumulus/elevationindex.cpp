@@ -0,0 +1,175 @@
+/***********************************************************************
+**
+**   elevationindex.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtAlgorithms>
+
+#include "elevationindex.h"
+
+namespace
+{
+  /** Sort helper, orders isolines by descending elevation. */
+  bool higherIsoline( const Isohypse* a, const Isohypse* b )
+  {
+    return a->getElevation() > b->getElevation();
+  }
+}
+
+ElevationIndex::ElevationIndex()
+{
+}
+
+ElevationIndex::~ElevationIndex()
+{
+  clear();
+}
+
+void ElevationIndex::addTile( const int secID,
+                              const QList<Isohypse>& groundList,
+                              const QList<Isohypse>& terrainList )
+{
+  removeTile( secID );
+
+  QList<const Isohypse *> isolines;
+
+  for( int i = 0; i < groundList.size(); i++ )
+    {
+      isolines.append( &groundList.at(i) );
+    }
+
+  for( int i = 0; i < terrainList.size(); i++ )
+    {
+      isolines.append( &terrainList.at(i) );
+    }
+
+  qStableSort( isolines.begin(), isolines.end(), higherIsoline );
+
+  TileIndex* tile = new TileIndex;
+  tile->entries.reserve( isolines.size() );
+
+  for( int i = 0; i < isolines.size(); i++ )
+    {
+      Entry entry;
+      entry.elevation = isolines.at(i)->getElevation();
+      entry.polygon   = isolines.at(i)->getProjectedPolygon();
+      entry.box       = entry.polygon.boundingRect();
+
+      if( entry.polygon.size() < 3 )
+        {
+          continue;
+        }
+
+      tile->box |= entry.box;
+      tile->entries.append( entry );
+    }
+
+  // Assign the isolines to the overlapped grid cells.
+  for( int i = 0; i < tile->entries.size(); i++ )
+    {
+      const QRect& box = tile->entries.at(i).box;
+
+      int left   = cellOf( box.left(),   tile->box.left(), tile->box.width() );
+      int right  = cellOf( box.right(),  tile->box.left(), tile->box.width() );
+      int top    = cellOf( box.top(),    tile->box.top(),  tile->box.height() );
+      int bottom = cellOf( box.bottom(), tile->box.top(),  tile->box.height() );
+
+      for( int row = top; row <= bottom; row++ )
+        {
+          for( int col = left; col <= right; col++ )
+            {
+              tile->cells[row * GridSize + col].append( i );
+            }
+        }
+    }
+
+  m_tiles.insert( secID, tile );
+}
+
+void ElevationIndex::removeTile( const int secID )
+{
+  delete m_tiles.take( secID );
+}
+
+void ElevationIndex::clear()
+{
+  qDeleteAll( m_tiles );
+  m_tiles.clear();
+}
+
+bool ElevationIndex::findElevation( const int secID,
+                                    const QPoint& point,
+                                    int& elevation ) const
+{
+  const TileIndex* tile = m_tiles.value( secID, 0 );
+
+  if( tile == 0 || tile->box.contains( point ) == false )
+    {
+      return false;
+    }
+
+  int col = cellOf( point.x(), tile->box.left(), tile->box.width() );
+  int row = cellOf( point.y(), tile->box.top(),  tile->box.height() );
+
+  const QVector<int>& cell = tile->cells[row * GridSize + col];
+
+  // The cell entries are ordered by descending elevation, the first hit
+  // is the searched one.
+  for( int i = 0; i < cell.size(); i++ )
+    {
+      const Entry& entry = tile->entries.at( cell.at(i) );
+
+      if( entry.box.contains( point ) && polygonContains( entry.polygon, point ) )
+        {
+          elevation = entry.elevation;
+          return true;
+        }
+    }
+
+  return false;
+}
+
+bool ElevationIndex::polygonContains( const QPolygon& polygon, const QPoint& point )
+{
+  const int size = polygon.size();
+
+  if( size < 3 )
+    {
+      return false;
+    }
+
+  const QPoint* p = polygon.constData();
+  const int px = point.x();
+  const int py = point.y();
+
+  bool inside = false;
+
+  for( int i = 0, j = size - 1; i < size; j = i++ )
+    {
+      const int yi = p[i].y();
+      const int yj = p[j].y();
+
+      if( (yi > py) != (yj > py) )
+        {
+          // x coordinate of the edge at the height of the point
+          double x = p[i].x() + double(p[j].x() - p[i].x()) * (py - yi) / (yj - yi);
+
+          if( px < x )
+            {
+              inside = ! inside;
+            }
+        }
+    }
+
+  return inside;
+}
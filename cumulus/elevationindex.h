@@ -0,0 +1,148 @@
+/***********************************************************************
+**
+**   elevationindex.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class ElevationIndex
+*
+* \author Axel Pauli
+*
+* \brief Spatial index over the isoline polygons of the loaded map tiles.
+*
+* The index is organized per map tile. For every tile a regular grid is
+* laid over the bounding box of its isolines. Every grid cell contains the
+* isolines, whose bounding box overlaps the cell, ordered by descending
+* elevation. A lookup has only to test the few isolines of one cell with a
+* point in polygon test and can stop at the first hit.
+*
+* The index works on the unscaled projected map coordinates of the
+* isolines. Therefore it is independent of the current map scale and of
+* the drawing of the map. A projection change reloads all tiles and the
+* index must be cleared then.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef ELEVATION_INDEX_H
+#define ELEVATION_INDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QPolygon>
+#include <QRect>
+#include <QVector>
+
+#include "isohypse.h"
+
+class ElevationIndex
+{
+ private:
+
+  Q_DISABLE_COPY ( ElevationIndex )
+
+ public:
+
+  ElevationIndex();
+
+  virtual ~ElevationIndex();
+
+  /**
+   * Checks, if the tile with the passed section identifier is indexed.
+   */
+  bool containsTile( const int secID ) const
+  {
+    return m_tiles.contains( secID );
+  };
+
+  /**
+   * Builds the index of a tile. An already existing index of the tile is
+   * replaced.
+   *
+   * \param secID The tile section identifier.
+   * \param groundList The ground isolines of the tile.
+   * \param terrainList The terrain isolines of the tile.
+   */
+  void addTile( const int secID,
+                const QList<Isohypse>& groundList,
+                const QList<Isohypse>& terrainList );
+
+  /**
+   * Removes the index of a tile.
+   */
+  void removeTile( const int secID );
+
+  /**
+   * Removes the index of all tiles.
+   */
+  void clear();
+
+  /**
+   * Searches the highest isoline of a tile, which contains the passed point.
+   *
+   * \param secID The tile section identifier.
+   * \param point The point in unscaled projected map coordinates.
+   * \param elevation The found elevation in meters.
+   *
+   * \return True, if an isoline containing the point was found.
+   */
+  bool findElevation( const int secID, const QPoint& point, int& elevation ) const;
+
+  /**
+   * Even odd point in polygon test.
+   */
+  static bool polygonContains( const QPolygon& polygon, const QPoint& point );
+
+ private:
+
+  /** Number of grid cells per tile side. */
+  enum { GridSize = 16 };
+
+  /** One indexed isoline. */
+  struct Entry
+  {
+    int elevation;
+    QRect box;
+    QPolygon polygon;
+  };
+
+  /** The index of one tile. */
+  struct TileIndex
+  {
+    /** Union of all isoline bounding boxes. */
+    QRect box;
+
+    /** Isolines ordered by descending elevation. */
+    QVector<Entry> entries;
+
+    /** Entry indexes per grid cell, the order of entries is kept. */
+    QVector<int> cells[GridSize * GridSize];
+  };
+
+  /**
+   * Returns the grid cell column or row of a coordinate.
+   */
+  static int cellOf( const int value, const int start, const int extent )
+  {
+    int cell = int( (qint64(value - start) * GridSize) / extent );
+    return qBound( 0, cell, GridSize - 1 );
+  };
+
+  /** Indexed tiles, the key is the tile section identifier. */
+  QHash<int, TileIndex *> m_tiles;
+};
+
+#endif /* ELEVATION_INDEX_H */
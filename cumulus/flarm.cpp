@@ -42,7 +42,7 @@ Flarm::~Flarm()
 /**
  * Extracts all items from $PFLAU sentence from Flarm device.
  */
-bool Flarm::extractPflau( const QStringList& stringList )
+bool Flarm::extractPflau( const NmeaTokenizer& stringList )
 {
   m_flarmStatus.valid = false;
 
@@ -106,7 +106,7 @@ bool Flarm::extractPflau( const QStringList& stringList )
     }
 
   // RelativeBearing
-  m_flarmStatus.RelativeBearing = stringList[6];
+  m_flarmStatus.RelativeBearing = stringList[6].toString();
 
   // AlarmType
   value = stringList[7].toShort( &ok );
@@ -118,13 +118,13 @@ bool Flarm::extractPflau( const QStringList& stringList )
     }
 
   // RelativeVertical
-  m_flarmStatus.RelativeVertical = stringList[8];
+  m_flarmStatus.RelativeVertical = stringList[8].toString();
 
   // RelativeDistance
-  m_flarmStatus.RelativeDistance = stringList[9];
+  m_flarmStatus.RelativeDistance = stringList[9].toString();
 
   // ID 6-digit hex value
-  m_flarmStatus.ID = stringList[10];
+  m_flarmStatus.ID = stringList[10].toString();
 
   m_flarmStatus.valid = true;
 
@@ -141,7 +141,7 @@ bool Flarm::extractPflau( const QStringList& stringList )
 /**
  * Extracts all items from the $PFLAA sentence sent by the Flarm device.
  */
-bool Flarm::extractPflaa( const QStringList& stringList, FlarmAcft& aircraft )
+bool Flarm::extractPflaa( const NmeaTokenizer& stringList, FlarmAcft& aircraft )
 {
   if ( stringList[0] != "$PFLAA" || stringList.size() < 12 )
     {
@@ -204,7 +204,7 @@ bool Flarm::extractPflaa( const QStringList& stringList, FlarmAcft& aircraft )
       aircraft.IdType = 0;
     }
 
-  aircraft.ID = stringList[6];
+  aircraft.ID = stringList[6].toString();
 
   // 0-359 or INT_MIN in stealth mode
   aircraft.Track = stringList[7].toInt( &ok );
@@ -268,7 +268,7 @@ bool Flarm::extractPflaa( const QStringList& stringList, FlarmAcft& aircraft )
   return true;
 }
 
-bool Flarm::extractPflav(const QStringList& stringList)
+bool Flarm::extractPflav(const NmeaTokenizer& stringList)
 {
   if ( stringList[0] != "$PFLAV" || stringList.size() < 5 )
      {
@@ -280,15 +280,15 @@ bool Flarm::extractPflav(const QStringList& stringList)
    PFLAV,<QueryType>,<HwVersion>,<SwVersion>,<ObstVersion>
    $PFLAV,A,2.00,5.00,alps20110221_*
   */
-  m_flarmVersion.hwVersion   = stringList[2];
-  m_flarmVersion.swVersion   = stringList[3];
-  m_flarmVersion.obstVersion = stringList[4];
+  m_flarmVersion.hwVersion   = stringList[2].toString();
+  m_flarmVersion.swVersion   = stringList[3].toString();
+  m_flarmVersion.obstVersion = stringList[4].toString();
 
   emit flarmVersionInfo( m_flarmVersion );
   return true;
 }
 
-bool Flarm::extractPflae(const QStringList& stringList)
+bool Flarm::extractPflae(const NmeaTokenizer& stringList)
 {
   /**
    * PFLAE,<QueryType>,<Severity>,<ErrorCode>(,<Message>)
@@ -331,12 +331,12 @@ bool Flarm::extractPflae(const QStringList& stringList)
       return false;
     }
 
-  m_flarmError.severity  = stringList[2];
-  m_flarmError.errorCode = stringList[3];
+  m_flarmError.severity  = stringList[2].toString();
+  m_flarmError.errorCode = stringList[3].toString();
 
   if( stringList.size() >= 5 )
     {
-      m_flarmError.errorText = stringList[4];
+      m_flarmError.errorText = stringList[4].toString();
     }
   else
     {
@@ -347,7 +347,7 @@ bool Flarm::extractPflae(const QStringList& stringList)
   return true;
 }
 
-bool Flarm::extractPflac(QStringList& stringList)
+bool Flarm::extractPflac(const NmeaTokenizer& stringList)
 {
   /**
    * PFLAC,<QueryType>,<Key>,<Value>
@@ -361,11 +361,12 @@ bool Flarm::extractPflac(QStringList& stringList)
         return false;
       }
 
-  emit flarmConfigurationInfo( stringList );
+  QStringList list = stringList.toStringList();
+  emit flarmConfigurationInfo( list );
   return true;
 }
 
-bool Flarm::extractPflar(QStringList& stringList)
+bool Flarm::extractPflar(const NmeaTokenizer& stringList)
 {
   /**
    * PFLAR,<QueryType>
@@ -380,11 +381,12 @@ bool Flarm::extractPflar(QStringList& stringList)
         return false;
       }
 
-  emit flarmResetResponse( stringList );
+  QStringList list = stringList.toStringList();
+  emit flarmResetResponse( list );
   return true;
 }
 
-bool Flarm::extractPflai(QStringList& stringList)
+bool Flarm::extractPflai(const NmeaTokenizer& stringList)
 {
   /**
    * PFLAI,<IGC Command>
@@ -404,11 +406,12 @@ bool Flarm::extractPflai(QStringList& stringList)
         return false;
       }
 
-  emit flarmIgcResponse( stringList );
+  QStringList list = stringList.toStringList();
+  emit flarmIgcResponse( list );
   return true;
 }
 
-bool Flarm::extractPflao(QStringList& stringList)
+bool Flarm::extractPflao(const NmeaTokenizer& stringList)
 {
   /**
    * 00: PFLAO,
@@ -506,13 +509,13 @@ bool Flarm::extractPflao(QStringList& stringList)
 
   if( faz.isActive() == false )
     {
-      qWarning() << "Flarm Alert Zone" << stringList[9]
+      qWarning() << "Flarm Alert Zone" << stringList[9].toString()
                  << "activity limit has expired! Ignoring $PFLAO.";
       return false;
     }
 
   // 9. ID
-  faz.ID = stringList[9];
+  faz.ID = stringList[9].toString();
 
   // 10. ID-Type
   faz.IdType = stringList[10].toShort( &ok );
@@ -538,7 +541,7 @@ bool Flarm::extractPflao(QStringList& stringList)
   return true;
 }
 
-bool Flarm::extractError(QStringList& stringList)
+bool Flarm::extractError(const NmeaTokenizer& stringList)
 {
   /**
    * $ERROR,CKSUM*37
@@ -549,7 +552,8 @@ bool Flarm::extractError(QStringList& stringList)
         return false;
       }
 
-  emit flarmError( stringList );
+  QStringList list = stringList.toStringList();
+  emit flarmError( list );
   return true;
 }
 
@@ -35,6 +35,7 @@
 #include <QTime>
 
 #include "flarmbase.h"
+#include "nmeatokenizer.h"
 
 class QPoint;
 class QStringList;
@@ -91,68 +92,68 @@ class Flarm : public QObject, public FlarmBase
 
   /**
    * Extracts all items from the $PFLAU sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAU as string list
+   * @param stringList Flarm sentence $PFLAU as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflau(const QStringList& stringList);
+  bool extractPflau(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAA sentence sent by the Flarm device.
    *
-   * @param stringList Flarm sentence $PFLAA as string list
+   * @param stringList Flarm sentence $PFLAA as tokenized sentence
    * @param aircraft extracted aircraft data from sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflaa( const QStringList& stringList, FlarmAcft& aircraft );
+  bool extractPflaa( const NmeaTokenizer& stringList, FlarmAcft& aircraft );
 
   /**
    * Extracts all items from the $PFLAV sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAV as string list
+   * @param stringList Flarm sentence $PFLAV as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflav(const QStringList& stringList);
+  bool extractPflav(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAE sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAV as string list
+   * @param stringList Flarm sentence $PFLAV as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflae(const QStringList& stringList);
+  bool extractPflae(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAC sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAV as string list
+   * @param stringList Flarm sentence $PFLAV as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflac(QStringList& stringList);
+  bool extractPflac(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAR sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAR as string list
+   * @param stringList Flarm sentence $PFLAR as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflar(QStringList& stringList);
+  bool extractPflar(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAI sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAR as string list
+   * @param stringList Flarm sentence $PFLAR as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflai(QStringList& stringList);
+  bool extractPflai(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $PFLAO sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAR as string list
+   * @param stringList Flarm sentence $PFLAR as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractPflao(QStringList& stringList);
+  bool extractPflao(const NmeaTokenizer& stringList);
 
   /**
    * Extracts all items from the $ERROR sentence sent by the Flarm device.
-   * @param stringList Flarm sentence $PFLAV as string list
+   * @param stringList Flarm sentence $PFLAV as tokenized sentence
    * @return true if a valid value exists otherwise false
    */
-  bool extractError(QStringList& stringList);
+  bool extractError(const NmeaTokenizer& stringList);
 
   /**
    * PFLAA data collection is finished.
@@ -0,0 +1,321 @@
+/***********************************************************************
+**
+**   flightstatistics.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include "flightstatistics.h"
+#include "mapcalc.h"
+
+// Minimum ground speed in m/s of a moving sample
+#define MOVING_SPEED 0.5
+
+// Minimum heading change in degrees of a counted turn
+#define TURN_LIMIT 4
+
+FlightStatistics::Window::Window( const RingBuffer<Sample>* history,
+                                  const qint64 span ) :
+  m_history(history),
+  m_span(span),
+  m_count(0),
+  m_movingCount(0),
+  m_positiveTurns(0),
+  m_negativeTurns(0),
+  m_turnSum(0),
+  m_speedSum(0.0),
+  m_distanceSum(0.0),
+  m_headingSinSum(0.0),
+  m_headingCosSum(0.0)
+{
+}
+
+void FlightStatistics::Window::addNewest()
+{
+  const Sample& sample = newest();
+
+  m_count++;
+
+  if( sample.speed >= MOVING_SPEED )
+    {
+      m_movingCount++;
+    }
+
+  if( sample.turn > TURN_LIMIT )
+    {
+      m_positiveTurns++;
+    }
+  else if( sample.turn < -TURN_LIMIT )
+    {
+      m_negativeTurns++;
+    }
+
+  m_turnSum       += sample.turn;
+  m_speedSum      += sample.speed;
+  m_distanceSum   += sample.distance;
+  m_headingSinSum += sample.headingSin;
+  m_headingCosSum += sample.headingCos;
+}
+
+void FlightStatistics::Window::removeOldest()
+{
+  const Sample& sample = oldest();
+
+  m_count--;
+
+  if( m_count == 0 )
+    {
+      // Start again from zero to avoid a drift of the floating point sums.
+      m_movingCount   = 0;
+      m_positiveTurns = 0;
+      m_negativeTurns = 0;
+      m_turnSum       = 0;
+      m_speedSum      = 0.0;
+      m_distanceSum   = 0.0;
+      m_headingSinSum = 0.0;
+      m_headingCosSum = 0.0;
+      return;
+    }
+
+  if( sample.speed >= MOVING_SPEED )
+    {
+      m_movingCount--;
+    }
+
+  if( sample.turn > TURN_LIMIT )
+    {
+      m_positiveTurns--;
+    }
+  else if( sample.turn < -TURN_LIMIT )
+    {
+      m_negativeTurns--;
+    }
+
+  m_turnSum       -= sample.turn;
+  m_speedSum      -= sample.speed;
+  m_distanceSum   -= sample.distance;
+  m_headingSinSum -= sample.headingSin;
+  m_headingCosSum -= sample.headingCos;
+}
+
+void FlightStatistics::Window::evict()
+{
+  if( m_count == 0 )
+    {
+      return;
+    }
+
+  const qint64 limit = newest().time - m_span;
+
+  while( m_count > 0 && oldest().time <= limit )
+    {
+      removeOldest();
+    }
+}
+
+qint64 FlightStatistics::Window::duration() const
+{
+  if( m_count < 2 )
+    {
+      return 0;
+    }
+
+  return newest().time - oldest().time;
+}
+
+double FlightStatistics::Window::averageSpeed() const
+{
+  if( m_count == 0 )
+    {
+      return 0.0;
+    }
+
+  return m_speedSum / m_count;
+}
+
+// The values between two samples are stored in the younger sample of the
+// pair. The oldest sample of the window has its pair partner outside of the
+// window, therefore its values are not considered.
+
+int FlightStatistics::Window::turn() const
+{
+  if( m_count < 2 )
+    {
+      return 0;
+    }
+
+  return m_turnSum - oldest().turn;
+}
+
+double FlightStatistics::Window::turnRate() const
+{
+  const qint64 time = duration();
+
+  if( time == 0 )
+    {
+      return 0.0;
+    }
+
+  return turn() * 1000.0 / time;
+}
+
+int FlightStatistics::Window::positiveTurns() const
+{
+  if( m_count < 2 )
+    {
+      return 0;
+    }
+
+  return m_positiveTurns - ( oldest().turn > TURN_LIMIT ? 1 : 0 );
+}
+
+int FlightStatistics::Window::negativeTurns() const
+{
+  if( m_count < 2 )
+    {
+      return 0;
+    }
+
+  return m_negativeTurns - ( oldest().turn < -TURN_LIMIT ? 1 : 0 );
+}
+
+double FlightStatistics::Window::headingVariance() const
+{
+  if( m_count == 0 )
+    {
+      return 0.0;
+    }
+
+  const double length = sqrt( m_headingSinSum * m_headingSinSum +
+                              m_headingCosSum * m_headingCosSum );
+
+  return qBound( 0.0, 1.0 - length / m_count, 1.0 );
+}
+
+double FlightStatistics::Window::altitudeChange() const
+{
+  if( m_count < 2 )
+    {
+      return 0.0;
+    }
+
+  return newest().altitude - oldest().altitude;
+}
+
+double FlightStatistics::Window::climbRate() const
+{
+  const qint64 time = duration();
+
+  if( time == 0 )
+    {
+      return 0.0;
+    }
+
+  return altitudeChange() * 1000.0 / time;
+}
+
+double FlightStatistics::Window::distance() const
+{
+  if( m_count < 2 )
+    {
+      return 0.0;
+    }
+
+  return m_distanceSum - oldest().distance;
+}
+
+FlightStatistics::FlightStatistics( const int capacity ) :
+  m_history( capacity )
+{
+}
+
+FlightStatistics::~FlightStatistics()
+{
+}
+
+int FlightStatistics::addWindow( const qint64 span )
+{
+  m_windows.append( Window( &m_history, span ) );
+
+  // A new window starts empty.
+  return m_windows.size() - 1;
+}
+
+void FlightStatistics::setWindowSpan( const int index, const qint64 span )
+{
+  Window& window = m_windows[index];
+
+  window.m_span = span;
+  window.evict();
+}
+
+void FlightStatistics::addSample( const qint64 time,
+                                  const int heading,
+                                  const double speed,
+                                  const double altitude )
+{
+  if( m_history.isEmpty() == false && time < m_history.first().time )
+    {
+      // The time runs backwards, e.g. the replay of a flight was restarted.
+      clear();
+    }
+
+  Sample sample;
+  sample.time       = time;
+  sample.altitude   = altitude;
+  sample.speed      = speed;
+  sample.heading    = heading;
+  sample.headingSin = sin( heading * M_PI / 180.0 );
+  sample.headingCos = cos( heading * M_PI / 180.0 );
+  sample.turn       = 0;
+  sample.distance   = 0.0;
+
+  if( m_history.isEmpty() == false )
+    {
+      const Sample& previous = m_history.first();
+
+      sample.turn     = MapCalc::angleDiff( previous.heading, heading );
+      sample.distance = speed * (time - previous.time) / 1000.0;
+    }
+
+  for( int i = 0; i < m_windows.size(); i++ )
+    {
+      Window& window = m_windows[i];
+
+      if( window.m_count == m_history.capacity() )
+        {
+          // The oldest sample of the window is overwritten in the history.
+          window.removeOldest();
+        }
+    }
+
+  m_history.add( sample );
+
+  for( int i = 0; i < m_windows.size(); i++ )
+    {
+      Window& window = m_windows[i];
+
+      window.addNewest();
+      window.evict();
+    }
+}
+
+void FlightStatistics::clear()
+{
+  for( int i = 0; i < m_windows.size(); i++ )
+    {
+      m_windows[i] = Window( &m_history, m_windows[i].m_span );
+    }
+
+  m_history.clear();
+}
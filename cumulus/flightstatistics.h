@@ -0,0 +1,253 @@
+/***********************************************************************
+**
+**   flightstatistics.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FlightStatistics
+ *
+ * \author Axel Pauli
+ *
+ * \brief Rolling statistics of the flight samples over several time windows.
+ *
+ * Every new flight sample updates the sums of all time windows. Samples,
+ * which are leaving a window, are subtracted from its sums. Therefore the
+ * costs per sample are constant and independent from the window lengths.
+ * A window delivers the average speed, the turn rate, the climb rate, the
+ * heading variance and the flown distance of its samples without any
+ * further scan of the sample history.
+ *
+ * The sample times are passed in milliseconds, so that no date time
+ * arithmetic is necessary.
+ *
+ * \date 2016
+ *
+ * \version 1.0
+ */
+
+#ifndef FLIGHT_STATISTICS_H
+#define FLIGHT_STATISTICS_H
+
+#include <QVector>
+
+#include "ringbuffer.h"
+
+class FlightStatistics
+{
+
+public:
+
+  /** Per sample values, which are needed for the window sums. */
+  struct Sample
+  {
+    /** Sample time in ms. */
+    qint64 time;
+
+    /** Altitude in meters. */
+    double altitude;
+
+    /** Ground speed in m/s. */
+    double speed;
+
+    /** Heading in degrees. */
+    int heading;
+
+    /** Heading as unit vector. */
+    double headingSin;
+    double headingCos;
+
+    /** Heading change to the previous sample in degrees, -180...180. */
+    int turn;
+
+    /** Distance to the previous sample in meters. */
+    double distance;
+  };
+
+  /**
+   * \class Window
+   *
+   * \brief Sums of the samples of a time window.
+   *
+   * The window contains the samples, which are younger than its time span
+   * relative to the newest sample. The values between two samples, like the
+   * turn and the distance, are summed up for the sample pairs inside of the
+   * window.
+   */
+  class Window
+  {
+    friend class FlightStatistics;
+
+  public:
+
+    Window( const RingBuffer<Sample>* history=0, const qint64 span=0 );
+
+    /** @return The time span of the window in ms. */
+    qint64 span() const
+    {
+      return m_span;
+    };
+
+    /** @return The number of samples inside of the window. */
+    int samples() const
+    {
+      return m_count;
+    };
+
+    /** @return The time between the oldest and the newest sample in ms. */
+    qint64 duration() const;
+
+    /** @return The average ground speed in m/s. */
+    double averageSpeed() const;
+
+    /**
+     * @return The number of samples with a ground speed of at least 0.5 m/s.
+     *         If it is zero, we may stand still.
+     */
+    int movingSamples() const
+    {
+      return m_movingCount;
+    };
+
+    /** @return The sum of the heading changes in degrees, can be negative. */
+    int turn() const;
+
+    /** @return The turn rate in degrees per second, can be negative. */
+    double turnRate() const;
+
+    /** @return The number of heading changes of more than +4 degrees. */
+    int positiveTurns() const;
+
+    /** @return The number of heading changes of less than -4 degrees. */
+    int negativeTurns() const;
+
+    /**
+     * @return The circular variance of the headings. 0 means a constant
+     *         heading, 1 means uniformly distributed headings.
+     */
+    double headingVariance() const;
+
+    /** @return The altitude change in meters, negative means sink. */
+    double altitudeChange() const;
+
+    /** @return The climb rate in m/s, negative means sink. */
+    double climbRate() const;
+
+    /** @return The flown distance over ground in meters. */
+    double distance() const;
+
+  private:
+
+    /** Adds the newest sample of the history to the sums. */
+    void addNewest();
+
+    /** Removes the oldest sample of the window from the sums. */
+    void removeOldest();
+
+    /** Removes all samples, which are outside of the window. */
+    void evict();
+
+    /** @return The newest sample. */
+    const Sample& newest() const
+    {
+      return m_history->at( 0 );
+    };
+
+    /** @return The oldest sample of the window. */
+    const Sample& oldest() const
+    {
+      return m_history->at( m_count - 1 );
+    };
+
+    const RingBuffer<Sample>* m_history;
+
+    qint64 m_span;
+    int    m_count;
+    int    m_movingCount;
+    int    m_positiveTurns;
+    int    m_negativeTurns;
+    int    m_turnSum;
+    double m_speedSum;
+    double m_distanceSum;
+    double m_headingSinSum;
+    double m_headingCosSum;
+  };
+
+  /**
+   * @param capacity Maximum number of samples in a window.
+   */
+  FlightStatistics( const int capacity );
+
+  virtual ~FlightStatistics();
+
+  /**
+   * Adds a new time window.
+   *
+   * @param span The time span of the window in ms.
+   *
+   * @return The index of the window.
+   */
+  int addWindow( const qint64 span );
+
+  /**
+   * Changes the time span of a window. If the window becomes shorter, the
+   * samples outside of it are removed. If it becomes longer, it is filled
+   * up by the next samples.
+   *
+   * @param index The index of the window.
+   *
+   * @param span The new time span of the window in ms.
+   */
+  void setWindowSpan( const int index, const qint64 span );
+
+  /**
+   * @param index The index of the window.
+   *
+   * @return The window with the passed index.
+   */
+  const Window& window( const int index ) const
+  {
+    return m_windows.at( index );
+  };
+
+  /**
+   * Adds a new sample to all windows.
+   *
+   * @param time Sample time in ms. If it is older than the last sample, all
+   *             windows are cleared before.
+   *
+   * @param heading Heading in degrees.
+   *
+   * @param speed Ground speed in m/s.
+   *
+   * @param altitude Altitude in meters.
+   */
+  void addSample( const qint64 time,
+                  const int heading,
+                  const double speed,
+                  const double altitude );
+
+  /** Removes all samples from all windows. */
+  void clear();
+
+private:
+
+  Q_DISABLE_COPY ( FlightStatistics )
+
+  /** The last samples, the newest is at index 0. */
+  RingBuffer<Sample> m_history;
+
+  /** The time windows. */
+  QVector<Window> m_windows;
+};
+
+#endif /* FLIGHT_STATISTICS_H */
@@ -0,0 +1,110 @@
+/***********************************************************************
+**
+**   flighttrail.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "flighttrail.h"
+#include "mapcalc.h"
+
+// Maximum number of positions per level, that are 24 hours at 1 Hz. If a
+// level is full, its older half is removed.
+#define MAX_TRAIL_POSITIONS (24 * 3600)
+
+// Gap in ms between two positions, after which a new trail is started
+#define MAX_TRAIL_GAP (3600 * 1000)
+
+// Minimum distance in pixels between two drawn trail positions
+#define TRAIL_PIXEL_DISTANCE 3.0
+
+// Minimum distance in meters between two positions of a detail level
+static const double levelDistances[TRAIL_LEVELS] = { 0.0, 25.0, 100.0, 400.0, 1600.0 };
+
+FlightTrail::FlightTrail() :
+  m_lastTime(0),
+  m_serial(0)
+{
+}
+
+FlightTrail::~FlightTrail()
+{
+}
+
+void FlightTrail::add( const QPoint& position, const qint64 time )
+{
+  if( isEmpty() == false &&
+      ( time < m_lastTime || time - m_lastTime > MAX_TRAIL_GAP ) )
+    {
+      // A new flight has been started.
+      clear();
+    }
+
+  m_lastTime = time;
+
+  for( int i = 0; i < TRAIL_LEVELS; i++ )
+    {
+      QVector<QPoint>& level = m_levels[i];
+
+      if( level.isEmpty() == false )
+        {
+          QPoint last = level.last();
+
+          if( last == position )
+            {
+              // No movement, nothing to add to all levels.
+              return;
+            }
+
+          QPoint next = position;
+
+          if( i > 0 && MapCalc::dist( &last, &next ) * 1000.0 < levelDistances[i] )
+            {
+              // The higher levels have even larger distances.
+              return;
+            }
+        }
+
+      if( level.size() >= MAX_TRAIL_POSITIONS )
+        {
+          level.remove( 0, level.size() / 2 );
+          m_serial++;
+        }
+
+      level.append( position );
+    }
+}
+
+void FlightTrail::clear()
+{
+  for( int i = 0; i < TRAIL_LEVELS; i++ )
+    {
+      m_levels[i].clear();
+    }
+
+  m_serial++;
+}
+
+int FlightTrail::levelFor( const double scale ) const
+{
+  const double distance = TRAIL_PIXEL_DISTANCE * scale;
+
+  int level = 0;
+
+  while( level < TRAIL_LEVELS - 1 && levelDistances[level + 1] <= distance )
+    {
+      level++;
+    }
+
+  return level;
+}
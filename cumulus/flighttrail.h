@@ -0,0 +1,120 @@
+/***********************************************************************
+**
+**   flighttrail.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FlightTrail
+ *
+ * \author Axel Pauli
+ *
+ * \brief Geographic store of the flight path.
+ *
+ * The trail keeps the positions of the whole flight in WGS84 coordinates,
+ * so that it is independent from the map projection. It consists of several
+ * detail levels. Level 0 contains all positions, the higher levels only
+ * positions with a growing minimum distance to their predecessor. The map
+ * selects the level, which matches its scale, and projects only the
+ * positions, which are new since its last drawing.
+ *
+ * The trail is cleared, if the time runs backwards or if there is a longer
+ * gap between two positions, because then a new flight has started.
+ *
+ * \date 2016
+ *
+ * \version 1.0
+ */
+
+#ifndef FLIGHT_TRAIL_H
+#define FLIGHT_TRAIL_H
+
+#include <QPoint>
+#include <QVector>
+
+// Number of detail levels of the trail
+#define TRAIL_LEVELS 5
+
+class FlightTrail
+{
+
+public:
+
+  FlightTrail();
+
+  virtual ~FlightTrail();
+
+  /**
+   * Adds a new position to the trail.
+   *
+   * @param position Position in KFLog format.
+   *
+   * @param time Time of the position in ms since the epoch.
+   */
+  void add( const QPoint& position, const qint64 time );
+
+  /** Removes all positions. */
+  void clear();
+
+  /** @return True, if the trail contains no position. */
+  bool isEmpty() const
+  {
+    return m_levels[0].isEmpty();
+  };
+
+  /** @return The newest position of the trail. Must not be called, if empty. */
+  const QPoint& lastPosition() const
+  {
+    return m_levels[0].last();
+  };
+
+  /**
+   * @param scale The map scale in meters per pixel.
+   *
+   * @return The detail level, which fits to the passed map scale.
+   */
+  int levelFor( const double scale ) const;
+
+  /**
+   * @param level The detail level, 0 ... TRAIL_LEVELS - 1.
+   *
+   * @return The positions of the level, the oldest position at first.
+   */
+  const QVector<QPoint>& positions( const int level ) const
+  {
+    return m_levels[level];
+  };
+
+  /**
+   * The serial is incremented, if positions have been removed from the
+   * trail. Then all projected positions must be discarded by the user.
+   *
+   * @return The serial of the trail.
+   */
+  uint serial() const
+  {
+    return m_serial;
+  };
+
+private:
+
+  /** The positions of the detail levels. */
+  QVector<QPoint> m_levels[TRAIL_LEVELS];
+
+  /** The time of the newest position in ms. */
+  qint64 m_lastTime;
+
+  /** Change counter for removals. */
+  uint m_serial;
+};
+
+#endif /* FLIGHT_TRAIL_H */
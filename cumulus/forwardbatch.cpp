@@ -0,0 +1,182 @@
+/***********************************************************************
+**
+**   forwardbatch.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+
+#include "forwardbatch.h"
+
+ForwardBatch::ForwardBatch( const int capacity ) :
+  m_length(0),
+  m_capacity(capacity),
+  m_count(0)
+{
+  // One allocation for all batches.
+  m_data.resize( m_capacity + sizeof(quint32) );
+  clear();
+}
+
+ForwardBatch::~ForwardBatch()
+{
+}
+
+void ForwardBatch::append( const Type type, const char* data, const int length )
+{
+  Header header;
+  header.type   = type;
+  header.length = ( data != 0 && length > 0 ) ? length : 0;
+
+  const int needed = m_length + sizeof(header) + header.length;
+
+  if( needed > m_data.size() )
+    {
+      // The array only grows, it is never shrunk.
+      m_data.resize( qMax( needed, 2 * m_data.size() ) );
+    }
+
+  char* ptr = m_data.data() + m_length;
+
+  memcpy( ptr, &header, sizeof(header) );
+
+  if( header.length > 0 )
+    {
+      memcpy( ptr + sizeof(header), data, header.length );
+    }
+
+  m_length = needed;
+  m_count++;
+}
+
+const char* ForwardBatch::frame()
+{
+  const quint32 length = size();
+
+  memcpy( m_data.data(), &length, sizeof(length) );
+
+  return m_data.constData();
+}
+
+void ForwardBatch::clear()
+{
+  // The array keeps its size, only the room for the batch length is used.
+  m_length = sizeof(quint32);
+  m_count  = 0;
+}
+
+int ForwardBatch::send( const int socket )
+{
+  if( m_pending.isEmpty() == false )
+    {
+      const int done = writeData( socket, m_pending.constData(), m_pending.size() );
+
+      if( done < 0 )
+        {
+          return -1;
+        }
+
+      m_pending.remove( 0, done );
+
+      if( m_pending.isEmpty() == false )
+        {
+          // The socket is still full. The batch is dropped as a whole, so
+          // that the stream keeps its synchronization.
+          const int dropped = m_count;
+          clear();
+          return dropped;
+        }
+    }
+
+  if( isEmpty() )
+    {
+      return 0;
+    }
+
+  const char* data = frame();
+
+  const int done = writeData( socket, data, m_length );
+
+  if( done < 0 )
+    {
+      return -1;
+    }
+
+  if( done < m_length )
+    {
+      // Keep the unsent tail, it is sent first by the next call.
+      m_pending = QByteArray( data + done, m_length - done );
+    }
+
+  clear();
+  return 0;
+}
+
+int ForwardBatch::writeData( const int socket, const char* data, const int length )
+{
+  int written = 0;
+
+  while( written < length )
+    {
+      int done = write( socket, data + written, length - written );
+
+      if( done < 0 )
+        {
+          if( errno == EINTR )
+            {
+              continue; // Ignore interrupts
+            }
+
+          if( errno == EAGAIN || errno == EWOULDBLOCK )
+            {
+              break; // The socket is full
+            }
+
+          return -1;
+        }
+
+      written += done;
+    }
+
+  return written;
+}
+
+bool ForwardBatch::next( const char* batch, const int batchLength, int& pos,
+                         Type& type, const char*& data, int& length )
+{
+  if( pos + static_cast<int> (sizeof(Header)) > batchLength )
+    {
+      return false;
+    }
+
+  // The header can be unaligned in the batch.
+  Header header;
+  memcpy( &header, batch + pos, sizeof(header) );
+
+  pos += sizeof(header);
+
+  if( header.length > static_cast<quint32> (batchLength - pos) )
+    {
+      // Malformed batch, skip the rest.
+      pos = batchLength;
+      return false;
+    }
+
+  type   = static_cast<Type> (header.type);
+  data   = batch + pos;
+  length = header.length;
+
+  pos += header.length;
+  return true;
+}
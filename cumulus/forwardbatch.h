@@ -0,0 +1,179 @@
+/***********************************************************************
+**
+**   forwardbatch.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class ForwardBatch
+*
+* \author Axel Pauli
+*
+* \brief Batch of typed messages for the forward channel of the GPS client.
+*
+* The GPS client forwards the GPS data and status messages to Cumulus via
+* the forward channel. Formerly every message was sent as an own frame with
+* a text prefix, which had to be compared by Cumulus. Now many messages are
+* collected in a batch and sent as one frame. Every message in the batch is
+* preceded by a binary header with its type and its length.
+*
+* A frame on the socket consists of the batch length as unsigned integer,
+* followed by the batch data. The batch keeps room for the length in front
+* of its data, so that a frame is written with a single call.
+*
+* The forward channel is non blocking. A frame is never truncated in the
+* stream, otherwise the receiver would lose the synchronization. If a frame
+* could be written only partly, its unsent tail is kept and written first by
+* the next \ref send call. As long as a tail is pending, new batches are
+* dropped as a whole.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef FORWARD_BATCH_H
+#define FORWARD_BATCH_H
+
+#include <QByteArray>
+
+class ForwardBatch
+{
+ public:
+
+  /** Types of the forwarded messages. */
+  enum Type
+  {
+    GpsData = 1,           // GPS sentence
+    ConnectionOff,         // GPS connection has gone off
+    ConnectionOn,          // GPS connection has gone on
+    FlarmFlightList,       // Flarm flight list response
+    FlarmDownloadInfo,     // Flarm flight download result
+    FlarmDownloadProgress  // Flarm flight download progress
+  };
+
+  /** Header in front of every message of a batch. */
+  struct Header
+  {
+    quint32 type;
+    quint32 length;
+  };
+
+  /**
+   * \param capacity The batch size in bytes, which is reserved in advance.
+   */
+  ForwardBatch( const int capacity=4096 );
+
+  virtual ~ForwardBatch();
+
+  /**
+   * Appends a message to the batch.
+   *
+   * \param type The type of the message.
+   * \param data The message data, can be null for messages without data.
+   * \param length The length of the message data.
+   */
+  void append( const Type type, const char* data=0, const int length=0 );
+
+  /**
+   * \return The frame to be sent, the batch length followed by the
+   *         batch data. Its length is returned by \ref frameSize.
+   */
+  const char* frame();
+
+  /** \return The size of the frame in bytes. */
+  int frameSize() const
+  {
+    return m_length;
+  };
+
+  /** \return The size of the batch data in bytes. */
+  int size() const
+  {
+    return m_length - sizeof(quint32);
+  };
+
+  /** \return True, if the batch contains no messages. */
+  bool isEmpty() const
+  {
+    return m_count == 0;
+  };
+
+  /** \return The number of messages in the batch. */
+  int count() const
+  {
+    return m_count;
+  };
+
+  /** Removes all messages. The reserved capacity is kept. */
+  void clear();
+
+  /**
+   * Writes the frame of the batch to the non blocking socket and clears the
+   * batch. A pending tail of the last frame is written before.
+   *
+   * \param socket The socket of the forward channel.
+   * \return -1 in case of a fatal write error, otherwise the number of
+   *         dropped messages, because the socket is full.
+   */
+  int send( const int socket );
+
+  /** \return True, if the tail of a frame is still to be sent. */
+  bool hasPending() const
+  {
+    return m_pending.isEmpty() == false;
+  };
+
+  /**
+   * Extracts the next message of a received batch.
+   *
+   * \param batch The received batch data.
+   * \param batchLength The length of the batch data.
+   * \param pos The position of the next message. It is advanced to the
+   *            following message.
+   * \param type The type of the extracted message.
+   * \param data Points to the data of the extracted message in the batch.
+   * \param length The length of the extracted message data.
+   * \return False, if no further message is available or if the batch is
+   *         malformed.
+   */
+  static bool next( const char* batch, const int batchLength, int& pos,
+                    Type& type, const char*& data, int& length );
+
+ private:
+
+  /**
+   * Writes data to the non blocking socket, until it is full.
+   *
+   * \return -1 in case of a fatal error, otherwise the number of written bytes.
+   */
+  static int writeData( const int socket, const char* data, const int length );
+
+  /**
+   * The frame with the batch data. The array is never shrunk, so that its
+   * memory is allocated only once. The used part is given by m_length.
+   */
+  QByteArray m_data;
+
+  /** Used bytes of the frame. */
+  int m_length;
+
+  /** Unsent tail of the last frame. */
+  QByteArray m_pending;
+
+  /** The batch size, which is reserved in advance. */
+  int m_capacity;
+
+  int m_count;
+};
+
+#endif /* FORWARD_BATCH_H */
@@ -204,6 +204,7 @@ void GeneralConfig::load()
   _fillColorGliderSector  = QColor( value("fillColorGliderSector", GLIDER_SECTOR_BRUSH_COLOR).toString() );
 
   _airspaceWarningGeneral = value("enableAirspaceWarning", true).toBool();
+  _airspaceLookAheadTime  = value("airspaceLookAheadTime", 60).toInt();
 
   // Airspace filling
   m_airspaceFillingEnabled = value("enableAirspaceFilling", true).toBool();
@@ -478,6 +479,8 @@ void GeneralConfig::load()
   _nearestSiteCalculatorSwitch   = value( "NearestSiteCalculatorOn",
                                           NEAREST_SITE_CALCULATOR_DEFAULT ).toBool();
   _maxNearestSiteCalculatorSites = value("MaxNumberOfSitesInList", 50).toInt();
+  _nearestSiteTerrainCheck       = value( "TerrainCheck",
+                                          NEAREST_SITE_TERRAIN_CHECK_DEFAULT ).toBool();
   endGroup();
 
   beginGroup("Information");
@@ -684,6 +687,7 @@ void GeneralConfig::save()
   setValue("fillColorGliderSector",   _fillColorGliderSector.name());
 
   setValue("enableAirspaceWarning", _airspaceWarningGeneral);
+  setValue("airspaceLookAheadTime", _airspaceLookAheadTime);
 
   // Airspace filling
   setValue("enableAirspaceFilling", m_airspaceFillingEnabled);
@@ -930,6 +934,7 @@ void GeneralConfig::save()
   beginGroup("NearestSitesCalc");
   setValue( "NearestSiteCalculatorOn", _nearestSiteCalculatorSwitch );
   setValue( "MaxNumberOfSitesInList", _maxNearestSiteCalculatorSites );
+  setValue( "TerrainCheck", _nearestSiteTerrainCheck );
   endGroup();
 
   beginGroup("Information");
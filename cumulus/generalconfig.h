@@ -62,6 +62,8 @@
 #define ALARM_SOUND_DEFAULT true
 // default for calculator of nearest sites (true = ON)
 #define NEAREST_SITE_CALCULATOR_DEFAULT true
+// default for terrain check of nearest sites (true = ON)
+#define NEAREST_SITE_TERRAIN_CHECK_DEFAULT false
 
 // default airspace fillings
 #define AS_FILL_NOT_NEAR   0
@@ -786,6 +788,24 @@ class GeneralConfig : protected QSettings
     _airspaceWarningGeneral=enable;
   };
 
+  /**
+   * @return The look ahead time in seconds for the airspace incursion
+   * prediction. 0 means disabled.
+   */
+  int getAirspaceLookAheadTime() const
+  {
+    return _airspaceLookAheadTime;
+  };
+
+  /**
+   * Sets the look ahead time in seconds for the airspace incursion
+   * prediction. 0 disables the prediction.
+   */
+  void setAirspaceLookAheadTime( const int newValue )
+  {
+    _airspaceLookAheadTime = newValue;
+  };
+
   /**
    * @return True if forcing of airspace drawing for closed by
    * structures is enabled
@@ -1826,6 +1846,18 @@ class GeneralConfig : protected QSettings
     _nearestSiteCalculatorSwitch = newValue;
   };
 
+  /** gets nearest site terrain check switch */
+  bool getNearestSiteTerrainCheck() const
+  {
+    return _nearestSiteTerrainCheck;
+  };
+
+  /** sets nearest site terrain check switch */
+  void setNearestSiteTerrainCheck(const bool newValue)
+  {
+    _nearestSiteTerrainCheck = newValue;
+  };
+
   /** gets max nearest site calculator sites */
   int getMaxNearestSiteCalculatorSites() const
   {
@@ -3032,6 +3064,8 @@ class GeneralConfig : protected QSettings
 
   //display airspace warnings at all?
   bool _airspaceWarningGeneral;
+  // look ahead time in seconds for airspace incursion warnings
+  int _airspaceLookAheadTime;
   // vertical fillings for airspaces
   int _verticalAirspaceFillings[4];
   // lateral fillings for airspaces
@@ -3250,6 +3284,8 @@ class GeneralConfig : protected QSettings
 
   // nearest site calculator switch
   bool _nearestSiteCalculatorSwitch;
+  // check terrain along the glide paths to the nearest sites
+  bool _nearestSiteTerrainCheck;
   // maximum sites considered by nearest site calculator
   int _maxNearestSiteCalculatorSites;
 
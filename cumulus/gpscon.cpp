@@ -24,7 +24,6 @@
 #include <fcntl.h>
 #include <libgen.h>
 #include <unistd.h>
-#include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/time.h>
@@ -42,6 +41,7 @@
 #include "signalhandler.h"
 #include "protocol.h"
 #include "ipc.h"
+#include "gpssensorthread.h"
 #include "hwinfo.h"
 
 #ifdef BLUEZ
@@ -70,7 +70,7 @@ GpsCon::GpsCon(QObject* parent, const char *pathIn) :
   startClient(false),
   pid(-1),
   listenNotifier(static_cast<QSocketNotifier *>(0)),
-  clientNotifier(static_cast<QSocketNotifier *>(0)),
+  sensorThread(static_cast<GpsSensorThread *>(0)),
   timer(0),
   ioSpeed(0)
 {
@@ -100,6 +100,12 @@ GpsCon::GpsCon(QObject* parent, const char *pathIn) :
   timer = new QTimer(this);
   timer->connect( timer, SIGNAL(timeout()), this, SLOT(slot_Timeout()) );
 
+  // The data of the forward channel are read by an own thread.
+  sensorThread = new GpsSensorThread(this);
+
+  connect( sensorThread, SIGNAL(newRecords()), this, SIGNAL(newRecords()) );
+  connect( sensorThread, SIGNAL(readError(int)), this, SLOT(slot_SensorError(int)) );
+
   initSignalHandler();
 
   // Port can be read from the configuration file for debugging purposes. If it
@@ -140,6 +146,8 @@ GpsCon::~GpsCon()
       writeClientMessage( 0, MSG_SHD );
     }
 
+  sensorThread->stop();
+
   server.closeListenSock();
   server.closeClientSock(0);
   server.closeClientSock(1);
@@ -381,9 +389,7 @@ void GpsCon::triggerRetry()
   // No GPS BT devices are available or other error. We do shutdown
   // the GPS client process. That will initiate a restart
   // by the Cumulus process supervision.
-  clientNotifier->setEnabled( false );
-  delete clientNotifier;
-  clientNotifier = static_cast<QSocketNotifier *>(0);
+  sensorThread->stop();
 
   writeClientMessage( 0, MSG_SHD );
 
@@ -503,18 +509,14 @@ bool GpsCon::startClientProcess()
       server.closeClientSock(0);
     }
 
+  // The reader thread is not more relevant after a crash, stop it
+  sensorThread->stop();
+
   if( server.getClientSock(1) != -1 )
     {
       server.closeClientSock(1);
     }
 
-  // not more relevant after a crash, remove it
-  if( clientNotifier )
-    {
-      delete clientNotifier;
-      clientNotifier = static_cast<QSocketNotifier *>(0);
-    }
-
   QStringList pathes;
 
   char *pathVar = getenv( "PATH" );
@@ -677,6 +679,7 @@ void GpsCon::slot_Timeout()
     {
       // Shutdown is requested via signal and client got the signal
       // too. Therefore we can close all sockets.
+      sensorThread->stop();
       server.closeListenSock();
       server.closeClientSock(0);
       server.closeClientSock(1);
@@ -721,21 +724,10 @@ void GpsCon::slot_ListenEvent( int socket )
           return; // accept failed
         }
 
-      // activate a socket notifier for the new client. The client can be
-      // programmed to send a notification, if there are new data
-      // available. That makes polling superfluous.
-
-      // Delete an old existing notifier, it remains after a crash.
-      if( clientNotifier )
-        {
-          delete clientNotifier;
-        }
-
-      clientNotifier = new QSocketNotifier( server.getClientSock(1),
-                                            QSocketNotifier::Read, this );
-
-      clientNotifier->connect( clientNotifier, SIGNAL(activated(int)), this,
-                               SLOT(slot_NotificationEvent(int)) );
+      // The GPS and status data of the new client are read and decoded by
+      // the sensor thread. The thread notifies us, if new data are available.
+      // That makes polling superfluous.
+      sensorThread->startReading( server.getClientSock(1) );
 
       // After the second client connect we send the initialization to the
       // client. That must be done at this point and not earlier, to avoid a
@@ -765,122 +757,19 @@ void GpsCon::slot_ListenEvent( int socket )
 }
 
 /**
- * This slot is triggered by the QT main loop and is used to get the
- * GPS or status data from the client.
- */
-void GpsCon::slot_NotificationEvent( int socket )
-{
-  QString method = QString("GPSCon::slot_NotificationEvent(%1):").arg(socket);
-
-  // Disable client notifier if socket shall be read. Advised by Qt.
-  clientNotifier->setEnabled( false );
-
-#ifdef DEBUG
-  qDebug("%s %s, got notification", method.toLatin1().data(), msg.toLatin1().data());
-#endif
-
-  getDataFromClient();
-
-  // Enable client notifier after read.
-  clientNotifier->setEnabled( true );
-}
-
-/**
- * Gets the GPS or status data from the client.
+ * This slot is called, if the sensor thread cannot read the forward channel
+ * anymore, e.g. the client has crashed. The socket is closed then.
  */
-void GpsCon::getDataFromClient()
+void GpsCon::slot_SensorError( int socket )
 {
-  if( server.getClientSock( 1 ) == -1 )
+  if( server.getClientSock(1) != socket )
     {
-      // No connection to the client established.
+      // The socket has been closed and reopened in the meantime.
       return;
     }
 
-  // QTime t; t.start();
-
-  int loops = 0;
-
-  while( loops++ < 250 )
-    {
-      // Check, if bytes are available in the receiver buffer because we
-      // use blocking IO.
-      int bytes = 0;
-
-      // Number of bytes currently in the socket receiver buffer.
-      if( ioctl( server.getClientSock( 1 ), FIONREAD, &bytes) == -1 )
-        {
-          qWarning() << "GpsCon::getDataFromClient():"
-                     << "ioctl() returns with ERROR: errno="
-                     << errno
-                     << "," << strerror(errno);
-          break;
-        }
-
-      if( bytes <= 0 )
-        {
-          break;
-        }
-
-      QString msg;
-
-      readClientMessage( 1, msg );
-
-      if( server.getClientSock( 1 ) == -1 )
-        {
-          // socket will be closed in case of any problems, e.g. client has
-          // crashed. we check that to avoid a dead lock here.
-          return;
-        }
-
-      if( msg.startsWith( MSG_GPS_DATA ) )
-        {
-          msg = msg.right(msg.length() - strlen(MSG_GPS_DATA) - 1);
-          emit newSentence(msg);
-        }
-      else if (msg == MSG_CON_OFF) // GPS connection has gone off
-        {
-          emit gpsConnectionOff();
-          qDebug(MSG_CON_OFF);
-        }
-      else if ( msg == MSG_CON_ON ) // GPS connection has gone on
-        {
-          emit gpsConnectionOn();
-          qDebug(MSG_CON_ON);
-        }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_LIST_RES) )
-        {
-          // A Flarm flight list was received.
-          msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_LIST_RES) - 1);
-          emit newFlarmFlightList(msg);
-        }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) )
-         {
-           // A Flarm download flight info was received.
-           msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_INFO) - 1);
-           emit newFlarmFlightDownloadInfo(msg);
-         }
-      else if( msg.startsWith(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) )
-         {
-           // A Flarm download progress info was received.
-           msg = msg.right(msg.length() - strlen(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS) - 1);
-
-           QStringList args = msg.split(",");
-
-           if( args.size() == 2 )
-             {
-               emit newFlarmFlightDownloadProgress(args[0].toInt(), args[1].toInt() );
-             }
-         }
-      else
-        {
-          qWarning() << "GpsCon::getDataFromClient(): Protocol Error!" << msg;
-        }
-    }
-
-  // qDebug() << "MSG_GPS_DATA Loops" << loops << t.elapsed();
-
-  // remember last start time
-  lastQuery.start();
+  sensorThread->stop();
+  server.closeClientSock(1);
 }
 
 /**
@@ -29,6 +29,9 @@
  * passed in the constructor, that the gpsClient resp. gpsMaemoClient binary
  * can be found. It lays in the same directory as Cumulus.
  *
+ * The GPS data of the client are read and decoded by the \ref GpsSensorThread.
+ * They are fetched as records via \ref takeRecord.
+ *
  * \date 2004-2015
  */
 
@@ -44,6 +47,8 @@
 
 #include "ipc.h"
 #include "datatypes.h"
+#include "gpsrecord.h"
+#include "gpssensorthread.h"
 
 // Device name for NMEA simulator. This name is also taken for the named pipe.
 #define NMEASIM_DEVICE "/tmp/nmeasim"
@@ -123,11 +128,23 @@ class GpsCon : public QObject
     bool stopGpsReceiving();
 
     /**
-     * Returns the socket notifier of the daemon connection.
+     * Takes the oldest record received from the client. Must be called by
+     * the GUI thread only.
+     *
+     * \return False, if no record is available.
+     */
+    bool takeRecord( GpsRecord& record )
+    {
+      return sensorThread->takeRecord( record );
+    };
+
+    /**
+     * Requests a new notification via signal \ref newRecords. Must be
+     * called before the records are taken.
      */
-    QSocketNotifier* getDaemonNotifier() const
+    void resetRecordNotification()
     {
-      return clientNotifier;
+      sensorThread->resetNotification();
     };
 
     /**
@@ -159,34 +176,10 @@ class GpsCon : public QObject
 
   signals:
     /**
-     * This signal is send every time a new sentence has arrived.
+     * This signal is send, if new records from the client are available.
+     * It is sent again only after a call of \ref resetRecordNotification.
      */
-    void newSentence(const QString& sentence);
-
-    /**
-     * This signal is send, if the GPS connection has been lost.
-     */
-    void gpsConnectionOff();
-
-    /**
-     * This signal is send, if the GPS connection has been established.
-     */
-    void gpsConnectionOn();
-
-    /**
-     * This signal is emitted, when a new Flarm flight list was received.
-     */
-    void newFlarmFlightList(const QString& list);
-
-    /**
-     * This signal is emitted, when a new Flarm flight download info was received.
-     */
-    void newFlarmFlightDownloadInfo(const QString& info);
-
-    /**
-     * This signal is emitted, when a new Flarm flight download progress was received.
-     */
-    void newFlarmFlightDownloadProgress(const int idx, const int progress);
+    void newRecords();
 
  private:
 
@@ -212,12 +205,6 @@ class GpsCon : public QObject
      */
     void writeClientMessage( uint index, const char *msg  );
 
-    /**
-     * Gets the GPS or status data from the client. The retrieved data will
-     * be hand over to the Cumulus process.
-     */
-    void getDataFromClient();
-
     /**
      * Triggers a connection retry in case of error.
      */
@@ -225,10 +212,10 @@ class GpsCon : public QObject
 
   private slots:
     /**
-     * This slot is triggered by the QT main loop and is used to handle the
-     * notification events from the client.
+     * This slot is called, if the sensor thread cannot read the forward
+     * channel anymore.
      */
-    void slot_NotificationEvent(int socket);
+    void slot_SensorError(int socket);
 
     /**
      * This slot is triggered by the QT main loop and is used to handle the
@@ -278,7 +265,9 @@ class GpsCon : public QObject
 
     // Notifier for QT main loop
     QSocketNotifier *listenNotifier;
-    QSocketNotifier *clientNotifier;
+
+    // Reader of the forward channel
+    GpsSensorThread *sensorThread;
 
     // used as timeout control for connection supervision
     QTimer *timer;
@@ -71,6 +71,8 @@ short GpsNmea::instances = 0;
 
 // Dictionary with known sentence keywords
 QHash<QString, short> GpsNmea::gpsHash;
+NmeaIdTable GpsNmea::gpsIdTable;
+bool GpsNmea::gpsIdTableFilled = false;
 
 // Mutex for thread synchronization
 QMutex GpsNmea::mutex;
@@ -93,10 +95,37 @@ GpsNmea::GpsNmea(QObject* parent) :
 
   _enableGpsDataProcessing = true;
 
+  latencyCount   = 0;
+  latencySum     = 0;
+  latencyMax     = 0;
+  coalescedFixes = 0;
+
+  // One allocation for all records taken at once.
+  records.reserve( 512 );
+
   resetDataObjects();
 
-  // Load desired GPS sentence identifier into the hash filter.
-  getGpsMessageKeys(gpsHash);
+  if( gpsIdTableFilled == false )
+    {
+      // Load desired GPS sentence identifier into the hash filter. That is
+      // done only once, because the sensor thread reads the table without
+      // a lock.
+      getGpsMessageKeys(gpsHash);
+
+      QHashIterator<QString, short> it(gpsHash);
+
+      while( it.hasNext() )
+        {
+          it.next();
+
+          if( gpsIdTable.insert( it.key().toLatin1(), it.value() ) == false )
+            {
+              qWarning() << "GpsNmea: Hash collision of sentence identifier" << it.key();
+            }
+        }
+
+      gpsIdTableFilled = true;
+    }
 
   // GPS fix supervision, is started after the first fix was received
   timeOutFix = new QTimer(this);
@@ -146,12 +175,12 @@ void GpsNmea::getGpsMessageKeys( QHash<QString, short>& gpsKeys)
   gpsKeys.clear();
 
   // Load all desired GPS sentence identifier into the hash table
-  gpsKeys.insert( "$GPRMC", 0);
+  gpsKeys.insert( "$GPRMC", GprmcId);
   gpsKeys.insert( "$GPGLL", 1);
-  gpsKeys.insert( "$GPGGA", 2);
+  gpsKeys.insert( "$GPGGA", GpggaId);
   gpsKeys.insert( "$GPGSA", 3);
   gpsKeys.insert( "$GPGSV", 4);
-  gpsKeys.insert( "$PGRMZ", 5);
+  gpsKeys.insert( "$PGRMZ", PgrmzId);
   gpsKeys.insert( "$PCAID", 6);
   gpsKeys.insert( "!w",     7);
   gpsKeys.insert( "$PGCS",  8);
@@ -247,43 +276,19 @@ void GpsNmea::createGpsConnection()
 
   gpsObject = serial;
 
-  connect (gpsObject, SIGNAL(newSentence(const QString&)),
-           this, SLOT(slot_sentence(const QString&)) );
-
-  // Broadcasts the new NMEA sentence
-  connect (gpsObject, SIGNAL(newSentence(const QString&)),
-           this, SIGNAL(newSentence(const QString&)) );
-
-  // Broadcasts that a new Flarm flight list is available
-  connect (gpsObject, SIGNAL(newFlarmFlightList(const QString&)),
-           this, SIGNAL(newFlarmFlightList(const QString&)) );
-
-  // Broadcasts that a new Flarm flight download info is available
-  connect (gpsObject, SIGNAL(newFlarmFlightDownloadInfo(const QString&)),
-           this, SIGNAL(newFlarmFlightDownloadInfo(const QString&)) );
-
-  // Broadcasts that a new Flarm flight download progress is available
-  connect (gpsObject, SIGNAL(newFlarmFlightDownloadProgress(const int, const int)),
-           this, SIGNAL(newFlarmFlightDownloadProgress(const int, const int)) );
-
-  // The connection to the GPS receiver or daemon has been lost
-  connect (gpsObject, SIGNAL(gpsConnectionOff()),
-           this, SLOT( _slotGpsConnectionOff()) );
-
-  // The connection to the GPS receiver or daemon has been established
-  connect (gpsObject, SIGNAL(gpsConnectionOn()),
-           this, SLOT( _slotGpsConnectionOn()) );
-
-  connect (gpsObject, SIGNAL(gpsConnectionOn()),
-           this, SLOT( _slotGpsConnectionOn()) );
+  // The GPS data and the status messages of the GPS client are queued by
+  // the GPS sensor thread as records.
+  connect (gpsObject, SIGNAL(newRecords()),
+           this, SLOT(slot_records()) );
 
 #endif
 }
 
 /**
- * Enables or disables the notifications from the GPS receiver socket. Can
- * be used to stop GPS data receiving for a certain time to prevent data loss.
- * But be careful to prevent a receiver socket buffer overflow!
+ * Enables or disables the processing of the received GPS data. Can be used
+ * to stop GPS data processing for a certain time. The GPS sensor thread
+ * keeps the data meanwhile, but be careful to prevent a receiver socket
+ * buffer overflow!
  */
 void GpsNmea::enableReceiving( bool enable )
 {
@@ -293,16 +298,10 @@ void GpsNmea::enableReceiving( bool enable )
 
 #ifndef ANDROID
 
-  if ( serial )
+  if ( serial && enable )
     {
-      QSocketNotifier* notifier = static_cast<QSocketNotifier *> (0);
-
-      notifier = serial->getDaemonNotifier();
-
-      if( notifier )
-        {
-          notifier->setEnabled( enable );
-        }
+      // Process the records queued in the meantime.
+      slot_records();
     }
 
 #endif
@@ -347,6 +346,202 @@ void GpsNmea::startGpsReceiver()
 void GpsNmea::slot_sentence(const QString& sentenceIn)
 {
   // qDebug("GpsNmea::slot_sentence: %s", sentenceIn.toLatin1().data());
+
+  // NMEA sentences contain only ASCII characters. The Latin1 conversion is
+  // the only memory allocation of the sentence parsing.
+  const QByteArray sentence = sentenceIn.toLatin1();
+
+  processSentence( sentence.constData(), sentence.size() );
+}
+
+/**
+ * This slot is called by the GpsCon object, when the GPS sensor thread has
+ * queued new records. The records are taken all at once. During a long map
+ * redraw many fixes can be queued. Only the newest fix of every fix
+ * sentence kind is applied, the older ones are logged and counted but not
+ * reported anymore. All other sentences and messages are processed in their
+ * order.
+ */
+void GpsNmea::slot_records()
+{
+#ifndef ANDROID
+
+  if( serial == 0 || _enableGpsDataProcessing == false )
+    {
+      // The records remain queued until the processing is enabled again.
+      return;
+    }
+
+  // Records queued from now on cause a new notification.
+  serial->resetRecordNotification();
+
+  records.resize( 0 );
+
+  GpsRecord record;
+
+  while( serial->takeRecord( record ) )
+    {
+      records.append( record );
+    }
+
+  // Find the newest record of every fix sentence kind, ($GPRMC, $GPGGA,
+  // $PGRMZ).
+  int newestGprmc = -1;
+  int newestGpgga = -1;
+  int newestPgrmz = -1;
+
+  for( int i = 0; i < records.size(); i++ )
+    {
+      const GpsRecord& rec = records.at(i);
+
+      if( rec.kind != GpsRecord::Sentence )
+        {
+          continue;
+        }
+
+      switch( rec.id )
+        {
+          case GprmcId:
+            newestGprmc = i;
+            break;
+          case GpggaId:
+            newestGpgga = i;
+            break;
+          case PgrmzId:
+            newestPgrmz = i;
+            break;
+          default:
+            break;
+        }
+    }
+
+  const bool hasReceivers = receivers( SIGNAL(newSentence(const QString&)) ) > 0;
+
+  for( int i = 0; i < records.size(); i++ )
+    {
+      const GpsRecord& rec = records.at(i);
+
+      switch( rec.kind )
+        {
+          case GpsRecord::Sentence:
+            {
+              bool coalesced = false;
+
+              if( rec.id == GprmcId || rec.id == GpggaId || rec.id == PgrmzId )
+                {
+                  const int newest = ( rec.id == GprmcId ) ? newestGprmc :
+                                     ( rec.id == GpggaId ) ? newestGpgga : newestPgrmz;
+
+                  coalesced = ( newest != i );
+                }
+
+              if( hasReceivers )
+                {
+                  // Broadcasts the new NMEA sentence
+                  emit newSentence( QString::fromLatin1( rec.text, rec.length ) );
+                }
+
+              processSentence( rec.text, rec.length, &rec, coalesced );
+
+              if( coalesced )
+                {
+                  coalescedFixes++;
+                }
+              else if( rec.id == GprmcId || rec.id == GpggaId )
+                {
+                  // Time between the reading from the socket and the
+                  // applying of the position fix.
+                  int latency = static_cast<int> (QDateTime::currentMSecsSinceEpoch() - rec.received);
+
+                  latencyCount++;
+                  latencySum += latency;
+                  latencyMax  = qMax( latencyMax, latency );
+
+                  // if( (latencyCount % 600) == 0 )
+                  //   {
+                  //     qDebug() << "GpsNmea: fixes" << latencyCount
+                  //              << "mean latency" << (latencySum / latencyCount) << "ms"
+                  //              << "max" << latencyMax << "ms"
+                  //              << "superseded" << coalescedFixes;
+                  //   }
+                }
+
+              break;
+            }
+
+          case GpsRecord::ConnectionOff:
+
+            qDebug( "GpsNmea: GPS connection off" );
+            _slotGpsConnectionOff();
+            break;
+
+          case GpsRecord::ConnectionOn:
+
+            qDebug( "GpsNmea: GPS connection on" );
+            _slotGpsConnectionOn();
+            break;
+
+          case GpsRecord::FlarmFlightList:
+
+            // A Flarm flight list was received.
+            emit newFlarmFlightList( QString::fromLatin1( rec.text, rec.length ) );
+            break;
+
+          case GpsRecord::FlarmDownloadInfo:
+
+            // A Flarm download flight info was received.
+            emit newFlarmFlightDownloadInfo( QString::fromLatin1( rec.text, rec.length ) );
+            break;
+
+          case GpsRecord::FlarmDownloadProgress:
+            {
+              // A Flarm download progress info was received.
+              QStringList args = QString::fromLatin1( rec.text, rec.length ).split(",");
+
+              if( args.size() == 2 )
+                {
+                  emit newFlarmFlightDownloadProgress( args[0].toInt(), args[1].toInt() );
+                }
+
+              break;
+            }
+
+          default:
+            break;
+        }
+    }
+
+#endif
+}
+
+/**
+ * This method is called by the GPS sensor thread. It must not touch any
+ * member of the GpsNmea instance.
+ */
+void GpsNmea::decodeRecord( GpsRecord& record )
+{
+  record.id    = -1;
+  record.flags = 0;
+
+  NmeaTokenizer slst;
+
+  if( slst.tokenize( record.text, record.length ) == false )
+    {
+      // The sentence is reported by the GUI thread.
+      return;
+    }
+
+  // The identifier table is only read after its initialization.
+  record.id = gpsIdTable.find( slst[0] );
+
+  decodeFix( slst, record );
+}
+
+void GpsNmea::processSentence( const char* sentence,
+                               const int length,
+                               const GpsRecord* record,
+                               const bool coalesced )
+{
   if( flarmNmeaOutInitDone == false )
     {
       flarmNmeaOutInitDone = true;
@@ -361,10 +556,10 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
   if( nmeaLogFile && nmeaLogFile->isOpen() )
     {
       // Write sentence into log file
-      nmeaLogFile->write(sentenceIn.toLatin1().data());
+      nmeaLogFile->write( sentence, length );
     }
 
-  if( sentenceIn.isEmpty() )
+  if( length == 0 )
     {
       return;
     }
@@ -379,15 +574,27 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
     }
 
   // Split sentence in single parts for each comma and the checksum. The first
-  // part will contain the identifier, the rest the arguments.
-  QStringList slst = sentenceIn.split( QRegExp("[,*]"), QString::KeepEmptyParts );
+  // part will contain the identifier, the rest the arguments. The parts
+  // refer to the sentence buffer, they are not copied.
+  NmeaTokenizer slst;
+
+  if( slst.tokenize( sentence, length ) == false )
+    {
+      qWarning() << "GpsNmea::processSentence: Invalid sentence"
+                 << QByteArray( sentence, length );
+      return;
+    }
+
+  const short id = gpsIdTable.find( slst[0] );
 
-  if( ! gpsHash.contains(slst[0]) )
+  if( id < 0 )
     {
-      if( ! reportedUnknownKeys.contains(slst[0]) )
+      const QString key = slst[0].toString();
+
+      if( ! reportedUnknownKeys.contains(key) )
         {
-          qWarning() << "GpsNmea::slot_sentence: No Id found for" << slst[0];
-          reportedUnknownKeys.insert(slst[0]);
+          qWarning() << "GpsNmea::processSentence: No Id found for" << key;
+          reportedUnknownKeys.insert(key);
         }
 
       return;
@@ -397,7 +604,7 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 
 #ifdef FLARM
 
-  if( slst[0] == "$PFLAA" )
+  if( id == 20 ) // $PFLAA
     {
       // PFLAA receiving starts
       pflaaIsReceiving = true;
@@ -533,16 +740,29 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 //aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa
 #endif
 
+  if( coalesced )
+    {
+      // A newer fix sentence of the same kind is already available.
+      return;
+    }
+
+  if( record != 0 && (record->flags & GpsRecord::Decoded) )
+    {
+      // The fix sentence was already decoded by the GPS sensor thread.
+      applyFix( *record );
+      return;
+    }
+
   // Call the decode methods for the known sentences
-  switch( gpsHash.value( slst[0] ) )
+  switch( id )
   {
-    case 0: // GPRMC
+    case GprmcId: // GPRMC
       __ExtractGprmc( slst );
       return;
     case 1: // GPGLL
       __ExtractGpgll( slst );
       return;
-    case 2: // GPGGA
+    case GpggaId: // GPGGA
       __ExtractGpgga( slst );
       return;
     case 3: // GPGSA
@@ -551,7 +771,7 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
     case 4: // GPGSV
       __ExtractSatsInView( slst );
       return;
-    case 5: // PGRMZ
+    case PgrmzId: // PGRMZ
       __ExtractPgrmz( slst );
       return;
     case 6: // PCAID
@@ -619,13 +839,13 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 #ifdef MAEMO5
 
     case 40:
-      // Handle sentences created by GPS Maemo Client process. These sentenceIns
+      // Handle sentences created by GPS Maemo Client process. These sentences
       // contain no checksum items.
       __ExtractMaemo0( slst );
       return;
 
     case 41:
-      // Handle sentences created by GPS Maemo Client process. These sentenceIns
+      // Handle sentences created by GPS Maemo Client process. These sentences
       // contain no checksum items.
       __ExtractMaemo1( slst );
       return;
@@ -634,7 +854,7 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
 
     default:
 
-      qWarning() << "Unknown GPS sentence:" << sentenceIn;
+      qWarning() << "Unknown GPS sentence:" << QByteArray( sentence, length );
       return;
   }
 }
@@ -667,26 +887,55 @@ void GpsNmea::slot_sentence(const QString& sentenceIn)
    12) Signal integrity, A=Autonomous mode
    13) Checksum, hh
 */
-void GpsNmea::__ExtractGprmc( const QStringList& slst )
+void GpsNmea::__ExtractGprmc( const NmeaTokenizer& slst )
+{
+  GpsRecord record;
+  record.id    = GprmcId;
+  record.flags = 0;
+
+  decodeFix( slst, record );
+  applyFix( record );
+}
+
+void GpsNmea::applyGprmc( const GpsRecord& record )
 {
-  if( slst.size() < 10 )
+  _gprmcSeen = true;
+
+  QTime time;
+  QDate date;
+
+  if( record.flags & GpsRecord::HasTime )
     {
-      qWarning( "$GPRMC contains too less parameters!" );
-      return;
+      time = QTime( 0, 0 ).addMSecs( record.msecOfDay );
+      _lastTime = time;
     }
 
-  _gprmcSeen = true;
+  if( record.flags & GpsRecord::HasDate )
+    {
+      date = QDate::fromJulianDay( record.julianDay );
+      _lastDate = date;
+    }
 
-  //qDebug("%s",slst[2].toLatin1().data());
-  if( slst[2] == "A" )
+  if( record.flags & GpsRecord::FixValid )
     { /* Data status A=OK, V=warning */
       fixOK( "RMC" );
 
-      __ExtractTime(slst[1]);
-      __ExtractDate(slst[9]);
-      __ExtractKnotSpeed(slst[7]);
-      __ExtractCoord(slst[3],slst[4],slst[5],slst[6]);
-      __ExtractHeading(slst[8]);
+      if( record.flags & GpsRecord::HasSpeed )
+        {
+          Speed speed;
+          speed.setKnot( record.speed );
+          setSpeed( speed );
+        }
+
+      if( record.flags & GpsRecord::HasCoord )
+        {
+          setCoord( QPoint( record.latitude, record.longitude ) );
+        }
+
+      if( record.flags & GpsRecord::HasHeading )
+        {
+          setHeading( record.heading );
+        }
 
       if( _lastTime.isValid() && _lastDate.isValid() )
         {
@@ -723,9 +972,6 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
     {
       fixNOK( "RMC" );
 
-      QTime time = __ExtractTime( slst[1] );
-      QDate date = __ExtractDate( slst[9] );
-
       if( time.isValid() && date.isValid() )
         {
           QDateTime utc( _lastDate, _lastTime, Qt::UTC );
@@ -755,7 +1001,7 @@ void GpsNmea::__ExtractGprmc( const QStringList& slst )
     6) Status A - Data Valid, V - Data Invalid
     7) Checksum
 */
-void GpsNmea::__ExtractGpgll( const QStringList& slst )
+void GpsNmea::__ExtractGpgll( const NmeaTokenizer& slst )
 {
   if ( slst.size() < 7 )
     {
@@ -806,15 +1052,19 @@ void GpsNmea::__ExtractGpgll( const QStringList& slst )
    14) Differential reference station ID, 0000-1023
    15) Checksum
 */
-void GpsNmea::__ExtractGpgga( const QStringList& slst )
+void GpsNmea::__ExtractGpgga( const NmeaTokenizer& slst )
 {
-  if ( slst.size() < 15 )
-    {
-      qWarning("$GPGGA contains too less parameters!");
-      return;
-    }
+  GpsRecord record;
+  record.id    = GpggaId;
+  record.flags = 0;
 
-  if ( slst[6] != "0" && ! slst[6].isEmpty() )
+  decodeFix( slst, record );
+  applyFix( record );
+}
+
+void GpsNmea::applyGpgga( const GpsRecord& record )
+{
+  if( record.flags & GpsRecord::FixValid )
     {
       /*a value of 0 means invalid fix and we don't need that one */
       if( _gprmcSeen == false )
@@ -824,12 +1074,38 @@ void GpsNmea::__ExtractGpgga( const QStringList& slst )
           fixOK( "GGA" );
         }
 
-      __ExtractTime(slst[1]);
-      __ExtractCoord(slst[2],slst[3],slst[4],slst[5]);
-      __ExtractAltitude(slst[9],slst[10]);
-      __ExtractSatsInView(slst[7]);
+      if( record.flags & GpsRecord::HasTime )
+        {
+          _lastTime = QTime( 0, 0 ).addMSecs( record.msecOfDay );
+        }
+
+      if( record.flags & GpsRecord::HasCoord )
+        {
+          setCoord( QPoint( record.latitude, record.longitude ) );
+        }
+
+      if( record.flags & GpsRecord::HasAltitude )
+        {
+          Altitude altitude;
+
+          if( record.flags & GpsRecord::AltitudeInFeet )
+            {
+              altitude.setFeet( record.altitude );
+            }
+          else
+            {
+              altitude.setMeters( record.altitude );
+            }
+
+          setAltitude( altitude );
+        }
+
+      if( record.flags & GpsRecord::HasSatCount )
+        {
+          setSatsInView( record.satsInView );
+        }
     }
-  else if( slst[6] == "0" )
+  else if( record.flags & GpsRecord::FixInvalid )
     {
       if( _gprmcSeen == false )
         {
@@ -847,57 +1123,268 @@ void GpsNmea::__ExtractGpgga( const QStringList& slst )
          3            Position fix dimensions 2 = FLARM barometric altitude
                                               3 = GPS altitude
 */
-void GpsNmea::__ExtractPgrmz( const QStringList& slst )
+void GpsNmea::__ExtractPgrmz( const NmeaTokenizer& slst )
+{
+  GpsRecord record;
+  record.id    = PgrmzId;
+  record.flags = 0;
+
+  decodeFix( slst, record );
+  applyFix( record );
+}
+
+void GpsNmea::applyPgrmz( const GpsRecord& record )
 {
-  if ( slst.size() < 4 )
+  if( ! (record.flags & GpsRecord::HasAltitude) )
     {
-      qWarning("$PGRMZ contains too less parameters!");
       return;
     }
 
-  /* Garmin proprietary sentence with altitude information */
-  if ( slst[3] == "2" ) // pressure altitude
+  Altitude altitude;
+
+  if( record.flags & GpsRecord::AltitudeInFeet )
     {
-      bool ok;
-      double num = slst[1].toDouble( &ok );
+      altitude.setFeet( record.altitude );
+    }
+  else
+    {
+      altitude.setMeters( record.altitude );
+    }
 
-      if( ok )
+  if( record.flags & GpsRecord::PressureAltitude )
+    {
+      setPressureAltitude( altitude );
+    }
+  else
+    {
+      // 3=GPS altitude
+      setAltitude( altitude );
+    }
+}
+
+/** Stores the pressure altitude and reports a change. */
+void GpsNmea::setPressureAltitude( const Altitude& altitude )
+{
+  _baroAltitudeSeen = true;
+
+  if( _lastPressureAltitude != altitude || _reportAltitude == true )
+    {
+      _reportAltitude = false;
+
+      // If we have pressure altitude, the barometer sensor is
+      // normally calibrated to 1013.25hPa and that is the standard
+      // pressure altitude.
+      _lastPressureAltitude = altitude;
+      _lastStdAltitude = altitude;
+
+      if( _userExpectedAltitude == GpsNmea::PRESSURE )
         {
-          _baroAltitudeSeen = true;
+          // Set these altitude too, when pressure is selected.
+          _lastMslAltitude.setMeters( altitude.getMeters() + _userAltitudeCorrection.getMeters() );
 
-          Altitude altitude;
+          // report new pressure altitude
+          emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+        }
+    }
+}
 
-          altitude.setFeet( num );
+/**
+ * Decodes the fix sentences $GPRMC, $GPGGA and $PGRMZ into the fix part of
+ * the record. The sentence identifier must be set in the record. This method
+ * is thread safe, it does not touch any member.
+ */
+void GpsNmea::decodeFix( const NmeaTokenizer& slst, GpsRecord& record )
+{
+  bool ok;
 
-          if( _lastPressureAltitude != altitude || _reportAltitude == true )
+  switch( record.id )
+    {
+      case GprmcId: // GPRMC
+        {
+          if( slst.size() < 10 )
             {
-              _reportAltitude = false;
+              qWarning( "$GPRMC contains too less parameters!" );
+              return;
+            }
 
-              // If we have pressure altitude, the barometer sensor is
-              // normally calibrated to 1013.25hPa and that is the standard
-              // pressure altitude.
-              _lastPressureAltitude = altitude;
-              _lastStdAltitude = altitude;
+          record.flags = GpsRecord::Decoded;
+          record.flags |= ( slst[2] == "A" ) ? GpsRecord::FixValid : GpsRecord::FixInvalid;
 
-              if( _userExpectedAltitude == GpsNmea::PRESSURE )
-                {
-                  // Set these altitude too, when pressure is selected.
-                  _lastMslAltitude.setMeters( altitude.getMeters() + _userAltitudeCorrection.getMeters() );
+          QTime time = decodeTime( slst[1] );
 
-                  // report new pressure altitude
-                  emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
+          if( time.isValid() )
+            {
+              record.flags |= GpsRecord::HasTime;
+              record.msecOfDay = QTime( 0, 0 ).msecsTo( time );
+            }
+
+          QDate date = decodeDate( slst[9] );
+
+          if( date.isValid() )
+            {
+              record.flags |= GpsRecord::HasDate;
+              record.julianDay = date.toJulianDay();
+            }
+
+          if( (record.flags & GpsRecord::FixValid) == 0 )
+            {
+              // Only date and time are used from an invalid fix.
+              return;
+            }
+
+          record.speed = slst[7].toDouble( &ok );
+
+          if( ok )
+            {
+              record.flags |= GpsRecord::HasSpeed;
+            }
+
+          QPoint coord;
+
+          if( decodeCoord( slst[3], slst[4], slst[5], slst[6], coord ) )
+            {
+              record.flags |= GpsRecord::HasCoord;
+              record.latitude  = coord.x();
+              record.longitude = coord.y();
+            }
+
+          record.heading = slst[8].toDouble( &ok );
+
+          if( ok )
+            {
+              record.flags |= GpsRecord::HasHeading;
+            }
+
+          return;
+        }
+
+      case GpggaId: // GPGGA
+        {
+          if( slst.size() < 15 )
+            {
+              qWarning( "$GPGGA contains too less parameters!" );
+              return;
+            }
+
+          record.flags = GpsRecord::Decoded;
+
+          if( slst[6] == "0" )
+            {
+              record.flags |= GpsRecord::FixInvalid;
+              return;
+            }
+
+          if( slst[6].isEmpty() )
+            {
+              return;
+            }
+
+          record.flags |= GpsRecord::FixValid;
+
+          QTime time = decodeTime( slst[1] );
+
+          if( time.isValid() )
+            {
+              record.flags |= GpsRecord::HasTime;
+              record.msecOfDay = QTime( 0, 0 ).msecsTo( time );
+            }
+
+          QPoint coord;
+
+          if( decodeCoord( slst[2], slst[3], slst[4], slst[5], coord ) )
+            {
+              record.flags |= GpsRecord::HasCoord;
+              record.latitude  = coord.x();
+              record.longitude = coord.y();
+            }
+
+          record.altitude = slst[9].toDouble( &ok );
+
+          if( ok )
+            {
+              record.flags |= GpsRecord::HasAltitude;
+
+              if( slst[10] == "F" || slst[10] == "f" )
+                {
+                  record.flags |= GpsRecord::AltitudeInFeet;
                 }
             }
-          }
 
+          record.satsInView = slst[7].toInt( &ok );
+
+          if( ok )
+            {
+              record.flags |= GpsRecord::HasSatCount;
+            }
+
+          return;
+        }
+
+      case PgrmzId: // PGRMZ
+        {
+          if( slst.size() < 4 )
+            {
+              qWarning( "$PGRMZ contains too less parameters!" );
+              return;
+            }
+
+          record.flags = GpsRecord::Decoded;
+
+          if( slst[3] != "2" && slst[3] != "3" )
+            {
+              return;
+            }
+
+          record.altitude = slst[1].toDouble( &ok );
+
+          if( ok == false )
+            {
+              return;
+            }
+
+          record.flags |= GpsRecord::HasAltitude;
+
+          if( slst[3] == "2" )
+            {
+              // pressure altitude, always in feet
+              record.flags |= GpsRecord::PressureAltitude | GpsRecord::AltitudeInFeet;
+            }
+          else if( slst[2] == "F" || slst[2] == "f" )
+            {
+              record.flags |= GpsRecord::AltitudeInFeet;
+            }
+
+          return;
+        }
+
+      default:
         return;
-      }
+    }
+}
 
-  if ( slst[3] == "3" ) // 3=GPS altitude
+/** Applies the decoded fix part of a record. */
+void GpsNmea::applyFix( const GpsRecord& record )
+{
+  if( (record.flags & GpsRecord::Decoded) == 0 )
     {
-      __ExtractAltitude(slst[1], slst[2]);
+      // Too less parameters, already reported by the decoding.
       return;
     }
+
+  switch( record.id )
+    {
+      case GprmcId: // GPRMC
+        applyGprmc( record );
+        break;
+      case GpggaId: // GPGGA
+        applyGpgga( record );
+        break;
+      case PgrmzId: // PGRMZ
+        applyPgrmz( record );
+        break;
+      default:
+        break;
+    }
 }
 
 /**
@@ -912,7 +1399,7 @@ void GpsNmea::__ExtractPgrmz( const QStringList& slst )
   <4>     Log Flags
   *hh     Checksum, XOR of all bytes of the sentence after the `$' and before the '!'
 */
-void GpsNmea::__ExtractPcaid( const QStringList& slst )
+void GpsNmea::__ExtractPcaid( const NmeaTokenizer& slst )
 {
   if ( slst.size() < 5 )
     {
@@ -951,7 +1438,7 @@ void GpsNmea::__ExtractPcaid( const QStringList& slst )
   5  - 03 - reserved for further use?
   CS - 1F - checksum of total sentence
 */
-void GpsNmea::__ExtractPgcs( const QStringList& slst )
+void GpsNmea::__ExtractPgcs( const NmeaTokenizer& slst )
 {
   if ( slst.size() < 6 )
     {
@@ -1002,7 +1489,7 @@ void GpsNmea::__ExtractPgcs( const QStringList& slst )
   $PFLAU,<RX>,<TX>,<GPS>,<Power>,<AlarmLevel>,<RelativeBearing>,<AlarmType>,
   <RelativeVertical>,<RelativeDistance>,<ID>
   */
-void GpsNmea::__ExtractPflau( const QStringList& slst )
+void GpsNmea::__ExtractPflau( const NmeaTokenizer& slst )
 {
   bool res = Flarm::instance()->extractPflau( slst );
 
@@ -1065,7 +1552,7 @@ void GpsNmea::__ExtractPflau( const QStringList& slst )
       ...
   9) Checksum
 */
-void GpsNmea::__ExtractGpdtm( const QStringList& slst )
+void GpsNmea::__ExtractGpdtm( const NmeaTokenizer& slst )
 {
   if ( slst.size() < 9 )
     {
@@ -1073,7 +1560,7 @@ void GpsNmea::__ExtractGpdtm( const QStringList& slst )
       return;
     }
 
-  _mapDatum = slst[8];
+  _mapDatum = slst[8].toString();
 }
 
 /**
@@ -1117,7 +1604,7 @@ Altitude GpsNmea::getLastAltitude() const
 
   Extracts wind, QNH and vario data from Cambridge's !w sentence.
 */
-void GpsNmea::__ExtractCambridgeW( const QStringList& stringList )
+void GpsNmea::__ExtractCambridgeW( const NmeaTokenizer& stringList )
 {
   bool ok, ok1;
   Speed speed(0);
@@ -1240,7 +1727,7 @@ void GpsNmea::__ExtractCambridgeW( const QStringList& stringList )
     CS - checksum of total sentence
 */
 
-void GpsNmea::__ExtractLxwp0( const QStringList& stringList )
+void GpsNmea::__ExtractLxwp0( const NmeaTokenizer& stringList )
 {
   bool ok, ok1;
   Speed speed(0);
@@ -1365,7 +1852,7 @@ void GpsNmea::__ExtractLxwp0( const QStringList& stringList )
 
    Extracts McCready data from LX Navigation $LXWP2 sentence.
 */
-void GpsNmea::__ExtractLxwp2( const QStringList& stringList )
+void GpsNmea::__ExtractLxwp2( const NmeaTokenizer& stringList )
 {
   bool ok;
   Speed speed(0);
@@ -1394,7 +1881,22 @@ void GpsNmea::__ExtractLxwp2( const QStringList& stringList )
 /**
  * This function returns a QTime from the time encoded in a MNEA sentence.
  */
-QTime GpsNmea::__ExtractTime(const QString& timeString)
+QTime GpsNmea::__ExtractTime(const NmeaField& timeString)
+{
+  QTime res = decodeTime( timeString );
+
+  if( res.isValid() )
+    {
+      _lastTime = res;
+    }
+
+  return res;
+}
+
+/**
+ * This function decodes the time of a NMEA sentence. It is thread safe.
+ */
+QTime GpsNmea::decodeTime(const NmeaField& timeString)
 {
   if( timeString.isEmpty() && timeString.size() < 6 )
     {
@@ -1402,9 +1904,9 @@ QTime GpsNmea::__ExtractTime(const QString& timeString)
       return QTime();
     }
 
-  QString hh (timeString.left(2));
-  QString mm (timeString.mid(2,2));
-  QString ss (timeString.mid(4,2));
+  NmeaField hh (timeString.left(2));
+  NmeaField mm (timeString.mid(2,2));
+  NmeaField ss (timeString.mid(4,2));
 
   // @AP: newer CF Cards can also provide milliseconds. In this case the time
   // format is defined as hhmmss.sss. But we will not use it to avoid problems
@@ -1414,19 +1916,32 @@ QTime GpsNmea::__ExtractTime(const QString& timeString)
   // @AP: don't overtake invalid times. They will cause invalid fixes!
   if ( ! res.isValid() )
     {
-      qWarning("GpsNmea::__ExtractTime(): Invalid time %s! Ignoring it (%s, %d)",
+      qWarning("GpsNmea::decodeTime(): Invalid time %s! Ignoring it (%s, %d)",
                timeString.toLatin1().data(), __FILE__, __LINE__ );
       return QTime();
     }
 
-  _lastTime = res;
-
   return res;
 }
 
 /** This function returns a QDate from the date string encoded in a
     NWEA sentence as "ddmmyy". */
-QDate GpsNmea::__ExtractDate(const QString& dateString)
+QDate GpsNmea::__ExtractDate(const NmeaField& dateString)
+{
+  QDate res = decodeDate( dateString );
+
+  if( res.isValid() )
+    {
+      _lastDate = res;
+    }
+
+  return res;
+}
+
+/**
+ * This function decodes the date of a NMEA sentence. It is thread safe.
+ */
+QDate GpsNmea::decodeDate(const NmeaField& dateString)
 {
   if( dateString.isEmpty() && dateString.size() != 6 )
     {
@@ -1434,9 +1949,9 @@ QDate GpsNmea::__ExtractDate(const QString& dateString)
       return QDate();
     }
 
-  QString dd (dateString.left(2));
-  QString mm (dateString.mid(2,2));
-  QString yy (dateString.right(2));
+  NmeaField dd (dateString.left(2));
+  NmeaField mm (dateString.mid(2,2));
+  NmeaField yy (dateString.right(2));
 
   /*we assume that we only use this after the year 2000, which is
     reasonable since this is made 2002 ...*/
@@ -1446,21 +1961,18 @@ QDate GpsNmea::__ExtractDate(const QString& dateString)
   QDate res (yy.toInt(&ok1) + 2000, mm.toInt(&ok2), dd.toInt(&ok3) );
 
   // @AP: don't take over invalid dates
-  if ( ok1 && ok2 && ok3 && res.isValid() )
-    {
-      _lastDate = res;
-    }
-  else
+  if ( ! (ok1 && ok2 && ok3 && res.isValid()) )
     {
-      qWarning("GpsNmea::__ExtractDate(): Invalid date %s! Ignoring it (%s, %d)",
+      qWarning("GpsNmea::decodeDate(): Invalid date %s! Ignoring it (%s, %d)",
                dateString.toLatin1().data(), __FILE__, __LINE__ );
+      return QDate();
     }
 
   return res;
 }
 
 /** This function returns a Speed from the speed encoded in knots */
-Speed GpsNmea::__ExtractKnotSpeed(const QString& speedString)
+Speed GpsNmea::__ExtractKnotSpeed(const NmeaField& speedString)
 {
   Speed res;
 
@@ -1479,18 +1991,53 @@ Speed GpsNmea::__ExtractKnotSpeed(const QString& speedString)
 
   res.setKnot( speed );
 
-  if( res != _lastSpeed )
+  setSpeed( res );
+
+  return res;
+}
+
+/** Stores the speed and reports a change. */
+void GpsNmea::setSpeed(const Speed& speed)
+{
+  if( speed != _lastSpeed )
     {
-      _lastSpeed = res;
+      _lastSpeed = speed;
       emit newSpeed( _lastSpeed );
     }
-
-  return res;
 }
 
 /** This function converts the coordinate data from the NMEA sentence to the internal QPoint format. */
-QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
-                               const QString& slon, const QString& slonEW)
+QPoint GpsNmea::__ExtractCoord(const NmeaField& slat, const NmeaField& slatNS,
+                               const NmeaField& slon, const NmeaField& slonEW)
+{
+  QPoint res;
+
+  if( decodeCoord( slat, slatNS, slon, slonEW, res ) == false )
+    {
+      return QPoint();
+    }
+
+  setCoord( res );
+
+  return _lastCoord;
+}
+
+/** Stores the coordinate and reports a change. */
+void GpsNmea::setCoord(const QPoint& coord)
+{
+  if ( _lastCoord != coord )
+    {
+      _lastCoord = coord;
+      emit newPosition( _lastCoord );
+    }
+}
+
+/**
+ * This function decodes the coordinate of a NMEA sentence. It is thread safe.
+ */
+bool GpsNmea::decodeCoord(const NmeaField& slat, const NmeaField& slatNS,
+                          const NmeaField& slon, const NmeaField& slonEW,
+                          QPoint& coord)
 {
   /* The internal KFLog format for coordinates represents coordinates in 10.000'st of a minute.
      So, one minute corresponds to 10.000, one degree to 600.000 and one second to 167.
@@ -1500,7 +2047,7 @@ QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
   if( slat.isEmpty() || slatNS.isEmpty() ||
       slon.isEmpty() || slonEW.isEmpty() )
       {
-        return QPoint();
+        return false;
       }
 
   int lat = 0;
@@ -1521,7 +2068,7 @@ QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
 
   if( !ok1 || !ok2 || !ok3 || !ok4 )
     {
-      return QPoint();
+      return false;
     }
 
   // qDebug ("slon: %s", slon.toLatin1().data());
@@ -1546,22 +2093,14 @@ QPoint GpsNmea::__ExtractCoord(const QString& slat, const QString& slatNS,
       lonTemp = -lonTemp;
     }
 
-  QPoint res (latTemp, lonTemp);
+  coord = QPoint( latTemp, lonTemp );
 
-  if ( _lastCoord != res )
-    {
-      _lastCoord=res;
-      emit newPosition( _lastCoord );
-    }
-
-  return _lastCoord;
+  return true;
 }
 
 /** Extract the heading from the NMEA sentence. */
-double GpsNmea::__ExtractHeading(const QString& headingstring)
+double GpsNmea::__ExtractHeading(const NmeaField& headingstring)
 {
-  static uint report = 0;
-
   if( headingstring.isEmpty() )
     {
       return 0.0;
@@ -1576,19 +2115,27 @@ double GpsNmea::__ExtractHeading(const QString& headingstring)
       return 0.0;
     }
 
+  setHeading( heading );
+
+  return heading;
+}
+
+/** Stores the heading and reports it. */
+void GpsNmea::setHeading(const double heading)
+{
+  static uint report = 0;
+
   if ( heading != _lastHeading || (++report % 5) == 0 )
     {
       _lastHeading = heading;
       emit newHeading( _lastHeading );
     }
-
-  return heading;
 }
 
 /**
  * Extracts the altitude from a NMEA GGA sentence.
  */
-Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& unit )
+Altitude GpsNmea::__ExtractAltitude( const NmeaField& altitude, const NmeaField& unit )
 {
   // qDebug("alt=%s, unit=%s", altitude.toLatin1().data(), unitAlt.toLatin1().data() );
   bool ok;
@@ -1603,7 +2150,7 @@ Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& uni
 
   // Check for other unit as meters, meters is the default.
   // Consider user's altitude correction
-  if ( unit.toLower() == "f" )
+  if ( unit == "F" || unit == "f" )
     {
       res.setFeet( alt );
     }
@@ -1612,11 +2159,19 @@ Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& uni
       res.setMeters( alt );
     }
 
+  setAltitude( res );
+
+  return res + _userAltitudeCorrection;
+}
+
+/** Stores the GPS altitude and reports it. */
+void GpsNmea::setAltitude(const Altitude& altitude)
+{
   // The GNNS altitude is never modified.
-  _lastGNSSAltitude = res;
+  _lastGNSSAltitude = altitude;
 
   // Apply the user's set altitude correction
-  res = res + _userAltitudeCorrection;
+  Altitude res = altitude + _userAltitudeCorrection;
 
   if( ( _lastMslAltitude != res || _reportAltitude == true ) &&
       _userExpectedAltitude != GpsNmea::PRESSURE )
@@ -1628,8 +2183,6 @@ Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& uni
     }
 
   emit newAltitude( _lastMslAltitude, _lastStdAltitude, _lastGNSSAltitude );
-
-  return res;
 }
 
 /**
@@ -1653,7 +2206,7 @@ Altitude GpsNmea::__ExtractAltitude( const QString& altitude, const QString& uni
 
   Extracts the constellation from the NMEA sentence.
 */
-QString GpsNmea::__ExtractConstellation(const QStringList& sentence)
+QString GpsNmea::__ExtractConstellation(const NmeaTokenizer& sentence)
 {
   if ( sentence.size() < 18 )
     {
@@ -1732,7 +2285,7 @@ QString GpsNmea::__ExtractConstellation(const QStringList& sentence)
 }
 
 /** Extracts the satellite count in view from the NMEA sentence. */
-bool GpsNmea::__ExtractSatsInView(const QString& satcount)
+bool GpsNmea::__ExtractSatsInView(const NmeaField& satcount)
 {
   bool ok;
 
@@ -1743,13 +2296,19 @@ bool GpsNmea::__ExtractSatsInView(const QString& satcount)
       return false;
     }
 
-  if( ok && count != _lastSatInfo.satsInView )
+  setSatsInView( count );
+
+  return true;
+}
+
+/** Stores the satellites in view and reports a change. */
+void GpsNmea::setSatsInView(const int count)
+{
+  if( count != _lastSatInfo.satsInView )
     {
       _lastSatInfo.satsInView = count;
       emit newSatCount( _lastSatInfo );
     }
-
-  return true;
 }
 
 #ifdef MAEMO5
@@ -1758,7 +2317,7 @@ bool GpsNmea::__ExtractSatsInView(const QString& satcount)
  * Extract proprietary sentence $MAEMO0. It is created by the GPS Maemo Client
  * and not all positions are always set. In such a case they are empty.
  */
-void GpsNmea::__ExtractMaemo0(const QStringList& slist)
+void GpsNmea::__ExtractMaemo0(const NmeaTokenizer& slist)
 {
   /**
    * Definition of proprietary sentence $MAEMO0.
@@ -1922,7 +2481,7 @@ void GpsNmea::__ExtractMaemo0(const QStringList& slist)
 /**
  * Extract proprietary sentence $MAEMO1.
  */
-void GpsNmea::__ExtractMaemo1(const QStringList& slist)
+void GpsNmea::__ExtractMaemo1(const NmeaTokenizer& slist)
 {
   /**
    * Definition of proprietary sentence $MAEMO1.
@@ -2597,7 +3156,7 @@ void GpsNmea::setSystemClock( const QDateTime& utcDt )
 
   Extract Satellites In View (SIV) info from a NMEA sentence.
 */
-void GpsNmea::__ExtractSatsInView(const QStringList& sentence)
+void GpsNmea::__ExtractSatsInView(const NmeaTokenizer& sentence)
 {
   if( sentence.size() < 8 )
     {
@@ -2648,10 +3207,10 @@ void GpsNmea::__ExtractSatsInView(const QStringList& sentence)
 }
 
 /** Extract Satellites In View (SIV) info from a NMEA sentence. */
-void GpsNmea::__ExtractSatsInView( const QString& id,
-				   const QString& elev,
-				   const QString& azimuth,
-				   const QString& snr)
+void GpsNmea::__ExtractSatsInView( const NmeaField& id,
+				   const NmeaField& elev,
+				   const NmeaField& azimuth,
+				   const NmeaField& snr)
 {
   if( id.isEmpty() || elev.isEmpty() || azimuth.isEmpty() || snr.isEmpty() )
     {
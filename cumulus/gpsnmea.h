@@ -46,9 +46,12 @@
 #include <QFile>
 #include <QSet>
 #include <QMutex>
+#include <QVector>
 
 #include "speed.h"
 #include "altitude.h"
+#include "gpsrecord.h"
+#include "nmeatokenizer.h"
 #include "wgspoint.h"
 
 #ifndef ANDROID
@@ -156,6 +159,13 @@ class GpsNmea : public QObject
      */
     enum GpsStatus { notConnected=0, noFix=1, validFix=2 };
 
+    /**
+     * Identifiers of the fix sentences in the sentence hash, see
+     * getGpsMessageKeys. These sentences are decoded already by the GPS
+     * sensor thread.
+     */
+    enum FixSentenceId { GprmcId=0, GpggaId=2, PgrmzId=5 };
+
   public:
 
     GpsNmea(QObject* parent);
@@ -414,6 +424,16 @@ class GpsNmea : public QObject
      */
     static void getGpsMessageKeys( QHash<QString, short>& gpsKeys );
 
+    /**
+     * Determines the sentence identifier of a sentence record and decodes
+     * the fix sentences $GPRMC, $GPGGA and $PGRMZ into the fix part of the
+     * record. This method is thread safe, it is called by the GPS sensor
+     * thread.
+     *
+     * @param record The sentence record to be decoded.
+     */
+    static void decodeRecord( GpsRecord& record );
+
   public slots: // Public slots
 
     /**
@@ -423,6 +443,14 @@ class GpsNmea : public QObject
      */
     void slot_sentence(const QString& sentence);
 
+    /**
+     * This slot is called by the GpsCon object, when new records from the
+     * GPS client are available. All available records are processed. Fix
+     * sentences, which are superseded by a newer one of the same kind,
+     * are only logged.
+     */
+    void slot_records();
+
     /**
      * This slot is called if the object needs to reset. It is
      * used to destroy the serial connection and create a new
@@ -603,67 +631,115 @@ class GpsNmea : public QObject
     /** write configuration data to allow restore of last fix */
     void writeConfig();
 
+    /**
+     * Processes a single sentence.
+     *
+     * @param sentence The sentence text.
+     * @param length The length of the sentence text.
+     * @param record The record of the sentence with the already decoded
+     *               fix part or null.
+     * @param coalesced If true, the sentence is superseded by a newer one
+     *                  and is not decoded.
+     */
+    void processSentence( const char* sentence,
+                          const int length,
+                          const GpsRecord* record=0,
+                          const bool coalesced=false );
+
+    /** Decodes the fix part of a record from the passed sentence parts. */
+    static void decodeFix( const NmeaTokenizer& slst, GpsRecord& record );
+
+    /** Applies the decoded fix part of a record. */
+    void applyFix( const GpsRecord& record );
+
+    /** Applies a decoded GPRMC sentence. */
+    void applyGprmc( const GpsRecord& record );
+    /** Applies a decoded GPGGA sentence. */
+    void applyGpgga( const GpsRecord& record );
+    /** Applies a decoded PGRMZ sentence. */
+    void applyPgrmz( const GpsRecord& record );
+
     /** Extracts GPRMC sentence. */
-    void __ExtractGprmc( const QStringList& slst );
+    void __ExtractGprmc( const NmeaTokenizer& slst );
     /** Extracts GPGLL sentence. */
-    void __ExtractGpgll( const QStringList& slst );
+    void __ExtractGpgll( const NmeaTokenizer& slst );
     /** Extracts GPGGA sentence. */
-    void __ExtractGpgga( const QStringList& slst );
+    void __ExtractGpgga( const NmeaTokenizer& slst );
     /** Extracts PGRMZ sentence. */
-    void __ExtractPgrmz( const QStringList& slst );
+    void __ExtractPgrmz( const NmeaTokenizer& slst );
     /** Extracts PCAID sentence. */
-    void __ExtractPcaid( const QStringList& slst );
+    void __ExtractPcaid( const NmeaTokenizer& slst );
     /** Extracts PGCS sentence. */
-    void __ExtractPgcs( const QStringList& slst );
+    void __ExtractPgcs( const NmeaTokenizer& slst );
     /** Extracts GPDTM sentence. */
-    void __ExtractGpdtm( const QStringList& slst );
+    void __ExtractGpdtm( const NmeaTokenizer& slst );
 
 #ifdef FLARM
     /** Extracts PFLAU sentence. */
-    void __ExtractPflau( const QStringList& slst );
+    void __ExtractPflau( const NmeaTokenizer& slst );
 #endif
 
     /** This function return a QTime from the time encoded in a MNEA sentence. */
-    QTime __ExtractTime(const QString& timestring);
+    QTime __ExtractTime(const NmeaField& timestring);
+    /** Decodes the time of a NMEA sentence without storing it. */
+    static QTime decodeTime(const NmeaField& timestring);
+    /** Decodes the date of a NMEA sentence without storing it. */
+    static QDate decodeDate(const NmeaField& datestring);
+    /** Decodes the coordinate of a NMEA sentence without storing it. */
+    static bool decodeCoord(const NmeaField& slat, const NmeaField& slatNS,
+                            const NmeaField& slon, const NmeaField& slonEW,
+                            QPoint& coord);
+    /** Stores the speed and reports a change. */
+    void setSpeed(const Speed& speed);
+    /** Stores the coordinate and reports a change. */
+    void setCoord(const QPoint& coord);
+    /** Stores the heading and reports it. */
+    void setHeading(const double heading);
+    /** Stores the GPS altitude and reports it. */
+    void setAltitude(const Altitude& altitude);
+    /** Stores the pressure altitude and reports a change. */
+    void setPressureAltitude(const Altitude& altitude);
+    /** Stores the satellites in view and reports a change. */
+    void setSatsInView(const int count);
     /** This function return a QDate from the date encoded in a MNEA sentence. */
-    QDate __ExtractDate(const QString& datestring);
+    QDate __ExtractDate(const NmeaField& datestring);
     /** This function return a Speed from the speed encoded in knots */
-    Speed __ExtractKnotSpeed(const QString& speedstring);
+    Speed __ExtractKnotSpeed(const NmeaField& speedstring);
     /** This function converts the coordinate data from the NMEA sentence to the internal QPoint coordinate format. */
-    QPoint __ExtractCoord(const QString& slat, const QString& slatNS, const QString& slon, const QString& slonEW);
+    QPoint __ExtractCoord(const NmeaField& slat, const NmeaField& slatNS, const NmeaField& slon, const NmeaField& slonEW);
     /** Extract the heading from the NMEA sentence. */
-    double __ExtractHeading(const QString& headingstring);
+    double __ExtractHeading(const NmeaField& headingstring);
     /** Extracts the altitude from a NMEA GGA or Gramin/Flarm PGRMZ sentence */
-    Altitude __ExtractAltitude(const QString& altitude, const QString& unit);
+    Altitude __ExtractAltitude(const NmeaField& altitude, const NmeaField& unit);
     /** Extracts the constellation from the NMEA sentence. */
-    QString __ExtractConstellation(const QStringList& sentence);
+    QString __ExtractConstellation(const NmeaTokenizer& sentence);
     /** Extracts the satellites in view from the NMEA sentence. */
-    bool __ExtractSatsInView(const QString& satcount);
+    bool __ExtractSatsInView(const NmeaField& satcount);
     /** Extracts satellites In View (SIV) info from a NMEA sentence. */
-    void __ExtractSatsInView(const QStringList& sentence);
+    void __ExtractSatsInView(const NmeaTokenizer& sentence);
     /** Extracts satellites In View (SIV) info from a NMEA sentence. */
-    void __ExtractSatsInView(const QString&, const QString&, const QString&, const QString&);
+    void __ExtractSatsInView(const NmeaField&, const NmeaField&, const NmeaField&, const NmeaField&);
     /** Extracts wind, QNH and vario data from Cambridge's !w sentence. */
-    void __ExtractCambridgeW(const QStringList& stringList);
+    void __ExtractCambridgeW(const NmeaTokenizer& stringList);
     /**
      * Extracts speed, altitude, vario, heading, wind data from LX Navigation $LXWP0
      * sentence.
      */
-    void __ExtractLxwp0(const QStringList& stringList);
+    void __ExtractLxwp0(const NmeaTokenizer& stringList);
     /**
      * Extracts McCready data from LX Navigation $LXWP2 sentence.
      */
-    void __ExtractLxwp2(const QStringList& stringList);
+    void __ExtractLxwp2(const NmeaTokenizer& stringList);
 
 #ifdef MAEMO
     /**
      * Extract proprietary sentence $MAEMO0.
      */
-    void __ExtractMaemo0(const QStringList& stringList);
+    void __ExtractMaemo0(const NmeaTokenizer& stringList);
     /**
      * Extract proprietary sentence $MAEMO1.
      */
-    void __ExtractMaemo1(const QStringList& stringList);
+    void __ExtractMaemo1(const NmeaTokenizer& stringList);
 #endif
 
     /** This function is called to indicate that good data has been received.
@@ -804,9 +880,27 @@ class GpsNmea : public QObject
     // Dictionary with known sentence keywords
     static QHash<QString, short> gpsHash;
 
+    // Perfect hash table with the known sentence keywords, used for the
+    // sentence dispatching.
+    static NmeaIdTable gpsIdTable;
+
+    // Set, if the identifier table has been filled.
+    static bool gpsIdTableFilled;
+
     // Set with reported unknown GPS keys
     QSet<QString> reportedUnknownKeys;
 
+    // Records taken from the GPS client, reused for every call
+    QVector<GpsRecord> records;
+
+    // Latency statistics of the applied fix records
+    uint latencyCount;
+    qint64 latencySum;
+    int latencyMax;
+
+    // Number of superseded fix records
+    uint coalescedFixes;
+
     /** Mutex for thread synchronization. */
     static QMutex mutex;
 
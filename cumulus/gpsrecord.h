@@ -0,0 +1,113 @@
+/***********************************************************************
+**
+**   gpsrecord.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifndef GPS_RECORD_H
+#define GPS_RECORD_H
+
+#include <QtGlobal>
+
+// Maximum text length of a record. That is enough for all NMEA sentences
+// and the proprietary Maemo sentences with a full satellite list.
+#define GPS_RECORD_TEXT_SIZE 384
+
+/**
+ * \struct GpsRecord
+ *
+ * \author Axel Pauli
+ *
+ * \brief Compact record of a message received from the GPS client.
+ *
+ * The records are created by the GPS sensor thread and passed to the GUI
+ * thread via a lock free queue. The record is a POD type, so that it can be
+ * copied without any memory allocation. A sentence record carries the
+ * sentence text. The fix sentences $GPRMC, $GPGGA and $PGRMZ are already
+ * decoded by the sensor thread, their values are stored in the fix part.
+ *
+ * \date 2016
+ *
+ * \version 1.0
+ */
+struct GpsRecord
+{
+  /** Kinds of records. */
+  enum Kind
+  {
+    Sentence,              // GPS sentence
+    ConnectionOff,         // GPS connection has gone off
+    ConnectionOn,          // GPS connection has gone on
+    FlarmFlightList,       // Flarm flight list response
+    FlarmDownloadInfo,     // Flarm flight download result
+    FlarmDownloadProgress  // Flarm flight download progress
+  };
+
+  /** Flags of the decoded fix part. */
+  enum FixFlags
+  {
+    Decoded          = 0x0001, // The fix part is valid
+    FixValid         = 0x0002, // The sentence reports a valid fix
+    FixInvalid       = 0x0004, // The sentence reports no fix
+    HasTime          = 0x0008,
+    HasDate          = 0x0010,
+    HasSpeed         = 0x0020,
+    HasCoord         = 0x0040,
+    HasHeading       = 0x0080,
+    HasAltitude      = 0x0100,
+    AltitudeInFeet   = 0x0200,
+    PressureAltitude = 0x0400,
+    HasSatCount      = 0x0800
+  };
+
+  /** Receive time in ms since the epoch, used for latency measurements. */
+  qint64 received;
+
+  /** The kind of the record, see enum Kind. */
+  short kind;
+
+  /** The sentence identifier of GpsNmea or -1, if unknown. */
+  short id;
+
+  /** Flags of the fix part, see enum FixFlags. */
+  quint16 flags;
+
+  /** Satellites in view. */
+  short satsInView;
+
+  /** UTC time of the fix in ms of the day. */
+  int msecOfDay;
+
+  /** UTC date of the fix as Julian day. */
+  int julianDay;
+
+  /** Position in KFLog format. */
+  int latitude;
+  int longitude;
+
+  /** Speed in knots. */
+  double speed;
+
+  /** Heading in degrees. */
+  double heading;
+
+  /** Altitude in the unit given by the flag AltitudeInFeet. */
+  double altitude;
+
+  /** Length of the text. */
+  int length;
+
+  /** Sentence or message text, not null terminated. */
+  char text[GPS_RECORD_TEXT_SIZE];
+};
+
+#endif /* GPS_RECORD_H */
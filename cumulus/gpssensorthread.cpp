@@ -0,0 +1,252 @@
+/***********************************************************************
+**
+**   gpssensorthread.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <unistd.h>
+#include <sys/select.h>
+
+#include <QtCore>
+
+#include "forwardbatch.h"
+#include "gpsnmea.h"
+#include "gpssensorthread.h"
+
+// define maximum accepted size of a forward batch
+#define MAX_BATCH_SIZE (1024*1024)
+
+// define the number of records, the queue can take. The ring buffer has one
+// slot more, that is a power of two.
+#define QUEUE_SIZE 511
+
+GpsSensorThread::GpsSensorThread( QObject *parent ) :
+  QThread( parent ),
+  m_queue( QUEUE_SIZE ),
+  m_socket( -1 ),
+  m_shutdown( false )
+{
+  setObjectName( "GpsSensorThread" );
+}
+
+GpsSensorThread::~GpsSensorThread()
+{
+  stop();
+}
+
+void GpsSensorThread::startReading( const int socket )
+{
+  stop();
+
+  m_socket = socket;
+  m_shutdown = false;
+
+  start();
+}
+
+void GpsSensorThread::stop()
+{
+  m_mutex.lock();
+  m_shutdown = true;
+  m_mutex.unlock();
+
+  wait();
+}
+
+bool GpsSensorThread::isShutdown()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_shutdown;
+}
+
+void GpsSensorThread::run()
+{
+  sigset_t sigset;
+  sigfillset( &sigset );
+
+  // deactivate all signals in this thread
+  pthread_sigmask( SIG_SETMASK, &sigset, 0 );
+
+  while( isShutdown() == false )
+    {
+      // Wait for data with a timeout, that the shutdown flag is checked
+      // regularly.
+      fd_set readFds;
+      FD_ZERO( &readFds );
+      FD_SET( m_socket, &readFds );
+
+      struct timeval timeout;
+      timeout.tv_sec  = 0;
+      timeout.tv_usec = 250000;
+
+      int result = select( m_socket + 1, &readFds, 0, 0, &timeout );
+
+      if( result == 0 || (result < 0 && errno == EINTR) )
+        {
+          continue;
+        }
+
+      if( result < 0 || readBatch() == false )
+        {
+          qWarning() << "GpsSensorThread: Reading of GPS client data failed, errno="
+                     << errno << strerror(errno);
+
+          emit readError( m_socket );
+          return;
+        }
+    }
+}
+
+bool GpsSensorThread::readData( void* data, const int length )
+{
+  char* ptr = static_cast<char *> (data);
+  int done = 0;
+
+  while( done < length )
+    {
+      int bytes = read( m_socket, ptr + done, length - done );
+
+      if( bytes < 0 && errno == EINTR )
+        {
+          continue; // Ignore interrupts
+        }
+
+      if( bytes <= 0 )
+        {
+          return false; // Error occurred or client has closed the socket
+        }
+
+      done += bytes;
+    }
+
+  return true;
+}
+
+bool GpsSensorThread::readBatch()
+{
+  quint32 batchLen = 0;
+
+  if( readData( &batchLen, sizeof(batchLen) ) == false )
+    {
+      return false;
+    }
+
+  if( batchLen > MAX_BATCH_SIZE )
+    {
+      qWarning() << "GpsSensorThread::readBatch(): Protocol Error! Batch length"
+                 << batchLen;
+      return false;
+    }
+
+  // The buffer is reused for all batches, it only grows, if necessary.
+  m_batch.resize( batchLen );
+
+  if( readData( m_batch.data(), batchLen ) == false )
+    {
+      return false;
+    }
+
+  // All messages of a batch get the same receive time.
+  const qint64 received = QDateTime::currentMSecsSinceEpoch();
+
+  int pos = 0;
+  ForwardBatch::Type type;
+  const char* data;
+  int length;
+
+  GpsRecord record;
+
+  while( ForwardBatch::next( m_batch.constData(), m_batch.size(), pos, type, data, length ) )
+    {
+      switch( type )
+        {
+          case ForwardBatch::GpsData:
+            record.kind = GpsRecord::Sentence;
+            break;
+          case ForwardBatch::ConnectionOff:
+            record.kind = GpsRecord::ConnectionOff;
+            break;
+          case ForwardBatch::ConnectionOn:
+            record.kind = GpsRecord::ConnectionOn;
+            break;
+          case ForwardBatch::FlarmFlightList:
+            record.kind = GpsRecord::FlarmFlightList;
+            break;
+          case ForwardBatch::FlarmDownloadInfo:
+            record.kind = GpsRecord::FlarmDownloadInfo;
+            break;
+          case ForwardBatch::FlarmDownloadProgress:
+            record.kind = GpsRecord::FlarmDownloadProgress;
+            break;
+          default:
+            qWarning() << "GpsSensorThread::readBatch(): Protocol Error! Type="
+                       << type;
+            continue;
+        }
+
+      if( length > GPS_RECORD_TEXT_SIZE )
+        {
+          // The message does not fit into a record.
+          const int dropped = m_droppedRecords.fetchAndAddRelaxed( 1 ) + 1;
+
+          qWarning() << "GpsSensorThread::readBatch(): Message of"
+                     << length << "bytes too long, dropped"
+                     << QByteArray( data, 20 )
+                     << "Dropped messages:" << dropped;
+          continue;
+        }
+
+      record.received = received;
+      record.id       = -1;
+      record.flags    = 0;
+      record.length   = length;
+      memcpy( record.text, data, length );
+
+      if( record.kind == GpsRecord::Sentence )
+        {
+          // The fix sentences are decoded already here.
+          GpsNmea::decodeRecord( record );
+        }
+
+      appendRecord( record );
+    }
+
+  if( m_notified.testAndSetOrdered( 0, 1 ) )
+    {
+      emit newRecords();
+    }
+
+  return true;
+}
+
+void GpsSensorThread::appendRecord( const GpsRecord& record )
+{
+  while( m_queue.push( record ) == false )
+    {
+      // The queue is full, the GUI thread is busy. Ensure, that it gets a
+      // notification and wait for free space.
+      if( m_notified.testAndSetOrdered( 0, 1 ) )
+        {
+          emit newRecords();
+        }
+
+      if( isShutdown() )
+        {
+          return;
+        }
+
+      msleep( 5 );
+    }
+}
@@ -0,0 +1,173 @@
+/***********************************************************************
+**
+**   gpssensorthread.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class GpsSensorThread
+*
+* \author Axel Pauli
+*
+* \brief Reads and decodes the data of the GPS client in an own thread.
+*
+* The thread reads the message batches from the forward channel of the GPS
+* client, see class ForwardBatch. Every message is converted into a compact
+* \ref GpsRecord and appended to a lock free queue. The fix sentences are
+* decoded already here. The GUI thread is notified via the signal
+* \ref newRecords, when the queue was empty before. It takes the records at
+* its own pace, so that a long map redraw does not delay the reading of the
+* socket. If the queue is full, the thread waits for free space. No record
+* is dropped.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef GPS_SENSOR_THREAD_H
+#define GPS_SENSOR_THREAD_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QMutex>
+#include <QThread>
+
+#include "gpsrecord.h"
+#include "spscqueue.h"
+
+class GpsSensorThread : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( GpsSensorThread )
+
+ public:
+
+  GpsSensorThread( QObject *parent );
+
+  virtual ~GpsSensorThread();
+
+  /**
+   * Starts the reading of the passed socket.
+   *
+   * \param socket The socket of the forward channel.
+   */
+  void startReading( const int socket );
+
+  /**
+   * Stops the thread and waits for its termination. The queued records
+   * are kept.
+   */
+  void stop();
+
+  /**
+   * Takes the oldest record from the queue. Must be called by the GUI
+   * thread only.
+   *
+   * \return False, if the queue is empty.
+   */
+  bool takeRecord( GpsRecord& record )
+  {
+    return m_queue.pop( record );
+  };
+
+  /**
+   * Requests a new notification for the next appended record. Must be called
+   * before the queue is read.
+   */
+  void resetNotification()
+  {
+    m_notified.fetchAndStoreRelease( 0 );
+  };
+
+  /**
+   * \return The number of messages dropped, because they did not fit into
+   *         a record.
+   */
+  int droppedRecords()
+  {
+    return m_droppedRecords.fetchAndAddRelaxed( 0 );
+  };
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+ signals:
+
+  /**
+   * Emitted, if records were appended to the empty queue.
+   */
+  void newRecords();
+
+  /**
+   * Emitted, if the socket cannot be read anymore. The thread is terminated
+   * then.
+   *
+   * \param socket The socket, which caused the error.
+   */
+  void readError( int socket );
+
+ private:
+
+  /** \return True, if the thread shall terminate. */
+  bool isShutdown();
+
+  /**
+   * Reads the requested number of bytes from the socket.
+   *
+   * \return True on success, false in case of error.
+   */
+  bool readData( void* data, const int length );
+
+  /**
+   * Reads a batch of messages from the socket and appends its messages to
+   * the queue.
+   *
+   * \return True on success, false in case of error.
+   */
+  bool readBatch();
+
+  /**
+   * Appends a record to the queue. Waits, if the queue is full.
+   */
+  void appendRecord( const GpsRecord& record );
+
+  /** The queue with the records for the GUI thread. */
+  SpscQueue<GpsRecord> m_queue;
+
+  /** Set, if the GUI thread is already notified about new records. */
+  QAtomicInt m_notified;
+
+  /** Number of messages dropped due to their length. */
+  QAtomicInt m_droppedRecords;
+
+  /** The socket of the forward channel. */
+  int m_socket;
+
+  /** Receive buffer of the forward batches. */
+  QByteArray m_batch;
+
+  /** Shutdown flag of the thread. */
+  bool m_shutdown;
+
+  /** Mutex to protect the shutdown flag. */
+  QMutex m_mutex;
+};
+
+#endif /* GPS_SENSOR_THREAD_H */
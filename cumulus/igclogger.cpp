@@ -54,7 +54,7 @@ IgcLogger::IgcLogger(QObject* parent) :
   QObject(parent),
   closeTimer(0),
   _kRecordLogging(false),
-  _backtrack( LimitedList<QStringList>(60) ),
+  _backtrack( 60 ),
   flightNumber(0),
   _flightMode( Calculator::unknown)
 {
@@ -64,7 +64,7 @@
 
 #include "altitude.h"
 #include "calculator.h"
-#include "limitedlist.h"
+#include "ringbuffer.h"
 
 class QMutex;
 
@@ -380,7 +380,7 @@ private:
     * and logging is triggered, the list is used to write out some older events
     * to the log. This way, we can be sure that the complete start sequence is
     * available in the log. */
-  LimitedList<QStringList> _backtrack;
+  RingBuffer<QStringList> _backtrack;
 
   /** Stores the flight number for this day */
   int flightNumber;
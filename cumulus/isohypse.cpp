@@ -36,7 +36,9 @@ Isohypse::Isohypse( QPolygon elevationCoordinates,
     _elevation(elevation),
     _elevationIndex(elevationIndex),
     _typeID(typeID)
-{}
+{
+  createDetailLevels();
+}
 
 
 Isohypse::~Isohypse()
@@ -52,7 +54,7 @@ QPainterPath* Isohypse::drawRegion( QPainter* targetP,
       return ppath;
     }
 
-  QPolygon mP = glMapMatrix->map(projPolygon);
+  QPolygon mP = glMapMatrix->map( getDetailPolygon( glMapMatrix->getDetailLevel() ) );
 
   if (mP.boundingRect().isNull())
     {
@@ -0,0 +1,185 @@
+/***********************************************************************
+**
+**   landableindex.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QRect>
+#include <QtAlgorithms>
+
+#include "landableindex.h"
+#include "mapcalc.h"
+#include "mapcontents.h"
+#include "waypoint.h"
+
+extern MapContents *_globalMapContents;
+
+LandableIndex::LandableIndex() :
+  m_waypointSerial(0),
+  m_valid(false)
+{
+}
+
+LandableIndex::~LandableIndex()
+{
+}
+
+int LandableIndex::cellOf( const int coordinate )
+{
+  // Round down also for negative coordinates.
+  if( coordinate >= 0 )
+    {
+      return coordinate / CellSize;
+    }
+
+  return -( (-coordinate + CellSize - 1) / CellSize );
+}
+
+QVector<int> LandableIndex::listSizes() const
+{
+  QVector<int> sizes;
+
+  sizes.append( _globalMapContents->getListLength( MapContents::AirfieldList ) );
+  sizes.append( _globalMapContents->getListLength( MapContents::GliderfieldList ) );
+  sizes.append( _globalMapContents->getListLength( MapContents::OutLandingList ) );
+  sizes.append( _globalMapContents->getWaypointList().size() );
+
+  return sizes;
+}
+
+bool LandableIndex::isOutdated() const
+{
+  // A changed list size is detected also without an invalidation, so that
+  // the index never refers to not existing points. The waypoints can be
+  // edited, deleted and added without a size change, that is detected by
+  // the change serial of the waypoint list.
+  return ( m_valid == false ||
+           m_waypointSerial != _globalMapContents->getWaypointListSerial() ||
+           m_listSizes != listSizes() );
+}
+
+void LandableIndex::add( const short listID, const int index, const QPoint& position )
+{
+  Entry entry;
+  entry.listID   = listID;
+  entry.index    = index;
+  entry.position = position;
+
+  m_cells[cellKey( cellOf( position.x() ), cellOf( position.y() ) )].append( m_entries.size() );
+  m_entries.append( entry );
+}
+
+void LandableIndex::build()
+{
+  m_entries.clear();
+  m_cells.clear();
+
+  const MapContents::ListID lists[3] = { MapContents::AirfieldList,
+                                         MapContents::GliderfieldList,
+                                         MapContents::OutLandingList };
+
+  for( int l = 0; l < 3; l++ )
+    {
+      // The positions and priorities are read from the columns of the point
+      // store, the point objects are not touched.
+      const PointStore* store = _globalMapContents->getPointStore( lists[l] );
+
+      for( int i = 0; i < store->size(); i++ )
+        {
+          // Closed airfields are no landing option.
+          if( store->priority(i) == PointStore::NotLandable )
+            {
+              continue;
+            }
+
+          add( lists[l], i, store->wgsPosition(i) );
+        }
+    }
+
+  // Only landable waypoints are taken into account.
+  QList<Waypoint>& wpList = _globalMapContents->getWaypointList();
+
+  for( int i = 0; i < wpList.size(); i++ )
+    {
+      const Waypoint& wp = wpList.at(i);
+
+      bool isLandable = false;
+
+      if( wp.rwyList.size() > 0 )
+        {
+          isLandable = wp.rwyList.at(0).m_isOpen;
+        }
+
+      if( isLandable || wp.type == BaseMapElement::Outlanding )
+        {
+          add( MapContents::WaypointList, i, wp.wgsPoint );
+        }
+    }
+
+  m_listSizes = listSizes();
+  m_waypointSerial = _globalMapContents->getWaypointListSerial();
+  m_valid = true;
+}
+
+void LandableIndex::findNearest( const QPoint& center,
+                                 const double radius,
+                                 QVector<Candidate>& candidates ) const
+{
+  candidates.clear();
+
+  QPoint c( center );
+
+  // The box is spanned by latitude in x and longitude in y.
+  QRect bbox = MapCalc::areaBox( center, radius );
+
+  const int firstRow = cellOf( bbox.left() );
+  const int lastRow  = cellOf( bbox.right() );
+  const int firstCol = cellOf( bbox.top() );
+  const int lastCol  = cellOf( bbox.bottom() );
+
+  for( int row = firstRow; row <= lastRow; row++ )
+    {
+      for( int col = firstCol; col <= lastCol; col++ )
+        {
+          QHash< qint64, QVector<int> >::const_iterator it =
+            m_cells.constFind( cellKey( row, col ) );
+
+          if( it == m_cells.constEnd() )
+            {
+              continue;
+            }
+
+          const QVector<int>& cell = it.value();
+
+          for( int i = 0; i < cell.size(); i++ )
+            {
+              QPoint pos = m_entries.at( cell.at(i) ).position;
+
+              if( bbox.contains( pos ) == false )
+                {
+                  continue;
+                }
+
+              Candidate candidate;
+              candidate.entry    = cell.at(i);
+              candidate.distance = MapCalc::dist( &c, &pos );
+
+              if( candidate.distance <= radius )
+                {
+                  candidates.append( candidate );
+                }
+            }
+        }
+    }
+
+  qSort( candidates.begin(), candidates.end() );
+}
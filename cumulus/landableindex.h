@@ -0,0 +1,159 @@
+/***********************************************************************
+**
+**   landableindex.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class LandableIndex
+*
+* \author Axel Pauli
+*
+* \brief Grid index over all landable points.
+*
+* The index contains the airfields, the glider fields, the outlandings and
+* the landable waypoints of the map contents. Closed airfields are left out.
+* The map points are taken from the columns of their point stores. The
+* points are sorted into grid cells of a fixed size in WGS84 coordinates.
+* A query returns all
+* points within a radius ordered by their distance, only the grid cells
+* overlapping the search area are visited.
+*
+* The index refers to the points by their list and list index. It has to
+* be rebuilt, if one of the point lists has been changed.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef LANDABLE_INDEX_H
+#define LANDABLE_INDEX_H
+
+#include <QHash>
+#include <QPoint>
+#include <QVector>
+
+class LandableIndex
+{
+ private:
+
+  Q_DISABLE_COPY ( LandableIndex )
+
+ public:
+
+  /** An indexed landable point. */
+  struct Entry
+  {
+    /** Point list as MapContents::ListID. */
+    short listID;
+
+    /** Index of the point in its list. */
+    int index;
+
+    /** WGS84 position in KFLog units. */
+    QPoint position;
+  };
+
+  /** A query result. */
+  struct Candidate
+  {
+    /** Number of the entry. */
+    int entry;
+
+    /** Distance to the query center in kilometers. */
+    double distance;
+
+    bool operator<( const Candidate& other ) const
+    {
+      return distance < other.distance;
+    };
+  };
+
+  LandableIndex();
+
+  virtual ~LandableIndex();
+
+  /**
+   * Builds the index over the current point lists of the map contents.
+   */
+  void build();
+
+  /**
+   * Marks the index as outdated.
+   */
+  void invalidate()
+  {
+    m_valid = false;
+  };
+
+  /**
+   * \return True, if the index must be rebuilt before it can be used.
+   */
+  bool isOutdated() const;
+
+  /**
+   * Searches all points within the radius around the center.
+   *
+   * \param center The search center as WGS84 coordinate in KFLog units.
+   * \param radius The search radius in kilometers.
+   * \param candidates The found points ordered by ascending distance.
+   */
+  void findNearest( const QPoint& center,
+                    const double radius,
+                    QVector<Candidate>& candidates ) const;
+
+  /**
+   * \return The entry with the passed number.
+   */
+  const Entry& entry( const int number ) const
+  {
+    return m_entries.at( number );
+  };
+
+ private:
+
+  /** Edge length of a grid cell in KFLog units, that are 10 minutes. */
+  enum { CellSize = 100000 };
+
+  /** \return The grid row or column of a coordinate. */
+  static int cellOf( const int coordinate );
+
+  /** \return The key of a grid cell. */
+  static qint64 cellKey( const int row, const int col )
+  {
+    return (qint64( row ) << 32) | quint32( col );
+  };
+
+  /** Adds a point to the index. */
+  void add( const short listID, const int index, const QPoint& position );
+
+  /** Sizes of the point lists at build time. */
+  QVector<int> listSizes() const;
+
+  /** All indexed points. */
+  QVector<Entry> m_entries;
+
+  /** Entry numbers per grid cell. */
+  QHash< qint64, QVector<int> > m_cells;
+
+  /** List sizes of the last build. */
+  QVector<int> m_listSizes;
+
+  /** Change serial of the waypoint list at the last build. */
+  uint m_waypointSerial;
+
+  /** False, if the index has to be rebuilt. */
+  bool m_valid;
+};
+
+#endif /* LANDABLE_INDEX_H */
@@ -18,6 +18,7 @@
 
 #include "lineelement.h"
 #include "generalconfig.h"
+#include "mapcalc.h"
 
 LineElement::LineElement() :
   BaseMapElement(),
@@ -50,6 +51,31 @@ LineElement::~LineElement()
 {
 }
 
+void LineElement::createDetailLevels()
+{
+  // Polygons must keep an area, lines need only their end points.
+  const int minPoints = ( closed || typeID == BaseMapElement::Isohypse ) ? 3 : 2;
+
+  int lastSize = projPolygon.size();
+
+  for( int i = 0; i < MapMatrix::DetailLevels; i++ )
+    {
+      detailPolygons[i].clear();
+
+      QPolygon simplified =
+          MapCalc::simplifyPolygon( projPolygon, MapMatrix::getDetailTolerance( i + 1 ) );
+
+      // A level is only stored, if it saves at least a quarter of the points
+      // of the next finer level.
+      if( simplified.size() >= minPoints && simplified.size() * 4 <= lastSize * 3 )
+        {
+          simplified.squeeze();
+          detailPolygons[i] = simplified;
+          lastSize = simplified.size();
+        }
+    }
+}
+
 bool LineElement::drawMapElement(QPainter* targetP)
 {
   // Reset screen bounding box
@@ -126,7 +152,7 @@ bool LineElement::drawMapElement(QPainter* targetP)
       break;
     }
 
-  QPolygon mP( glMapMatrix->map(projPolygon) );
+  QPolygon mP( glMapMatrix->map( getDetailPolygon( glMapMatrix->getDetailLevel() ) ) );
 
   // Save screen bounding box
   sbBox = mP.boundingRect();
@@ -119,6 +119,38 @@ class LineElement : public BaseMapElement
     {
       projPolygon = newPolygon;
       bBox = newPolygon.boundingRect();
+
+      for( int i = 0; i < MapMatrix::DetailLevels; i++ )
+        {
+          detailPolygons[i].clear();
+        }
+    };
+
+    /**
+     * Creates the simplified polygons of the detail levels from the projected
+     * polygon. Levels, which would not save enough points, are left empty.
+     * Should be called once after loading, it is too expensive for the
+     * drawing.
+     */
+    void createDetailLevels();
+
+    /**
+     * Returns the polygon to be drawn at a detail level. If the level has no
+     * own polygon, the next finer one is returned.
+     *
+     * \param level The detail level as returned by MapMatrix::getDetailLevel.
+     */
+    const QPolygon& getDetailPolygon( const int level ) const
+    {
+      for( int i = qMin( level, int(MapMatrix::DetailLevels) ); i > 0; i-- )
+        {
+          if( detailPolygons[i - 1].isEmpty() == false )
+            {
+              return detailPolygons[i - 1];
+            }
+        }
+
+      return projPolygon;
     };
 
 protected:
@@ -127,6 +159,11 @@ protected:
      */
     QPolygon projPolygon;
 
+    /**
+     * Simplified projected polygons of the detail levels 1...DetailLevels.
+     */
+    QPolygon detailPolygons[MapMatrix::DetailLevels];
+
     /**
      * The bounding-box of the line element.
      */
@@ -27,6 +27,9 @@
 #include "layout.h"
 #include "listwidgetparent.h"
 #include "generalconfig.h"
+#include "mapconfig.h"
+
+extern MapConfig *_globalMapConfig;
 
 ListWidgetParent::ListWidgetParent( QWidget *parent, bool showMovePage ) :
   QWidget(parent),
@@ -160,6 +163,22 @@ void ListWidgetParent::fillItemList()
 
   // Sets the icon size of a list entry
   list->setIconSize( QSize(iconSize, iconSize) );
+
+  // The type pixmaps can be changed by the configuration.
+  m_typeIcons.clear();
+}
+
+const QIcon& ListWidgetParent::typeIcon( const int type )
+{
+  QHash<int, QIcon>::iterator it = m_typeIcons.find( type );
+
+  if( it == m_typeIcons.end() )
+    {
+      QPixmap pm = _globalMapConfig->getPixmap( uint( type ), false );
+      it = m_typeIcons.insert( type, QIcon( pm ) );
+    }
+
+  return it.value();
 }
 
 /**
@@ -38,6 +38,8 @@
 #ifndef LISTWIDGET_PARENT_H
 #define LISTWIDGET_PARENT_H
 
+#include <QHash>
+#include <QIcon>
 #include <QWidget>
 #include <QTreeWidget>
 #include <QItemDelegate>
@@ -134,6 +136,12 @@ class ListWidgetParent : public QWidget
 
     void showEvent( QShowEvent *event );
 
+    /**
+     * \return The list icon of the passed point type. The icons are created
+     * only once per type and list filling.
+     */
+    const QIcon& typeIcon( const int type );
+
     QTreeWidget*    list;
     ListViewFilter* filter;
 
@@ -151,6 +159,9 @@ class ListWidgetParent : public QWidget
 
     RowDelegate* rowDelegate;
 
+    /** Icons of the point types used by the current list filling. */
+    QHash<int, QIcon> m_typeIcons;
+
   private slots:
 
     /**
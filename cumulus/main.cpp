@@ -46,6 +46,7 @@
 #include "generalconfig.h"
 #include "messagehandler.h"
 #include "hwinfo.h"
+#include "nmeabenchmark.h"
 
 #ifdef ANDROID
 #include "jnisupport.h"
@@ -328,6 +329,19 @@ int main(int argc, char *argv[])
   // save done configuration settings
   conf->save();
 
+#ifdef BENCHMARK
+
+  // Replay a NMEA or IGC file after the startup instead of receiving GPS
+  // data, see class NmeaBenchmark.
+  int benchIdx = app.arguments().indexOf( "--nmea-benchmark" );
+
+  if( benchIdx > 0 && benchIdx + 1 < app.arguments().size() )
+    {
+      new NmeaBenchmark( app.arguments().at( benchIdx + 1 ), &app );
+    }
+
+#endif
+
   // create the Cumulus application window
   MainWindow *cumulus = new MainWindow( Qt::WindowContextHelpButtonHint );
 
@@ -52,6 +52,7 @@
 #include "mapcontents.h"
 #include "mapmatrix.h"
 #include "messagewidget.h"
+#include "nmeabenchmark.h"
 #include "preflightwidget.h"
 #include "sound.h"
 #include "target.h"
@@ -744,7 +745,7 @@ void MainWindow::slotCreateApplicationWidgets()
            _globalMapContents, SLOT( slotReloadMapData() ) );
 
   connect( _globalMapContents, SIGNAL( mapDataReloaded(Map::mapLayer) ),
-           Map::instance, SLOT( slotRedraw(Map::mapLayer) ) );
+           Map::instance, SLOT( slotMapDataReloaded(Map::mapLayer) ) );
 
   connect( _globalMapContents, SIGNAL( mapDataReloaded() ),
            viewAF, SLOT( slot_reloadList() ) );
@@ -919,6 +920,8 @@ void MainWindow::slotCreateApplicationWidgets()
            viewMap, SLOT( slot_Position( const QPoint&, const int ) ) );
   connect( calculator, SIGNAL( newPosition( const QPoint&, const int ) ),
            Map::getInstance(), SLOT( slotPosition( const QPoint&, const int ) ) );
+  connect( calculator, SIGNAL( newPosition( const QPoint&, const int ) ),
+           _globalMapContents, SLOT( slotPosition( const QPoint&, const int ) ) );
   connect( calculator, SIGNAL( switchManualInFlight() ),
            Map::getInstance(), SLOT( slotSwitchManualInFlight() ) );
   connect( calculator, SIGNAL( switchMapScale(const double&) ),
@@ -1063,6 +1066,17 @@ void MainWindow::slotFinishStartUp()
   // Startup GPS client process now for data receiving
   GpsNmea::gps->blockSignals( false );
 
+#ifdef BENCHMARK
+
+  if( NmeaBenchmark::instance() != 0 )
+    {
+      // Replay the benchmark file instead of receiving GPS data.
+      QTimer::singleShot( 0, NmeaBenchmark::instance(), SLOT(slotStart()) );
+      return;
+    }
+
+#endif
+
 #ifndef ANDROID
   GpsNmea::gps->startGpsReceiver();
 #endif
@@ -2791,6 +2805,8 @@ void MainWindow::slotReadconfig()
         }
     }
 
+  // The base layer can be drawn in another style now.
+  Map::instance->invalidateBaseLayer();
   Map::instance->scheduleRedraw();
 }
 
@@ -37,6 +37,7 @@
 #include "mapdefaults.h"
 #include "mapmatrix.h"
 #include "mapview.h"
+#include "nmeabenchmark.h"
 #include "radiopoint.h"
 #include "reachablelist.h"
 #include "runway.h"
@@ -58,14 +59,34 @@ extern MapView     *_globalMapView;
 
 Map *Map::instance = static_cast<Map *>(0);
 
+// Minimum ground speed in m/s for the airspace incursion prediction
+#define LOOK_AHEAD_MIN_SPEED 5.0
+
+// Time budget in ms per position fix for the airspace incursion prediction
+#define LOOK_AHEAD_BUDGET 5
+
+// Interval in ms between the renderings of base layer tiles in advance
+#define BASE_TILE_PREFETCH_INTERVAL 50
+
+// Intended time in ms between two redraws of the information layer and
+// minimum delay in ms of a redraw of the lower layers
 #ifdef MAEMO
-#define TRAIL_LENGTH 7*60
+#define REDRAW_FRAME_BUDGET 200
+#define REDRAW_MIN_DELAY 750
 #else
-#define TRAIL_LENGTH 10*60
+#define REDRAW_FRAME_BUDGET 100
+#define REDRAW_MIN_DELAY 500
 #endif
 
+// Maximum delay in ms of a redraw request
+#define REDRAW_MAX_DELAY 2000
+
 Map::Map(QWidget* parent) : QWidget(parent),
-  TrailListLength( TRAIL_LENGTH )
+  m_redrawScheduler( REDRAW_FRAME_BUDGET, REDRAW_MIN_DELAY, REDRAW_MAX_DELAY ),
+  m_tppLevel(-1),
+  m_tppCount(0),
+  m_tppSerial(0),
+  m_tppConnected(false)
 {
 //  qDebug( "Map::Map parent window size is %dx%d, width=%d, height=%d",
 //          size().width(),
@@ -89,6 +110,8 @@ Map::Map(QWidget* parent) : QWidget(parent),
   m_mode = northUp;
   m_scheduledFromLayer = baseLayer;
   m_ShowGlider = false;
+  m_lateralConflictsValid = false;
+  m_airspaceOverlayValid = false;
   setMutex(false);
 
   //setup progressive zooming values
@@ -101,8 +124,8 @@ Map::Map(QWidget* parent) : QWidget(parent),
     }
 
   // Set pixmaps first to the size of the parent
-  m_pixPaintBuffer = QPixmap( parent->size() );
-  m_pixPaintBuffer.fill(Qt::white);
+  m_pixInformationMap = QPixmap( parent->size() );
+  m_pixInformationMap.fill(Qt::white);
 
   QPalette palette;
   palette.setColor(backgroundRole(), Qt::white);
@@ -126,6 +149,12 @@ Map::Map(QWidget* parent) : QWidget(parent),
   connect( m_showASSTimer, SIGNAL(timeout()),
             this, SLOT(slotASSTimerExpired()));
 
+  m_baseTileTimer = new QTimer(this);
+  m_baseTileTimer->setSingleShot(true);
+
+  connect( m_baseTileTimer, SIGNAL(timeout()),
+            this, SLOT(slotPrefetchBaseTile()));
+
   m_zoomFactor = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
   m_curMANPos  = _globalMapMatrix->getMapCenter();
   m_curGPSPos  = _globalMapMatrix->getMapCenter();
@@ -343,9 +372,13 @@ void Map::p_displayDetailedItemInfo(const QPoint& current)
   // @AP: On map scale higher as 1024 we don't evaluate anything
   for( int l = 0; l < 5 && cs < 1024.0; l++ )
     {
-      for(unsigned int loop = 0;
-          loop < _globalMapContents->getListLength(searchList[l]); loop++)
+      // Only the points drawn at the last map drawing can be hit.
+      const QVector<int>& drawnPoints = _globalMapContents->getDrawnPoints( searchList[l] );
+
+      for( int d = 0; d < drawnPoints.size(); d++ )
         {
+          const int loop = drawnPoints.at(d);
+
           // Get specific site data from current list. We have to
           // distinguish between AirfieldList, GilderfieldList, OutlandingList
           // RadioList and HotspotList.
@@ -729,17 +762,39 @@ void Map::paintEvent(QPaintEvent* event)
       qDebug("Map::paintEvent(): mutex is locked");
     }
 
-  // We copy always the content from the m_pixPaintBuffer to the paint device.
+  // We copy always the content from the m_pixInformationMap to the paint device.
   QPainter p(this);
 
-  p.drawPixmap( event->rect().left(), event->rect().top(), m_pixPaintBuffer,
-                0, 0, event->rect().width(), event->rect().height() );
+  p.drawPixmap( event->rect().left(), event->rect().top(), m_pixInformationMap,
+                event->rect().left(), event->rect().top(),
+                event->rect().width(), event->rect().height() );
+
+  p_drawMapButtons( p );
 
   // qDebug("Map.paintEvent(): return");
 }
 
+void Map::p_drawMapButtons( QPainter& painter )
+{
+  // draw the wind arrow, if pixmap was initialized by slot slotNewWind
+  if( ! m_windArrow.isNull() )
+    {
+      painter.drawPixmap( 10, 10, m_windArrow );
+    }
+
+  // Draw the zoom buttons at the map
+  const QPixmap& plus  = _globalMapConfig->getPlusButton();
+  const QPixmap& minus = _globalMapConfig->getMinusButton();
+
+  painter.drawPixmap( width()-plus.width()-5, 5, plus );
+  painter.drawPixmap( width()-minus.width()-5, height()-minus.width()-5, minus);
+}
+
 void Map::slotNewWind( Vector& wind )
 {
+  // The area of the old wind arrow must be repainted too.
+  QRect arrowRect( QPoint(10, 10), m_windArrow.size() );
+
   if( wind.isValid() && wind.getSpeed().getMps() > 0.0 )
     {
       int angle = wind.getAngleDeg();
@@ -755,15 +810,13 @@ void Map::slotNewWind( Vector& wind )
       m_windArrow = QPixmap();
     }
 
-  slotRedraw( Map::wind );
+  // The wind arrow is put over the map by the paint event only.
+  arrowRect |= QRect( QPoint(10, 10), m_windArrow.size() );
+  update( arrowRect );
 }
 
 void Map::p_drawAirspaces( bool reset )
 {
-  QPainter cuAeroMapP;
-
-  cuAeroMapP.begin(&m_pixAeroMap);
-
   QTime t;
   t.start();
 
@@ -801,12 +854,23 @@ void Map::p_drawAirspaces( bool reset )
   // The border is stored as FL
   uint asBorder = (uint) rint(settings->getAirspaceDrawingBorder() * 100.0 * Distance::mFromFeet );
 
+  // The lateral conflicts are taken from the airspace index.
+  const QHash<Airspace*, Airspace::ConflictType> lateralConflicts =
+      p_lateralConflicts( pos, awd );
+
   // Two airspace lists have to be processed.
   SortableAirspaceList* asl[2];
 
   asl[0] = _globalMapContents->getAirspaceList();
   asl[1] = _globalMapContents->getFlarmAlertZoneList();
 
+  // The outline of an airspace is drawn over the border of its region.
+  const int margin = settings->getAirspaceLineWidth() + 2;
+
+  // The airspaces to be drawn in drawing order.
+  QVector<AirspaceOverlayItem> items;
+  items.reserve( m_airspaceOverlayItems.size() );
+
   for( int i = 0; i < 2; i++ )
     {
       for( int loop = 0; loop < asl[i]->size(); loop++ )
@@ -862,7 +926,8 @@ void Map::p_drawAirspaces( bool reset )
           if( region && currentAirS->getTypeID() != BaseMapElement::AirFir )
             {
               // determine lateral conflict
-              Airspace::ConflictType lConflict = region->conflicts( pos, awd );
+              Airspace::ConflictType lConflict =
+                  lateralConflicts.value( currentAirS, Airspace::none );
 
               // determine vertical conflict
               Airspace::ConflictType vConflict = currentAirS->conflicts( alt, awd );
@@ -885,12 +950,175 @@ void Map::p_drawAirspaces( bool reset )
                 }
             }
 
-          currentAirS->drawRegion( &cuAeroMapP, airspaceOpacity );
+          AirspaceOverlayItem item;
+          item.airspace = currentAirS;
+          item.opacity  = airspaceOpacity;
+
+          if( currentAirS->getTypeID() == BaseMapElement::AirFlarm || region == 0 )
+            {
+              // Flarm alert zones are drawn as circles around their center,
+              // their region does not describe the covered area.
+              item.bounds = rect();
+            }
+          else
+            {
+              item.bounds = region->m_region->boundingRect().toAlignedRect().
+                              adjusted( -margin, -margin, margin, margin );
+            }
+
+          items.append( item );
+        }
+    }
+
+  // Determine the area of the overlay, which must be rendered again.
+  bool fullRender = ( reset == true ||
+                      m_airspaceOverlayValid == false ||
+                      m_pixAirspaceOverlay.size() != size() ||
+                      m_airspaceOverlayBorder != _globalMapMatrix->getMapBorder() ||
+                      items.size() != m_airspaceOverlayItems.size() );
+
+  QRect dirty;
+
+  for( int i = 0; fullRender == false && i < items.size(); i++ )
+    {
+      const AirspaceOverlayItem& oldItem = m_airspaceOverlayItems.at(i);
+      const AirspaceOverlayItem& newItem = items.at(i);
+
+      if( oldItem.airspace != newItem.airspace )
+        {
+          // Another set of airspaces is drawn.
+          fullRender = true;
+          break;
+        }
+
+      if( oldItem.opacity != newItem.opacity || oldItem.bounds != newItem.bounds )
+        {
+          dirty |= oldItem.bounds;
+          dirty |= newItem.bounds;
         }
     }
 
+  if( fullRender == true )
+    {
+      // The fill with a transparent color provides the alpha channel.
+      m_pixAirspaceOverlay = QPixmap( size() );
+      m_pixAirspaceOverlay.fill( Qt::transparent );
+      dirty = rect();
+    }
+  else
+    {
+      dirty &= rect();
+    }
+
+  if( dirty.isEmpty() == false )
+    {
+      QPainter overlayP( &m_pixAirspaceOverlay );
+
+      // Clear the dirty area and draw all airspaces again, which are
+      // overlapping it. The drawing order remains the same as at a full
+      // rendering, so that overlapping fillings are blended identically.
+      overlayP.setCompositionMode( QPainter::CompositionMode_Source );
+      overlayP.fillRect( dirty, Qt::transparent );
+      overlayP.setCompositionMode( QPainter::CompositionMode_SourceOver );
+      overlayP.setClipRect( dirty );
+
+      for( int i = 0; i < items.size(); i++ )
+        {
+          const AirspaceOverlayItem& item = items.at(i);
+
+          if( item.bounds.intersects( dirty ) )
+            {
+              item.airspace->drawRegion( &overlayP, item.opacity );
+            }
+        }
+
+      overlayP.end();
+    }
+
+  m_airspaceOverlayItems  = items;
+  m_airspaceOverlayBorder = _globalMapMatrix->getMapBorder();
+  m_airspaceOverlayValid  = true;
+
+  QPainter cuAeroMapP;
+
+  cuAeroMapP.begin(&m_pixAeroMap);
+  cuAeroMapP.drawPixmap( 0, 0, m_pixAirspaceOverlay );
   cuAeroMapP.end();
-  // qDebug("Airspace, drawTime=%d ms", t.elapsed());
+
+  // qDebug("Airspace, drawTime=%d ms, full=%d, dirty=%dx%d",
+  //        t.elapsed(), fullRender, dirty.width(), dirty.height());
+}
+
+const QHash<Airspace*, Airspace::ConflictType>&
+Map::p_lateralConflicts( const QPoint& pos, const AirspaceWarningDistance& awd )
+{
+  AirspaceIndex* indexes[2] = { &m_airspaceIndex, &m_flarmZoneIndex };
+
+  SortableAirspaceList* lists[2] =
+    { _globalMapContents->getAirspaceList(),
+      _globalMapContents->getFlarmAlertZoneList() };
+
+  for( int i = 0; i < 2; i++ )
+    {
+      if( indexes[i]->isDirty() )
+        {
+          QTime t;
+          t.start();
+
+          indexes[i]->build( *lists[i], _globalMapMatrix->getProjection() );
+          m_lateralConflictsValid = false;
+
+          qDebug( "Map::p_lateralConflicts(): Index of %d airspaces built in %dms",
+                  lists[i]->size(), t.elapsed() );
+        }
+    }
+
+  if( m_lateralConflictsValid &&
+      m_lateralConflictPos == pos &&
+      m_lateralConflictAwd == awd )
+    {
+      return m_lateralConflicts;
+    }
+
+  const double nearDist     = awd.horClose.getMeters();
+  const double veryNearDist = awd.horVeryClose.getMeters();
+
+  QList<AirspaceIndex::Hit> hits;
+
+  for( int i = 0; i < 2; i++ )
+    {
+      indexes[i]->query( pos, qMax( nearDist, veryNearDist ), hits );
+    }
+
+  m_lateralConflicts.clear();
+
+  for( int i = 0; i < hits.size(); i++ )
+    {
+      const AirspaceIndex::Hit& hit = hits.at(i);
+
+      Airspace::ConflictType conflict = Airspace::near;
+
+      if( hit.inside )
+        {
+          conflict = Airspace::inside;
+        }
+      else if( hit.distance <= veryNearDist )
+        {
+          conflict = Airspace::veryNear;
+        }
+      else if( hit.distance > nearDist )
+        {
+          continue;
+        }
+
+      m_lateralConflicts.insert( hit.airspace, conflict );
+    }
+
+  m_lateralConflictPos   = pos;
+  m_lateralConflictAwd   = awd;
+  m_lateralConflictsValid = true;
+
+  return m_lateralConflicts;
 }
 
 void Map::p_drawGrid()
@@ -1025,92 +1253,87 @@ void Map::p_drawPlannedTask( QPainter *taskP, QList<TaskPoint*> &drawnTp )
  */
 void Map::p_drawTrail()
 {
-  static uint counter = 0;
-
   // QTime t; t.start();
 
-  int pointCnt = m_trailPoints.size();
+  const FlightTrail& trail = calculator->getFlightTrail();
 
-  if( GeneralConfig::instance()->getMapDrawTrail() == false || pointCnt < 15 )
+  if( GeneralConfig::instance()->getMapDrawTrail() == false || trail.isEmpty() )
     {
       return;
     }
 
-  int step = 2;
-
   double scale = _globalMapMatrix->getScale( MapMatrix::CurrentScale );
 
-  // Set step width according to map scale. The values are nearly seconds.
-  if( scale < 12 )
-    {
-      step = 2;
-    }
-  else if( scale < 15 )
-    {
-      step = 3;
-    }
-  else if( scale < 20 )
-    {
-      step = 4;
-    }
-  else if( scale < 30 )
-    {
-      step = 5;
-    }
-  else if( scale < 40 )
-    {
-      step = 8;
-    }
-  else if( scale < 100 )
-    {
-      step = 10;
-    }
-  else if( scale < 200 )
-    {
-      step = 20;
-    }
-  else
+  if( scale >= 200 )
     {
       // draw nothing up to this scale
       return;
     }
 
-  // view port rectangle
-  QRect rect( QPoint(0, 0), size() );
+  // Select the detail level according to the map scale.
+  const int level = trail.levelFor( scale );
+  const QVector<QPoint>& positions = trail.positions( level );
 
-  // define start conditions
-  int startIdx = counter % step;
-  QPoint startPos = m_trailPoints.at( startIdx );
-
-  int loop = startIdx + step;
-
-  counter++;
+  if( level != m_tppLevel || trail.serial() != m_tppSerial ||
+      m_tppCount > positions.size() )
+    {
+      // The path must be rebuilt from the whole trail.
+      p_calculateTrailPoints();
+      m_tppLevel  = level;
+      m_tppSerial = trail.serial();
+    }
 
-  if( startIdx == 0 || m_tpp.isEmpty() )
+  if( m_tppCount < positions.size() )
     {
-      // Start a recalculation of the trail if start index is zero.
-      if( ! m_tpp.isEmpty() )
-        {
-          // reset painter path
-          m_tpp = QPainterPath();
-        }
+      // Project only the positions, which are new since the last drawing.
+      // The path keeps the already projected positions until the next
+      // projection change.
+      QPolygon wgs( positions.mid( m_tppCount ) );
+      QPolygon points;
 
-      m_tpp.moveTo( startPos );
+      _globalMapMatrix->map( _globalMapMatrix->wgsToMap( wgs ), points );
 
-      while( loop < pointCnt )
+      // view port rectangle
+      QRect rect( QPoint(0, 0), size() );
+
+      for( int i = 0; i < points.size(); i++ )
         {
-          const QPoint& pos = m_trailPoints.at(loop);
+          const QPoint& pos = points.at(i);
 
-          if( rect.contains( startPos ) || rect.contains( pos ) )
+          if( m_tppCount == 0 && i == 0 )
             {
+              m_tppLastPoint = pos;
+              continue;
+            }
+
+          // Only segments touching the view port are added to the path.
+          if( QRect( m_tppLastPoint, pos ).normalized().intersects( rect ) )
+            {
+              if( m_tppConnected == false )
+                {
+                  m_tpp.moveTo( m_tppLastPoint );
+                  m_tppRect |= QRect( m_tppLastPoint, QSize(1, 1) );
+                }
+
               m_tpp.lineTo( pos );
+              m_tppRect |= QRect( pos, QSize(1, 1) );
+              m_tppConnected = true;
+            }
+          else
+            {
+              m_tppConnected = false;
             }
 
-          startPos = pos;
-          loop += step;
+          m_tppLastPoint = pos;
         }
+
+      m_tppCount = positions.size();
     }
 
+  // The newest position is connected to the path, also if it is not
+  // contained in the selected detail level.
+  const QPoint lastPos = _globalMapMatrix->map( _globalMapMatrix->wgsToMap( trail.lastPosition() ) );
+
   qreal penWidth = GeneralConfig::instance()->getMapTrailLineWidth();
   QColor color = GeneralConfig::instance()->getMapTrailColor();
 
@@ -1123,7 +1346,17 @@ void Map::p_drawTrail()
       p.setPen(pen);
       p.setRenderHints( QPainter::Antialiasing | QPainter::SmoothPixmapTransform );
       p.drawPath(m_tpp);
+
+      if( m_tppConnected && lastPos != m_tppLastPoint )
+        {
+          p.drawLine( m_tppLastPoint, lastPos );
+        }
+
       p.end();
+
+      const int pw = static_cast<int> (ceil(penWidth));
+      QRect drawRect = m_tppRect | QRect( lastPos, QSize(1, 1) );
+      m_informationRect |= drawRect.adjusted( -pw, -pw, pw, pw );
     }
 
   // qDebug("Trail, drawTime=%d ms", t.elapsed());
@@ -1131,36 +1364,15 @@ void Map::p_drawTrail()
 
 void Map::p_calculateTrailPoints()
 {
-  // clears the trail point list because map projection has been changed.
-  m_trailPoints.clear();
-
-  // reset trail point painter path
+  // reset trail point painter path because map projection has been changed.
   if( ! m_tpp.isEmpty() )
     {
       m_tpp = QPainterPath();
     }
 
-  if( GeneralConfig::instance()->getMapDrawTrail() == false )
-    {
-      return;
-    }
-
-  QDateTime minTime = calculator->getLastSampleTime().addSecs(- TrailListLength );
-
-  int loop = 0;
-  int sampleCnt = calculator->samplelist.count();
-
-  while( loop < sampleCnt &&
-          loop < TrailListLength &&
-          calculator->samplelist.at(loop).time >= minTime )
-    {
-      // Map WGS84 position to map projection
-      const QPoint& pos = _globalMapMatrix->map(_globalMapMatrix->wgsToMap(calculator->samplelist.at(loop).position));
-
-      // newest positions at first, oldest at last
-      m_trailPoints.append( pos );
-      loop++;
-    }
+  m_tppRect = QRect();
+  m_tppCount = 0;
+  m_tppConnected = false;
 }
 
 void Map::setDrawing(bool isEnable)
@@ -1234,6 +1446,12 @@ void Map::p_redrawMap(mapLayer fromLayer, bool queueRequest)
   //set the map rotation
   m_curMapRot = m_mapRot;
 
+  // The drawing times are passed to the redraw scheduler.
+  QTime frameTime;
+  frameTime.start();
+
+  QTime layerTime;
+
   // draw the layers we need to refresh
   if (fromLayer < aeroLayer)
     {
@@ -1265,26 +1483,41 @@ void Map::p_redrawMap(mapLayer fromLayer, bool queueRequest)
         }
 
       //actually start doing our drawing
+      layerTime.start();
       p_drawBaseLayer();
+      m_redrawScheduler.addDrawTime( RedrawScheduler::Base, layerTime.elapsed() );
     }
 
   if (fromLayer < navigationLayer)
     {
+      layerTime.start();
       p_drawAeroLayer(fromLayer < aeroLayer);
+      m_redrawScheduler.addDrawTime( RedrawScheduler::Aero, layerTime.elapsed() );
     }
 
   if (fromLayer < informationLayer)
     {
+      layerTime.start();
       p_drawNavigationLayer();
+      m_redrawScheduler.addDrawTime( RedrawScheduler::Navigation, layerTime.elapsed() );
     }
 
+  // The area of the map to be repainted.
+  QRect damage = rect();
+
   if (fromLayer < topLayer)
     {
-      p_drawInformationLayer();
-    }
+      layerTime.start();
+      QRect lastRect = p_drawInformationLayer( fromLayer < informationLayer );
+      m_redrawScheduler.addDrawTime( RedrawScheduler::Information, layerTime.elapsed() );
 
-  // copy the new map content into the paint buffer
-  m_pixPaintBuffer = m_pixInformationMap;
+      if( fromLayer >= informationLayer )
+        {
+          // Only the elements of the information layer have been changed,
+          // repaint only their old and new area.
+          damage = lastRect | m_informationRect;
+        }
+    }
 
   // unlock mutex
   setMutex(false);
@@ -1307,11 +1540,22 @@ void Map::p_redrawMap(mapLayer fromLayer, bool queueRequest)
       // Inform MainWindow about first drawing
       emit firstDrawingFinished();
     }
-  else
+  else if( damage.isEmpty() == false )
     {
-      repaint( m_pixPaintBuffer.rect() );
+      repaint( damage );
     }
 
+  m_redrawScheduler.addFrame( frameTime.elapsed() );
+
+  // if( m_redrawScheduler.frames() % 100 == 0 )
+  //   {
+  //     qDebug( "Map::p_redrawMap(): %d frames, last=%dms, avg=%.1fms, max=%dms",
+  //             m_redrawScheduler.frames(),
+  //             m_redrawScheduler.lastFrameTime(),
+  //             m_redrawScheduler.averageFrameTime(),
+  //             m_redrawScheduler.maxFrameTime() );
+  //   }
+
   // @AP: check, if a pending redraw request is active. In this case
   // the scheduler timers will be restarted to handle it.
   if( m_isRedrawEvent )
@@ -1345,29 +1589,123 @@ void Map::p_drawBaseLayer()
       return;
     }
 
-  m_drawnCityList.clear();
-  QList<BaseMapElement *> drawnElements;
+  // make sure we have all the map files we need loaded
+  _globalMapContents->proofeSection();
+
+  double cs = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
+
+  // The view is composed of the base layer tiles covering it. Missing
+  // tiles are rendered now, all others are taken from the cache.
+  const QPoint origin = _globalMapMatrix->getPlaneOrigin();
+  const QRect view( origin, m_pixBaseMap.size() );
+
+  const int firstCol = BaseTileCache::tileOf( view.left() );
+  const int lastCol  = BaseTileCache::tileOf( view.right() );
+  const int firstRow = BaseTileCache::tileOf( view.top() );
+  const int lastRow  = BaseTileCache::tileOf( view.bottom() );
+
+  // The cache shall hold the tiles of the view and of its neighbourhood.
+  m_baseTileCache.setCapacity( 2 * (lastCol - firstCol + 3) * (lastRow - firstRow + 3) );
+
+  BaseTileCache::Key key;
+  key.scale    = qRound( cs );
+  key.rotation = _globalMapMatrix->getRotationStep();
+
+  QList<BaseTileCache::Label> labels;
+
+  QPainter baseMapP;
+
+  baseMapP.begin(&m_pixBaseMap);
+
+  for( key.row = firstRow; key.row <= lastRow; key.row++ )
+    {
+      for( key.col = firstCol; key.col <= lastCol; key.col++ )
+        {
+          BaseTileCache::Tile* tile = m_baseTileCache.tile( key );
+
+          if( tile == 0 )
+            {
+              tile = p_renderBaseTile( key );
+              m_baseTileCache.insert( key, tile );
+            }
+
+          baseMapP.drawPixmap( BaseTileCache::tileRect( key ).topLeft() - origin,
+                               tile->pixmap );
+          labels += tile->labels;
+        }
+    }
+
+  // end the painter
+  baseMapP.end();
+
+  // draw the city labels if scale is not to high
+  if( cs <= 60.0 )
+    {
+      p_drawCityLabels( m_pixBaseMap, labels, origin );
+    }
+
+  // The ring of tiles around the view is rendered in advance, when the
+  // map is idle. So a following map move finds them in the cache.
+  m_baseTilePrefetch.clear();
+
+  for( key.row = firstRow - 1; key.row <= lastRow + 1; key.row++ )
+    {
+      for( key.col = firstCol - 1; key.col <= lastCol + 1; key.col++ )
+        {
+          if( key.row >= firstRow && key.row <= lastRow &&
+              key.col >= firstCol && key.col <= lastCol )
+            {
+              // tile is part of the view
+              continue;
+            }
 
-  // Erase the base layer and fill it with the subterrain color. If there
+          if( m_baseTileCache.contains( key ) == false )
+            {
+              m_baseTilePrefetch.append( key );
+            }
+        }
+    }
+
+  if( m_baseTilePrefetch.isEmpty() == false )
+    {
+      m_baseTileTimer->start( BASE_TILE_PREFETCH_INTERVAL );
+    }
+
+  // calculate the tail points because projection has been changed
+  p_calculateTrailPoints();
+}
+
+BaseTileCache::Tile* Map::p_renderBaseTile( const BaseTileCache::Key& key )
+{
+  BaseTileCache::Tile* tile = new BaseTileCache::Tile;
+
+  tile->pixmap = QPixmap( BaseTileCache::TileSize, BaseTileCache::TileSize );
+
+  // Erase the tile and fill it with the subterrain color. If there
   // are no terrain map data available, this is the default map ground color.
-  m_pixBaseMap.fill( GeneralConfig::instance()->getTerrainColor(0) );
+  tile->pixmap.fill( GeneralConfig::instance()->getTerrainColor(0) );
 
-  // make sure we have all the map files we need loaded
-  _globalMapContents->proofeSection();
+  const QRect rect = BaseTileCache::tileRect( key );
+
+  // All map elements are drawn relative to the tile origin.
+  _globalMapMatrix->beginPlaneRect( rect );
 
   double cs = _globalMapMatrix->getScale(MapMatrix::CurrentScale);
 
+  QList<BaseMapElement *> drawnElements;
+  QList<BaseMapElement *> drawnCities;
+
   // create a pixmap painter
   QPainter baseMapP;
 
-  baseMapP.begin(&m_pixBaseMap);
+  baseMapP.begin(&tile->pixmap);
 
   // first, draw the iso lines
   _globalMapContents->drawIsoList(&baseMapP);
 
   // next, draw the topographical elements and the cities
   _globalMapContents->drawList(&baseMapP, MapContents::TopoList, drawnElements);
-  _globalMapContents->drawList(&baseMapP, MapContents::CityList, m_drawnCityList);
+  _globalMapContents->drawList(&baseMapP, MapContents::CityList, drawnCities);
   _globalMapContents->drawList(&baseMapP, MapContents::LakeList, drawnElements);
 
   // draw the roads, the railroads, the hydro
@@ -1392,14 +1730,60 @@ void Map::p_drawBaseLayer()
   // end the painter
   baseMapP.end();
 
-  // draw the city labels if scale is not to high
-  if( cs <= 60.0 )
+  _globalMapMatrix->endPlaneRect();
+
+  // Save the label positions of the drawn cities in the map plane. The
+  // labels are drawn over the composed tiles, otherwise they would be cut
+  // at the tile borders.
+  for( int i = 0; i < drawnCities.size(); i++ )
     {
-      p_drawCityLabels( m_pixBaseMap );
+      LineElement* city = static_cast<LineElement *> (drawnCities.at(i));
+
+      // Get the screen bounding box of the city in the tile
+      QRect sbRect = city->getScreenBoundingBox();
+
+      if( sbRect.isValid() )
+        {
+          BaseTileCache::Label label;
+          label.name = city->getName();
+          label.pos  = rect.topLeft() +
+                       QPoint( sbRect.x() + sbRect.width() / 2,
+                               sbRect.y() + sbRect.height() / 2 + 3 );
+
+          tile->labels.append( label );
+        }
     }
 
-  // calculate the tail points because projection has been changed
-  p_calculateTrailPoints();
+  return tile;
+}
+
+void Map::slotPrefetchBaseTile()
+{
+  if( mutex() || ! m_isEnable || m_baseTilePrefetch.isEmpty() )
+    {
+      // a running redraw sets up a new prefetch list
+      return;
+    }
+
+  BaseTileCache::Key key = m_baseTilePrefetch.takeFirst();
+
+  if( key.scale != qRound( _globalMapMatrix->getScale(MapMatrix::CurrentScale) ) ||
+      key.rotation != _globalMapMatrix->getRotationStep() )
+    {
+      // The matrix has been changed in the meantime.
+      m_baseTilePrefetch.clear();
+      return;
+    }
+
+  if( m_baseTileCache.contains( key ) == false )
+    {
+      m_baseTileCache.insert( key, p_renderBaseTile( key ) );
+    }
+
+  if( m_baseTilePrefetch.isEmpty() == false )
+    {
+      m_baseTileTimer->start( BASE_TILE_PREFETCH_INTERVAL );
+    }
 }
 
 /**
@@ -1583,13 +1967,31 @@ void Map::p_drawNavigationLayer()
 
 /**
  * Draws the information layer of the map.
- * The information layer consists of the wind arrow, the
- * trail and the position indicator.
+ * The information layer consists of the trail, the position indicator,
+ * the direction lines and the Flarm objects.
  * It is drawn on top of the navigation layer.
  */
-void Map::p_drawInformationLayer()
+QRect Map::p_drawInformationLayer( const bool reset )
 {
-  m_pixInformationMap = m_pixNavigationMap;
+  QRect lastRect = m_informationRect;
+
+  if( reset == true || m_pixInformationMap.size() != m_pixNavigationMap.size() )
+    {
+      m_pixInformationMap = m_pixNavigationMap;
+      lastRect = rect();
+    }
+  else if( m_informationRect.isEmpty() == false )
+    {
+      // Restore the navigation layer in the area of the last drawn elements.
+      // That avoids the copy of the whole navigation layer at every new
+      // position.
+      QPainter p(&m_pixInformationMap);
+      p.setCompositionMode( QPainter::CompositionMode_Source );
+      p.drawPixmap( m_informationRect, m_pixNavigationMap, m_informationRect );
+    }
+
+  // The drawing methods add the areas of their elements.
+  m_informationRect = QRect();
 
   // Draw a glider symbol on the map if GPS has a fix and no manual mode
   // is selected by the user.
@@ -1611,21 +2013,13 @@ void Map::p_drawInformationLayer()
       p_drawX();
     }
 
-  // draw the wind arrow, if pixmap was initialized by slot slotNewWind
-  if( ! m_windArrow.isNull() )
+  if( m_informationRect.isEmpty() == false )
     {
-      QPainter p(&m_pixInformationMap);
-      p.drawPixmap( 10, 10, m_windArrow );
+      // Consider antialiased edges and clip the area to the map.
+      m_informationRect = m_informationRect.adjusted( -2, -2, 2, 2 ) & rect();
     }
 
-  // Draw the zoom buttons at the map
-  QPainter p(&m_pixInformationMap);
-
-  QPixmap plus  = _globalMapConfig->getPlusButton();
-  QPixmap minus = _globalMapConfig->getMinusButton();
-
-  p.drawPixmap( width()-plus.width()-5, 5, plus );
-  p.drawPixmap( width()-minus.width()-5, height()-minus.width()-5, minus);
+  return lastRect;
 }
 
 // Performs an unscheduled, immediate redraw of the entire map.
@@ -1951,15 +2345,15 @@ void Map::p_drawLabel( QPainter* painter,
   painter->restore();
 }
 
-void Map::p_drawCityLabels( QPixmap& pixmap )
+void Map::p_drawCityLabels( QPixmap& pixmap,
+                            const QList<BaseTileCache::Label>& labels,
+                            const QPoint& origin )
 {
-  if( m_drawnCityList.size() == 0 )
+  if( labels.size() == 0 )
     {
       return;
     }
 
-  QString labelText;
-
   QPainter painter(&pixmap);
   QFont font = painter.font();
 
@@ -1972,22 +2366,16 @@ void Map::p_drawCityLabels( QPixmap& pixmap )
 
   QSet<QString> set;
 
-  for( int i = 0; i < m_drawnCityList.size(); i++ )
+  for( int i = 0; i < labels.size(); i++ )
     {
-      LineElement* city = static_cast<LineElement *> (m_drawnCityList.at(i));
+      const BaseTileCache::Label& label = labels.at(i);
 
-      // Get the screen bounding box of the city
-      QRect sbRect = city->getScreenBoundingBox();
-
-      // A city can consist of several segments at a border edge but we want to
-      // draw the name only once.
-      if( sbRect.isValid() && set.contains( city->getName() ) == false )
+      // A city can consist of several segments at a border edge or at tile
+      // edges but we want to draw the name only once.
+      if( set.contains( label.name ) == false )
         {
-          painter.drawText( sbRect.x() + sbRect.width() / 2,
-                            sbRect.y() + sbRect.height() / 2 + 3,
-                            city->getName() );
-
-          set.insert( city->getName() );
+          painter.drawText( label.pos - origin, label.name );
+          set.insert( label.name );
         }
     }
 }
@@ -2288,9 +2676,11 @@ void Map::slotPosition(const QPoint& newPos, const int source)
                 {
                   static QTime lastDisplay = QTime::currentTime();
 
-                  // The display is updated every 1 seconds only.
-                  // That will reduce the X-Server load.
-                  if( lastDisplay.elapsed() < 750 )
+                  // The display is updated according to the drawing costs
+                  // of the information layer only. That will reduce the
+                  // X-Server load on slow devices.
+                  if( lastDisplay.elapsed() <
+                      m_redrawScheduler.interval( RedrawScheduler::Information ) )
                     {
                       scheduleRedraw( informationLayer );
                     }
@@ -2536,6 +2926,11 @@ void Map::p_drawMostRelevantObject( const Flarm::FlarmStatus& status )
 
   painter.setPen( QPen( Qt::black ) );
   painter.drawText( textRect, Qt::AlignCenter, text );
+
+  // All circles have the same size.
+  m_informationRect |= QRect( Rx-diameter/2, Ry-diameter/2,
+                              redCircle.width(), redCircle.height() );
+  m_informationRect |= textRect;
 }
 
 /**
@@ -2593,12 +2988,17 @@ void Map::p_drawSelectedFlarmObject( const Flarm::FlarmAcft& flarmAcft )
   font.setPointSize( MapFlarmLabelFontPointSize + 4 );
   const int triangle = QFontMetrics(font).height();
 
+  // The area covered by the drawn object.
+  QRect objectRect;
+
   if( flarmAcft.Track == INT_MIN )
     {
       // Stealth mode is active, no additional information are available.
       // We draw only a circle.
       painter.drawPixmap(  Rx-diameter/2, Ry-diameter/2, magentaCircle );
       usedObjectSize = diameter;
+      objectRect.setRect( Rx-diameter/2, Ry-diameter/2,
+                          magentaCircle.width(), magentaCircle.height() );
     }
   else
     {
@@ -2614,6 +3014,8 @@ void Map::p_drawSelectedFlarmObject( const Flarm::FlarmAcft& flarmAcft )
 
       painter.drawPixmap(  Rx-triangle/2, Ry-triangle/2, object );
       usedObjectSize = triangle;
+      objectRect.setRect( Rx-triangle/2, Ry-triangle/2,
+                          object.width(), object.height() );
     }
 
   // additional info can be drawn here, like horizontal arelDistancend vertical distance
@@ -2659,6 +3061,9 @@ void Map::p_drawSelectedFlarmObject( const Flarm::FlarmAcft& flarmAcft )
 
   painter.setPen( QPen( Qt::darkMagenta ) );
   painter.drawText( textRect, Qt::AlignCenter, text );
+
+  m_informationRect |= objectRect;
+  m_informationRect |= textRect;
 }
 
 #endif
@@ -2683,17 +3088,6 @@ void Map::p_drawGlider()
       return;
     }
 
-  if( GeneralConfig::instance()->getMapDrawTrail() == true )
-    {
-      // Add the mapped point at the beginning of the tail point list.
-      m_trailPoints.prepend( mapPos );
-
-      if( m_trailPoints.length() > TrailListLength )
-        {
-          m_trailPoints.removeLast();
-        }
-    }
-
   int rot = calcGliderRotation();
 
   //we only want to rotate in steps of 10 degrees. Finer is not useful.
@@ -2711,6 +3105,9 @@ void Map::p_drawGlider()
 
   QPixmap& gl = m_glider[rot];
   p.drawPixmap( Rx - gl.width()/2, Ry - gl.height()/2, gl );
+
+  m_informationRect |= QRect( Rx - gl.width()/2, Ry - gl.height()/2,
+                              gl.width(), gl.height() );
 }
 
 /** Draws the X symbol on the pixmap */
@@ -2742,6 +3139,9 @@ void Map::p_drawX()
   // @ee draw preloaded pixmap
   QPainter p(&m_pixInformationMap);
   p.drawPixmap(  Rx-m_cross.width() / 2, Ry-m_cross.height() / 2, m_cross );
+
+  m_informationRect |= QRect( Rx-m_cross.width() / 2, Ry-m_cross.height() / 2,
+                              m_cross.width(), m_cross.height() );
 }
 
 /** Used to zoom into the map. Will schedule a redraw. */
@@ -2799,6 +3199,17 @@ void Map::slotRedraw( Map::mapLayer fromLayer )
   scheduleRedraw(fromLayer);
 }
 
+void Map::slotMapDataReloaded( Map::mapLayer fromLayer )
+{
+  if( fromLayer == baseLayer )
+    {
+      // The prerendered base layer tiles are outdated.
+      invalidateBaseLayer();
+    }
+
+  scheduleRedraw(fromLayer);
+}
+
 /** Used to zoom the map out. Will schedule a redraw. */
 void Map::slotZoomOut()
 {
@@ -2858,6 +3269,12 @@ void Map::scheduleRedraw(mapLayer fromLayer)
 {
   // qDebug("Map::scheduleRedraw(): mapLayer=%d, loopLevel=%d", fromLayer, qApp->loopLevel() );
 
+  if( fromLayer == airspaces )
+    {
+      // The airspace configuration has been changed, render all airspaces new.
+      m_airspaceOverlayValid = false;
+    }
+
   if( !m_isEnable )
     {
       m_isRedrawEvent = false;
@@ -2876,22 +3293,39 @@ void Map::scheduleRedraw(mapLayer fromLayer)
       return;
     }
 
-  // start resp. restart short timer to combine several draw requests to one
-#ifndef MAEMO
-  m_redrawTimerShort->start(500);
-#else
-  m_redrawTimerShort->start(750);
-#endif
+  // start resp. restart short timer to combine several draw requests to one.
+  // The delay depends on the drawing costs of the requested layers.
+  m_redrawTimerShort->start( m_redrawScheduler.delay( p_schedulerLayer(m_scheduledFromLayer) ) );
 
   if (!m_redrawTimerLong->isActive() && m_ShowGlider)
     {
       // Long timer shall ensure, that a map drawing is executed on expiration
       // in every case. Will be activated only in GPS mode and not in manually
       // mode.
-      m_redrawTimerLong->start(2000);
+      m_redrawTimerLong->start( m_redrawScheduler.longDelay() );
     }
 }
 
+RedrawScheduler::Layer Map::p_schedulerLayer( const mapLayer layer )
+{
+  if( layer < aeroLayer )
+    {
+      return RedrawScheduler::Base;
+    }
+
+  if( layer < navigationLayer )
+    {
+      return RedrawScheduler::Aero;
+    }
+
+  if( layer < informationLayer )
+    {
+      return RedrawScheduler::Navigation;
+    }
+
+  return RedrawScheduler::Information;
+}
+
 
 /** sets a new scale */
 void Map::slotSetScale(const double& newScale)
@@ -2937,6 +3371,9 @@ void Map::p_drawDirectionLine(const QPoint& from)
       lineP.setPen(QPen(col, penWidth, Qt::DashLine));
       lineP.drawLine(from, to);
       lineP.end();
+
+      const int pw = static_cast<int> (ceil(penWidth));
+      m_informationRect |= QRect(from, to).normalized().adjusted( -pw, -pw, pw, pw );
     }
 }
 
@@ -2981,6 +3418,9 @@ void Map::p_drawHeadingLine(const QPoint& from)
   lineP.setPen(QPen(color, penWidth, Qt::SolidLine));
   lineP.drawLine(from, to);
   lineP.end();
+
+  const int pw = static_cast<int> (ceil(penWidth));
+  m_informationRect |= QRect(from, to).normalized().adjusted( -pw, -pw, pw, pw );
 }
 
 /**
@@ -3061,12 +3501,16 @@ void Map::p_drawRelBearingInfo()
       return;
     }
 
+  QRect displayRect( width() / 2 - m_pixRelBearingDisplay.width() / 2, 0,
+                     m_pixRelBearingDisplay.width(),
+                     m_pixRelBearingDisplay.height() );
+
   QPainter painter;
   painter.begin(&m_pixInformationMap);
-  painter.drawPixmap( width() / 2 - m_pixRelBearingDisplay.width() / 2,
-                      0,
-                      m_pixRelBearingDisplay );
+  painter.drawPixmap( displayRect.topLeft(), m_pixRelBearingDisplay );
   painter.end();
+
+  m_informationRect |= displayRect;
 }
 
 /**
@@ -3076,6 +3520,8 @@ void Map::p_drawRelBearingInfo()
  */
 void Map::checkAirspace(const QPoint& pos)
 {
+  BENCHMARK_STAGE( NmeaBenchmark::Airspace );
+
   if ( mutex() )
     {
       return;
@@ -3121,10 +3567,42 @@ void Map::checkAirspace(const QPoint& pos)
 
   bool warn = false; // warning flag
 
-  // check if there are overlaps between the region around our current position and airspaces
-  for( int loop = 0; loop < m_airspaceRegionList.count(); loop++ )
+  // The lateral conflicts of the last check
+  const QHash<Airspace*, Airspace::ConflictType> lastHConflicts = m_lateralConflicts;
+
+  // Query the airspace index for all airspaces near to our current position.
+  const QHash<Airspace*, Airspace::ConflictType> hConflicts =
+      p_lateralConflicts( pos, awd );
+
+  // Only airspaces with a current or a previous lateral conflict have to be
+  // checked, all others cannot cause a conflict change.
+  QList<Airspace *> candidates = hConflicts.keys();
+
+  QHashIterator<Airspace*, Airspace::ConflictType> lit(lastHConflicts);
+
+  while( lit.hasNext() )
     {
-      Airspace* pSpace = m_airspaceRegionList.at(loop)->m_airspace;
+      lit.next();
+
+      if( ! hConflicts.contains( lit.key() ) )
+        {
+          candidates.append( lit.key() );
+        }
+    }
+
+  // The border is stored as FL
+  bool drawingBorder = GeneralConfig::instance()->getAirspaceDrawBorderEnabled();
+  uint asBorder = (uint) rint(GeneralConfig::instance()->getAirspaceDrawingBorder() * 100.0 * Distance::mFromFeet );
+
+  for( int loop = 0; loop < candidates.size(); loop++ )
+    {
+      Airspace* pSpace = candidates.at(loop);
+
+      if( drawingBorder && pSpace->getLowerL() > asBorder )
+        {
+          // Airspaces above the drawing border are not checked.
+          continue;
+        }
 
       if( pSpace->getTypeID() == BaseMapElement::AirFir )
         {
@@ -3143,7 +3621,7 @@ void Map::checkAirspace(const QPoint& pos)
         }
 
       lastVConflict = pSpace->lastVConflict();
-      lastHConflict = m_airspaceRegionList.at(loop)->currentConflict();
+      lastHConflict = lastHConflicts.value( pSpace, Airspace::none );
       lastConflict = (lastHConflict < lastVConflict ? lastHConflict : lastVConflict);
 
       // check for vertical conflicts at first
@@ -3157,8 +3635,8 @@ void Map::checkAirspace(const QPoint& pos)
           continue;
         }
 
-      // check for horizontal conflicts
-      hConflict = m_airspaceRegionList.at(loop)->conflicts(pos, awd);
+      // horizontal conflict from the index query
+      hConflict = hConflicts.value( pSpace, Airspace::none );
 
       // the resulting conflict is always the lesser of the two
       conflict = (hConflict < vConflict ? hConflict : vConflict);
@@ -3281,10 +3759,76 @@ void Map::checkAirspace(const QPoint& pos)
 
     } // End of For loop
 
+  // Look ahead along the track for predicted airspace incursions.
+  QMap<QString, int> newIncursionAsMap; // AS Text and seconds to incursion
+  QMap<QString, int> allIncursionAsMap;
+
+  int lookAhead = GeneralConfig::instance()->getAirspaceLookAheadTime();
+  double speed = calculator->getLastSpeed().getMps();
+
+  if( warningEnabled && lookAhead > 0 && speed >= LOOK_AHEAD_MIN_SPEED )
+    {
+      QList<const AirspaceIndex *> indexes;
+      indexes << &m_airspaceIndex << &m_flarmZoneIndex;
+
+      m_airspacePredictor.update( indexes,
+                                  pos,
+                                  calculator->getlastHeading(),
+                                  speed,
+                                  calculator->getlastVario().getMps(),
+                                  alt,
+                                  lookAhead,
+                                  LOOK_AHEAD_BUDGET );
+
+      QHashIterator<Airspace*, AirspacePredictor::Incursion> pit(m_airspacePredictor.incursions());
+
+      while( pit.hasNext() )
+        {
+          pit.next();
+
+          Airspace* pSpace = pit.key();
+          const AirspacePredictor::Incursion& inc = pit.value();
+
+          if( inc.time <= 0.0 ||
+              pSpace->getTypeID() == BaseMapElement::AirFir ||
+              ! GeneralConfig::instance()->getItemDrawingEnabled(pSpace->getTypeID()) ||
+              (drawingBorder && pSpace->getLowerL() > asBorder) )
+            {
+              // Already inside or not of interest
+              continue;
+            }
+
+          if( pSpace->getTypeID() == BaseMapElement::AirFlarm &&
+              ( pSpace->getFlarmAlertZone().isValid() == false ||
+                pSpace->getFlarmAlertZone().isActive() == false ) )
+            {
+              continue;
+            }
+
+          QString info = pSpace->getInfoString();
+
+          allIncursionAsMap.insert( info, pSpace->getTypeID() );
+
+          // Warn only once per predicted incursion and not, if we are
+          // already inside.
+          if( ! m_incursionAsMap.contains( info ) &&
+              ! allInsideAsMap.contains( info ) )
+            {
+              newIncursionAsMap.insert( info, (int) rint(inc.time) );
+              warn = true;
+            }
+        }
+    }
+  else
+    {
+      m_airspacePredictor.clear();
+    }
+
   // save all conflicting airspaces for the next round
-  m_insideAsMap   = allInsideAsMap;
-  m_veryNearAsMap = allVeryNearAsMap;
-  m_nearAsMap     = allNearAsMap;
+  m_insideAsMap    = allInsideAsMap;
+  m_veryNearAsMap  = allVeryNearAsMap;
+  m_nearAsMap      = allNearAsMap;
+  m_incursionAsMap = allIncursionAsMap;
 
   // redraw the airspaces if needed
   if (needAirspaceRedraw && fillingEnabled)
@@ -3424,6 +3968,20 @@ void Map::checkAirspace(const QPoint& pos)
           }
     }
 
+  // Predicted incursions are always listed.
+  QMapIterator<QString, int> inc(newIncursionAsMap);
+
+  while ( inc.hasNext() )
+    {
+      inc.next();
+
+      text += "<tr><td align=left>"
+           + tr("Entry in %1 s").arg(inc.value())
+           + "</td></tr><tr><td align=left>"
+           + inc.key()
+           + "</td></tr>";
+    }
+
   // Pop up a warning window with all data to touched airspace
   if ( warn == true )
     {
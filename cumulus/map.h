@@ -30,6 +30,7 @@
 #ifndef MAP_H
 #define MAP_H
 
+#include <QHash>
 #include <QMap>
 #include <QMutableMapIterator>
 #include <QPoint>
@@ -40,6 +41,7 @@
 #include <QPixmap>
 #include <QString>
 #include <QList>
+#include <QVector>
 #include <QLabel>
 #include <QEvent>
 #include <QResizeEvent>
@@ -48,7 +50,11 @@
 #include <QWheelEvent>
 
 #include "airspace.h"
+#include "airspaceindex.h"
+#include "airspacepredictor.h"
 #include "airregion.h"
+#include "basetilecache.h"
+#include "redrawscheduler.h"
 #include "flighttask.h"
 #include "speed.h"
 #include "vector.h"
@@ -167,7 +173,8 @@ public:
   /**
    * This function schedules a redraw of the map. It sets two timers:
    * The first timer is set for a small interval, and reset every time scheduleRedraw
-   * is called. This allows for several modifications to the map being used for the
+   * is called. Its interval is adapted by the redraw scheduler to the drawing
+   * costs of the layers to be redrawn. This allows for several modifications to the map being used for the
    * redraw at once.
    * The second timer is set for a larger interval, and is not reset. It makes sure
    * the redraw occurs once in a while, even if events modifying the map keep coming
@@ -203,6 +210,48 @@ public:
       qDeleteAll(m_airspaceRegionList);
       m_airspaceRegionList.clear();
       m_airspaceRegionList = QList<AirRegion *>();
+      invalidateAirspaceIndex();
+      m_airspaceOverlayValid = false;
+    };
+
+  /**
+   * Marks the airspace index as outdated. Must be called, if the airspace
+   * list has been changed.
+   */
+  void invalidateAirspaceIndex()
+    {
+      m_airspaceIndex.setDirty();
+      m_flarmZoneIndex.setDirty();
+      m_lateralConflicts.clear();
+      m_lateralConflictsValid = false;
+    };
+
+  /**
+   * Marks the Flarm alert zone index as outdated. Must be called, if a
+   * Flarm alert zone has been added or changed.
+   */
+  void invalidateFlarmZoneIndex()
+    {
+      m_flarmZoneIndex.setDirty();
+      m_lateralConflictsValid = false;
+    };
+
+  /**
+   * Removes all prerendered base layer tiles. Must be called, if the
+   * content or the style of the base layer has been changed.
+   */
+  void invalidateBaseLayer()
+    {
+      m_baseTileCache.clear();
+      m_baseTilePrefetch.clear();
+    };
+
+  /**
+   * \return The redraw scheduler with the measured drawing times.
+   */
+  const RedrawScheduler& getRedrawScheduler() const
+    {
+      return m_redrawScheduler;
     };
 
 public slots:
@@ -221,6 +270,12 @@ public slots:
   /** Scheduled redraw of the map starting up passed layer. */
   void slotRedraw( Map::mapLayer fromLayer );
 
+  /**
+   * Called, if map data have been reloaded. Schedules a redraw starting
+   * up the passed layer.
+   */
+  void slotMapDataReloaded( Map::mapLayer fromLayer );
+
   /**
    * This slot is called to set a new position. The map object
    * determines if it is necessary to recenter the map or if
@@ -268,6 +323,9 @@ private slots:
   /** Called by timer expiration. */
   void slotASSTimerExpired();
 
+  /** Called by timer expiration to render a base layer tile in advance. */
+  void slotPrefetchBaseTile();
+
 signals:
 
   /**
@@ -313,7 +371,8 @@ signals:
 
 protected:
   /**
-   * Redefinition of paintEvent.
+   * Redefinition of paintEvent. Copies the damaged area of the information
+   * layer to the widget and puts the wind arrow and the zoom buttons on top.
    */
   virtual void paintEvent(QPaintEvent* event);
 
@@ -391,11 +450,28 @@ private:
 
   /**
    * Draws the information layer of the map.
-   * The information layer consists of the flight task, wind arrow, the
-   * trail, the position indicator and the scale.
+   * The information layer consists of the trail, the position indicator,
+   * the direction lines and the Flarm objects.
    * It is drawn on top of the navigation layer.
+   *
+   * @arg reset If set to true, the layer is drawn on a new copy of the
+   *            navigation layer. Otherwise only the area covered by the
+   *            last drawn elements is restored from the navigation layer.
+   * @return The area of the last drawn elements.
    */
-  void p_drawInformationLayer();
+  QRect p_drawInformationLayer( const bool reset );
+
+  /**
+   * \return The layer group of the redraw scheduler, to which the passed
+   *         map layer belongs.
+   */
+  static RedrawScheduler::Layer p_schedulerLayer( const mapLayer layer );
+
+  /**
+   * Draws the wind arrow and the zoom buttons over the map. They are
+   * not part of a layer and are put on top during every paint event.
+   */
+  void p_drawMapButtons( QPainter& painter );
 
   /**
    * Draws the task which is currently planned
@@ -410,7 +486,11 @@ private:
   void p_drawGrid();
 
   /**
-   * Draws the airspaces on the map
+   * Draws the airspaces on the map. The airspaces are rendered into the
+   * airspace overlay, which is then copied onto the aero layer. If the
+   * map has not been moved, only the areas of airspaces with a changed
+   * filling are rendered again.
+   *
    * @arg reset If set to true, the registry of airspaces is reset.
    *            This only needs to be done if a change in which
    *            airspaces are drawn can be expected. Otherwise, it's
@@ -418,6 +498,17 @@ private:
    */
   void p_drawAirspaces(bool reset);
 
+  /**
+   * Determines the lateral conflicts of the airspaces at the passed
+   * position via the airspace index. The index is rebuilt, if it is
+   * outdated. The result of the last call is reused, if position and
+   * warning distances are unchanged.
+   *
+   * @return Hash with all airspaces having a lateral conflict.
+   */
+  const QHash<Airspace*, Airspace::ConflictType>&
+  p_lateralConflicts( const QPoint& pos, const AirspaceWarningDistance& awd );
+
   /**
    * Draws the waypoints of the active waypoint catalog to the map.
    * @arg wpPainter Painter for the waypoints
@@ -432,8 +523,8 @@ private:
   void p_drawTrail();
 
   /**
-   * Calculates the trails points to be used for trail drawing. This method must
-   * be always called after a projection change.
+   * Discards the projected trail points. This method must be always called
+   * after a projection change.
    */
   void p_calculateTrailPoints();
 
@@ -449,8 +540,21 @@ private:
 
   /**
    * Draws the city labels at the map.
+   *
+   * \param pixmap The pixmap to be drawn on.
+   * \param labels The city labels with map plane positions.
+   * \param origin The map plane position of the pixmap origin.
    */
-  void p_drawCityLabels( QPixmap& pixmap );
+  void p_drawCityLabels( QPixmap& pixmap,
+                         const QList<BaseTileCache::Label>& labels,
+                         const QPoint& origin );
+
+  /**
+   * Renders a tile of the base layer.
+   *
+   * \return The rendered tile. The caller becomes the owner of it.
+   */
+  BaseTileCache::Tile* p_renderBaseTile( const BaseTileCache::Key& key );
 
   /**
    * Display Info about Airspace items
@@ -605,19 +709,28 @@ private: //members
   //the basic layer of the map
   QPixmap m_pixBaseMap;
 
+  // prerendered tiles of the base layer
+  BaseTileCache m_baseTileCache;
+
+  // tiles around the view, which are rendered in advance
+  QList<BaseTileCache::Key> m_baseTilePrefetch;
+
+  // timer for rendering of the base layer tiles in advance
+  QTimer* m_baseTileTimer;
+
   //the map, but now including the aeronautical elements
   QPixmap m_pixAeroMap;
 
   //the map, but now including the navigation elements
   QPixmap m_pixNavigationMap;
 
-  //the map, but now including the informational elements
+  // the map, but now including the informational elements. It is used
+  // as buffer for the paint events, it is only modified at the end of
+  // a map drawing.
   QPixmap m_pixInformationMap;
 
-  // this map is used as overall buffer, to make the last painted
-  // map available for paint events even the map is redrawn and
-  // new data are are requested by the window system.
-  QPixmap m_pixPaintBuffer;
+  // The area of the information layer covered by its drawn elements.
+  QRect m_informationRect;
 
   // Pixmap containing relative bearing display.
   QPixmap m_pixRelBearingDisplay;
@@ -637,6 +750,53 @@ private: //members
    */
   QList<AirRegion*> m_airspaceRegionList;
 
+  /** Geographic index over the airspaces for the conflict checks. */
+  AirspaceIndex m_airspaceIndex;
+
+  /** Geographic index over the Flarm alert zones. */
+  AirspaceIndex m_flarmZoneIndex;
+
+  /**
+   * Lateral conflicts at m_lateralConflictPos. Airspaces without a
+   * lateral conflict are not contained.
+   */
+  QHash<Airspace*, Airspace::ConflictType> m_lateralConflicts;
+
+  /** Position and warning distances of the lateral conflicts. */
+  QPoint m_lateralConflictPos;
+  AirspaceWarningDistance m_lateralConflictAwd;
+  bool m_lateralConflictsValid;
+
+  /** Look ahead for airspace incursions along the track. */
+  AirspacePredictor m_airspacePredictor;
+
+  /** An airspace drawn into the airspace overlay. */
+  struct AirspaceOverlayItem
+  {
+    Airspace* airspace;
+
+    /** The filling opacity used for drawing. */
+    qreal opacity;
+
+    /** The screen area covered by the airspace including its outline. */
+    QRect bounds;
+  };
+
+  /**
+   * Transparent pixmap with all drawn airspaces of the current map
+   * position and scale.
+   */
+  QPixmap m_pixAirspaceOverlay;
+
+  /** The airspaces in the overlay in drawing order. */
+  QVector<AirspaceOverlayItem> m_airspaceOverlayItems;
+
+  /** False, if the overlay must be rendered completely. */
+  bool m_airspaceOverlayValid;
+
+  /** The map border used at the last rendering of the overlay. */
+  QRect m_airspaceOverlayBorder;
+
   //contains the layer the next redraw should start from
   mapLayer m_scheduledFromLayer;
 
@@ -648,6 +808,9 @@ private: //members
   QTimer *m_redrawTimerShort;
   /** reference to the long interval redraw timer */
   QTimer *m_redrawTimerLong;
+
+  /** Determines the intervals of the redraw timers. */
+  RedrawScheduler m_redrawScheduler;
   /** Determines weather to draw the glider symbol. */
   bool m_ShowGlider;
 
@@ -696,23 +859,33 @@ protected:
   QMap<QString, int> m_insideAsMap;   // AS Text and AS type
   QMap<QString, int> m_veryNearAsMap; // AS Text and AS type
   QMap<QString, int> m_nearAsMap;     // AS Text and AS type
+  QMap<QString, int> m_incursionAsMap; // AS Text and AS type of predicted incursions
 
   /* Airspace conflicts touch times */
   QMap<QString, QTime> m_insideAsMapTouchTime;   // AS Text and touch time
   QMap<QString, QTime> m_veryNearAsMapTouchTime; // AS Text and touch time
   QMap<QString, QTime> m_nearAsMapTouchTime;     // AS Text and touch time
 
-  /** List of drawn cities. */
-  QList<BaseMapElement *> m_drawnCityList;
+  /** trail point painter path, it is extended by the new trail points. */
+  QPainterPath m_tpp;
+
+  /** Bounding rectangle of the trail painter path. */
+  QRect m_tppRect;
 
-  /** List of mapped positions for trail drawing */
-  QList<QPoint> m_trailPoints;
+  /** Detail level of the trail painter path. */
+  int m_tppLevel;
 
-  /** trail point painter path. */
-  QPainterPath m_tpp;
+  /** Number of trail positions of the detail level added to the path. */
+  int m_tppCount;
+
+  /** Serial of the flight trail at the creation of the path. */
+  uint m_tppSerial;
+
+  /** Last projected trail point of the path. */
+  QPoint m_tppLastPoint;
 
-  /** maximum length of trail list */
-  const int TrailListLength;
+  /** Set, if the path ends at the last projected trail point. */
+  bool m_tppConnected;
 
   /** Timer which activates the airspace status display. */
   QTimer* m_showASSTimer;
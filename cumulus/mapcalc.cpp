@@ -554,3 +554,89 @@ bool MapCalc::calcETAS( const int tk,
 
   return true;
 }
+
+QPolygon MapCalc::simplifyPolygon( const QPolygon& polygon, const int tolerance )
+{
+  const int size = polygon.size();
+
+  if( size < 3 )
+    {
+      return polygon;
+    }
+
+  const QPoint* p = polygon.constData();
+  const qint64 tolerance2 = qint64(tolerance) * qint64(tolerance);
+
+  QVector<bool> keep( size, false );
+  keep[0] = true;
+  keep[size - 1] = true;
+
+  // Sections to be checked, an explicit stack avoids a deep recursion for
+  // long lines.
+  QVector<QPair<int, int> > stack;
+  stack.append( qMakePair( 0, size - 1 ) );
+
+  while( stack.isEmpty() == false )
+    {
+      const int first = stack.last().first;
+      const int last  = stack.last().second;
+      stack.pop_back();
+
+      if( last - first < 2 )
+        {
+          continue;
+        }
+
+      const qint64 dx = p[last].x() - p[first].x();
+      const qint64 dy = p[last].y() - p[first].y();
+      const qint64 len2 = dx * dx + dy * dy;
+
+      double maxDist2 = -1.0;
+      int maxIdx = first;
+
+      for( int i = first + 1; i < last; i++ )
+        {
+          const qint64 px = p[i].x() - p[first].x();
+          const qint64 py = p[i].y() - p[first].y();
+          double dist2;
+
+          if( len2 == 0 )
+            {
+              // Start and end point are identical, e.g. at closed polygons.
+              dist2 = double(px * px + py * py);
+            }
+          else
+            {
+              // Squared distance to the line through first and last point
+              const double cross = double(px * dy - py * dx);
+              dist2 = cross * cross / double(len2);
+            }
+
+          if( dist2 > maxDist2 )
+            {
+              maxDist2 = dist2;
+              maxIdx = i;
+            }
+        }
+
+      if( maxDist2 > double(tolerance2) )
+        {
+          keep[maxIdx] = true;
+          stack.append( qMakePair( first, maxIdx ) );
+          stack.append( qMakePair( maxIdx, last ) );
+        }
+    }
+
+  QPolygon result;
+  result.reserve( size );
+
+  for( int i = 0; i < size; i++ )
+    {
+      if( keep[i] )
+        {
+          result.append( p[i] );
+        }
+    }
+
+  return result;
+}
@@ -17,6 +17,7 @@
 #ifndef MAP_CALC_H
 #define MAP_CALC_H
 
+#include <QPolygon>
 #include <QRect>
 
 #include "speed.h"
@@ -174,6 +175,17 @@ namespace MapCalc
 		 const Speed& ws,
 		 Speed& etas,
 		 int& eth );
+
+  /**
+   * Simplifies a polyline with the Douglas-Peucker algorithm. The first and
+   * the last point are always kept. All removed points are nearer to the
+   * simplified line as the passed tolerance.
+   *
+   * \param polygon The polyline to be simplified.
+   * \param tolerance The maximum deviation in the units of the coordinates.
+   * \return The simplified polyline.
+   */
+  QPolygon simplifyPolygon( const QPolygon& polygon, const int tolerance );
 };
 
 #endif
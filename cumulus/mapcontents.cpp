@@ -42,6 +42,7 @@
 #include "projectionbase.h"
 #include "resource.h"
 #include "taskfilemanager.h"
+#include "TileLoaderThread.h"
 #include "waypointcatalog.h"
 #include "welt2000.h"
 #include "wgspoint.h"
@@ -53,20 +54,14 @@
 extern MapMatrix* _globalMapMatrix;
 extern MapView*   _globalMapView;
 
-#define FILE_FORMAT_ID 100 // used to handle a previous version
-
-#define READ_POINT_LIST\
-  if (compiling) {\
-    in >> locLength;\
-    all.resize(locLength);\
-    for(uint i = 0; i < locLength; i++) { \
-      in >> lat_temp; \
-      in >> lon_temp; \
-      all.setPoint(i, _globalMapMatrix->wgsToMap(lat_temp, lon_temp)); \
-    }\
-    ShortSave(out, all);\
-  } else\
-    ShortLoad(in, all);\
+// Lookahead time in seconds used for the tile prediction along the track.
+#define TILE_PREDICTION_TIME 900
+
+// Number of positions checked along the predicted track.
+#define TILE_PREDICTION_STEPS 3
+
+// Minimum ground speed in m/s to start a tile prediction.
+#define TILE_PREDICTION_MIN_SPEED 10.0
 
 // Minimum amount of required free memory to start loading of a map file.
 // Do not under run this limit, OS can freeze is such a case.
@@ -87,7 +82,8 @@ MapContents::MapContents(QObject* parent, WaitScreen* waitscreen) :
     unloadDone(false),
     memoryFull(false),
     isFirst(true),
-    isReload(false)
+    isReload(false),
+    m_waypointListSerial(0)
 #ifdef INTERNET
 
     , m_downloadMangerMaps(0),
@@ -108,10 +104,23 @@ MapContents::MapContents(QObject* parent, WaitScreen* waitscreen) :
       isoHash.insert( isoLevels[i], i );
     }
 
-  _nextIsoLevel=10000;
-  _lastIsoLevel=-1;
-  _isoLevelReset=true;
-  _lastIsoEntry=0;
+  // Setup the tile loader, which decodes map tiles in an extra thread.
+  m_tileGeneration = 0;
+  m_tileLoader = new TileLoaderThread( this, isoHash );
+  m_tileLoader->setProjection( _globalMapMatrix->getProjection() );
+
+  // Register a special data type for return results. That must be
+  // done to transfer the results between different threads.
+  qRegisterMetaType<MapTilePtr>("MapTilePtr");
+
+  connect( m_tileLoader, SIGNAL(tileLoaded(MapTilePtr)),
+           this, SLOT(slotTileLoaded(MapTilePtr)) );
+
+  connect( m_tileLoader, SIGNAL(progress(int)),
+           this, SIGNAL(progress(int)) );
+
+  connect( m_tileLoader, SIGNAL(loadingFile(const QString&)),
+           this, SIGNAL(loadingFile(const QString&)) );
 
   // read in waypoint list from catalog
   WaypointCatalog wpCat;
@@ -148,6 +157,9 @@ MapContents::MapContents(QObject* parent, WaitScreen* waitscreen) :
 
 MapContents::~MapContents()
 {
+  // Stop the tile loader thread before the map lists are destroyed.
+  m_tileLoader->stop();
+
   if ( currentTask )
     {
       delete currentTask;
@@ -160,6 +172,11 @@ MapContents::~MapContents()
 // save the current waypoint list
 void MapContents::saveWaypointList()
 {
+  // Waypoints can be modified in place or be replaced by others, also if
+  // the list size is kept. Users of the list indices detect that by the
+  // changed serial.
+  m_waypointListSerial++;
+
   WaypointCatalog wpCat;
 
   if( GeneralConfig::instance()->getWaypointFileFormat() == GeneralConfig::Binary )
@@ -173,30 +190,15 @@ void MapContents::saveWaypointList()
 }
 
 /**
- * This method reads in the ground and terrain files from the original
- * kflog source or from the own compiled source. Compiled sources are
- * created from the original kflog source to have a faster access to the
- * single data items. If the map projection is changed the compiled source
- * must be renewed.
- *
- * Ground files describe the surface at level 0m. They are always read in.
- * Terrain files describe the surface above level 0m. If isoline drawing
- * is switched off, terrain files are never read in.
- *
- * Thanks to Josua Dietze for his contribution of precomputed map files.
- *
+ * Checks, if a ground, terrain or map file of a tile can be loaded. That
+ * includes the check of the free memory and of the file existence. If the
+ * file is missing and download is enabled, the user is asked once for the
+ * download of missing map files.
  */
-bool MapContents::readTerrainFile( const int fileSecID, const int fileTypeID )
+bool MapContents::prepareTileFile( const int fileSecID,
+                                   const int fileTypeID,
+                                   const bool download )
 {
-  bool kflExists, kfcExists;
-  bool compiling = false;
-
-  if ( fileTypeID != FILE_TYPE_TERRAIN && fileTypeID != FILE_TYPE_GROUND )
-    {
-      qWarning( "Requested terrain file type 0x%X is unsupported!", fileTypeID );
-      return false;
-    }
-
   // First check if we need to load terrain files.
   if ( fileTypeID == FILE_TYPE_TERRAIN &&
        ( !GeneralConfig::instance()->getMapLoadIsoLines() ))
@@ -237,1164 +239,267 @@ bool MapContents::readTerrainFile( const int fileSecID, const int fileTypeID )
         }
     }
 
-  QString kflPathName, kfcPathName, pathName;
+  QString kflPathName, kfcPathName;
   QString kflName, kfcName;
 
   kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
-  kflExists = locateFile("landscape/" + kflName, kflPathName);
-
   kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
-  kfcExists = locateFile(kfcName, kfcPathName);
-
-  if ( ! (kflExists || kfcExists) )
-    {
-      QString path = GeneralConfig::instance()->getMapRootDir() + "/landscape";
-
-      bool res = false;
-
-#ifdef INTERNET
-
-      res = askUserForDownload();
-
-      if( res == true )
-        {
-          res = downloadMapFile( kflName, path );
-        }
-
-#endif
-
-      if( res == false  )
-        {
-          qWarning( "no map files (%s or %s) found! Please install %s.",
-                    kflName.toLatin1().data(), kfcName.toLatin1().data(),
-                    kflName.toLatin1().data() );
-        }
-
-      return false; // file could not be located in any of the possible map directories.
-    }
-
-  if ( kflExists )
-    {
-      if ( kfcExists )
-        {
-          // kfl file newer than kfc ? Then compile it
-          if (getDateFromMapFile( kflPathName ) > getDateFromMapFile( kfcPathName ))
-            {
-              compiling = true;
-              qDebug("Map file %s has a newer date! Recompiling it from source.",
-                     kflPathName.toLatin1().data() );
-            }
-        }
-      else
-        {
-          // no kfc file, we compile anyway
-          compiling = true;
-        }
-    }
-
-  // what file do we read after all ?
-  if ( compiling )
-    {
-      pathName = kflPathName;
-      kfcPathName = kflPathName;
-      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
-    }
-  else
-    {
-      pathName = kfcPathName;
-      kflPathName = kfcPathName;
-      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
-    }
-
-  QFile mapfile(pathName);
-
-  if( mapfile.size() == 0 )
-    {
-      // qWarning() << "Map file" << pathName << "is empty!";
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  mapfile.remove();
-	}
-
-      return false;
-    }
-
-  if ( !mapfile.open(QIODevice::ReadOnly) )
-    {
-      qWarning("Can't open map file %s for reading", pathName.toLatin1().data() );
-
-      if ( ! compiling && kflExists )
-        {
-          qDebug("Try to use file %s", kflPathName.toLatin1().data());
-          // try to remove unopenable file, not sure if this works.
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      return false;
-    }
-
-  emit loadingFile(pathName);
-
-  QDataStream in(&mapfile);
-
-  if( compiling )
-    {
-      in.setVersion(QDataStream::Qt_3_3);
-    }
-  else
-    {
-      in.setVersion(QDataStream::Qt_4_7);
-    }
-
-  // qDebug("reading file %s", pathName.toLatin1().data());
-
-  qint8 loadTypeID;
-  quint16 loadSecID, formatID;
-  quint32 magic;
-  QDateTime createDateTime;
-  ProjectionBase *projectionFromFile = 0;
-
-  in >> magic;
-  in >> loadTypeID;
-  in >> formatID;
-  in >> loadSecID;
-  in >> createDateTime;
-
-  if( in.status() != QDataStream::Ok )
-    {
-      qWarning() << "Data stream status of" << pathName
-	         << "is NOK! Status=" << in.status();
-      mapfile.close();
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  unlink( pathName.toLatin1().data() );
-	}
-
-      return false;
-    }
-
-  if ( magic != KFLOG_FILE_MAGIC )
-    {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
-                   magic, kflPathName.toLatin1().data());
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning( "Wrong magic key %x read from %s! Removing content.",
-                 magic, pathName.toLatin1().data() );
-      // Some map file does not exists on the server. But if they have
-      // been downloaded, the map server has sent some http page content.
-      // That content makes no sense, therefore the map file content is cleared.
-      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
-      mapfile.close();
-      return false;
-    }
-
-  if (loadTypeID != fileTypeID) // wrong type
-    {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong load type identifier %x read! "
-                   "Retry to compile %s",
-                   loadTypeID, kflPathName.toLatin1().data() );
-          mapfile.remove();
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s wrong load type identifier %x read! ",
-                pathName.toLatin1().data(), loadTypeID );
-
-      return false;
-    }
-
-  // Determine, which file format id is expected
-  int expFormatID, expComFormatID;
-
-  if ( fileTypeID == FILE_TYPE_TERRAIN )
-    {
-      expFormatID = FILE_VERSION_TERRAIN;
-      expComFormatID = FILE_VERSION_TERRAIN_C;
-    }
-  else
-    {
-      expFormatID = FILE_VERSION_GROUND;
-      expComFormatID = FILE_VERSION_GROUND_C;
-    }
-
-  QFileInfo fi( pathName );
-
-  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, formatId=%d, Date=%s",
-         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
-         createDateTime.toString(Qt::ISODate).toLatin1().data() );
-
-  if ( compiling )
-    {
-      // Check map file
-      if ( formatID < expFormatID )
-        {
-          // too old ...
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-      else if (formatID > expFormatID )
-        {
-          // too new ...
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID,expFormatID );
-          return false;
-        }
-    }
-  else
-    {
-      // Check compiled file
-      if ( formatID < expComFormatID )
-        {
-          // too old ...
-          if ( kflExists )
-            {
-              qWarning("File format too old! (version %d, expecting: %d) "
-                       "Retry to compile %s",
-                       formatID, expComFormatID, kflPathName.toLatin1().data() );
-              mapfile.close();
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-      else if (formatID > expComFormatID )
-        {
-          // too new ...
-          if ( kflExists )
-            {
-              qWarning( "File format too new! (version %d, expecting: %d) "
-                        "Retry to compile %s",
-                        formatID, expComFormatID, kflPathName.toLatin1().data() );
-              mapfile.close();
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, expFormatID );
-          return false;
-        }
-    }
-
-  if ( loadSecID != fileSecID )
-    {
-      if ( ! compiling && kflExists )
-        {
-          qWarning( "%s: wrong section, bogus file name!"
-                    "\n Retry to compile %s",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          mapfile.close();
-          unlink( pathName.toLatin1().data() );
-          return readTerrainFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s: wrong section, bogus file name! Arborting ...",
-               pathName.toLatin1().data() );
-      return false;
-    }
-
-  if ( ! compiling )
-    {
-      // check projection parameters from file against current used values
-      projectionFromFile = LoadProjection(in);
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
-
-      if ( ! compareProjections( projectionFromFile, currentProjection ) )
-        {
-          delete projectionFromFile;
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning( "%s, can't use file, compiled for another projection!"
-                        "\n Retry to compile %s",
-                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-
-              unlink( pathName.toLatin1().data() );
-              return readTerrainFile( fileSecID, fileTypeID );
-            }
-
-          qWarning( "%s, can't use file, compiled for another projection!"
-                    " Please install %s file and restart.",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          return false;
-        }
-      else
-        {
-          // Must be deleted after use to avoid memory leak
-          delete projectionFromFile;
-        }
-    }
-
-  // Got to initialize "out" stream properly, even if write file is not needed
-  QFile ausgabe(kfcPathName);
-  QDataStream out(&ausgabe);
-
-  if( compiling )
-    {
-      out.setDevice(&ausgabe);
-      out.setVersion(QDataStream::Qt_4_7);
-
-      if (!ausgabe.open(QIODevice::WriteOnly))
-        {
-          mapfile.close();
-          qWarning("Can't open compiled map file %s for writing!"
-                   " Arborting...",
-                   kfcPathName.toLatin1().data() );
-          return false;
-        }
-
-      qDebug("Writing file %s", kfcPathName.toLatin1().data());
-
-      out << magic;
-      out << loadTypeID;
-      out << quint16(expComFormatID);
-      out << loadSecID;
-
-      //set time one second later than the time of the original file;
-      out << createDateTime.addSecs(1);
-
-      // save current projection data
-      SaveProjection(out, _globalMapMatrix->getProjection() );
-    }
-
-  int loop = 0;
-
-  while ( !in.atEnd() )
-    {
-      qint16 elevation;
-      qint32 pointNumber, lat, lon;
-      QPolygon isoline;
-
-      in >> elevation;
-
-      if ( compiling )
-        {
-          in >> pointNumber;
-          isoline.resize( pointNumber );
-
-          for (int i = 0; i < pointNumber; i++)
-            {
-              in >> lat;
-              in >> lon;
-
-              // This is what causes the long delays, lots of floating point calculations
-              isoline.setPoint( i, _globalMapMatrix->wgsToMap(lat, lon));
-            }
-
-          // Check, if first point and last point of the isoline identical. In this
-          // case we can remove the last point and repeat the check.
-          for( int i = isoline.size() - 1; i >= 0; i-- )
-            {
-              if( isoline.point(0) == isoline.point(i) )
-                 {
-                   //qWarning( "Isoline Tile=%d has same start and end point. Remove end point.",
-                   //           loadSecID );
-
-                   // remove last point and check again
-                   isoline.remove(i);
-                   continue;
-                 }
-
-              break;
-            }
-
-          if( isoline.size() < 3)
-            {
-              // ignore to small isolines
-              qWarning( "Isoline Tile=%d, elevation=%dm has to less points!",
-                         loadSecID, elevation );
-              continue;
-            }
-
-          out << elevation;
-          // And that is the whole trick: saving the computed result. Takes the same space!
-          ShortSave( out, isoline );
-        }
-      else
-        {
-          // Reading the computed result from kfc file
-          ShortLoad( in, isoline );
-        }
-
-      // determine elevation index, 0 is returned as default for not existing values
-      uchar elevationIdx = isoHash.value( elevation, 0 );
-
-      Isohypse newItem(isoline, elevation, elevationIdx, fileSecID, fileTypeID);
-
-      // Check in which map the isohypse has to be stored. We do use two
-      // different maps, one for Ground and another for Terrain. The default
-      // is set to terrain because there are a lot more.
-      QMap<int, QList<Isohypse> > *usedMap = &terrainMap;
-
-      if( fileTypeID == FILE_TYPE_GROUND )
-        {
-          usedMap = &groundMap;
-        }
-
-      // Store new isohypse in the isomap. The tile section identifier is the key.
-      if( usedMap->contains( fileSecID ))
-        {
-          // append isohypse to existing vector
-          QList<Isohypse>& isoList = (*usedMap)[fileSecID];
-          isoList.append( newItem );
-        }
-      else
-        {
-          // create a new entry in the isomap
-          QList<Isohypse> isoList;
-          isoList.append( newItem );
-          usedMap->insert( fileSecID, isoList );
-        }
-
-      // qDebug("Isohypse added: Size=%d, Elevation=%d, FileTypeID=%c",
-      //       isoline.size(), elevation, fileTypeID );
-
-      // AP: Performance brake! emit progress calls wait screen and
-      // this steps into main loop
-      if ( compiling && (++loop % 100) == 0 )
-        {
-          emit progress(2);
-        }
-    }
-
-  // qDebug("loop=%d", loop);
-  mapfile.close();
-
-  if ( compiling )
-    {
-      ausgabe.close();
-    }
 
-  return true;
-}
-
-bool MapContents::readBinaryFile(const int fileSecID, const char fileTypeID)
-{
-  bool kflExists, kfcExists;
-  bool compiling = false;
-
-  //first, check if we need to load this file at all...
-  if ( fileTypeID == FILE_TYPE_TERRAIN &&
-       ( !GeneralConfig::instance()->getMapLoadIsoLines() ))
+  if( locateFile("landscape/" + kflName, kflPathName) ||
+      locateFile(kfcName, kfcPathName) )
     {
       return true;
     }
 
-  if (memoryFull)   //if we already know the memory if full and can't be emptied at this point, just return.
-    {
-      _globalMapView->message(tr("Out of memory! Map not loaded."));
-      return false;
-    }
-
-  //check free memory
-  int memFree = HwInfo::instance()->getFreeMemory();
-
-  if ( memFree < MINIMUM_FREE_MEMORY )
-    {
-      if ( !unloadDone)
-        {
-          unloadMaps();  //try freeing some memory
-          memFree = HwInfo::instance()->getFreeMemory();  //re-asses free memory
-          if ( memFree < MINIMUM_FREE_MEMORY )
-            {
-              memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-              qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-              _globalMapView->message(tr("Out of memory! Map not loaded."));
-              return false;
-            }
-        }
-      else
-        {
-          memoryFull=true; //set flag to indicate that we need not try loading any more mapfiles now.
-          qWarning("Cumulus couldn't load file, low on memory! Memory needed: %d kB, free: %d kB", MINIMUM_FREE_MEMORY, memFree );
-          _globalMapView->message(tr("Out of memory! Map not loaded."));
-          return false;
-        }
-    }
-
-  QString kflPathName, kfcPathName, pathName;
-  QString kflName, kfcName;
-
-  kflName.sprintf("%c_%.5d.kfl", fileTypeID, fileSecID);
-  kflExists = locateFile("landscape/" + kflName, kflPathName);
+  bool res = false;
 
-  kfcName.sprintf("landscape/%c_%.5d.kfc", fileTypeID, fileSecID);
-  kfcExists = locateFile(kfcName, kfcPathName);
+#ifdef INTERNET
 
-  if ( ! (kflExists || kfcExists) )
+  if( download == true )
     {
       QString path = GeneralConfig::instance()->getMapRootDir() + "/landscape";
 
-      bool res = false;
-
-#ifdef INTERNET
-
       res = askUserForDownload();
 
       if( res == true )
         {
           res = downloadMapFile( kflName, path );
         }
-
-#endif
-
-      if( res == false  )
-        {
-          qWarning( "no map files (%s or %s) found! Please install %s.",
-                    kflName.toLatin1().data(), kfcName.toLatin1().data(),
-                    kflName.toLatin1().data() );
-        }
-
-      return false; // file could not be located in any of the possible map directories.
     }
 
-  if ( kflExists )
-    {
-      if ( kfcExists )
-        // kfl file newer than kfc ? Then compile it
-        {
-          if ( getDateFromMapFile( kflPathName ) > getDateFromMapFile( kfcPathName ) )
-            {
-              compiling = true;
-              qDebug("Map file %s has a newer date! Recompiling it from source.",
-                     kflPathName.toLatin1().data() );
-            }
-        }
-      else
-        {
-          // no kfc file, we compile anyway
-          compiling = true;
-        }
-    }
+#else
 
-  // what file do we read after all ?
-  if ( compiling )
-    {
-      pathName = kflPathName;
-      kfcPathName = kflPathName;
-      kfcPathName.replace( kfcPathName.length()-1, 1, QString("c") );
-    }
-  else
-    {
-      pathName = kfcPathName;
-      kflPathName = kfcPathName;
-      kflPathName.replace( kflPathName.length()-1, 1, QString("l") );
-    }
+  Q_UNUSED( download );
 
-  QFile mapfile(pathName);
+#endif
 
-  if( mapfile.size() == 0 )
+  if( res == false  )
     {
-      // qWarning() << "Map file" << pathName << "is empty!";
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  mapfile.remove();
-	}
-
-      return false;
+      qWarning( "no map files (%s or %s) found! Please install %s.",
+                kflName.toLatin1().data(), kfcName.toLatin1().data(),
+                kflName.toLatin1().data() );
     }
 
-  if (!mapfile.open(QIODevice::ReadOnly))
-    {
-      if ( ! compiling && kflExists )
-        {
-          qDebug("Can't open map file %s for reading!"
-                 " Try to use file %s",
-                 pathName.toLatin1().data(), kflPathName.toLatin1().data());
-          // try to remove unopenable file, not sure if this works.
-          mapfile.remove();
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("Can't open map file %s for reading! Aborting ...",
-               pathName.toLatin1().data() );
-      return false;
-    }
+  return false; // file could not be located in any of the possible map directories.
+}
 
-  emit loadingFile(pathName);
+/**
+ * Determines the tile parts, which must be loaded for the passed tile.
+ */
+char MapContents::getMissingTileParts( const int secID, const bool download )
+{
+  char hasstep = 0;
+  char parts = 0;
 
-  QDataStream in(&mapfile);
+  // check to see if parts of this tile has already been loaded before
+  TilePartMap::Iterator it = tilePartMap.find(secID);
 
-  if( compiling )
+  if (it != tilePartMap.end())
     {
-      in.setVersion( QDataStream::Qt_2_0 );
+      hasstep = it.value();
     }
-  else
-    {
-      in.setVersion( QDataStream::Qt_4_7 );
-    }
-
-  // qDebug("reading file %s", pathName.toLatin1().data());
 
-  qint8 loadTypeID;
-  quint16 loadSecID, formatID;
-  quint32 magic;
-  QDateTime createDateTime;
-  ProjectionBase *projectionFromFile = 0;
-
-  in >> magic;
-
-  if ( magic != KFLOG_FILE_MAGIC )
+  if( !(hasstep & TILE_PART_GROUND) &&
+      prepareTileFile( secID, FILE_TYPE_GROUND, download ) )
     {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning("Wrong magic key %x read!\n Retry to compile %s.",
-                   magic, kflPathName.toLatin1().data());
-
-          mapfile.remove();
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning( "Wrong magic key %x read from %s! Removing content.",
-                 magic, pathName.toLatin1().data() );
-      // Some map file does not exists on the server. But if they have
-      // been downloaded, the map server has sent some http page content.
-      // That content makes no sense, therefore the map file content is cleared.
-      mapfile.open( QIODevice::WriteOnly|QIODevice::Truncate );
-      mapfile.close();
-      return false;
+      parts |= TILE_PART_GROUND;
     }
 
-  in >> loadTypeID;
-
-  /** Originally, the binary files were mend to come in different flavors.
-   * Now, they are all of type 'm'. Use that fact to do check for the
-   * compiled or the uncompiled version. */
-  if (compiling)
+  if( !(hasstep & TILE_PART_TERRAIN) &&
+      prepareTileFile( secID, FILE_TYPE_TERRAIN, download ) )
     {
-      // uncompiled maps have a different format identifier than compiled
-      // maps
-      if (loadTypeID != FILE_TYPE_MAP)
-        {
-          qWarning("Wrong load type identifier %x read! Aborting ...",
-                   loadTypeID );
-          mapfile.close();
-          return false;
-        }
+      parts |= TILE_PART_TERRAIN;
     }
-  else
-    {
-      if ( loadTypeID != FILE_TYPE_MAP_C) // wrong type
-        {
-          mapfile.close();
 
-          if ( kflExists )
-            {
-              qWarning("Wrong load type identifier %x read! "
-                       "Retry to compile %s",
-                       loadTypeID, kflPathName.toLatin1().data() );
-              mapfile.remove();
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("%s wrong load type identifier %x read!",
-                   pathName.toLatin1().data(), loadTypeID );
-          return false;
-        }
-    }
-
-  // Check the version of the subtype. This can be different for the
-  // compiled and the uncompiled version.
-  in >> formatID;
-  in >> loadSecID;
-  in >> createDateTime;
-
-  if( in.status() != QDataStream::Ok )
+  if( !(hasstep & TILE_PART_MAP) &&
+      prepareTileFile( secID, FILE_TYPE_MAP, download ) )
     {
-      qWarning() << "Data stream status of" << pathName
-	         << "is NOK! Status=" << in.status();
-      mapfile.close();
-
-      if( ! compiling )
-	{
-	  // Remove corrupted compiled file
-	  unlink( pathName.toLatin1().data() );
-	}
-
-      return false;
+      parts |= TILE_PART_MAP;
     }
 
-  QFileInfo fi( pathName );
-
-  qDebug("Reading File=%s, Magic=0x%x, TypeId=%c, FormatId=%d, Date=%s",
-         fi.fileName().toLatin1().data(), magic, loadTypeID, formatID,
-         createDateTime.toString(Qt::ISODate).toLatin1().data() );
+  return parts;
+}
 
-  if (compiling)
+/**
+ * Takes over the content of a decoded tile into the map element lists.
+ */
+bool MapContents::mergeTile( MapTile& tile )
+{
+  if( tile.generation != m_tileGeneration )
     {
-      if ( formatID < FILE_VERSION_MAP)
-        {
-          // to old ...
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP );
-          mapfile.close();
-          return false;
-        }
-      else if (formatID > FILE_VERSION_MAP)
-        {
-          // to new ...
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP );
-          mapfile.close();
-          return false;
-        }
+      // Tile was decoded for an outdated projection.
+      return false;
     }
-  else
-    {
-      if ( formatID < FILE_VERSION_MAP_C)
-        {
-          // to old ...
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning("File format too old! (version %d, expecting: %d) "
-                       "Retry to compile %s",
-                       formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning("File format too old! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
-          return false;
-        }
-      else if (formatID > FILE_VERSION_MAP_C)
-        {
-          // to new ...
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning( "File format too new! (version %d, expecting: %d) "
-                        "Retry to compile %s",
-                        formatID, FILE_VERSION_MAP_C, kflPathName.toLatin1().data() );
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
 
-          qWarning("File format too new! (version %d, expecting: %d) "
-                   "Aborting ...", formatID, FILE_VERSION_MAP_C );
+  const int secID = tile.secID;
 
-          return false;
-        }
-    }
-
-  // check if this section really covers the area we want to deal with
-  if ( loadSecID != fileSecID )
+  if( tileSectionSet.contains( secID ) )
     {
-      mapfile.close();
-
-      if ( ! compiling && kflExists )
-        {
-          qWarning( "%s: wrong section, bogus file name!"
-                    "\n Retry to compile %s",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          unlink( pathName.toLatin1().data() );
-          return readBinaryFile( fileSecID, fileTypeID );
-        }
-
-      qWarning("%s: wrong section, bogus file name! Aborting ...",
-               pathName.toLatin1().data() );
+      // Tile is already complete.
       return false;
     }
 
-  if ( ! compiling )
-    {
-      // check projection parameters from file against current used values
-      projectionFromFile = LoadProjection(in);
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
-
-      if ( ! compareProjections( projectionFromFile, currentProjection ) )
-        {
-          delete projectionFromFile;
-          mapfile.close();
-
-          if ( kflExists )
-            {
-              qWarning( "%s, can't use file, compiled for another projection!"
-                        "\n Retry to compile %s",
-                        pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-
-              unlink( pathName.toLatin1().data() );
-              return readBinaryFile( fileSecID, fileTypeID );
-            }
-
-          qWarning( "%s, can't use file, compiled for another projection!"
-                    " Please install %s file and restart.",
-                    pathName.toLatin1().data(), kflPathName.toLatin1().data() );
-          return false;
-        }
-      else
-        {
-          // Must be deleted after use to avoid memory leak
-          delete projectionFromFile;
-        }
-    }
+  char hasstep = tilePartMap.value( secID, 0 );
 
-  QFile ausgabe(kfcPathName);
-  QDataStream out(&ausgabe);
+  // Take over only the parts, which are not already loaded.
+  char newParts = tile.loadedParts & ~hasstep;
 
-  if ( compiling )
+  if( newParts == 0 )
     {
-      out.setDevice( &ausgabe );
-      out.setVersion( QDataStream::Qt_4_7 );
-
-      if (!ausgabe.open(QIODevice::WriteOnly))
-        {
-          qWarning("Can't open compiled map file %s for writing!"
-                   " Aborting ...",
-                   kfcPathName.toLatin1().data() );
-          mapfile.close();
-          return false;
-        }
-
-      qDebug("Writing file %s", kfcPathName.toLatin1().data());
-
-      out << magic;
-      loadTypeID = FILE_TYPE_MAP_C;
-      formatID   = FILE_VERSION_MAP_C;
-      out << loadTypeID;
-      out << formatID;
-      out << loadSecID;
-      out << createDateTime.addSecs(1);   //set time one second later than the time of the original file;
-      SaveProjection(out, _globalMapMatrix->getProjection());
+      return false;
     }
 
-  quint8 lm_typ;
-  qint8 sort, elev;
-  qint32 lat_temp, lon_temp;
-  quint32 locLength = 0;
-  QString name = "";
-
-  unsigned int gesamt_elemente = 0;
-  uint loop = 0;
-
-  while ( ! in.atEnd() )
-    {
-      BaseMapElement::objectType typeIn = BaseMapElement::NotSelected;
-      in >> (quint8&)typeIn;
-
-      if ( compiling )
-        out << (quint8&)typeIn;
-
-      locLength = 0;
-      name = "";
-
-      QPolygon all;
-      QPoint single;
-
-      gesamt_elemente++;
-
-      switch (typeIn)
-        {
-        case BaseMapElement::Motorway:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadMotorways() ) break;
-
-          motorwayList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Road:
-        case BaseMapElement::Trail:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadRoads() ) break;
-
-          roadList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Aerial_Cable:
-        case BaseMapElement::Railway:
-        case BaseMapElement::Railway_D:
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadRailways() ) break;
-
-          railList.append( LineElement("", typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::Canal:
-        case BaseMapElement::River:
-        case BaseMapElement::River_T:
-
-          typeIn = BaseMapElement::River; //don't use different river types internally
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadWaterways() ) break;
-
-          hydroList.append( LineElement(name, typeIn, all, false, fileSecID) );
-          break;
-
-        case BaseMapElement::City:
-          in >> sort;
-          if ( compiling )
-            out << sort;
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
-
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
-
-          cityList.append( LineElement(name, typeIn, all, sort, fileSecID) );
-          // qDebug("added city '%s'", name.toLatin1().data());
-          break;
-
-        case BaseMapElement::Lake:
-        case BaseMapElement::Lake_T:
-
-          typeIn=BaseMapElement::Lake; // don't use different lake type internally
-          in >> sort;
-
-          if ( compiling )
-            out << sort;
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-
-          READ_POINT_LIST
+  if( (newParts & TILE_PART_GROUND) && tile.groundList.size() > 0 )
+    {
+      groundMap[secID] += tile.groundList;
+      m_elevationIndex.removeTile( secID );
+    }
 
-          lakeList.append(LineElement(name, typeIn, all, sort, fileSecID));
-          // qDebug("appended lake, name='%s', pointCount=%d", name.toLatin1().data(), all.count());
-          break;
+  if( (newParts & TILE_PART_TERRAIN) && tile.terrainList.size() > 0 )
+    {
+      terrainMap[secID] += tile.terrainList;
+      m_elevationIndex.removeTile( secID );
+    }
 
-        case BaseMapElement::Forest:
-        case BaseMapElement::Glacier:
-        case BaseMapElement::PackIce:
-          in >> sort;
-          if ( compiling )
-            out << sort;
+  if( newParts & TILE_PART_MAP )
+    {
+      cityList     += tile.cityList;
+      hydroList    += tile.hydroList;
+      lakeList     += tile.lakeList;
+      motorwayList += tile.motorwayList;
+      railList     += tile.railList;
+      roadList     += tile.roadList;
+      topoList     += tile.topoList;
+      landmarkList += tile.landmarkList;
+      obstacleList += tile.obstacleList;
+      villageList  += tile.villageList;
+    }
 
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
+  char step = hasstep | newParts;
 
-          READ_POINT_LIST
+  if( step == TILE_PART_ALL ) //set the correct flags for this map tile
+    {
+      tileSectionSet.insert(secID);  // add section id to set
+      tilePartMap.remove(secID); // make sure we don't leave it as partly loaded
+    }
+  else
+    {
+      tilePartMap.insert(secID, step);
+    }
 
-          if ( !GeneralConfig::instance()->getMapLoadForests() ||
-               typeIn == BaseMapElement::Glacier ||
-               typeIn == BaseMapElement::PackIce )
-            {
-              // Cumulus ignores Glacier and PackIce items
-              break;
-            }
+  // Update the latency counter of this tile.
+  TileLatency& latency = m_tileLatencies[secID];
+  latency.loads++;
+  latency.lastDecodeTime = tile.decodeTime;
+  latency.lastTotalTime  = tile.requestTimer.elapsed();
+  latency.maxTotalTime   = qMax( latency.maxTotalTime, latency.lastTotalTime );
 
-          topoList.append( LineElement(name, typeIn, all, sort, fileSecID) );
-          break;
+  // qDebug( "Tile %d merged: parts=%d, decode=%lldms, total=%lldms",
+  //         secID, step, latency.lastDecodeTime, latency.lastTotalTime );
 
-        case BaseMapElement::Village:
+  return true;
+}
 
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              if ( compiling )
-                {
-                  in >> name;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
-          in >> lat_temp;
-          in >> lon_temp;
+/**
+ * Called by the tile loader thread, if a requested tile has been decoded.
+ * The passed tile must be deleted in this method.
+ */
+void MapContents::slotTileLoaded( MapTilePtr tile )
+{
+  m_pendingTiles.remove( tile->secID );
 
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+  bool merged = mergeTile( *tile );
 
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
+  delete tile;
 
-          villageList.append( SinglePoint( name,
-                                           "",
-                                           typeIn,
-                                           WGSPoint(lat_temp, lon_temp),
-                                           single,
-                                           0,
-                                           "",
-                                           "",
-                                           fileSecID ) );
-          // qDebug("added village '%s'", name.toLatin1().data());
-          break;
-
-        case BaseMapElement::Spot:
-
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              in >> elev;
-              if ( compiling )
-                out << elev;
-            }
+  if( merged )
+    {
+      // Redraw the base layer to show the new tile content.
+      emit mapDataReloaded( Map::baseLayer );
+    }
+}
+
+/**
+ * Called, if a new position is available. The tiles along the current track
+ * are predicted from speed and heading and loaded in advance.
+ */
+void MapContents::slotPosition( const QPoint& position, const int source )
+{
+  extern Calculator *calculator;
 
-          in >> lat_temp;
-          in >> lon_temp;
+  if( source != Calculator::GPS || calculator == 0 ||
+      isFirst == true || memoryFull == true )
+    {
+      return;
+    }
 
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+  double speed = calculator->getLastSpeed().getMps();
 
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
+  m_predictedTiles.clear();
 
-          obstacleList.append( SinglePoint( "Spot",
-                                            "",
-                                            typeIn,
-                                            WGSPoint(lat_temp, lon_temp),
-                                            single,
-                                            0,
-                                            "",
-                                            "",
-                                            fileSecID ) );
-          break;
+  if( speed < TILE_PREDICTION_MIN_SPEED )
+    {
+      // Standing on ground or circling slowly, no prediction needed.
+      return;
+    }
 
-        case BaseMapElement::Landmark:
+  int heading = calculator->getlastHeading();
 
-          if (formatID >= FILE_FORMAT_ID)
-            {
-              in >> lm_typ;
-              if ( compiling )
-                {
-                  in >> name;
-                  out << lm_typ;
-                  ShortSave(out, name);
-                }
-              else
-                {
-                  ShortLoad(in, name);
-                }
-            }
+  // Check the current position and some points ahead along the track.
+  for( int i = 0; i <= TILE_PREDICTION_STEPS; i++ )
+    {
+      QPoint pos = position;
 
-          in >> lat_temp;
-          in >> lon_temp;
+      if( i > 0 )
+        {
+          double distance = speed * TILE_PREDICTION_TIME * i / TILE_PREDICTION_STEPS;
+          pos = MapCalc::getPosition( position, distance, heading );
+        }
 
-          if ( !GeneralConfig::instance()->getMapLoadCities() ) break;
+      int secID = tileNumber( pos );
 
-          if ( compiling )
-            {
-              single = _globalMapMatrix->wgsToMap(lat_temp, lon_temp);
-              out << single;
-            }
-          else
-            {
-              in >> single;
-            }
+      if( secID < 0 || secID > MAX_TILE_NUMBER )
+        {
+          continue;
+        }
+
+      m_predictedTiles.insert( secID );
 
-          landmarkList.append( SinglePoint( name,
-                               "",
-                               typeIn,
-                               WGSPoint(lat_temp, lon_temp),
-                               single,
-                               0,
-                               "",
-                               "",
-                               fileSecID ) );
-
-          // qDebug("added landmark '%s'", name.toLatin1().data());
-          break;
-        default:
-          qWarning ("MapContents::__readBinaryFile; type not handled in switch: %d", typeIn);
-          break;
+      if( tileSectionSet.contains( secID ) || m_pendingTiles.contains( secID ) )
+        {
+          continue;
         }
 
-      // @AP: Performance brake! emit progress calls waitscreen and
-      // this steps into main loop
-      if ( compiling && (++loop % 100) == 0 )
+      // Do not ask the user for a download in flight.
+      char parts = getMissingTileParts( secID, false );
+
+      if( parts == 0 )
         {
-          emit progress(2);
+          continue;
         }
-    }
 
-  // qDebug("loop=%d", loop);
-  mapfile.close();
+      // qDebug( "MapContents::slotPosition(): prefetch predicted tile %d", secID );
 
-  if ( compiling )
-    {
-      ausgabe.close();
+      m_pendingTiles.insert( secID );
+      m_tileLoader->requestTile( secID, parts, m_tileGeneration );
     }
+}
 
-  return true;
+/**
+ * Calculates the tile section identifier of the passed WGS84 position.
+ */
+int MapContents::tileNumber( const QPoint& position )
+{
+  // QPoint x is the latitude, y is the longitude.
+  int col = ( ( position.y() / 600000 / 2 ) * 2 + 180 ) / 2;
+  int row = ( ( position.x() / 600000 / 2 ) * 2 - 88 ) / -2;
+
+  if( position.y() < 0 )
+    col -= 1;
+  if( position.x() < 0 )
+    row += 1;
+
+  return row + (col + (row * 179));
 }
 
 #ifdef INTERNET
@@ -1915,8 +1020,6 @@ void MapContents::proofeSection()
 
   unloadDone = false;
   memoryFull = false;
-  char step, hasstep; // used as small integers
-  TilePartMap::Iterator it;
 
   if( isReload )
     {
@@ -1948,7 +1051,8 @@ void MapContents::proofeSection()
           if( secID >= 0 && secID <= MAX_TILE_NUMBER )
             {
               // a valid tile (2x2 degree area) must be in the range 0 ... 16200
-              if( ! tileSectionSet.contains( secID ) )
+              if( ! tileSectionSet.contains( secID ) &&
+                  ! m_pendingTiles.contains( secID ) )
                 {
                   // qDebug(" Tile %d is missing", secID );
                   // Tile is missing
@@ -1969,50 +1073,31 @@ void MapContents::proofeSection()
 
                   // qDebug("Going to load sectionID %d", secID);
 
-                  step = 0;
-                  // check to see if parts of this tile has already been loaded before
-                  it = tilePartMap.find(secID);
-
-                  if (it == tilePartMap.end())
-                    {
-                      //not found
-                      hasstep = 0;
-                    }
-                  else
-                    {
-                      hasstep = it.value();
-                    }
-
-                  //try loading the currently unloaded files
-                  if (!(hasstep & 1))
-                    {
-                      if (readTerrainFile(secID, FILE_TYPE_GROUND))
-                        step |= 1;
-                    }
+                  // Check, which parts of the tile can be loaded.
+                  char parts = getMissingTileParts( secID, true );
 
-                  if (!(hasstep & 2))
+                  if( parts == 0 )
                     {
-                      if (readTerrainFile(secID, FILE_TYPE_TERRAIN))
-                        step |= 2;
+                      continue;
                     }
 
-                  if (!(hasstep & 4))
+                  if( isFirst )
                     {
-                      if (readBinaryFile(secID, FILE_TYPE_MAP))
-                        step |= 4;
-                    }
+                      // During the first load the wait screen is shown,
+                      // the tile is loaded at once.
+                      MapTile tile( secID, m_tileGeneration );
+                      tile.requestedParts = parts;
 
-                  if (step == 7) //set the correct flags for this map tile
-                    {
-                      tileSectionSet.insert(secID);  // add section id to set
-                      tilePartMap.remove(secID); // make sure we don't leave it as partly loaded
+                      m_tileLoader->loadTile( tile );
+                      mergeTile( tile );
                     }
                   else
                     {
-                      if (step > 0)
-                        {
-                          tilePartMap.insert(secID, step);
-                        }
+                      // In flight the tile is loaded by the tile loader
+                      // thread to avoid a blocking of the GUI thread. The
+                      // result is handed over via slotTileLoaded.
+                      m_pendingTiles.insert( secID );
+                      m_tileLoader->requestTile( secID, parts, m_tileGeneration );
                     }
                 }
             }
@@ -2094,6 +1179,9 @@ void MapContents::proofeSection()
             }
         }
 
+      // The point lists have been loaded new.
+      invalidatePointStores();
+
       ws->slot_SetText1(tr("Loading maps done"));
     }
 
@@ -2163,6 +1251,9 @@ void MapContents::unloadMaps(unsigned int distance)
         }
     }
 
+  // Keep the tiles, which were predicted along the flight track.
+  currentTileSet.unite( m_predictedTiles );
+
   bool something2free = false;
 
   // Iterate over all loaded tiles (tileSectionSet) and remove all tiles,
@@ -2218,6 +1309,9 @@ void MapContents::unloadMaps(unsigned int distance)
   unloadMapObjects( groundMap );
   unloadMapObjects( terrainMap );
 
+  // The elevation index is rebuilt on demand for the remaining tiles.
+  m_elevationIndex.clear();
+
 #ifdef DEBUG_UNLOAD
   sum += t.elapsed();
   qDebug("Unload isoList(%d), elapsed=%d", isoList.count(), t.restart());
@@ -2372,6 +1466,13 @@ void MapContents::unloadMapObjects(QMap<int, QList<Isohypse> > isoMap)
  */
 void MapContents::clearList(const int listIndex)
 {
+  PointStore* store = findPointStore( listIndex );
+
+  if( store != static_cast<PointStore *> (0) )
+    {
+      store->invalidate();
+    }
+
   switch (listIndex)
     {
     case AirfieldList:
@@ -2614,14 +1715,24 @@ void MapContents::slotReloadMapData()
   hotspotList = QList<SinglePoint>();
   m_hotspotLoadMutex.unlock();
 
+  invalidatePointStores();
+
   // all isolines are cleared
   groundMap.clear();
   terrainMap.clear();
+  m_elevationIndex.clear();
 
   // tile maps are cleared
   tileSectionSet.clear();
   tilePartMap.clear();
 
+  // Pending tile loads are outdated, their results will be ignored.
+  m_tileGeneration++;
+  m_tileLoader->clearRequests();
+  m_tileLoader->setProjection( _globalMapMatrix->getProjection() );
+  m_pendingTiles.clear();
+  m_predictedTiles.clear();
+
   isFirst  = true;
   isReload = true;
 
@@ -2739,6 +1850,8 @@ void MapContents::slotOpenAipAirfieldLoadFinished( int noOfLists,
   gliderfieldList = QList<Airfield>();
   outLandingList  = QList<Airfield>();
 
+  invalidatePointStores();
+
   emit mapDataReloaded( Map::airfields );
 
   // This signal will update all list views of the main window.
@@ -2795,6 +1908,8 @@ void MapContents::slotOpenAipNavAidLoadFinished( int noOfLists,
   radioList = *radioListIn;
   delete radioListIn;
 
+  m_radioStore.invalidate();
+
   emit mapDataReloaded( Map::navaids );
 
   // This signal will update all list views of the main window.
@@ -2851,6 +1966,8 @@ void MapContents::slotOpenAipHotspotLoadFinished( int noOfLists,
   hotspotList = *hotspotListIn;
   delete hotspotListIn;
 
+  m_hotspotStore.invalidate();
+
   emit mapDataReloaded( Map::hotspots );
 
   // This signal will update all list views of the main window.
@@ -2989,6 +2106,8 @@ void MapContents::slotWelt2000LoadFinished( bool ok,
   outLandingList = *outlandingListIn;
   delete outlandingListIn;
 
+  invalidatePointStores();
+
   // Remove content of radio list. It can contain openAIP data.
   radioList = QList<RadioPoint>();
 
@@ -3090,10 +2209,11 @@ void MapContents::slotNewFlarmAlertZoneData( FlarmBase::FlarmAlertZone& faz )
           x = rint(x);
           y = rint(y);
 
-          aspg.append( _globalMapMatrix->wgsToMap( x, y ) );
+          aspg.append( QPoint( int(x), int(y) ) );
         }
 
-      as->setProjectedPolygon( aspg );
+      as->setWgsPolygon( aspg );
+      as->setProjectedPolygon( _globalMapMatrix->wgsToMap( aspg ) );
     }
 
   // Flarm Alert Zone
@@ -3118,9 +2238,118 @@ void MapContents::slotNewFlarmAlertZoneData( FlarmBase::FlarmAlertZone& faz )
       flarmAlertZoneList.sort();
     }
 
+  // The conflict check must take over the changed zone.
+  Map::getInstance()->invalidateFlarmZoneIndex();
+
   emit mapDataReloaded( Map::airspaces );
 }
 
+template<class T, class D>
+void MapContents::drawPoints( QPainter* targetP,
+                              QList<T>& list,
+                              PointStore& store,
+                              QList<D*>* drawnList )
+{
+  updatePointStore( list, store );
+
+  // The points drawn at the last time get back the marker for not drawn
+  // points. The visible ones get their new map position during drawing.
+  const QVector<int>& lastDrawn = store.drawnPoints();
+
+  for( int i = 0; i < lastDrawn.size(); i++ )
+    {
+      list[lastDrawn.at(i)].setMapPosition( QPoint(-5000, -5000) );
+    }
+
+  QVector<int> visible;
+  store.findInside( _globalMapMatrix->getMapBorder(), visible );
+
+  for( int i = 0; i < visible.size(); i++ )
+    {
+      T& point = list[visible.at(i)];
+
+      if( point.drawMapElement(targetP) && drawnList != 0 )
+        {
+          drawnList->append( &point );
+        }
+    }
+
+  store.setDrawnPoints( visible );
+}
+
+template<class T>
+PointStore* MapContents::updatePointStore( QList<T>& list, PointStore& store )
+{
+  if( store.isOutdated( list.size() ) )
+    {
+      store.build( list );
+    }
+
+  return &store;
+}
+
+PointStore* MapContents::findPointStore( const int listID )
+{
+  switch( listID )
+    {
+    case AirfieldList:
+      return &m_airfieldStore;
+    case GliderfieldList:
+      return &m_gliderfieldStore;
+    case OutLandingList:
+      return &m_outLandingStore;
+    case RadioList:
+      return &m_radioStore;
+    case HotspotList:
+      return &m_hotspotStore;
+    default:
+      return static_cast<PointStore *> (0);
+    }
+}
+
+PointStore* MapContents::getPointStore( const int listID )
+{
+  switch( listID )
+    {
+    case AirfieldList:
+      return updatePointStore( airfieldList, m_airfieldStore );
+    case GliderfieldList:
+      return updatePointStore( gliderfieldList, m_gliderfieldStore );
+    case OutLandingList:
+      return updatePointStore( outLandingList, m_outLandingStore );
+    case RadioList:
+      return updatePointStore( radioList, m_radioStore );
+    case HotspotList:
+      return updatePointStore( hotspotList, m_hotspotStore );
+    default:
+      return static_cast<PointStore *> (0);
+    }
+}
+
+void MapContents::invalidatePointStores()
+{
+  m_airfieldStore.invalidate();
+  m_gliderfieldStore.invalidate();
+  m_outLandingStore.invalidate();
+  m_radioStore.invalidate();
+  m_hotspotStore.invalidate();
+}
+
+const QVector<int>& MapContents::getDrawnPoints( const int listID )
+{
+  static const QVector<int> noPoints;
+
+  PointStore* store = findPointStore( listID );
+
+  if( store == static_cast<PointStore *> (0) ||
+      store->isOutdated( getListLength( listID ) ) )
+    {
+      return noPoints;
+    }
+
+  return store->drawnPoints();
+}
+
 /** Special method to add the drawn objects to the return list,
  * if the required option is set.
  */
@@ -3143,14 +2372,8 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing airports") );
 
-      for (int i = 0; i < airfieldList.size(); i++)
-        {
-          if(  airfieldList[i].drawMapElement(targetP) && showAfLabels )
-            {
-              // required and draw object is appended to the list
-              drawnAfList.append( &airfieldList[i] );
-            }
-        }
+      // drawn objects are appended to the list, if labels are required
+      drawPoints( targetP, airfieldList, m_airfieldStore, showAfLabels ? &drawnAfList : 0 );
 
       break;
 
@@ -3160,14 +2383,8 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing glider sites") );
 
-      for (int i = 0; i < gliderfieldList.size(); i++)
-        {
-          if( gliderfieldList[i].drawMapElement(targetP) && showAfLabels )
-            {
-              // required and draw object is appended to the list
-              drawnAfList.append( &gliderfieldList[i] );
-            }
-        }
+      // drawn objects are appended to the list, if labels are required
+      drawPoints( targetP, gliderfieldList, m_gliderfieldStore, showAfLabels ? &drawnAfList : 0 );
 
       break;
 
@@ -3177,14 +2394,8 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing outlanding sites") );
 
-      for (int i = 0; i < outLandingList.size(); i++)
-        {
-          if( outLandingList[i].drawMapElement(targetP) && showOlLabels )
-            {
-              // required and draw object is appended to the list
-              drawnAfList.append( &outLandingList[i] );
-            }
-        }
+      // drawn objects are appended to the list, if labels are required
+      drawPoints( targetP, outLandingList, m_outLandingStore, showOlLabels ? &drawnAfList : 0 );
 
       break;
 
@@ -3205,13 +2416,7 @@ void MapContents::drawList( QPainter* targetP,
 
   showProgress2WaitScreen( tr("Drawing navaids") );
 
-  for (int i = 0; i < radioList.size(); i++)
-    {
-      if( radioList[i].drawMapElement( targetP ) && showNaLabels )
-	{
-	  drawnNaList.append( &radioList[i] );
-	}
-    }
+  drawPoints( targetP, radioList, m_radioStore, showNaLabels ? &drawnNaList : 0 );
 }
 
 void MapContents::drawList( QPainter* targetP,
@@ -3232,10 +2437,7 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing airports") );
 
-      for (int i = 0; i < airfieldList.size(); i++)
-        {
-          airfieldList[i].drawMapElement(targetP);
-        }
+      drawPoints( targetP, airfieldList, m_airfieldStore, static_cast<QList<Airfield *> *> (0) );
 
       break;
 
@@ -3245,10 +2447,7 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing glider sites") );
 
-      for (int i = 0; i < gliderfieldList.size(); i++)
-        {
-          gliderfieldList[i].drawMapElement(targetP);
-        }
+      drawPoints( targetP, gliderfieldList, m_gliderfieldStore, static_cast<QList<Airfield *> *> (0) );
 
       break;
 
@@ -3258,10 +2457,7 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing outlanding sites") );
 
-      for (int i = 0; i < outLandingList.size(); i++)
-        {
-          outLandingList[i].drawMapElement(targetP);
-        }
+      drawPoints( targetP, outLandingList, m_outLandingStore, static_cast<QList<Airfield *> *> (0) );
 
       break;
 
@@ -3271,10 +2467,7 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing navaids") );
 
-      for (int i = 0; i < radioList.size(); i++)
-	{
-	  radioList[i].drawMapElement(targetP);
-	}
+      drawPoints( targetP, radioList, m_radioStore, static_cast<QList<RadioPoint *> *> (0) );
 
       break;
 
@@ -3284,10 +2477,7 @@ void MapContents::drawList( QPainter* targetP,
 
       showProgress2WaitScreen( tr("Drawing hotspots") );
 
-      for (int i = 0; i < hotspotList.size(); i++)
-	{
-	  hotspotList[i].drawMapElement(targetP);
-	}
+      drawPoints( targetP, hotspotList, m_hotspotStore, static_cast<QList<SinglePoint *> *> (0) );
 
       break;
 
@@ -3445,8 +2635,6 @@ void MapContents::drawIsoList(QPainter* targetP)
   t.start();
 
   extern MapMatrix* _globalMapMatrix;
-  _lastIsoEntry = 0;
-  _isoLevelReset = true;
   pathIsoLines.clear();
   bool isolines = false;
   GeneralConfig *conf = GeneralConfig::instance();
@@ -3565,7 +2753,6 @@ void MapContents::drawIsoList(QPainter* targetP)
 
   targetP->restore();
   pathIsoLines.sort();
-  _isoLevelReset = false;
 
   qDebug( "IsoList, drawTime=%dms", t.elapsed() );
 
@@ -3902,105 +3089,103 @@ bool MapContents::compareProjections(ProjectionBase* p1, ProjectionBase* p2)
   return false;
 }
 
+/**
+ * The real altitude is between the found and the next isolevel, therefore
+ * the middle of both is returned. The error is set to the half level step.
+ */
+static int isoLevelMiddle( int height, double& error )
+{
+  if ( height <100 )
+    {
+      error = 12.5;
+      return height + 12;
+    }
+  else if ( (height >=100) && (height < 500) )
+    {
+      error = 25.0;
+      return height + 25;
+    }
+  else if ( (height >=500) && (height < 1000) )
+    {
+      error = 50.0;
+      return height + 50;
+    }
+
+  error = 125.0;
+  return height + 125;
+}
+
 int MapContents::findElevation(const QPoint& coordP, Distance* errorDist)
 {
   extern MapMatrix* _globalMapMatrix;
 
-  const IsoListEntry* entry = 0;
   int height = 0;
   double error = 0.0;
 
-  QPoint coordP1 = _globalMapMatrix->wgsToMap(coordP.x(), coordP.y());
-  QPoint coord = _globalMapMatrix->map(coordP1);
+  const int secID = tileNumber( coordP );
+
+  if( secID >= 0 && secID < MAX_TILE_NUMBER )
+    {
+      if( ! m_elevationIndex.containsTile( secID ) )
+        {
+          // The index of a tile is built on first use.
+          m_elevationIndex.addTile( secID,
+                                    groundMap.value( secID ),
+                                    terrainMap.value( secID ) );
+        }
+
+      // The index works on the unscaled projected coordinates, no drawn
+      // map is required for the search.
+      QPoint coord = _globalMapMatrix->wgsToMap( coordP.x(), coordP.y() );
 
-  IsoList* list = getIsohypseRegions();
+      m_elevationIndex.findElevation( secID, coord, height );
+    }
+
+  height = isoLevelMiddle( height, error );
 
-  // qDebug("list->count() %d", list->count() );
-  //qDebug("==searching for elevation==");
-  //qDebug("_lastIsoLevel %d, _nextIsoLevel %d",_lastIsoLevel, _nextIsoLevel);
-  if (_isoLevelReset)
+  // if errorDist is set, set the correct error margin
+  if (errorDist)
     {
-      qDebug("findElevation: Busy rebuilding the isomap. Returning last known result...");
-      return _lastIsoLevel;
+      errorDist->setMeters(error);
     }
 
-  int cnt = list->count();
+  return height;
+}
+
+void MapContents::findElevations( const QVector<QPoint>& coords,
+                                  QVector<int>& elevations )
+{
+  extern MapMatrix* _globalMapMatrix;
+
+  elevations.resize( coords.size() );
+
+  double error;
+  int lastSecID = -1;
 
-  for ( int i=0; i<cnt; i++ )
+  for( int i = 0; i < coords.size(); i++ )
     {
-      entry = &(list->at(i));
-      // qDebug("i: %d entry->height %d contains %d",i,entry->height, entry->path->contains(coord) );
-      // qDebug("Point x:%d y:%d", coord.x(), coord.y() );
-      // qDebug("boundingRect l:%d r:%d t:%d b:%d", entry->path->boundingRect().left(),
-      //                                 entry->path->boundingRect().right(),
-      //                                 entry->path->boundingRect().top(),
-      //                                 entry->path->boundingRect().bottom() );
+      const QPoint& coordP = coords.at(i);
+      const int secID = tileNumber( coordP );
 
-      if (entry->height > height && /*there is no reason to search a lower level if we already have a hit on a higher one*/
-          entry->height <= _nextIsoLevel) /* since the odds of skipping a level between two fixes are not too high, we can ignore higher levels, making searching more efficient.*/
+      int height = 0;
+
+      if( secID >= 0 && secID < MAX_TILE_NUMBER )
         {
-          if (entry->height == _lastIsoLevel && _lastIsoEntry)
+          // The tile index check is done only on a tile change.
+          if( secID != lastSecID && ! m_elevationIndex.containsTile( secID ) )
             {
-              //qDebug("Trying previous entry...");
-              if (_lastIsoEntry->path->contains(coord))
-                {
-                  height = qMax(height, entry->height);
-                  //qDebug("Found on height %d",entry->height);
-                  break;
-                }
+              m_elevationIndex.addTile( secID,
+                                        groundMap.value( secID ),
+                                        terrainMap.value( secID ) );
             }
 
-          if (entry == _lastIsoEntry)
-            {
-              continue; //we already tried this one, and it wasn't it.
-            }
+          lastSecID = secID;
 
-          //qDebug("Probing on height %d...", entry->height);
+          QPoint coord = _globalMapMatrix->wgsToMap( coordP.x(), coordP.y() );
 
-          if (entry->path->contains(coord))
-            {
-              height = qMax(height,entry->height);
-              //qDebug("Found on height %d",entry->height);
-              _lastIsoEntry = entry;
-              break;
-            }
+          m_elevationIndex.findElevation( secID, coord, height );
         }
-    }
-
-  _lastIsoLevel = height;
-
-  // The real altitude is between the current and the next
-  // isolevel, therefore reduce error by taking the middle
-  if ( height <100 )
-    {
-      _nextIsoLevel = height+25;
-      height += 12;
-      error=12.5;
-    }
-  else if ( (height >=100) && (height < 500) )
-    {
-      _nextIsoLevel = height+50;
-      height += 25;
-      error=25.0;
-    }
-  else if ( (height >=500) && (height < 1000) )
-    {
-      _nextIsoLevel = height+100;
-      height += 50;
-      error=50.0;
-    }
-  else
-    {
-      _nextIsoLevel = height+250;
-      height += 125;
-      error = 125.0;
-    }
 
-  // if errorDist is set, set the correct error margin
-  if (errorDist)
-    {
-      errorDist->setMeters(error);
+      elevations[i] = isoLevelMiddle( height, error );
     }
-
-  return height;
 }
@@ -42,14 +42,19 @@
 #include <QMap>
 #include <QMutex>
 #include <QString>
+#include <QVector>
 
 #include "airfield.h"
 #include "airspace.h"
+#include "datatypes.h"
 #include "distance.h"
+#include "elevationindex.h"
 #include "flarmbase.h"
 #include "flighttask.h"
 #include "isolist.h"
 #include "map.h"
+#include "maptile.h"
+#include "pointstore.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
 #include "waitscreen.h"
@@ -61,6 +66,7 @@
 class Isohypse;
 class LineElement;
 class SinglePoint;
+class TileLoaderThread;
 
 // number of isoline levels
 #define ISO_LINE_LEVELS 51
@@ -257,6 +263,25 @@ class MapContents : public QObject
                    unsigned int listID,
                    QList<BaseMapElement *>& drawnElements );
 
+    /**
+     * Returns the points of an airfield, glider field, outlanding, navaid
+     * or hotspot list, which have been drawn at the last map drawing.
+     *
+     * @param listID The index of the point list
+     * @return The list indices of the drawn points
+     */
+    const QVector<int>& getDrawnPoints( const int listID );
+
+    /**
+     * Returns the point store of an airfield, glider field, outlanding,
+     * navaid or hotspot list. The store is rebuilt before, if the list has
+     * been changed.
+     *
+     * @param listID The index of the point list
+     * @return The point store of the list or null, if the list has none
+     */
+    PointStore* getPointStore( const int listID );
+
     /**
      * Draws all isohypses into the given painter
      *
@@ -273,10 +298,21 @@ class MapContents : public QObject
     };
 
     /**
-     * Saves the current waypoint list into a file.
+     * Saves the current waypoint list into a file. Every modification of
+     * the waypoint list is saved, therefore the change serial of the list is
+     * incremented here.
      */
     void saveWaypointList();
 
+    /**
+     * @return the change serial of the waypoint list. It is incremented at
+     * every modification of the list.
+     */
+    uint getWaypointListSerial() const
+    {
+      return m_waypointListSerial;
+    };
+
     /**
      * Sets the current flight task.
      */
@@ -354,6 +390,12 @@ class MapContents : public QObject
      */
     int findElevation(const QPoint& coord, Distance* errorDist=0);
 
+    /** Returns the ground elevations in meters of many points at once.
+     * The points are WGS84 coordinates in KFLog units. Consecutive points
+     * should lie close together, the lookup is optimized for such runs.
+     */
+    void findElevations(const QVector<QPoint>& coords, QVector<int>& elevations);
+
     /** Updates the projected coordinates of this map object type */
     void updateProjectedCoordinates( QList<SinglePoint>& list );
     /**
@@ -456,6 +498,23 @@ class MapContents : public QObject
     void slotAirspaceLoadFinished( int noOfLists,
                                    SortableAirspaceList* airspaceListIn );
 
+    /**
+     * This slot is called by the tile loader thread to signal, that a
+     * requested map tile has been decoded. The passed tile is deleted by
+     * this slot.
+     */
+    void slotTileLoaded( MapTilePtr tile );
+
+    /**
+     * This slot is called, if a new position is available. The map tiles
+     * ahead along the flight track are predicted from speed and heading and
+     * loaded in advance by the tile loader thread.
+     *
+     * \param position The new position as WGS84 coordinate.
+     * \param source The source of the position, GPS or manual.
+     */
+    void slotPosition( const QPoint& position, const int source );
+
     /**
      * This slot is called, if a new or updated Flarm Alert Zone is available.
      *
@@ -560,26 +619,45 @@ class MapContents : public QObject
   private:
 
     /**
-     * Reads a binary map file.
+     * Checks, if a ground, terrain or map file of a tile can be loaded. The
+     * free memory and the file existence are checked.
      *
      * @param  fileSecID  The sectionID of the map file
-     * @param  fileTypeID  The typeID of the map file ("M" for additional
-     *                     map data)
+     * @param  fileTypeID  The typeID of the map file
+     * @param  download  If true, the user is asked for the download of a
+     *                   missing file.
      *
-     * @return "true", when the file has successfully been loaded
+     * @return "true", when the file can be loaded
      */
-    bool readBinaryFile(const int fileSecID, const char fileTypeID);
+    bool prepareTileFile( const int fileSecID,
+                          const int fileTypeID,
+                          const bool download );
 
     /**
-     * Reads a binary ground/terrain file.
+     * Determines the parts of a tile, which are not loaded and can be loaded.
      *
-     * @param  fileSecID  The sectionID of the map file
-     * @param  fileTypeID  The typeID of the map file ("G" for ground-data,
-     *                     and "T" for terrain data)
+     * @param  secID  The tile section identifier
+     * @param  download  If true, the user is asked for the download of a
+     *                   missing file.
+     *
+     * @return The parts of the tile to be loaded, see TILE_PART_* flags.
+     */
+    char getMissingTileParts( const int secID, const bool download );
+
+    /**
+     * Takes over the decoded content of a tile into the map element lists.
+     * Tiles of an outdated load generation are ignored.
+     *
+     * @param  tile  The decoded tile
      *
-     * @return "true", when the file has successfully been loaded
+     * @return "true", when new tile content was taken over
      */
-    bool readTerrainFile( const int fileSecID, const int fileTypeID );
+    bool mergeTile( MapTile& tile );
+
+    /**
+     * @return The tile section identifier of the passed WGS84 position.
+     */
+    static int tileNumber( const QPoint& position );
 
     /**
      * Starts a thread, which is loading the requested Welt2000 data.
@@ -624,6 +702,40 @@ class MapContents : public QObject
      */
     void showProgress2WaitScreen( QString message );
 
+    /**
+     * Draws the visible points of a point list. Only the points found via
+     * the point store are touched.
+     *
+     * @param targetP The painter to draw the points into
+     * @param list The point list to be drawn
+     * @param store The point store of the list
+     * @param drawnList If not null, the drawn points are appended to it
+     */
+    template<class T, class D> void drawPoints( QPainter* targetP,
+                                                QList<T>& list,
+                                                PointStore& store,
+                                                QList<D*>* drawnList );
+
+    /**
+     * Brings a point store up to date with its point list.
+     *
+     * @return The passed store
+     */
+    template<class T> PointStore* updatePointStore( QList<T>& list,
+                                                    PointStore& store );
+
+    /**
+     * @return The point store of a point list without an update or null,
+     *         if the list has none.
+     */
+    PointStore* findPointStore( const int listID );
+
+    /**
+     * Marks all point stores as outdated. Must be called, if a point list
+     * has been replaced.
+     */
+    void invalidatePointStores();
+
     /**
      * airfieldList contains airports, airfields, ultralight sites
      */
@@ -649,6 +761,15 @@ class MapContents : public QObject
      */
     QList<SinglePoint> hotspotList;
 
+    /**
+     * Column stores of the projected positions of the point lists above.
+     */
+    PointStore m_airfieldStore;
+    PointStore m_gliderfieldStore;
+    PointStore m_outLandingStore;
+    PointStore m_radioStore;
+    PointStore m_hotspotStore;
+
     /**
      * airspaceList contains all airspaces. The sort function on this
      * list will sort the airspaces from top to bottom. This list must be stay
@@ -742,6 +863,59 @@ class MapContents : public QObject
     typedef QMap<int, char> TilePartMap;
     TilePartMap tilePartMap;
 
+    /**
+     * Thread for decoding of map tiles.
+     */
+    TileLoaderThread* m_tileLoader;
+
+    /**
+     * Tile load generation. It is increased on every map data reload, so
+     * that results of outdated tile loads can be recognized.
+     */
+    int m_tileGeneration;
+
+    /**
+     * Set of tiles requested at the tile loader, but not yet merged.
+     */
+    QSet<int> m_pendingTiles;
+
+    /**
+     * Set of tiles, which were predicted ahead along the flight track. These
+     * tiles are not unloaded.
+     */
+    QSet<int> m_predictedTiles;
+
+    /**
+     * Latency counter of a tile load.
+     */
+    struct TileLatency
+    {
+      TileLatency() :
+        loads(0),
+        lastDecodeTime(0),
+        lastTotalTime(0),
+        maxTotalTime(0)
+      {};
+
+      /** Number of tile loads. */
+      int loads;
+
+      /** Decoding time in ms of the last load. */
+      qint64 lastDecodeTime;
+
+      /** Time in ms from the request until the merge of the last load. */
+      qint64 lastTotalTime;
+
+      /** Maximum time in ms from the request until the merge. */
+      qint64 maxTotalTime;
+    };
+
+    /**
+     * Latency counters of all loaded tiles. The key is the tile section
+     * identifier.
+     */
+    QHash<int, TileLatency> m_tileLatencies;
+
     /**
      * True if an unload call has already been made this 'round' of map drawing.
      */
@@ -771,13 +945,10 @@ class MapContents : public QObject
     IsoList pathIsoLines;
 
     /**
-     * Elevation where the next search for the current elevation will start.
-     * Set to one level higher than the current level by findElevation().
+     * Spatial index over the isolines of all loaded tiles, used by
+     * findElevation().
      */
-    int _nextIsoLevel;
-    int _lastIsoLevel;
-    bool _isoLevelReset;
-    const IsoListEntry* _lastIsoEntry;
+    ElevationIndex m_elevationIndex;
 
     /**
      * Array containing the used elevation levels in meters. Is used as help
@@ -800,6 +971,9 @@ class MapContents : public QObject
      */
     QList<Waypoint> wpList;
 
+    /** Change serial of the waypoint list. */
+    uint m_waypointListSerial;
+
 #ifdef INTERNET
 
     /** Manager to handle downloads of missing map file. */
@@ -35,6 +35,9 @@
 #define NUM_TO_RAD(num) ( (M_PI / 108000000.0) * (double)(num) )
 #define RAD_TO_NUM(rad) ( ( (rad) * (108000000.0 / M_PI) ) )
 
+// Step width in radian of the map rotation
+#define ROTATION_STEP 0.002
+
 // Macros borrowed from FPM ()
 //
 // Fixed point math improves polygon and point mapping;
@@ -69,7 +72,7 @@
 MapMatrix::MapMatrix( QObject* parent ) :
   QObject(parent),
   mapCenterLat(0), mapCenterLon(0),
-  homeLat(0), homeLon(0), cScale(0), pScale(0), rotationArc(0)
+  homeLat(0), homeLon(0), cScale(0), pScale(0), rotationArc(0), rotationStep(0)
 {
   viewBorder.setTop(32000000);
   viewBorder.setBottom(25000000);
@@ -147,12 +150,63 @@ QPoint MapMatrix::wgsToMap(const QPoint& origPoint) const
 }
 
 QPoint MapMatrix::wgsToMap(int lat, int lon) const
+{
+  return wgsToMap( currentProjection, lat, lon );
+}
+
+
+QPoint MapMatrix::wgsToMap(ProjectionBase* projection, int lat, int lon)
 {
   double rLat = NUM_TO_RAD(lat);
   double rLon = NUM_TO_RAD(lon);
 
-  return QPoint((int) (rint(currentProjection->projectX(rLat, rLon) * (RADIUS / MAX_SCALE))),
-                (int) (rint(currentProjection->projectY(rLat, rLon) * (RADIUS / MAX_SCALE))));
+  return QPoint((int) (rint(projection->projectX(rLat, rLon) * (RADIUS / MAX_SCALE))),
+                (int) (rint(projection->projectY(rLat, rLon) * (RADIUS / MAX_SCALE))));
+}
+
+
+void MapMatrix::wgsToMap( ProjectionBase* projection,
+                          const QPoint* wgs,
+                          QPoint* proj,
+                          const int count )
+{
+  // The points are projected in chunks, so that the buffers can be placed
+  // on the stack.
+  enum { ChunkSize = 256 };
+
+  double rLat[ChunkSize];
+  double rLon[ChunkSize];
+  double x[ChunkSize];
+  double y[ChunkSize];
+
+  for( int start = 0; start < count; start += ChunkSize )
+    {
+      const int n = qMin( int(ChunkSize), count - start );
+
+      for( int i = 0; i < n; i++ )
+        {
+          rLat[i] = NUM_TO_RAD(wgs[start + i].x());
+          rLon[i] = NUM_TO_RAD(wgs[start + i].y());
+        }
+
+      projection->project( rLat, rLon, x, y, n );
+
+      for( int i = 0; i < n; i++ )
+        {
+          proj[start + i].rx() = (int) (rint(x[i] * (RADIUS / MAX_SCALE)));
+          proj[start + i].ry() = (int) (rint(y[i] * (RADIUS / MAX_SCALE)));
+        }
+    }
+}
+
+
+QPolygon MapMatrix::wgsToMap(const QPolygon& polygon) const
+{
+  QPolygon projPolygon( polygon.size() );
+
+  wgsToMap( currentProjection, polygon.constData(), projPolygon.data(), polygon.size() );
+
+  return projPolygon;
 }
 
 
@@ -190,6 +244,17 @@ QPoint MapMatrix::__mapToWgs(int x, int y) const
 }
 
 
+QPoint MapMatrix::mapToWgs(ProjectionBase* projection, int x, int y)
+{
+  double lat = RAD_TO_NUM(projection->invertLat(x * (MAX_SCALE / RADIUS),
+                                                y * (MAX_SCALE / RADIUS)));
+  double lon = RAD_TO_NUM(projection->invertLon(x * (MAX_SCALE / RADIUS),
+                                                y * (MAX_SCALE / RADIUS)));
+
+  return QPoint((int)rint(lat), (int)rint(lon));
+}
+
+
 bool MapMatrix::isVisible( const QRect& itemBorder, int typeID) const
 {
   // Grenze: Nahe 15Bit
@@ -250,6 +315,26 @@ int MapMatrix::getScaleRange()  const
     return Border3;
 }
 
+int MapMatrix::getDetailTolerance( const int level )
+{
+  // One projected unit corresponds to MAX_SCALE meters. The tolerances
+  // of level 1, 2, 3 are 100m, 400m and 1600m.
+  return 2 << ((level - 1) * 2);
+}
+
+int MapMatrix::getDetailLevel() const
+{
+  int level = 0;
+
+  while( level < DetailLevels &&
+         getDetailTolerance( level + 1 ) * MAX_SCALE <= cScale )
+    {
+      level++;
+    }
+
+  return level;
+}
+
 QPoint MapMatrix::getMapCenter(bool) const
 {
   return QPoint(mapCenterLat, mapCenterLon);
@@ -380,7 +465,12 @@ void MapMatrix::createMatrix(const QSize& newSize)
 
   /* Set rotating and scaling */
   const double scale = MAX_SCALE / cScale;
-  rotationArc = currentProjection->getRotationArc(tempPoint.x(), tempPoint.y());
+  // The rotation is rounded to fixed steps. So the map plane does not change
+  // with every small center move and prerendered base layer tiles can be
+  // reused.
+  rotationStep = qRound( currentProjection->getRotationArc(tempPoint.x(), tempPoint.y()) /
+                         ROTATION_STEP );
+  rotationArc = rotationStep * ROTATION_STEP;
   // qDebug("rotationArc: %f", rotationArc);
   double sinscaled = sin(rotationArc) * scale;
   double cosscaled = cos(rotationArc) * scale;
@@ -402,6 +492,26 @@ void MapMatrix::createMatrix(const QSize& newSize)
     worldMatrix.translate(curProjCenter.x(),curProjCenter.y());
   */
 
+  __setViewData(newSize);
+
+  //create the map center area definition
+  int vqDist = -viewBorder.height() / 5;
+  int hqDist = viewBorder.width() / 5;
+
+  mapCenterArea=QRect(mapCenterLat - vqDist, mapCenterLon - hqDist, 2* vqDist, 2* hqDist);
+
+  vqDist = mapBorder.height() / 5;
+  hqDist = mapBorder.width() / 5;
+
+  mapCenterAreaProj=QRect(tempPoint.x() - vqDist,
+                          tempPoint.y() - hqDist,
+                          2* vqDist, 2* hqDist);
+
+  emit displayMatrixValues(getScaleRange(), isSwitchScale());
+}
+
+void MapMatrix::__setViewData(const QSize& newSize)
+{
   // Setting the viewBorder
   bool result = true;
   invertMatrix = worldMatrix.inverted( &result );
@@ -430,19 +540,6 @@ void MapMatrix::createMatrix(const QSize& newSize)
   mapBorder = invertMatrix.mapRect( QRect( 0, 0, newSize.width(), newSize.height() ) );
   mapViewSize = newSize;
 
-  //create the map center area definition
-  int vqDist = -viewBorder.height() / 5;
-  int hqDist = viewBorder.width() / 5;
-
-  mapCenterArea=QRect(mapCenterLat - vqDist, mapCenterLon - hqDist, 2* vqDist, 2* hqDist);
-
-  vqDist = mapBorder.height() / 5;
-  hqDist = mapBorder.width() / 5;
-
-  mapCenterAreaProj=QRect(tempPoint.x() - vqDist,
-                          tempPoint.y() - hqDist,
-                          2* vqDist, 2* hqDist);
-
   // fixed math mapping value assignment
   m11 = (fp24p8_t)( worldMatrix.m11() * 16777216.0 );
   m12 = (fp24p8_t)( worldMatrix.m12() * 16777216.0 );
@@ -450,8 +547,45 @@ void MapMatrix::createMatrix(const QSize& newSize)
   m22 = (fp24p8_t)( worldMatrix.m22() * 16777216.0 );
   dx = dtofp24p8( worldMatrix.dx() );
   dy = dtofp24p8( worldMatrix.dy() );
+}
 
-  emit displayMatrixValues(getScaleRange(), isSwitchScale());
+void MapMatrix::beginPlaneRect(const QRect& rect)
+{
+  // Save the view data, they are restored by endPlaneRect.
+  savedState.worldMatrix       = worldMatrix;
+  savedState.invertMatrix      = invertMatrix;
+  savedState.viewBorder        = viewBorder;
+  savedState.mapBorder         = mapBorder;
+  savedState.mapViewSize       = mapViewSize;
+  savedState.m11 = m11;
+  savedState.m12 = m12;
+  savedState.m21 = m21;
+  savedState.m22 = m22;
+  savedState.dx  = dx;
+  savedState.dy  = dy;
+
+  // Replace the translation, so that the rectangle origin becomes the
+  // upper left corner of the view.
+  worldMatrix = QTransform( worldMatrix.m11(), worldMatrix.m12(),
+                            worldMatrix.m21(), worldMatrix.m22(),
+                            -rect.x(), -rect.y() );
+
+  __setViewData( rect.size() );
+}
+
+void MapMatrix::endPlaneRect()
+{
+  worldMatrix  = savedState.worldMatrix;
+  invertMatrix = savedState.invertMatrix;
+  viewBorder   = savedState.viewBorder;
+  mapBorder    = savedState.mapBorder;
+  mapViewSize  = savedState.mapViewSize;
+  m11 = savedState.m11;
+  m12 = savedState.m12;
+  m21 = savedState.m21;
+  m22 = savedState.m22;
+  dx  = savedState.dx;
+  dy  = savedState.dy;
 }
 
 void MapMatrix::slotSetScale(const double& nScale)
@@ -682,6 +816,11 @@ QPolygon MapMatrix::map(const QPolygon &a) const
   return worldMatrix.map(a);
 }
 
+void MapMatrix::map(const QPolygon &a, QPolygon &mapped) const
+{
+  mapped = worldMatrix.map(a);
+}
+
 QPoint MapMatrix::map(const QPoint& p) const
 {
   return worldMatrix.map(p);
@@ -692,35 +831,51 @@ QPoint MapMatrix::map(const QPoint& p) const
 // The new function using fixed point multiplication
 QPolygon MapMatrix::map(const QPolygon &a) const
 {
-  int size = a.size();
-  int64_t fx;
-  int64_t fy;
-  int32_t curx;
-  int32_t cury;
-  int32_t lastx = 0;
-  int32_t lasty = 0;
-
   QPolygon p;
+  map( a, p );
+  return p;
+}
 
+void MapMatrix::map(const QPolygon &a, QPolygon &mapped) const
+{
+  const int size = a.size();
+
+  mapped.resize( size );
+
+  if( size == 0 )
+    {
+      return;
+    }
+
+  // The output is fetched first, a detach of it does not touch the input.
+  // Both can be the same polygon.
+  QPoint* out = mapped.data();
+  const QPoint* in = a.constData();
+
+  // All points are transformed in a loop without dependencies between the
+  // iterations and without branches, so that the compiler can vectorize it.
   for( int i = 0; i < size; i++ )
     {
-      a.point(i, &curx, &cury);
-      fx = itofp24p8( curx );
-      fy = itofp24p8( cury );
+      const int64_t fx = itofp24p8( in[i].x() );
+      const int64_t fy = itofp24p8( in[i].y() );
       // some cheating involved; multiplication with the "wrong" macro
       // after "left shifting" the "m" value in createMatrix
-      curx = fp24p8toi( mulfp8p24(m11,fx) + mulfp8p24(m21,fy) + dx);
-      cury = fp24p8toi( mulfp8p24(m22,fy) + mulfp8p24(m12,fx) + dy);
+      out[i].rx() = fp24p8toi( mulfp8p24(m11,fx) + mulfp8p24(m21,fy) + dx);
+      out[i].ry() = fp24p8toi( mulfp8p24(m22,fy) + mulfp8p24(m12,fx) + dy);
+    }
 
-      if ( (i==0) | ( ((curx - lastx) | (cury - lasty)) != 0) )
+  // Consecutive points at the same pixel are removed in a second pass.
+  int last = 0;
+
+  for( int i = 1; i < size; i++ )
+    {
+      if( out[i] != out[last] )
         {
-          p.append(QPoint(curx, cury));
-          lastx = curx;
-          lasty = cury;
+          out[++last] = out[i];
         }
     }
 
-  return p;
+  mapped.resize( last + 1 );
 }
 
 QPoint MapMatrix::map(const QPoint& p) const
@@ -86,6 +86,48 @@ public:
    */
   QPoint wgsToMap(int lat, int lon) const;
 
+  /**
+   * Converts the given geographic-data into the passed map-projection. Can
+   * be used from other threads with an own projection instance.
+   *
+   * @param  projection The projection to be used.
+   * @param  lat  The latitude of the point to be converted. The point must
+   *              be in the internal format of 1/10.000 minutes.
+   * @param  lon  The longitude of the point to be converted. The point must
+   *              be in the internal format of 1/10.000 minutes.
+   *
+   * @return the projected point
+   */
+  static QPoint wgsToMap(ProjectionBase* projection, int lat, int lon);
+
+  /**
+   * Converts an array of geographic points into the passed map-projection.
+   * The results are identical to the ones of the single point conversion,
+   * but the projection is called only once per chunk of points. Can be used
+   * from other threads with an own projection instance.
+   *
+   * @param  projection The projection to be used.
+   * @param  wgs    The points to be converted. The points must be in the
+   *                internal format of 1/10.000 minutes.
+   * @param  proj   Array for the projected points. It may be the same array
+   *                as wgs, then the points are converted in place.
+   * @param  count  The number of points.
+   */
+  static void wgsToMap( ProjectionBase* projection,
+                        const QPoint* wgs,
+                        QPoint* proj,
+                        const int count );
+
+  /**
+   * Converts the given geographic polygon into the current map-projection.
+   *
+   * @param  polygon  The polygon to be converted. The points must be in
+   *                  the internal format of 1/10.000 minutes.
+   *
+   * @return the projected polygon
+   */
+  QPolygon wgsToMap(const QPolygon& polygon) const;
+
   /**
    * Converts the given geographic-data into the current map-projection.
    *
@@ -119,6 +161,19 @@ public:
    * @return the mapped polygon
    */
   QPolygon map(const QPolygon &pPolygon) const;
+
+  /**
+   * Maps the given projected polygon into the current map-matrix. The
+   * result is stored in the passed polygon, which is resized as needed.
+   * If it is reused for several calls, no memory must be allocated.
+   * Consecutive points, which are mapped to the same pixel, are stored
+   * only once.
+   *
+   * @param  pPolygon  The polygon to be mapped
+   *
+   * @param  mPolygon  The mapped polygon
+   */
+  void map(const QPolygon &pPolygon, QPolygon &mPolygon) const;
 #if 0
   {
     return worldMatrix.map(pPolygon);
@@ -243,11 +298,44 @@ public:
   /** */
   QPoint mapToWgs(const QPoint& pos) const;
 
+  /**
+   * Converts unscaled projected map coordinates back into geographic
+   * coordinates. This is the inverse of the static \ref wgsToMap.
+   *
+   * @param  projection The projection to be used.
+   * @param  x  The unscaled projected x coordinate.
+   * @param  y  The unscaled projected y coordinate.
+   *
+   * @return the point as latitude (x) and longitude (y) in the internal
+   *         format of 1/10.000 minutes.
+   */
+  static QPoint mapToWgs(ProjectionBase* projection, int x, int y);
+
   /**
    *
    */
   int getScaleRange() const;
 
+  /**
+   * Number of simplified geometries, which the map elements can provide
+   * in addition to their full geometry.
+   */
+  enum { DetailLevels = 3 };
+
+  /**
+   * @param level The detail level 1...DetailLevels.
+   *
+   * @return the maximum deviation of the simplified geometry of a detail
+   *         level in projected coordinates.
+   */
+  static int getDetailTolerance( const int level );
+
+  /**
+   * @return the detail level to be drawn at the current scale. The deviation
+   *         of its geometry is at most one pixel. 0 means the full geometry.
+   */
+  int getDetailLevel() const;
+
   /**
    * @return "true", if the current scale is smaller than the border1.
    */
@@ -359,6 +447,36 @@ public:
     return mapCenterAreaProj.intersects(r);
   };
 
+  /**
+   * @returns the map plane position of the upper left view corner. The map
+   * plane is the scaled and rotated, but not translated projection plane.
+   */
+  QPoint getPlaneOrigin() const
+  {
+    return QPoint( -qRound(worldMatrix.dx()), -qRound(worldMatrix.dy()) );
+  };
+
+  /**
+   * @returns the current map rotation as number of rotation steps
+   */
+  int getRotationStep() const
+  {
+    return rotationStep;
+  };
+
+  /**
+   * Sets up the matrix for drawing the passed rectangle of the map plane.
+   * Scale and rotation are kept, the rectangle origin becomes the upper
+   * left corner of the view. Must be always terminated by a call of
+   * endPlaneRect, which restores the previous view.
+   */
+  void beginPlaneRect(const QRect& rect);
+
+  /**
+   * Restores the view after drawing of a map plane rectangle.
+   */
+  void endPlaneRect();
+
   /**
    * @returns the current projection type
    */
@@ -424,6 +542,12 @@ public:
    */
   QPoint __mapToWgs(int x, int y) const;
 
+  /**
+   * Calculates the view borders and the fixed math values from the
+   * world matrix.
+   */
+  void __setViewData(const QSize& newSize);
+
   /**
    * Used map transformation matrix.
    */
@@ -477,6 +601,8 @@ public:
   double pScale;
   /** */
   double rotationArc;
+  /** map rotation as number of rotation steps */
+  int rotationStep;
   /** */
   int scaleBorders[7];
 
@@ -488,6 +614,17 @@ public:
 
   fp24p8_t m11, m12, m21, m22, dx, dy, fx, fy;
 
+  /** View data saved during the drawing of a map plane rectangle. */
+  struct
+  {
+    QTransform worldMatrix;
+    QTransform invertMatrix;
+    QRect viewBorder;
+    QRect mapBorder;
+    QSize mapViewSize;
+    fp24p8_t m11, m12, m21, m22, dx, dy;
+  } savedState;
+
   /** Root path to the map directories */
   QString mapRootDir;
 
@@ -0,0 +1,98 @@
+/***********************************************************************
+**
+**   maptile.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \struct MapTile
+ *
+ * \author Axel Pauli
+ *
+ * \brief Container for the decoded content of one 2x2 degree map tile.
+ *
+ * A map tile consists of up to three files, ground, terrain and map. The
+ * decoded elements of all of them are collected in this container. It is
+ * filled by the \ref TileLoaderThread and handed over as a whole to
+ * \ref MapContents, which merges it into its element lists.
+ *
+ * \date 2016
+ *
+ * \version 1.0
+ */
+
+#ifndef MAP_TILE_H
+#define MAP_TILE_H
+
+#include <QElapsedTimer>
+#include <QList>
+
+#include "isohypse.h"
+#include "lineelement.h"
+#include "singlepoint.h"
+
+/** Bit flags of the tile parts, the same as used in the tilePartMap. */
+#define TILE_PART_GROUND  1
+#define TILE_PART_TERRAIN 2
+#define TILE_PART_MAP     4
+#define TILE_PART_ALL     (TILE_PART_GROUND|TILE_PART_TERRAIN|TILE_PART_MAP)
+
+struct MapTile
+{
+  MapTile( const int secID=-1, const int generation=0 ) :
+    secID(secID),
+    generation(generation),
+    requestedParts(0),
+    loadedParts(0),
+    decodeTime(0)
+  {
+    requestTimer.start();
+  };
+
+  /** The tile section identifier 0...16200. */
+  int secID;
+
+  /**
+   * Load generation of the requester. Results of an older generation are
+   * outdated, e.g. because the projection has been changed meanwhile.
+   */
+  int generation;
+
+  /** The parts, which should be loaded, see TILE_PART_* flags. */
+  char requestedParts;
+
+  /** The parts, which were loaded successfully. */
+  char loadedParts;
+
+  /** Started, when the tile load was requested. */
+  QElapsedTimer requestTimer;
+
+  /** Time in ms needed for the decoding of all tile files. */
+  qint64 decodeTime;
+
+  QList<Isohypse> groundList;
+  QList<Isohypse> terrainList;
+
+  QList<LineElement> cityList;
+  QList<LineElement> hydroList;
+  QList<LineElement> lakeList;
+  QList<LineElement> motorwayList;
+  QList<LineElement> railList;
+  QList<LineElement> roadList;
+  QList<LineElement> topoList;
+
+  QList<SinglePoint> landmarkList;
+  QList<SinglePoint> obstacleList;
+  QList<SinglePoint> villageList;
+};
+
+#endif /* MAP_TILE_H */
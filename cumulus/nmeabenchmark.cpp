@@ -0,0 +1,632 @@
+/***********************************************************************
+**
+**   nmeabenchmark.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <QtCore>
+
+#include "forwardbatch.h"
+#include "gpsnmea.h"
+#include "map.h"
+#include "mapcalc.h"
+#include "nmeabenchmark.h"
+#include "nmeatokenizer.h"
+#include "speed.h"
+
+// Minimum number of sentences parsed by the parser benchmark
+#define PARSER_SENTENCES 200000
+
+// Minimum number of sentences passed through the forward channel benchmark
+#define FORWARD_SENTENCES 200000
+
+// Batch size of the forward channel benchmark, the same as in GpsClient
+#define FORWARD_BATCH_SIZE 8192
+
+// Number of histogram buckets, bucket n counts times below 2^n micro seconds
+#define HISTOGRAM_BUCKETS 21
+
+NmeaBenchmark* NmeaBenchmark::m_instance = 0;
+
+namespace
+{
+  const char* StageNames[NmeaBenchmark::StageCount] =
+    {
+      "Sentence",
+      "Position",
+      "Fix",
+      "Reachable",
+      "Wind",
+      "Airspace",
+      "Render"
+    };
+
+  /**
+   * Reads up to length bytes from the non blocking socket. While the socket
+   * is empty, a pending frame tail of the sender is pushed.
+   *
+   * \return The number of read bytes, less than length, if no more data is
+   *         available.
+   */
+  int readForward( const int socket, ForwardBatch& sender, const int senderSocket,
+                   char* data, const int length )
+  {
+    int done = 0;
+
+    while( done < length )
+      {
+        ssize_t bytes = read( socket, data + done, length - done );
+
+        if( bytes > 0 )
+          {
+            done += bytes;
+            continue;
+          }
+
+        if( bytes < 0 && errno == EINTR )
+          {
+            continue;
+          }
+
+        if( bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+            sender.hasPending() && sender.send( senderSocket ) >= 0 )
+          {
+            continue;
+          }
+
+        break;
+      }
+
+    return done;
+  }
+
+  /**
+   * Receives all available frames like GpsSensorThread::readBatch does and
+   * unbatches their messages.
+   *
+   * \return The number of received messages.
+   */
+  int receiveForward( const int socket, ForwardBatch& sender, const int senderSocket,
+                      QByteArray& buffer, int& check )
+  {
+    int messages = 0;
+
+    while( true )
+      {
+        quint32 batchLen = 0;
+
+        if( readForward( socket, sender, senderSocket,
+                         (char *) &batchLen, sizeof(batchLen) ) != sizeof(batchLen) )
+          {
+            return messages;
+          }
+
+        buffer.resize( batchLen );
+
+        if( readForward( socket, sender, senderSocket,
+                         buffer.data(), batchLen ) != (int) batchLen )
+          {
+            return messages;
+          }
+
+        int pos = 0;
+        ForwardBatch::Type type;
+        const char* data;
+        int length;
+
+        while( ForwardBatch::next( buffer.constData(), buffer.size(), pos, type, data, length ) )
+          {
+            check += length;
+            messages++;
+          }
+      }
+  }
+}
+
+NmeaBenchmark::NmeaBenchmark( const QString& fileName, QObject* parent ) :
+  QObject(parent),
+  m_fileName(fileName),
+  m_recording(false),
+  m_fixSeen(false),
+  m_fixes(0)
+{
+  m_instance = this;
+}
+
+NmeaBenchmark::~NmeaBenchmark()
+{
+  m_instance = 0;
+}
+
+void NmeaBenchmark::addSample( const Stage stage, const qint64 nsecs )
+{
+  if( isRecording() )
+    {
+      m_instance->m_samples[stage].append( nsecs );
+    }
+}
+
+void NmeaBenchmark::slotStart()
+{
+  QStringList sentences;
+
+  if( readFile( sentences ) == false || sentences.isEmpty() )
+    {
+      qWarning() << "NmeaBenchmark: No sentences found in" << m_fileName;
+      QCoreApplication::exit( 1 );
+      return;
+    }
+
+  benchmarkParser( sentences );
+  benchmarkForward( sentences );
+  replay( sentences );
+  QCoreApplication::quit();
+}
+
+void NmeaBenchmark::slotNewFix()
+{
+  m_fixSeen = true;
+}
+
+bool NmeaBenchmark::readFile( QStringList& sentences )
+{
+  QFile file( m_fileName );
+
+  if( ! file.open( QIODevice::ReadOnly | QIODevice::Text ) )
+    {
+      qWarning() << "NmeaBenchmark: Cannot open file" << m_fileName;
+      return false;
+    }
+
+  QTextStream in( &file );
+  QStringList lines;
+
+  while( ! in.atEnd() )
+    {
+      QString line = in.readLine().trimmed();
+
+      if( line.isEmpty() == false )
+        {
+          lines.append( line );
+        }
+    }
+
+  if( m_fileName.endsWith( ".igc", Qt::CaseInsensitive ) )
+    {
+      convertIgc( lines, sentences );
+      return true;
+    }
+
+  for( int i = 0; i < lines.size(); i++ )
+    {
+      // Take over only NMEA sentences, a log can contain other lines too.
+      if( lines.at(i).startsWith( '$' ) || lines.at(i).startsWith( '!' ) )
+        {
+          sentences.append( lines.at(i) );
+        }
+    }
+
+  return true;
+}
+
+void NmeaBenchmark::convertIgc( const QStringList& lines, QStringList& sentences )
+{
+  QString date = "010116";
+  QPoint lastPos;
+  QTime lastTime;
+
+  for( int i = 0; i < lines.size(); i++ )
+    {
+      const QString& line = lines.at(i);
+
+      if( line.startsWith( "HFDTE" ) )
+        {
+          // H-Record, Date, Examples HFDTE270614 or HFDTEDATE:270614,01
+          QString value = line.mid( 5 );
+
+          if( value.startsWith( "DATE:" ) )
+            {
+              value = value.mid( 5 );
+            }
+
+          date = value.left( 6 );
+          continue;
+        }
+
+      // 0           1          2            3
+      // 0 123456 78901234 567890123 4 56789 01234
+      // B 155706 5229791N 01331393E A 00000 00081
+      if( line.startsWith( 'B' ) == false || line.size() < 35 )
+        {
+          continue;
+        }
+
+      const QString time = line.mid( 1, 6 );
+      const QString lat  = line.mid( 7, 4 ) + "." + line.mid( 11, 3 );
+      const QString latNS = line.mid( 14, 1 );
+      const QString lon  = line.mid( 15, 5 ) + "." + line.mid( 20, 3 );
+      const QString lonEW = line.mid( 23, 1 );
+      const QString status = ( line.mid( 24, 1 ) == "A" ) ? "A" : "V";
+      const int baroAlt = line.mid( 25, 5 ).toInt();
+      const int gnssAlt = line.mid( 30, 5 ).toInt();
+
+      // Position in KFLog units for speed and track
+      int latK = line.mid( 7, 2 ).toInt() * 600000 + line.mid( 9, 5 ).toInt() * 10;
+      int lonK = line.mid( 15, 3 ).toInt() * 600000 + line.mid( 18, 5 ).toInt() * 10;
+
+      if( latNS == "S" )
+        {
+          latK = -latK;
+        }
+
+      if( lonEW == "W" )
+        {
+          lonK = -lonK;
+        }
+
+      QPoint pos( latK, lonK );
+      QTime qtime = QTime::fromString( time, "HHmmss" );
+
+      double knots = 0.0;
+      double track = 0.0;
+
+      if( lastTime.isValid() && qtime.isValid() )
+        {
+          const int dt = lastTime.secsTo( qtime );
+          const double dist = MapCalc::dist( &lastPos, &pos ) * 1000.0;
+
+          if( dt > 0 )
+            {
+              Speed speed( dist / dt );
+              knots = speed.getKnots();
+            }
+
+          if( dist > 0.5 )
+            {
+              track = MapCalc::getBearingWgs( lastPos, pos ) * 180.0 / M_PI;
+            }
+        }
+
+      lastPos  = pos;
+      lastTime = qtime;
+
+      QString rmc = QString( "$GPRMC,%1,%2,%3,%4,%5,%6,%7,%8,%9,,,A" )
+                      .arg( time ).arg( status )
+                      .arg( lat ).arg( latNS ).arg( lon ).arg( lonEW )
+                      .arg( knots, 0, 'f', 1 ).arg( track, 0, 'f', 1 )
+                      .arg( date );
+
+      QString gga = QString( "$GPGGA,%1,%2,%3,%4,%5,%6,08,1.0,%7,M,0.0,M,," )
+                      .arg( time )
+                      .arg( lat ).arg( latNS ).arg( lon ).arg( lonEW )
+                      .arg( status == "A" ? 1 : 0 )
+                      .arg( gnssAlt );
+
+      sentences.append( addCheckSum( rmc ) );
+      sentences.append( addCheckSum( gga ) );
+
+      if( baroAlt != 0 )
+        {
+          // Pressure altitude in feet
+          QString rmz = QString( "$PGRMZ,%1,f,2" )
+                          .arg( qRound( baroAlt / 0.3048 ) );
+
+          sentences.append( addCheckSum( rmz ) );
+        }
+    }
+}
+
+QString NmeaBenchmark::addCheckSum( const QString& sentence )
+{
+  uint sum = GpsNmea::calcCheckSum( sentence.toLatin1().data() );
+
+  return sentence + QString( "*%1" ).arg( sum, 2, 16, QChar('0') ).toUpper();
+}
+
+void NmeaBenchmark::benchmarkParser( const QStringList& sentences )
+{
+  const int rounds = qMax( 1, PARSER_SENTENCES / sentences.size() );
+  const int count  = rounds * sentences.size();
+
+  QHash<QString, short> gpsKeys;
+  GpsNmea::getGpsMessageKeys( gpsKeys );
+
+  NmeaIdTable idTable;
+  QHashIterator<QString, short> it( gpsKeys );
+
+  while( it.hasNext() )
+    {
+      it.next();
+      idTable.insert( it.key().toLatin1(), it.value() );
+    }
+
+  // Avoids, that the compiler removes the loops.
+  int check = 0;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  // The former parsing of GpsNmea::slot_sentence
+  for( int r = 0; r < rounds; r++ )
+    {
+      for( int i = 0; i < sentences.size(); i++ )
+        {
+          QStringList slst = sentences.at(i).split( QRegExp("[,*]"),
+                                                    QString::KeepEmptyParts );
+
+          check += gpsKeys.value( slst[0], -1 ) + slst.size();
+        }
+    }
+
+  const qint64 splitNsecs = qMax( Q_INT64_C(1), timer.nsecsElapsed() );
+
+  timer.start();
+
+  NmeaTokenizer tokenizer;
+
+  for( int r = 0; r < rounds; r++ )
+    {
+      for( int i = 0; i < sentences.size(); i++ )
+        {
+          const QByteArray sentence = sentences.at(i).toLatin1();
+
+          tokenizer.tokenize( sentence.constData(), sentence.size() );
+
+          check -= idTable.find( tokenizer[0] ) + tokenizer.size();
+        }
+    }
+
+  const qint64 tokenizerNsecs = qMax( Q_INT64_C(1), timer.nsecsElapsed() );
+
+  fprintf( stdout, "NMEA parser benchmark, %d sentences, check %d\n", count, check );
+  fprintf( stdout, "  Split    %12.0f sentences/s\n", count * 1e9 / splitNsecs );
+  fprintf( stdout, "  Tokenize %12.0f sentences/s\n", count * 1e9 / tokenizerNsecs );
+  fflush( stdout );
+}
+
+void NmeaBenchmark::benchmarkForward( const QStringList& sentences )
+{
+  int sockets[2];
+
+  if( socketpair( AF_UNIX, SOCK_STREAM, 0, sockets ) == -1 )
+    {
+      qWarning() << "NmeaBenchmark: socketpair() returns with ERROR: errno="
+                 << errno << strerror(errno);
+      return;
+    }
+
+  // The client writes non blocking. The reader must not block too, because
+  // both sides run in the same thread.
+  fcntl( sockets[0], F_SETFL, O_NONBLOCK );
+  fcntl( sockets[1], F_SETFL, O_NONBLOCK );
+
+  QList<QByteArray> messages;
+
+  for( int i = 0; i < sentences.size(); i++ )
+    {
+      messages.append( sentences.at(i).toLatin1() );
+    }
+
+  const int rounds = qMax( 1, FORWARD_SENTENCES / messages.size() );
+  const int count  = rounds * messages.size();
+
+  fprintf( stdout, "Forward channel benchmark, %d sentences\n", count );
+
+  // The first pass sends every sentence as an own frame, as before the
+  // batching. The second pass collects the sentences like GpsClient does.
+  const int batchSizes[2] = { 0, FORWARD_BATCH_SIZE };
+  const char* passNames[2] = { "Single", "Batched" };
+
+  for( int p = 0; p < 2; p++ )
+    {
+      ForwardBatch batch;
+      QByteArray buffer;
+      int dropped  = 0;
+      int received = 0;
+      int check    = 0;
+
+      QElapsedTimer timer;
+      timer.start();
+
+      for( int r = 0; r < rounds; r++ )
+        {
+          for( int i = 0; i < messages.size(); i++ )
+            {
+              const QByteArray& msg = messages.at(i);
+
+              batch.append( ForwardBatch::GpsData, msg.constData(), msg.size() );
+
+              if( batch.size() < batchSizes[p] )
+                {
+                  continue;
+                }
+
+              dropped  += qMax( 0, batch.send( sockets[0] ) );
+              received += receiveForward( sockets[1], batch, sockets[0], buffer, check );
+            }
+        }
+
+      dropped  += qMax( 0, batch.send( sockets[0] ) );
+      received += receiveForward( sockets[1], batch, sockets[0], buffer, check );
+
+      const qint64 nsecs = qMax( Q_INT64_C(1), timer.nsecsElapsed() );
+
+      fprintf( stdout, "  %-8s %12.0f sentences/s, %d received, %d dropped, check %d\n",
+               passNames[p], received * 1e9 / nsecs, received, dropped, check );
+    }
+
+  fflush( stdout );
+
+  close( sockets[0] );
+  close( sockets[1] );
+}
+
+void NmeaBenchmark::replay( const QStringList& sentences )
+{
+  connect( GpsNmea::gps, SIGNAL(newFix(const QDateTime&)),
+           this, SLOT(slotNewFix()) );
+
+  for( int i = 0; i < StageCount; i++ )
+    {
+      m_samples[i].clear();
+    }
+
+  m_fixes = 0;
+  m_recording = true;
+
+  QElapsedTimer total;
+  total.start();
+
+  QElapsedTimer timer;
+
+  for( int i = 0; i < sentences.size(); i++ )
+    {
+      m_fixSeen = false;
+
+      timer.start();
+      GpsNmea::gps->slot_sentence( sentences.at(i) );
+      addSample( Sentence, timer.nsecsElapsed() );
+
+      if( m_fixSeen == false )
+        {
+          continue;
+        }
+
+      m_fixes++;
+
+      // Render the map synchronously instead of waiting for the redraw timers.
+      if( Map::instance )
+        {
+          timer.start();
+          QMetaObject::invokeMethod( Map::instance, "slotRedrawMap" );
+          addSample( Render, timer.nsecsElapsed() );
+        }
+
+      // Handle the events posted during the fix processing like the event
+      // loop does between two fixes.
+      QCoreApplication::processEvents();
+    }
+
+  const qint64 totalNsecs = total.nsecsElapsed();
+
+  m_recording = false;
+
+  disconnect( GpsNmea::gps, SIGNAL(newFix(const QDateTime&)),
+              this, SLOT(slotNewFix()) );
+
+  report( totalNsecs );
+}
+
+void NmeaBenchmark::report( const qint64 totalNsecs )
+{
+  fprintf( stdout, "NMEA replay of %s\n", m_fileName.toLatin1().data() );
+  fprintf( stdout, "  %d sentences, %d fixes in %.3f s, %.1f fixes/s\n",
+           m_samples[Sentence].size(), m_fixes, totalNsecs / 1e9,
+           totalNsecs > 0 ? m_fixes * 1e9 / totalNsecs : 0.0 );
+
+  fprintf( stdout, "  %-10s %8s %10s %10s %10s %10s %10s   (us)\n",
+           "Stage", "Count", "Mean", "P50", "P90", "P99", "Max" );
+
+  for( int s = 0; s < StageCount; s++ )
+    {
+      QVector<qint64> samples = m_samples[s];
+
+      if( samples.isEmpty() )
+        {
+          fprintf( stdout, "  %-10s %8d\n", StageNames[s], 0 );
+          continue;
+        }
+
+      qSort( samples.begin(), samples.end() );
+
+      double sum = 0.0;
+
+      for( int i = 0; i < samples.size(); i++ )
+        {
+          sum += samples.at(i);
+        }
+
+      const int last = samples.size() - 1;
+
+      fprintf( stdout, "  %-10s %8d %10.1f %10.1f %10.1f %10.1f %10.1f\n",
+               StageNames[s],
+               samples.size(),
+               sum / samples.size() / 1000.0,
+               samples.at( last * 50 / 100 ) / 1000.0,
+               samples.at( last * 90 / 100 ) / 1000.0,
+               samples.at( last * 99 / 100 ) / 1000.0,
+               samples.at( last ) / 1000.0 );
+    }
+
+  // Histograms with logarithmic buckets
+  for( int s = 0; s < StageCount; s++ )
+    {
+      const QVector<qint64>& samples = m_samples[s];
+
+      if( samples.isEmpty() )
+        {
+          continue;
+        }
+
+      int buckets[HISTOGRAM_BUCKETS];
+      memset( buckets, 0, sizeof(buckets) );
+
+      for( int i = 0; i < samples.size(); i++ )
+        {
+          const qint64 usecs = samples.at(i) / 1000;
+
+          int b = 0;
+
+          while( b < HISTOGRAM_BUCKETS - 1 && usecs >= (Q_INT64_C(1) << b) )
+            {
+              b++;
+            }
+
+          buckets[b]++;
+        }
+
+      fprintf( stdout, "  Histogram %s\n", StageNames[s] );
+
+      for( int b = 0; b < HISTOGRAM_BUCKETS; b++ )
+        {
+          if( buckets[b] == 0 )
+            {
+              continue;
+            }
+
+          const int bar = int( ceil( 50.0 * buckets[b] / samples.size() ) );
+
+          if( b < HISTOGRAM_BUCKETS - 1 )
+            {
+              fprintf( stdout, "     < %8lld us %8d %s\n",
+                       (long long) (Q_INT64_C(1) << b), buckets[b],
+                       QByteArray( bar, '#' ).constData() );
+            }
+          else
+            {
+              fprintf( stdout, "    >= %8lld us %8d %s\n",
+                       (long long) (Q_INT64_C(1) << (b - 1)), buckets[b],
+                       QByteArray( bar, '#' ).constData() );
+            }
+        }
+    }
+
+  fflush( stdout );
+}
@@ -0,0 +1,222 @@
+/***********************************************************************
+**
+**   nmeabenchmark.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class NmeaBenchmark
+*
+* \author Axel Pauli
+*
+* \brief Replays a recorded flight through the processing chain and measures it.
+*
+* The benchmark is only available, if Cumulus is built with the qmake
+* configuration option benchmark. It is started with the command line option
+*
+* cumulus --nmea-benchmark <file>
+*
+* The file can be a NMEA log, e.g. CumulusNmea.log, or an IGC file. The
+* B-records of an IGC file are converted to $GPRMC, $GPGGA and $PGRMZ
+* sentences. Under Qt5 Cumulus can run headless with the additional
+* option -platform offscreen. The report is written to stdout.
+*
+* After the startup the sentences are passed as fast as possible to
+* GpsNmea::slot_sentence instead of starting the GPS receiver. The map is
+* rendered after every fix. The latencies of the processing stages are
+* collected and printed as histograms together with the fixes per second.
+* Stages called by other stages are contained in their times. Before the
+* replay, the pure parsing throughput of the old string list split and of
+* the NmeaTokenizer is measured. Furthermore the throughput of the forward
+* channel from the GPS client to Cumulus is measured over a local socket pair,
+* once with a frame per sentence and once with batched sentences.
+*
+* Processing stages are measured by placing the macro BENCHMARK_STAGE at the
+* begin of their methods. In builds without the benchmark, the macro is
+* empty.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef NMEA_BENCHMARK_H
+#define NMEA_BENCHMARK_H
+
+#ifdef BENCHMARK
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class NmeaBenchmark : public QObject
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( NmeaBenchmark )
+
+ public:
+
+  /** The measured processing stages. */
+  enum Stage
+  {
+    Sentence,  // GpsNmea::slot_sentence
+    Position,  // Calculator::slot_Position
+    Fix,       // Calculator::slot_newFix
+    Reachable, // ReachableList::calculate
+    Wind,      // WindAnalyser::slot_newSample
+    Airspace,  // Map::checkAirspace
+    Render,    // Map redraw after a fix
+    StageCount
+  };
+
+  /**
+   * Measures the time of the current scope for a stage.
+   */
+  class StageTimer
+  {
+   public:
+
+    StageTimer( const Stage stage ) :
+      m_stage(stage),
+      m_active(NmeaBenchmark::isRecording())
+    {
+      if( m_active )
+        {
+          m_timer.start();
+        }
+    };
+
+    ~StageTimer()
+    {
+      if( m_active )
+        {
+          NmeaBenchmark::addSample( m_stage, m_timer.nsecsElapsed() );
+        }
+    };
+
+   private:
+
+    Stage m_stage;
+    bool m_active;
+    QElapsedTimer m_timer;
+  };
+
+  /**
+   * \param fileName The NMEA or IGC file to be replayed.
+   * \param parent The parent object.
+   */
+  NmeaBenchmark( const QString& fileName, QObject* parent=0 );
+
+  virtual ~NmeaBenchmark();
+
+  /**
+   * \return The benchmark instance or null, if no benchmark is requested.
+   */
+  static NmeaBenchmark* instance()
+  {
+    return m_instance;
+  };
+
+  /**
+   * \return True, if the replay is running and stage times are collected.
+   */
+  static bool isRecording()
+  {
+    return m_instance != 0 && m_instance->m_recording;
+  };
+
+  /**
+   * Stores a measured stage time in nano seconds.
+   */
+  static void addSample( const Stage stage, const qint64 nsecs );
+
+ public slots:
+
+  /**
+   * Runs the benchmark and quits the application afterwards.
+   */
+  void slotStart();
+
+ private slots:
+
+  /** Called by GpsNmea, if a new fix has been received. */
+  void slotNewFix();
+
+ private:
+
+  /**
+   * Reads the sentences of the benchmark file. IGC files are converted.
+   */
+  bool readFile( QStringList& sentences );
+
+  /**
+   * Converts the B-records of an IGC file to NMEA sentences.
+   */
+  void convertIgc( const QStringList& lines, QStringList& sentences );
+
+  /**
+   * Appends the checksum to a NMEA sentence.
+   */
+  static QString addCheckSum( const QString& sentence );
+
+  /**
+   * Measures the split and dispatch throughput of the parsers.
+   */
+  void benchmarkParser( const QStringList& sentences );
+
+  /**
+   * Measures the batch and unbatch throughput of the forward channel.
+   */
+  void benchmarkForward( const QStringList& sentences );
+
+  /**
+   * Passes all sentences to GpsNmea and collects the stage times.
+   */
+  void replay( const QStringList& sentences );
+
+  /**
+   * Prints the collected stage times.
+   */
+  void report( const qint64 totalNsecs );
+
+  /** The file to be replayed. */
+  QString m_fileName;
+
+  /** Set during the replay. */
+  bool m_recording;
+
+  /** Set, if the last sentence has completed a fix. */
+  bool m_fixSeen;
+
+  /** Number of fixes of the replay. */
+  int m_fixes;
+
+  /** Collected times in nano seconds per stage. */
+  QVector<qint64> m_samples[StageCount];
+
+  static NmeaBenchmark* m_instance;
+};
+
+#define BENCHMARK_STAGE(stage) NmeaBenchmark::StageTimer benchmarkStageTimer(stage)
+
+#else
+
+#define BENCHMARK_STAGE(stage)
+
+#endif /* BENCHMARK */
+
+#endif /* NMEA_BENCHMARK_H */
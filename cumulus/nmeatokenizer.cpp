@@ -0,0 +1,473 @@
+/***********************************************************************
+**
+**   nmeatokenizer.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <climits>
+
+#include "nmeatokenizer.h"
+
+namespace
+{
+  /** Exact powers of ten, usable as divisor without rounding errors. */
+  const double Pow10[] =
+    {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+      1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+      1e20, 1e21, 1e22
+    };
+
+  const int MaxPow10 = sizeof(Pow10) / sizeof(Pow10[0]) - 1;
+
+  /** \return The value of a digit in the passed base or -1. */
+  inline int digitValue( const char c, const int base )
+  {
+    int value;
+
+    if( c >= '0' && c <= '9' )
+      {
+        value = c - '0';
+      }
+    else if( c >= 'a' && c <= 'z' )
+      {
+        value = c - 'a' + 10;
+      }
+    else if( c >= 'A' && c <= 'Z' )
+      {
+        value = c - 'A' + 10;
+      }
+    else
+      {
+        return -1;
+      }
+
+    return ( value < base ) ? value : -1;
+  }
+
+  inline bool isSpace( const char c )
+  {
+    return c == ' ' || c == '\t';
+  }
+
+  /** Removes leading and trailing spaces. */
+  inline void trim( const char*& begin, const char*& end )
+  {
+    while( begin < end && isSpace( *begin ) )
+      {
+        begin++;
+      }
+
+    while( end > begin && isSpace( *(end - 1) ) )
+      {
+        end--;
+      }
+  }
+}
+
+NmeaField NmeaField::left( const int n ) const
+{
+  if( n < 0 || n >= m_size )
+    {
+      return *this;
+    }
+
+  return NmeaField( m_data, n );
+}
+
+NmeaField NmeaField::mid( const int pos, const int n ) const
+{
+  if( pos < 0 || pos >= m_size )
+    {
+      return NmeaField();
+    }
+
+  if( n < 0 || pos + n > m_size )
+    {
+      return NmeaField( m_data + pos, m_size - pos );
+    }
+
+  return NmeaField( m_data + pos, n );
+}
+
+NmeaField NmeaField::right( const int n ) const
+{
+  if( n < 0 || n >= m_size )
+    {
+      return *this;
+    }
+
+  return NmeaField( m_data + m_size - n, n );
+}
+
+bool NmeaField::toInteger( qint64& value,
+                           const int base,
+                           const qint64 min,
+                           const qint64 max ) const
+{
+  const char* p   = m_data;
+  const char* end = m_data + m_size;
+
+  trim( p, end );
+
+  bool negative = false;
+
+  if( p < end && (*p == '-' || *p == '+') )
+    {
+      negative = (*p == '-');
+      p++;
+    }
+
+  if( p == end )
+    {
+      return false;
+    }
+
+  qint64 result = 0;
+
+  for( ; p < end; p++ )
+    {
+      const int digit = digitValue( *p, base );
+
+      if( digit < 0 )
+        {
+          return false;
+        }
+
+      result = result * base + digit;
+
+      if( result > max - min )
+        {
+          // Overflow, the range width is an upper limit for both signs.
+          return false;
+        }
+    }
+
+  if( negative )
+    {
+      result = -result;
+    }
+
+  if( result < min || result > max )
+    {
+      return false;
+    }
+
+  value = result;
+  return true;
+}
+
+int NmeaField::toInt( bool* ok, const int base ) const
+{
+  qint64 value = 0;
+  bool res = toInteger( value, base, INT_MIN, INT_MAX );
+
+  if( ok )
+    {
+      *ok = res;
+    }
+
+  return res ? int(value) : 0;
+}
+
+uint NmeaField::toUInt( bool* ok, const int base ) const
+{
+  qint64 value = 0;
+  bool res = toInteger( value, base, 0, UINT_MAX );
+
+  if( ok )
+    {
+      *ok = res;
+    }
+
+  return res ? uint(value) : 0;
+}
+
+short NmeaField::toShort( bool* ok, const int base ) const
+{
+  qint64 value = 0;
+  bool res = toInteger( value, base, SHRT_MIN, SHRT_MAX );
+
+  if( ok )
+    {
+      *ok = res;
+    }
+
+  return res ? short(value) : 0;
+}
+
+ushort NmeaField::toUShort( bool* ok, const int base ) const
+{
+  qint64 value = 0;
+  bool res = toInteger( value, base, 0, USHRT_MAX );
+
+  if( ok )
+    {
+      *ok = res;
+    }
+
+  return res ? ushort(value) : 0;
+}
+
+ulong NmeaField::toULong( bool* ok, const int base ) const
+{
+  qint64 value = 0;
+
+  // Such large values are not expected in NMEA sentences, the limit avoids
+  // an overflow during the conversion.
+  const qint64 max = ( sizeof(ulong) < sizeof(qint64) ) ? qint64(ULONG_MAX) :
+                                                          Q_INT64_C(0x00ffffffffffffff);
+
+  bool res = toInteger( value, base, 0, max );
+
+  if( ok )
+    {
+      *ok = res;
+    }
+
+  return res ? ulong(value) : 0;
+}
+
+double NmeaField::toDouble( bool* ok ) const
+{
+  if( ok )
+    {
+      *ok = false;
+    }
+
+  const char* p   = m_data;
+  const char* end = m_data + m_size;
+
+  trim( p, end );
+
+  bool negative = false;
+
+  if( p < end && (*p == '-' || *p == '+') )
+    {
+      negative = (*p == '-');
+      p++;
+    }
+
+  // The digits are collected as integer mantissa, the position of the
+  // decimal point is kept in the exponent.
+  qint64 mantissa = 0;
+  int exponent = 0;
+  int digits = 0;
+  bool point = false;
+
+  for( ; p < end; p++ )
+    {
+      if( *p == '.' && point == false )
+        {
+          point = true;
+          continue;
+        }
+
+      if( *p < '0' || *p > '9' )
+        {
+          break;
+        }
+
+      digits++;
+
+      if( mantissa < Q_INT64_C(100000000000000000) )
+        {
+          mantissa = mantissa * 10 + (*p - '0');
+
+          if( point )
+            {
+              exponent--;
+            }
+        }
+      else if( point == false )
+        {
+          // Digit beyond the precision
+          exponent++;
+        }
+    }
+
+  if( digits == 0 )
+    {
+      return 0.0;
+    }
+
+  if( p < end && (*p == 'e' || *p == 'E') )
+    {
+      NmeaField expField( p + 1, int(end - p - 1) );
+
+      bool expOk;
+      int exp = expField.toInt( &expOk );
+
+      if( expOk == false )
+        {
+          return 0.0;
+        }
+
+      // Larger exponents are out of the double range anyway.
+      exponent += qBound( -400, exp, 400 );
+      p = end;
+    }
+
+  if( p != end )
+    {
+      return 0.0;
+    }
+
+  double value = double( mantissa );
+
+  if( exponent < 0 )
+    {
+      while( exponent < -MaxPow10 )
+        {
+          value /= Pow10[MaxPow10];
+          exponent += MaxPow10;
+        }
+
+      value /= Pow10[-exponent];
+    }
+  else if( exponent > 0 )
+    {
+      while( exponent > MaxPow10 )
+        {
+          value *= Pow10[MaxPow10];
+          exponent -= MaxPow10;
+        }
+
+      value *= Pow10[exponent];
+    }
+
+  if( ok )
+    {
+      *ok = true;
+    }
+
+  return negative ? -value : value;
+}
+
+float NmeaField::toFloat( bool* ok ) const
+{
+  return float( toDouble( ok ) );
+}
+
+NmeaTokenizer::NmeaTokenizer() :
+  m_count(0)
+{
+}
+
+bool NmeaTokenizer::tokenize( const char* data, const int size )
+{
+  m_count = 0;
+
+  int length = size;
+
+  while( length > 0 && (data[length - 1] == '\n' || data[length - 1] == '\r') )
+    {
+      length--;
+    }
+
+  uchar sum = 0;
+  int start = 0;
+  int star = -1;
+
+  for( int i = 0; i < length; i++ )
+    {
+      const char c = data[i];
+
+      // The checksum covers all signs between the start sign and the star.
+      if( star < 0 && i > 0 && c != '*' )
+        {
+          sum ^= uchar(c);
+        }
+
+      if( c != ',' && c != '*' )
+        {
+          continue;
+        }
+
+      if( m_count == MaxFields - 1 )
+        {
+          m_count = 0;
+          return false;
+        }
+
+      m_fields[m_count++] = NmeaField( data + start, i - start );
+      start = i + 1;
+
+      if( c == '*' && star < 0 )
+        {
+          star = i;
+        }
+    }
+
+  m_fields[m_count++] = NmeaField( data + start, length - start );
+
+  if( star < 0 )
+    {
+      // Sentence without checksum
+      return true;
+    }
+
+  bool ok;
+  const uint checkSum = NmeaField( data + star + 1, length - star - 1 ).left(2).toUInt( &ok, 16 );
+
+  if( ok == false || length - star - 1 < 2 || checkSum != sum )
+    {
+      m_count = 0;
+      return false;
+    }
+
+  return true;
+}
+
+QStringList NmeaTokenizer::toStringList() const
+{
+  QStringList list;
+
+  for( int i = 0; i < m_count; i++ )
+    {
+      list.append( m_fields[i].toString() );
+    }
+
+  return list;
+}
+
+NmeaIdTable::NmeaIdTable()
+{
+  clear();
+}
+
+void NmeaIdTable::clear()
+{
+  memset( m_slots, 0, sizeof(m_slots) );
+}
+
+bool NmeaIdTable::insert( const QByteArray& key, const short id )
+{
+  if( key.size() == 0 || key.size() > MaxKeyLength )
+    {
+      return false;
+    }
+
+  Slot& slot = m_slots[hash( key.constData(), key.size() )];
+
+  if( slot.size > 0 &&
+      (slot.size != key.size() || memcmp( slot.key, key.constData(), slot.size ) != 0) )
+    {
+      // Slot is used by another identifier
+      return false;
+    }
+
+  memcpy( slot.key, key.constData(), key.size() );
+  slot.size = key.size();
+  slot.id   = id;
+  return true;
+}
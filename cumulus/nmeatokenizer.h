@@ -0,0 +1,292 @@
+/***********************************************************************
+**
+**   nmeatokenizer.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class NmeaField
+*
+* \author Axel Pauli
+*
+* \brief Read only view of one field of a NMEA sentence.
+*
+* The field refers to the characters of the tokenized sentence buffer, it
+* does not own them. The number conversions work directly on the characters
+* and are locale independent. Their behavior follows the QString methods of
+* the same name, so that a field can replace a QString in the sentence
+* parsers.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef NMEA_TOKENIZER_H
+#define NMEA_TOKENIZER_H
+
+#include <cstring>
+
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+class NmeaField
+{
+ public:
+
+  NmeaField() :
+    m_data(""),
+    m_size(0)
+  {
+  };
+
+  NmeaField( const char* data, const int size ) :
+    m_data(data),
+    m_size(size)
+  {
+  };
+
+  /** Creates a view of a zero terminated string. */
+  NmeaField( const char* str ) :
+    m_data(str),
+    m_size(int(strlen(str)))
+  {
+  };
+
+  const char* data() const
+  {
+    return m_data;
+  };
+
+  int size() const
+  {
+    return m_size;
+  };
+
+  bool isEmpty() const
+  {
+    return m_size == 0;
+  };
+
+  bool operator==( const char* str ) const
+  {
+    return strncmp( m_data, str, m_size ) == 0 && str[m_size] == '\0';
+  };
+
+  bool operator!=( const char* str ) const
+  {
+    return ! operator==( str );
+  };
+
+  bool operator==( const NmeaField& other ) const
+  {
+    return m_size == other.m_size && memcmp( m_data, other.m_data, m_size ) == 0;
+  };
+
+  /** \return The first n characters. */
+  NmeaField left( const int n ) const;
+
+  /** \return n characters starting at pos, all remaining ones if n is -1. */
+  NmeaField mid( const int pos, const int n=-1 ) const;
+
+  /** \return The last n characters. */
+  NmeaField right( const int n ) const;
+
+  int toInt( bool* ok=0, const int base=10 ) const;
+
+  uint toUInt( bool* ok=0, const int base=10 ) const;
+
+  short toShort( bool* ok=0, const int base=10 ) const;
+
+  ushort toUShort( bool* ok=0, const int base=10 ) const;
+
+  ulong toULong( bool* ok=0, const int base=10 ) const;
+
+  double toDouble( bool* ok=0 ) const;
+
+  float toFloat( bool* ok=0 ) const;
+
+  /** \return A copy of the field as string, that allocates memory. */
+  QString toString() const
+  {
+    return QString::fromLatin1( m_data, m_size );
+  };
+
+  /** \return A copy of the field as byte array, that allocates memory. */
+  QByteArray toLatin1() const
+  {
+    return QByteArray( m_data, m_size );
+  };
+
+ private:
+
+  /**
+   * Converts the field to an integer in the passed range. Leading and
+   * trailing spaces are ignored like QString does.
+   */
+  bool toInteger( qint64& value, const int base, const qint64 min, const qint64 max ) const;
+
+  const char* m_data;
+  int m_size;
+};
+
+/**
+* \class NmeaTokenizer
+*
+* \author Axel Pauli
+*
+* \brief Splits a NMEA sentence into fields without allocating memory.
+*
+* The sentence is split at every comma and at the asterisk in front of the
+* checksum, like a split with the regular expression "[,*]" does. The first
+* field contains the sentence identifier, the last one the checksum, if the
+* sentence has one. The checksum is verified during the split.
+*
+* The fields refer to the passed buffer, which must stay unchanged as long
+* as the fields are used.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+class NmeaTokenizer
+{
+ private:
+
+  Q_DISABLE_COPY ( NmeaTokenizer )
+
+ public:
+
+  /** Maximum number of fields in a sentence. */
+  enum { MaxFields = 96 };
+
+  NmeaTokenizer();
+
+  /**
+   * Splits the passed sentence into its fields. A trailing carriage return
+   * or line feed is ignored.
+   *
+   * \param data The sentence characters.
+   * \param size The number of sentence characters.
+   * \return False, if the checksum does not match or if the sentence has
+   *         too many fields. The field list is empty then.
+   */
+  bool tokenize( const char* data, const int size );
+
+  int size() const
+  {
+    return m_count;
+  };
+
+  int count() const
+  {
+    return m_count;
+  };
+
+  /** \return The field at index i or an empty field, if i is out of range. */
+  const NmeaField& operator[]( const int i ) const
+  {
+    return ( i >= 0 && i < m_count ) ? m_fields[i] : m_empty;
+  };
+
+  /** \return A copy of all fields as string list, that allocates memory. */
+  QStringList toStringList() const;
+
+ private:
+
+  NmeaField m_fields[MaxFields];
+  int m_count;
+  const NmeaField m_empty;
+};
+
+/**
+* \class NmeaIdTable
+*
+* \author Axel Pauli
+*
+* \brief Perfect hash table of the known NMEA sentence identifiers.
+*
+* The hash function is chosen in that way, that the identifiers processed
+* by Cumulus get all a different slot. A lookup needs only one hash
+* calculation and one compare. New identifiers must be checked for
+* collisions, \ref insert reports them.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+class NmeaIdTable
+{
+ private:
+
+  Q_DISABLE_COPY ( NmeaIdTable )
+
+ public:
+
+  NmeaIdTable();
+
+  /**
+   * Adds an identifier to the table.
+   *
+   * \return False, if the slot of the identifier is already used by another
+   *         one.
+   */
+  bool insert( const QByteArray& key, const short id );
+
+  /** Removes all identifiers. */
+  void clear();
+
+  /** \return The number of the passed identifier or -1, if it is unknown. */
+  short find( const NmeaField& key ) const
+  {
+    const Slot& slot = m_slots[hash( key.data(), key.size() )];
+
+    if( slot.size == key.size() && slot.size > 0 &&
+        memcmp( slot.key, key.data(), slot.size ) == 0 )
+      {
+        return slot.id;
+      }
+
+    return -1;
+  };
+
+ private:
+
+  /** Table size, must be a power of two. */
+  enum { Size = 64, MaxKeyLength = 8 };
+
+  static int hash( const char* key, const int size )
+  {
+    if( size < 2 )
+      {
+        return 0;
+      }
+
+    const uchar* k = reinterpret_cast<const uchar *>(key);
+
+    return ( k[1] + k[size-2] * 17 + k[size-1] + size ) & (Size - 1);
+  };
+
+  struct Slot
+  {
+    char key[MaxKeyLength];
+    int size;
+    short id;
+  };
+
+  Slot m_slots[Size];
+};
+
+#endif /* NMEA_TOKENIZER_H */
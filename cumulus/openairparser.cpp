@@ -393,18 +393,14 @@ void OpenAirParser::finishAirspace()
     }
 
   // Translate all WGS84 points to current map projection
-  QPolygon astPA;
-
-  for (int i = 0; i < asPA.count(); i++)
-    {
-      astPA.append( _globalMapMatrix->wgsToMap(asPA.at(i)) );
-    }
+  QPolygon astPA = _globalMapMatrix->wgsToMap( asPA );
 
   Airspace* as = new Airspace( asName,
                                asType,
                                astPA,
                                asUpper, asUpperType,
                                asLower, asLowerType );
+  as->setWgsPolygon( asPA );
   _airlist.append(as);
   _objCounter++;
 
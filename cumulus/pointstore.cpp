@@ -0,0 +1,122 @@
+/***********************************************************************
+**
+**   pointstore.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include "pointstore.h"
+
+PointStore::PointStore() :
+  m_strings( 1, '\0' ),
+  m_valid(false)
+{
+}
+
+PointStore::~PointStore()
+{
+}
+
+quint32 PointStore::intern( const QString& text,
+                            QByteArray& strings,
+                            QHash<QByteArray, quint32>& offsets )
+{
+  if( text.isEmpty() )
+    {
+      return 0;
+    }
+
+  const QByteArray utf8 = text.toUtf8();
+
+  QHash<QByteArray, quint32>::const_iterator it = offsets.constFind( utf8 );
+
+  if( it != offsets.constEnd() )
+    {
+      return it.value();
+    }
+
+  const quint32 offset = strings.size();
+
+  strings.append( utf8 );
+  strings.append( '\0' );
+  offsets.insert( utf8, offset );
+
+  return offset;
+}
+
+void PointStore::setText( const int index, const TextColumn column, const QString& value )
+{
+  if( value.isEmpty() )
+    {
+      m_texts[column][index] = 0;
+      return;
+    }
+
+  m_texts[column][index] = m_strings.size();
+
+  m_strings.append( value.toUtf8() );
+  m_strings.append( '\0' );
+}
+
+PointStore::LandingPriority PointStore::landingPriority( const BaseMapElement::objectType type )
+{
+  switch( type )
+    {
+      case BaseMapElement::IntAirport:
+      case BaseMapElement::Airport:
+      case BaseMapElement::MilAirport:
+      case BaseMapElement::CivMilAirport:
+        return Airport;
+
+      case BaseMapElement::Airfield:
+      case BaseMapElement::Gliderfield:
+      case BaseMapElement::UltraLight:
+      case BaseMapElement::HangGlider:
+      case BaseMapElement::Parachute:
+      case BaseMapElement::Balloon:
+        return Landable;
+
+      case BaseMapElement::Outlanding:
+      case BaseMapElement::CivHeliport:
+      case BaseMapElement::MilHeliport:
+      case BaseMapElement::AmbHeliport:
+        return Outlanding;
+
+      default:
+        return NotLandable;
+    }
+}
+
+void PointStore::findInside( const QRect& rect, QVector<int>& indices ) const
+{
+  indices.clear();
+
+  const QRect r = rect.normalized();
+
+  const int left   = r.left();
+  const int right  = r.right();
+  const int top    = r.top();
+  const int bottom = r.bottom();
+
+  const QPoint* pos = m_positions.constData();
+  const int size = m_positions.size();
+
+  for( int i = 0; i < size; i++ )
+    {
+      const int x = pos[i].x();
+      const int y = pos[i].y();
+
+      if( x >= left && x <= right && y >= top && y <= bottom )
+        {
+          indices.append( i );
+        }
+    }
+}
@@ -0,0 +1,327 @@
+/***********************************************************************
+**
+**   pointstore.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class PointStore
+*
+* \author Axel Pauli
+*
+* \brief Column store of the point data of a point list.
+*
+* The store keeps the often used data of the points of a list in contiguous
+* columns: the WGS84 and the projected positions, the elevations, the point
+* types and landing priorities as packed bytes and the names, short names,
+* ICAO codes, countries and comments as offsets into one string buffer. The
+* texts are stored as UTF-8 and every text is stored only once, also if it is
+* used by many points.
+*
+* After the build, the points of the list are attached to the store. An
+* attached point releases its own copies of these data and reads and writes
+* them via the store. Only the rarely used data, like runways and
+* frequencies, remain in the point objects. A copy of an attached point is
+* detached again, so that it stays valid independent of the store.
+*
+* Loops over all points of a list, like the visibility check of the map
+* drawing, the landable point index and the list views, run over the
+* columns without touching the point objects.
+*
+* The store refers to the points by their list index. It has to be rebuilt,
+* if the point list has been changed.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef POINT_STORE_H
+#define POINT_STORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QString>
+#include <QVector>
+
+#include "basemapelement.h"
+#include "wgspoint.h"
+
+class PointStore
+{
+ public:
+
+  /** The text columns of the store. */
+  enum TextColumn
+  {
+    Name,
+    ShortName,
+    Icao,
+    Country,
+    Comment,
+    TextColumns
+  };
+
+  /** Landing priorities of the point types. */
+  enum LandingPriority
+  {
+    NotLandable = 0,
+    Outlanding  = 1,
+    Landable    = 2,
+    Airport     = 3
+  };
+
+  PointStore();
+
+  virtual ~PointStore();
+
+  /**
+   * Takes over the point data of the passed list and attaches the points to
+   * the store. The list elements must be derived from SinglePoint.
+   */
+  template<class T> void build( QList<T>& list );
+
+  /**
+   * Marks the store as outdated.
+   */
+  void invalidate()
+  {
+    m_valid = false;
+  };
+
+  /**
+   * \param listSize The current size of the stored point list.
+   * \return True, if the store must be rebuilt before it can be used.
+   */
+  bool isOutdated( const int listSize ) const
+  {
+    // A changed list size is detected also without an invalidation, so that
+    // the store never refers to not existing points.
+    return ( m_valid == false || listSize != m_positions.size() );
+  };
+
+  /** \return The number of stored points. */
+  int size() const
+  {
+    return m_positions.size();
+  };
+
+  /** \return The projected position of the point with the passed index. */
+  const QPoint& position( const int index ) const
+  {
+    return m_positions.at( index );
+  };
+
+  void setPosition( const int index, const QPoint& value )
+  {
+    m_positions[index] = value;
+  };
+
+  /** \return The WGS84 position of the point with the passed index. */
+  const WGSPoint& wgsPosition( const int index ) const
+  {
+    return m_wgsPositions.at( index );
+  };
+
+  WGSPoint& wgsPositionRef( const int index )
+  {
+    return m_wgsPositions[index];
+  };
+
+  void setWGSPosition( const int index, const WGSPoint& value )
+  {
+    m_wgsPositions[index] = value;
+  };
+
+  /** \return The elevation of the point with the passed index. */
+  float elevation( const int index ) const
+  {
+    return m_elevations.at( index );
+  };
+
+  void setElevation( const int index, const float value )
+  {
+    m_elevations[index] = value;
+  };
+
+  /** \return The type of the point with the passed index. */
+  BaseMapElement::objectType type( const int index ) const
+  {
+    return static_cast<BaseMapElement::objectType> (m_types.at( index ));
+  };
+
+  void setType( const int index, const BaseMapElement::objectType value )
+  {
+    m_types[index]      = uchar( value );
+    m_priorities[index] = uchar( landingPriority( value ) );
+  };
+
+  /** \return The landing priority of the point with the passed index. */
+  LandingPriority priority( const int index ) const
+  {
+    return static_cast<LandingPriority> (m_priorities.at( index ));
+  };
+
+  /**
+   * \return The text of the passed column of the point with the passed
+   *         index.
+   */
+  QString text( const int index, const TextColumn column ) const
+  {
+    return QString::fromUtf8( m_strings.constData() + m_texts[column].at( index ) );
+  };
+
+  /**
+   * Sets a text of a point. The text is appended to the string buffer, the
+   * former text remains unused in it until the next build.
+   */
+  void setText( const int index, const TextColumn column, const QString& value );
+
+  /**
+   * \return The landing priority of the passed point type.
+   */
+  static LandingPriority landingPriority( const BaseMapElement::objectType type );
+
+  /**
+   * Collects all points, whose projected position lays inside of the
+   * passed rectangle. The rectangle borders belong to it like at
+   * QRect::contains.
+   *
+   * \param rect The search rectangle in projected coordinates.
+   * \param indices The list indices of the found points.
+   */
+  void findInside( const QRect& rect, QVector<int>& indices ) const;
+
+  /**
+   * \return The list indices of the points drawn at the last map drawing.
+   */
+  const QVector<int>& drawnPoints() const
+  {
+    return m_drawn;
+  };
+
+  /**
+   * Stores the list indices of the drawn points.
+   */
+  void setDrawnPoints( const QVector<int>& indices )
+  {
+    m_drawn = indices;
+  };
+
+ private:
+
+  Q_DISABLE_COPY ( PointStore )
+
+  /**
+   * Adds a text to the string buffer, if it is not contained already.
+   *
+   * \return The offset of the text in the string buffer.
+   */
+  static quint32 intern( const QString& text,
+                         QByteArray& strings,
+                         QHash<QByteArray, quint32>& offsets );
+
+  /** WGS84 positions of the points. */
+  QVector<WGSPoint> m_wgsPositions;
+
+  /** Projected positions of the points. */
+  QVector<QPoint> m_positions;
+
+  /** Elevations of the points. */
+  QVector<float> m_elevations;
+
+  /** Types of the points as BaseMapElement::objectType. */
+  QVector<uchar> m_types;
+
+  /** Landing priorities of the points. */
+  QVector<uchar> m_priorities;
+
+  /** Offsets of the point texts in the string buffer. */
+  QVector<quint32> m_texts[TextColumns];
+
+  /**
+   * Zero terminated UTF-8 texts of the points. The offset 0 is the empty
+   * text.
+   */
+  QByteArray m_strings;
+
+  /** List indices of the points drawn at the last map drawing. */
+  QVector<int> m_drawn;
+
+  /** False, if the store has to be rebuilt. */
+  bool m_valid;
+};
+
+template<class T>
+void PointStore::build( QList<T>& list )
+{
+  const int size = list.size();
+
+  // The points can be attached to this store already. Therefore the new
+  // columns are collected at first and exchanged afterwards.
+  QVector<WGSPoint> wgsPositions( size );
+  QVector<QPoint>   positions( size );
+  QVector<float>    elevations( size );
+  QVector<uchar>    types( size );
+  QVector<uchar>    priorities( size );
+  QVector<quint32>  texts[TextColumns];
+  QByteArray        strings( 1, '\0' );
+
+  QHash<QByteArray, quint32> offsets;
+
+  for( int c = 0; c < TextColumns; c++ )
+    {
+      texts[c].resize( size );
+    }
+
+  for( int i = 0; i < size; i++ )
+    {
+      const T& point = list.at(i);
+
+      wgsPositions[i] = point.getWGSPosition();
+      positions[i]    = point.getPosition();
+      elevations[i]   = point.getElevation();
+      types[i]        = uchar( point.getTypeID() );
+      priorities[i]   = uchar( landingPriority( point.getTypeID() ) );
+
+      texts[Name][i]      = intern( point.getName(), strings, offsets );
+      texts[ShortName][i] = intern( point.getWPName(), strings, offsets );
+      texts[Icao][i]      = intern( point.getICAO(), strings, offsets );
+      texts[Country][i]   = intern( point.getCountry(), strings, offsets );
+      texts[Comment][i]   = intern( point.getComment(), strings, offsets );
+    }
+
+  m_wgsPositions = wgsPositions;
+  m_positions    = positions;
+  m_elevations   = elevations;
+  m_types        = types;
+  m_priorities   = priorities;
+  m_strings      = strings;
+
+  for( int c = 0; c < TextColumns; c++ )
+    {
+      m_texts[c] = texts[c];
+    }
+
+  m_drawn.clear();
+  m_valid = true;
+
+  for( int i = 0; i < size; i++ )
+    {
+      list[i].attach( this, i );
+    }
+}
+
+#endif /* POINT_STORE_H */
@@ -27,6 +27,17 @@ ProjectionBase::~ProjectionBase()
 {}
 
 
+void ProjectionBase::project( const double* latitude, const double* longitude,
+                              double* x, double* y, const int count )
+{
+  for( int i = 0; i < count; i++ )
+    {
+      x[i] = projectX( latitude[i], longitude[i] );
+      y[i] = projectY( latitude[i], longitude[i] );
+    }
+}
+
+
 void SaveProjection(QDataStream & s, ProjectionBase * p)
 {
   s << qint8( p->projectionType() );
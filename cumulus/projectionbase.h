@@ -56,6 +56,21 @@ class ProjectionBase
   /** */
   virtual double projectY(const double& latitude, const double& longitude)  = 0;
 
+  /**
+   * Projects an array of positions. The results are identical to the ones
+   * of \ref projectX and \ref projectY. Derived classes should overwrite
+   * this method with a loop without virtual calls and branches, which the
+   * compiler can vectorize.
+   *
+   * @param  latitude  The latitudes of the positions, given in radiant.
+   * @param  longitude The longitudes of the positions, given in radiant.
+   * @param  x         Array for the x-positions.
+   * @param  y         Array for the y-positions.
+   * @param  count     Number of positions.
+   */
+  virtual void project( const double* latitude, const double* longitude,
+                        double* x, double* y, const int count );
+
   /** */
   virtual double invertLat(const double& x, const double& y) const = 0;
 
@@ -73,6 +73,19 @@ class ProjectionCylindric : public ProjectionBase
     return -latitude;
   };
 
+  /**
+   * Projects an array of positions.
+   */
+  virtual void project( const double* latitude, const double* longitude,
+                        double* x, double* y, const int count )
+  {
+    for( int i = 0; i < count; i++ )
+      {
+        x[i] = longitude[i] * cos_v1;
+        y[i] = -latitude[i];
+      }
+  };
+
   /**
    * Returns the latitude of a given projected position in radiant.
    *
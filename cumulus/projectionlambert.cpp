@@ -131,6 +131,22 @@ double ProjectionLambert::projectY(const double& latitude, const double& longitu
 }
 
 
+void ProjectionLambert::project( const double* latitude, const double* longitude,
+                                 double* x, double* y, const int count )
+{
+  // The terms must be calculated in the same order as in projectX and
+  // projectY to get identical results.
+  for( int i = 0; i < count; i++ )
+    {
+      const double argLat = var4*sqrt(cosv1_2 + (sinv1 - sin(latitude[i]))*var1);
+      const double argLon = 2.0 * var3 * (longitude[i] - origin);
+
+      x[i] = argLat * sin( argLon );
+      y[i] = argLat * cos( argLon );
+    }
+}
+
+
 double ProjectionLambert::invertLat(const double& x, const double& y) const
 {
   //    double lat =
@@ -91,6 +91,13 @@ public:
    */
   virtual double projectY(const double& latitude, const double& longitude) ;
 
+  /**
+   * Projects an array of positions. The radius and the angle of a position
+   * are calculated only once for both coordinates.
+   */
+  virtual void project( const double* latitude, const double* longitude,
+                        double* x, double* y, const int count );
+
   /**
    * Returns the latitude of a given projected position in radiant.
    */
@@ -29,7 +29,7 @@
 
 //------- Used by Command/Response channel -------//
 
-#define MSG_PROTOCOL   "Cumulus-GPS_Client_IPC_V1.5_Axel@kflog.org"
+#define MSG_PROTOCOL   "Cumulus-GPS_Client_IPC_V1.6_Axel@kflog.org"
 
 #define MSG_MAGIC      "\\Magic\\"
 
@@ -69,20 +69,7 @@
 
 //------- Used by Forward data channel -------//
 
-// GPS data message
-#define MSG_GPS_DATA  "#Gps_Data#"
-
-// Flarm flight list response
-#define MSG_FLARM_FLIGHT_LIST_RES  "#FFLR#"
-
-// Flarm flight download response, used to report results.
-#define MSG_FLARM_FLIGHT_DOWNLOAD_INFO  "#FFDI#"
-
-// Flarm flight download progress, used to report dowload progress.
-#define MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS  "#FFDP#"
-
-#define MSG_CON_OFF     "#GPS_Connection_off#"
-
-#define MSG_CON_ON      "#GPS_Connection_on#"
+// The forward data channel transfers batches of typed binary messages,
+// see class ForwardBatch.
 
 #endif  // #ifndef _Protocol_h_
@@ -35,11 +35,11 @@ RadioPoint::RadioPoint(const QString& name,
   SinglePoint( name, shortName, type, wgsP, pos, elevation, country ),
   m_frequency(frequency),
   m_channel(channel),
-  m_icao(icao),
   m_range(range),
   m_declination(declination),
   m_aligned2TrueNorth(aligned2TrueNorth)
 {
+  m_icao = icao;
 }
 
 RadioPoint::~RadioPoint()
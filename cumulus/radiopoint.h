@@ -120,22 +120,6 @@ class RadioPoint : public SinglePoint
       m_channel = value;
     };
 
-  /**
-   * @return ICAO name
-   */
-  QString getICAO() const
-    {
-      return m_icao;
-    };
-
-  /**
-   * @param value ICAO name
-   */
-  void setICAO( const QString& value )
-    {
-      m_icao = value;
-    }
-
   bool isAligned2TrueNorth () const
     {
       return m_aligned2TrueNorth;
@@ -184,11 +168,6 @@ class RadioPoint : public SinglePoint
    */
   QString m_channel;
 
-  /**
-   * The icao name
-   */
-  QString m_icao;
-
   /**
    * Range of service in meters. 0 means unknown.
    */
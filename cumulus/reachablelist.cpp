@@ -35,6 +35,8 @@
 #include "calculator.h"
 #include "mapcontents.h"
 #include "mapcalc.h"
+#include "nmeabenchmark.h"
+#include "pointstore.h"
 #include "polar.h"
 #include "waypoint.h"
 #include "airfield.h"
@@ -43,13 +45,20 @@ extern MapContents *_globalMapContents;
 
 // Initialize static members
 int  ReachableList::safetyAlt = 0;
-QMap<QString, int> ReachableList::arrivalAltMap;
-QMap<QString, Distance> ReachableList::distanceMap;
+QHash<qint64, int> ReachableList::arrivalAltMap;
+QHash<qint64, int> ReachableList::clearanceMap;
+QHash<qint64, Distance> ReachableList::distanceMap;
 bool ReachableList::modeAltitude = false;
 
 // Radius of reachables to be taken into account in kilometers
 #define RANGE_RADIUS 100.0;
 
+// Distance in meters between two terrain samples along a glide path
+#define TERRAIN_SAMPLE_DISTANCE 500.0
+
+// Maximum number of terrain samples along a glide path
+#define MAX_TERRAIN_SAMPLES 200
+
 // number of created class instances
 short ReachableList::instances = 0;
 
@@ -89,6 +98,8 @@ ReachableList::~ReachableList()
 
 void ReachableList::calculate(bool always)
 {
+  BENCHMARK_STAGE( NmeaBenchmark::Reachable );
+
   if ( !isOn() )
     {
       //qDebug("ReachableList::calculate is off");
@@ -105,8 +116,9 @@ void ReachableList::calculate(bool always)
 
   // qDebug("tick %d %d",tick, always );
   // The whole list is new computed, if the distance has become
-  // greater than 5km to the last computing point.
-  if ( dist2Last > 5.0 || always )
+  // greater than 1km to the last computing point. The landable index
+  // makes that cheap.
+  if ( dist2Last > 1.0 || always )
     {
       // save position where new calculation has been done
       lastCalculationPosition = currentPosition;
@@ -122,173 +134,86 @@ void ReachableList::calculate(bool always)
     }
 }
 
-void ReachableList::addItemsToList(enum MapContents::ListID item)
+ReachablePoint ReachableList::createPoint( const LandableIndex::Entry& entry,
+                                           const double distanceKm )
 {
   Distance distance;
-  QRect bbox = MapCalc::areaBox(lastPosition, _maxReach);
-  int r=0, a=0;
-  //qDebug("bounding box: (%d, %d), (%d, %d) (%d x %d km)", bbox.left(),bbox.top(),bbox.right(),bbox.bottom(),0,0);
+  distance.setKilometers( distanceKm );
 
-  if( item == MapContents::WaypointList )
+  // calculate bearing
+  double result = MapCalc::getBearing( lastPosition, entry.position );
+  short bearing = short(rint(result * 180./M_PI));
+  Altitude altitude(0);
+
+  if( entry.listID == MapContents::WaypointList )
     {
       // Waypoints have different structure treat them here
       QList<Waypoint> &wpList = _globalMapContents->getWaypointList();
-      // qDebug("Nr of Waypoints: %d", wpList.count() );
-
-      for ( int i=0; i < wpList.count(); i++ )
-        {
-          WGSPoint pt = wpList.at(i).wgsPoint;
 
-          if (! bbox.contains(pt))
-            {
-              //qDebug("Not in bounding box, so ignore! (distance: %d, (%d, %d), %s)", (int)distance.getKilometers(), pt.x(),pt.y(), wpList.at(i)->name.latin1());
-              r++;
-              continue;
-            }
-          else
-            {
-              a++;
-              //qDebug("In bounding box, so accept! (distance: %d, %s)", (int)distance.getKilometers(), wpList.at(i)->name.latin1());
-            }
-
-          distance.setKilometers(MapCalc::dist(&lastPosition, &pt));
-
-          bool isLandable = false;
-
-          if( wpList.at(i).rwyList.size() > 0 )
-            {
-              isLandable = wpList.at(i).rwyList.at(0).m_isOpen;
-            }
-
-
-          // check if point is a potential reachable candidate at best LD
-          if ( (distance.getKilometers() > _maxReach ) ||
-               ! (isLandable ||
-                 (wpList.at(i).type == BaseMapElement::Outlanding) )  )
-            {
-              continue;
-            }
-
-          // calculate bearing
-          double result = MapCalc::getBearing(lastPosition, pt);
-          int bearing = int(rint(result * 180./M_PI));
-          Altitude altitude(0);
-
-          ReachablePoint rp( wpList[i],
+      return ReachablePoint( wpList[entry.index],
                              false,
                              distance,
                              bearing,
                              altitude );
+    }
 
-          append(rp);
-        }
+  // Get specific site data from the list. We have to distinguish
+  // between AirfieldList, GilderSiteList and OutlandingList.
+  Airfield* site;
+
+  if( entry.listID == MapContents::AirfieldList )
+    {
+      // Fetch data from airport list
+      site = _globalMapContents->getAirfield( entry.index );
+    }
+  else if( entry.listID == MapContents::GliderfieldList )
+    {
+      // fetch data from glider site list
+      site = _globalMapContents->getGliderfield( entry.index );
     }
   else
     {
-      // get number of elements in the list
-      int nr = _globalMapContents->getListLength(item);
-
-      // qDebug("No of sites: %d type %d", nr, item );
-      for (int i=0; i<nr; i++ )
-        {
-          // Get specific site data from current list. We have to distinguish
-          // between AirfieldList, GilderSiteList and OutlandingList.
-          Airfield* site;
-
-          if( item == MapContents::AirfieldList )
-            {
-              // Fetch data from airport list
-              site = _globalMapContents->getAirfield(i);
-            }
-          else if( item == MapContents::GliderfieldList )
-            {
-              // fetch data from glider site list
-              site = _globalMapContents->getGliderfield(i);
-            }
-          else if( item == MapContents::OutLandingList )
-            {
-              // fetch data from glider site list
-              site = _globalMapContents->getOutlanding(i);
-            }
-          else
-            {
-              qWarning( "ReachableList::addItemsToList: ListType %d is unknown",
-                        item );
-              break;
-            }
-
-          QString siteName = site->getWPName();
-          QString siteIcao = site->getICAO();
-          QString siteDescription = site->getName();
-          QString siteCountry = site->getCountry();
-          short siteType = site->getTypeID();
-          float siteFrequency = site->getFrequency();
-          WGSPoint siteWgsPosition = site->getWGSPosition();
-          QPoint sitePosition = site->getPosition();
-          float siteElevation = site->getElevation();
-          QString siteComment = site->getComment();
-          QList<Runway> siteRwyList = site->getRunwayList();
-
-          if (! bbox.contains(siteWgsPosition) )
-            {
-              //qDebug("Not in bounding box, so ignore! (distance: %d, (%d, %d), %s)", (int)distance.getKilometers(), pt.x(),pt.y(), site->getName().latin1());
-              r++;
-              continue;
-            }
-          else
-            {
-              a++;
-              //qDebug("In bounding box, so accept! (distance: %d, %s)", (int)distance.getKilometers(), site->getName().latin1());
-            }
-          distance.setKilometers(MapCalc::dist(&lastPosition,&siteWgsPosition));
-          // qDebug("%d  %f %f", i, (float)distance.getKilometers(),_maxReach );
-          // check if point is a potential reachable candidate at best LD
-          if ( distance.getKilometers() > _maxReach )
-            {
-              continue;
-            }
-
-          // calculate bearing
-          double result = MapCalc::getBearing(lastPosition, siteWgsPosition);
-          short bearing = short(rint(result * 180./M_PI));
-          Altitude altitude(0);
-
-          // add all potential reachable points to the list, altitude is calculated later
-          ReachablePoint rp( siteName,
-                             siteIcao,
-                             siteDescription,
-                             siteCountry,
-                             true,
-                             siteType,
-                             siteFrequency,
-                             siteWgsPosition,
-                             sitePosition,
-                             siteElevation,
-                             siteComment,
-                             distance,
-                             bearing,
-                             altitude,
-                             siteRwyList );
-          append(rp);
-
-          // qDebug("%s(%d) %f %d° %d", rp.getName().toLatin1().data(), rp.getElevation(),  rp.getDistance().getKilometers(), rp.getBearing(), (int)rp->getArrivalAlt().getMeters() );
-
-        }
+      // fetch data from outlanding list
+      site = _globalMapContents->getOutlanding( entry.index );
     }
-  // qDebug("accepted: %d, rejected: %d. Percent reject: %f",a,r,(100.0*r)/(a+r));
+
+  // The often used point data are read from the columns of the point
+  // store, only frequency and runways are taken from the site object.
+  const PointStore* store = _globalMapContents->getPointStore( entry.listID );
+  const int i = entry.index;
+
+  QList<Runway> siteRwyList = site->getRunwayList();
+
+  return ReachablePoint( store->text( i, PointStore::ShortName ),
+                         store->text( i, PointStore::Icao ),
+                         store->text( i, PointStore::Name ),
+                         store->text( i, PointStore::Country ),
+                         true,
+                         store->type( i ),
+                         site->getFrequency(),
+                         store->wgsPosition( i ),
+                         store->position( i ),
+                         store->elevation( i ),
+                         store->text( i, PointStore::Comment ),
+                         distance,
+                         bearing,
+                         altitude,
+                         siteRwyList );
 }
 
 QColor ReachableList::getReachColor( const QPoint& position )
 {
   // qDebug("name: %s: %d", (const char *)name, arrivalAltMap[name] );
 
-  if ( arrivalAltMap.contains( ReachableList::coordinateString( position ) ) )
+  if ( arrivalAltMap.contains( coordinateKey( position ) ) )
     {
-      if ( arrivalAltMap[ ReachableList::coordinateString ( position ) ] > safetyAlt )
+      int reachAlt = reachAltitude( coordinateKey( position ) );
+
+      if ( reachAlt > safetyAlt )
         {
           return( Qt::green );
         }
-      else if ( arrivalAltMap[ ReachableList::coordinateString ( position ) ] > 0 )
+      else if ( reachAlt > 0 )
         {
           return( Qt::magenta );
         }
@@ -305,9 +230,9 @@ int ReachableList::getArrivalAlt( const QPoint& position )
 {
   // qDebug("name: %s: %d", (const char *)name, arrivalAltMap[name] );
 
-  if ( arrivalAltMap.contains( coordinateString ( position ) ) )
+  if ( arrivalAltMap.contains( coordinateKey ( position ) ) )
     {
-      return( arrivalAltMap[ coordinateString ( position ) ] - safetyAlt );
+      return( arrivalAltMap[ coordinateKey ( position ) ] - safetyAlt );
     }
 
   return( -9999 );
@@ -317,9 +242,9 @@ Altitude ReachableList::getArrivalAltitude( const QPoint& position )
 {
   // qDebug("name: %s: %d", (const char *)name, arrivalAltMap[name] );
 
-  if ( arrivalAltMap.contains( coordinateString ( position ) ) )
+  if ( arrivalAltMap.contains( coordinateKey ( position ) ) )
     {
-      return (Altitude( arrivalAltMap[ coordinateString ( position ) ]) - safetyAlt) ;
+      return (Altitude( arrivalAltMap[ coordinateKey ( position ) ]) - safetyAlt) ;
     }
 
   return Altitude(); //return an invalid altitude
@@ -329,9 +254,9 @@ Distance ReachableList::getDistance( const QPoint& position )
 {
   // qDebug("name: %s: %d", (const char *)name, arrivalAltMap[name] );
 
-  if ( distanceMap.contains( coordinateString ( position ) ) )
+  if ( distanceMap.contains( coordinateKey ( position ) ) )
     {
-      return( distanceMap[ coordinateString ( position ) ] );
+      return( distanceMap[ coordinateKey ( position ) ] );
     }
 
   return Distance();    //return an invalid distance
@@ -341,11 +266,13 @@ ReachablePoint::reachable ReachableList::getReachable( const QPoint& position )
 {
   // qDebug("name: %s: %d", (const char *)name, arrivalAltMap[name] );
 
-  if ( arrivalAltMap.contains( coordinateString ( position ) ) )
+  if ( arrivalAltMap.contains( coordinateKey ( position ) ) )
     {
-      if ( arrivalAltMap[ coordinateString ( position ) ] > safetyAlt )
+      int reachAlt = reachAltitude( coordinateKey( position ) );
+
+      if ( reachAlt > safetyAlt )
         return ReachablePoint::yes;
-      else if ( arrivalAltMap[ coordinateString ( position ) ] > 0 )
+      else if ( reachAlt > 0 )
         return ReachablePoint::belowSafety;
       else
         return ReachablePoint::no;
@@ -354,6 +281,18 @@ ReachablePoint::reachable ReachableList::getReachable( const QPoint& position )
   return ReachablePoint::no;
 }
 
+int ReachableList::reachAltitude( const qint64 key )
+{
+  int reachAlt = arrivalAltMap.value( key );
+
+  if ( clearanceMap.contains( key ) )
+    {
+      reachAlt = qMin( reachAlt, clearanceMap.value( key ) );
+    }
+
+  return reachAlt;
+}
+
 /**
  * Calculate course, distance and reachability from the current position
  * to the elements contained in the limited list. If a glider is defined
@@ -367,6 +306,7 @@ void ReachableList::calculateDataInList()
   int counter = 0;
   setInitValues();
   arrivalAltMap.clear();
+  clearanceMap.clear();
   distanceMap.clear();
 
   for (int i = 0; i < count(); i++)
@@ -378,6 +318,9 @@ void ReachableList::calculateDataInList()
       Distance distance;
       Speed bestSpeed;
 
+      // reset the result of the last terrain check
+      p.setTerrainClearance( Altitude(), WGSPoint() );
+
       distance.setKilometers( MapCalc::dist(&lastPosition, &pt) );
 
       if ( lastPosition == pt || distance.getMeters() <= 100.0 )
@@ -408,10 +351,10 @@ void ReachableList::calculateDataInList()
       if ( arrivalAlt.isValid() )
         {
           // add only valid altitudes to the map
-          arrivalAltMap[ coordinateString ( pt ) ] = (int) arrivalAlt.getMeters() + safetyAlt;
+          arrivalAltMap[ coordinateKey ( pt ) ] = (int) arrivalAlt.getMeters() + safetyAlt;
         }
 
-      distanceMap[ coordinateString ( pt ) ] = distance;
+      distanceMap[ coordinateKey ( pt ) ] = distance;
 
       if ( arrivalAlt.getMeters() > 0 )
         {
@@ -419,6 +362,12 @@ void ReachableList::calculateDataInList()
         }
     }
 
+  if ( calcMode == ReachableList::altitude &&
+       GeneralConfig::instance()->getNearestSiteTerrainCheck() )
+    {
+      calculateTerrainClearance();
+    }
+
   // sorting of items depends on the glider selection
   if ( calculator->glider() )
     {
@@ -435,6 +384,99 @@ void ReachableList::calculateDataInList()
   emit newReachList();
 }
 
+void ReachableList::calculateTerrainClearance()
+{
+  // QTime t;
+  // t.start();
+
+  // Collect the sample points of all glide paths. The samples of a path are
+  // stored consecutively, so that the elevation lookup mostly stays in the
+  // same map tile.
+  QVector<QPoint> samples;
+  QVector<int> firstSample( count(), 0 );
+  QVector<int> sampleCount( count(), 0 );
+
+  for ( int i = 0; i < count(); i++ )
+    {
+      const ReachablePoint& p = at(i);
+
+      if ( p.getArrivalAlt().isValid() == false || p.getDistance().getMeters() <= 0.0 )
+        {
+          continue;
+        }
+
+      const QPoint& pt = p.getWaypoint()->wgsPoint;
+
+      // The start and the end point of the path are not sampled.
+      int n = qBound( 1, int( p.getDistance().getMeters() / TERRAIN_SAMPLE_DISTANCE ),
+                      MAX_TERRAIN_SAMPLES );
+
+      firstSample[i] = samples.size();
+      sampleCount[i] = n;
+
+      for ( int k = 1; k <= n; k++ )
+        {
+          const double f = double(k) / double(n + 1);
+
+          samples.append( QPoint( lastPosition.x() + int( rint( f * (pt.x() - lastPosition.x()) ) ),
+                                  lastPosition.y() + int( rint( f * (pt.y() - lastPosition.y()) ) ) ) );
+        }
+    }
+
+  if ( samples.isEmpty() )
+    {
+      return;
+    }
+
+  QVector<int> elevations;
+  _globalMapContents->findElevations( samples, elevations );
+
+  for ( int i = 0; i < count(); i++ )
+    {
+      const int n = sampleCount.at(i);
+
+      if ( n == 0 )
+        {
+          continue;
+        }
+
+      ReachablePoint& p = (*this)[i];
+
+      // The glide path descends linearly from the current altitude to the
+      // arrival altitude above the site elevation plus the safety altitude.
+      const double drop = lastAltitude -
+                          (p.getElevation() + safetyAlt + p.getArrivalAlt().getMeters());
+
+      double minClearance = 0.0;
+      int minIdx = -1;
+
+      for ( int k = 0; k < n; k++ )
+        {
+          const double f = double(k + 1) / double(n + 1);
+          const int idx = firstSample.at(i) + k;
+
+          const double clearance = lastAltitude - f * drop - elevations.at(idx);
+
+          if ( minIdx < 0 || clearance < minClearance )
+            {
+              minClearance = clearance;
+              minIdx = idx;
+            }
+        }
+
+      p.setTerrainClearance( Altitude( minClearance ), WGSPoint( samples.at(minIdx) ) );
+
+      clearanceMap[ coordinateKey( p.getWaypoint()->wgsPoint ) ] = int( minClearance );
+
+      // qDebug( "%s: clearance=%.0fm at %d,%d",
+      //         p.getName().toLatin1().data(), minClearance,
+      //         samples.at(minIdx).x(), samples.at(minIdx).y() );
+    }
+
+  // qDebug("Time for terrain clearance calculation: %d msec, %d samples",
+  //        t.elapsed(), samples.size() );
+}
+
 void ReachableList::setInitValues()
 {
   // This info we do need from the calculator
@@ -479,27 +521,61 @@ void ReachableList::calculateNewList()
   setInitValues();
   clearLists();  // clear all lists
 
-  // Now add items of different type to the list
-  addItemsToList(MapContents::AirfieldList);
-  addItemsToList(MapContents::GliderfieldList);
-  addItemsToList(MapContents::OutLandingList);
-  addItemsToList(MapContents::WaypointList);
-  modeAltitude = false;
-  //qDebug("Number of potential reachable sites: %d", count() );
+  if ( landableIndex.isOutdated() )
+    {
+      landableIndex.build();
+    }
 
-  // sort list according to distances
-  qSort(begin(), end() );
-  removeDoubles();
-  // qDebug("Number of potential reachable sites (after pruning): %d", count() );
+  // Fetch all landable points in range ordered by their distances.
+  QVector<LandableIndex::Candidate> candidates;
+  landableIndex.findNearest( lastPosition, _maxReach, candidates );
 
-  // Remove all elements over the maximum. That are the far away elements.
+  // Take over the nearest points until the maximum is reached. Double
+  // entries at the same position are detected by a hash of the positions.
   int nr = getMaxNrOfSites();
+  double lastDistance = 0.0;
 
-  while ( nr < size() )
+  QHash<qint64, int> positions;
+
+  for ( int i = 0; i < candidates.size(); i++ )
     {
-      removeFirst();
+      const LandableIndex::Candidate& c = candidates.at(i);
+
+      // Further points with the same distance can still be doubles.
+      if ( positions.size() >= nr && c.distance > lastDistance )
+        {
+          break;
+        }
+
+      const LandableIndex::Entry& entry = landableIndex.entry( c.entry );
+      const qint64 key = coordinateKey( entry.position );
+
+      QHash<qint64, int>::const_iterator it = positions.constFind( key );
+
+      if ( it != positions.constEnd() )
+        {
+          ReachablePoint rp = createPoint( entry, c.distance );
+
+          if ( isPreferred( rp, at( it.value() ) ) )
+            {
+              replace( it.value(), rp );
+            }
+
+          continue;
+        }
+
+      if ( positions.size() >= nr )
+        {
+          continue;
+        }
+
+      positions.insert( key, size() );
+      append( createPoint( entry, c.distance ) );
+      lastDistance = c.distance;
     }
 
+  modeAltitude = false;
+
   // qDebug("Limited Number of potential reachable sites: %d", count() );
   calculateDataInList();
   //qDebug("Time for full calculation: %d msec", t.restart() );
@@ -522,105 +598,33 @@ void ReachableList::show()
 }
 
 /**
- * Removes double entries from the list. Double entries can occur
- * when a point is a waypoint as well as an airfield. In this case,
- * the one with the higher severity or longer name is preferred.
- * This function ASSUMES THE LIST IS SORTED!
+ * Decides, which one of two points at the same position is kept. Double
+ * entries can occur when a point is a waypoint as well as an airfield. In
+ * this case, the one with the higher severity or longer name is preferred.
  */
-void ReachableList::removeDoubles()
+bool ReachableList::isPreferred( const ReachablePoint& p1, const ReachablePoint& p2 )
 {
-  QList<int> removeList;
-
-  for (int i=count()-1; i>=1; i--)
+  if ( p2.getWaypoint()->priority != p1.getWaypoint()->priority )
     {
-      const ReachablePoint& p1 = at(i);
-
-      for (int j=0; j<i; j++)
-        {
-          const ReachablePoint& p2 = at(j);
-
-          //qDebug("i=%d j=%d, P1=%s, P2=%s,", i, j, p1.getWaypoint()->name.toLatin1().data(), p2.getWaypoint()->name.toLatin1().data());
-
-          if ( p2.getWaypoint()->wgsPoint == p1.getWaypoint()->wgsPoint )
-            {
-              //qDebug("  points are the same");
-              // ok, the points are the same. Now we choose which one to remove
-
-              if ( p2.getWaypoint()->priority != p1.getWaypoint()->priority )
-                {
-                  // the waypoint with the lower priority will be removed
-                  if ( p2.getWaypoint()->priority > p1.getWaypoint()->priority )
-                    {
-                      removeList.append(i);
-                    }
-                  else
-                    {
-                      removeList.append(j);
-                    }
-                  continue;
-                }
-
-              if ( p2.getWaypoint()->name == p1.getWaypoint()->name )
-                {
-                  // both name are identical. remove the one which has not set
-                  // the airfield origin flag.
-                  if( ! p1.isOrignAfl() )
-                     {
-                       removeList.append(i);
-                       continue;
-                     }
-
-                  if( ! p2.isOrignAfl() )
-                     {
-                       removeList.append(j);
-                       continue;
-                     }
-
-                  // both origin flags are set, remove one of the objects
-                  removeList.append(j);
-                  continue;
-                }
-
-              if ( p2.getWaypoint()->name.length() == p1.getWaypoint()->name.length() )
-                {
-                  // the lengths of the names are the same
-                  // remove the one with the lowest alphabetical value
-                  // (remember that A<a)
-                  if (p2.getWaypoint()->name > p1.getWaypoint()->name)
-                    {
-                      removeList.append(i);
-                    }
-                  else
-                    {
-                      removeList.append(j);
-                    }
-                  continue;
-                }
-
-              // if the names are not of equal length, remove the shortest.
-              if ( p2.getWaypoint()->name.length() > p1.getWaypoint()->name.length() )
-                {
-                  removeList.append(i);
-                }
-              else
-                {
-                  removeList.append(j);
-                }
-              continue;
-            }
-
-          // qDebug("  points are NOT the same: (%d, %d) vs (%d, %d)",p1.getWaypoint()->origP.x(),p1.getWaypoint()->origP.y(),p2.getWaypoint()->origP.x(),p2.getWaypoint()->origP.y());
-        } // End of for j
-    } // End of for i
+      // the waypoint with the lower priority will be removed
+      return ( p1.getWaypoint()->priority > p2.getWaypoint()->priority );
+    }
 
-  // sort remove list
-  qSort( removeList.begin(), removeList.end(), qLess<int>() );
+  if ( p2.getWaypoint()->name == p1.getWaypoint()->name )
+    {
+      // both name are identical. Prefer the one which has set
+      // the airfield origin flag.
+      return ( p1.isOrignAfl() && ! p2.isOrignAfl() );
+    }
 
-  // Start remove at the end of the list so that access index is always valid.
-  for (int i = removeList.count()-1; i >= 0; i--)
+  if ( p2.getWaypoint()->name.length() == p1.getWaypoint()->name.length() )
     {
-      // qDebug("Removing point %d (%s)", removeList.at(i), at(removeList.at(i)).getWaypoint()->name.toLatin1().data());
-      // remove doubles from global list
-      removeAt( removeList.at(i) );
+      // the lengths of the names are the same
+      // remove the one with the lowest alphabetical value
+      // (remember that A<a)
+      return ( p1.getWaypoint()->name > p2.getWaypoint()->name );
     }
+
+  // if the names are not of equal length, remove the shortest.
+  return ( p1.getWaypoint()->name.length() > p2.getWaypoint()->name.length() );
 }
@@ -40,12 +40,13 @@
 
 #include <QObject>
 #include <QPoint>
+#include <QHash>
 #include <QList>
-#include <QMap>
 
 #include "generalconfig.h"
 #include "mapmatrix.h"
 #include "distance.h"
+#include "landableindex.h"
 #include "mapcontents.h"
 #include "altitude.h"
 #include "vector.h"
@@ -96,6 +97,15 @@ class ReachableList : public QObject, QList<ReachablePoint>
    */
   void calculateNewList();
 
+  /**
+   * Marks the index of the landable points as outdated. Must be called,
+   * if the point lists have been changed.
+   */
+  void invalidateIndex()
+  {
+    landableIndex.invalidate();
+  };
+
   /**
    * returns the number of sites in the list
    */
@@ -144,6 +154,7 @@ class ReachableList : public QObject, QList<ReachablePoint>
   {
     clear();
     arrivalAltMap.clear();
+    clearanceMap.clear();
     distanceMap.clear();
   };
 
@@ -203,15 +214,29 @@ class ReachableList : public QObject, QList<ReachablePoint>
     */
   void calculateDataInList();
 
+  /**
+   * Samples the terrain elevation along the glide paths to all points with
+   * a valid arrival altitude and sets their minimum terrain clearance. The
+   * terrain of all glide paths is fetched in one batch.
+   */
+  void calculateTerrainClearance();
+
+  /**
+   * Returns the arrival altitude plus safety altitude of a point, limited
+   * by the terrain clearance of its glide path.
+   */
+  static int reachAltitude( const qint64 key );
+
   /**
    * Sets the initial values needed for the calculation.
    */
   void setInitValues();
 
   /**
-   * adds glider, airport or waypoint site (if not out of reach) to the list
+   * creates a reachable point from a landable index entry
    */
-  void addItemsToList(enum MapContents::ListID item);
+  ReachablePoint createPoint( const LandableIndex::Entry& entry,
+                              const double distanceKm );
 
   /**
    * print list via qDebug interface
@@ -219,16 +244,18 @@ class ReachableList : public QObject, QList<ReachablePoint>
   void show();
 
   /**
-   * Removes double entries from the list. Double entries can occur
-   * when a point is a waypoint as well as an airfield. In this case,
-   * the one with the higher severity or longer name is preferred.
-   * This function ASSUMES THE LIST IS SORTED!
+   * Decides, which one of two points at the same position is kept. Double
+   * entries can occur when a point is a waypoint as well as an airfield.
+   * In this case, the one with the higher severity or longer name is
+   * preferred.
+   *
+   * @returns true, if p1 is preferred to p2
    */
-  void removeDoubles();
+  static bool isPreferred( const ReachablePoint& p1, const ReachablePoint& p2 );
 
-  static QString coordinateString(const QPoint& position)
+  static qint64 coordinateKey(const QPoint& position)
   {
-    return QString("%1.%2").arg(position.x()).arg(position.y());
+    return (qint64( position.x() ) << 32) | quint32( position.y() );
   };
 
   QPoint      lastCalculationPosition; // position at last calculation
@@ -237,6 +264,7 @@ class ReachableList : public QObject, QList<ReachablePoint>
   Vector      lastWind;
   Speed       lastMc;
   double      _maxReach;
+  LandableIndex landableIndex;
   int         tick;
   bool        initValuesOK;
 
@@ -246,8 +274,9 @@ class ReachableList : public QObject, QList<ReachablePoint>
   static bool modeAltitude;
   static int safetyAlt;
 
-  static QMap<QString, int> arrivalAltMap;
-  static QMap<QString, Distance> distanceMap;
+  static QHash<qint64, int> arrivalAltMap;
+  static QHash<qint64, int> clearanceMap;
+  static QHash<qint64, Distance> distanceMap;
 
   // number of created class instances
   static short instances;
@@ -75,11 +75,21 @@ ReachablePoint::~ReachablePoint()
 
 ReachablePoint::reachable ReachablePoint::getReachable()
 {
-  if ( _arrivalAlt.isValid() && _arrivalAlt.getMeters() > 0 )
+  double arrival = _arrivalAlt.getMeters();
+
+  if ( _terrainClearance.isValid() )
+    {
+      // A ridge on the glide path downgrades the reachability. The
+      // clearance must be above the safety altitude like the arrival.
+      arrival = qMin( arrival,
+                      _terrainClearance.getMeters() - ReachableList::getSafetyAltititude() );
+    }
+
+  if ( _arrivalAlt.isValid() && arrival > 0 )
     {
       return ReachablePoint::yes;
     }
-  else if ( _arrivalAlt.isValid() && _arrivalAlt.getMeters() > -ReachableList::getSafetyAltititude() )
+  else if ( _arrivalAlt.isValid() && arrival > -ReachableList::getSafetyAltititude() )
     {
       return ReachablePoint::belowSafety;
     }
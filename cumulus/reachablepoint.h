@@ -174,6 +174,33 @@ class ReachablePoint
     _arrivalAlt = alt;
   };
 
+  /**
+   * Returns the minimum clearance above the terrain along the glide path
+   * to the point. It is invalid, if the terrain was not checked.
+   */
+  Altitude getTerrainClearance() const
+  {
+    return _terrainClearance;
+  };
+
+  /**
+   * Returns the position of the minimum terrain clearance along the glide
+   * path. It is the obstructing position, if the clearance is negative.
+   */
+  const WGSPoint& getObstruction() const
+  {
+    return _obstruction;
+  };
+
+  /**
+   * Sets the result of the terrain check. An invalid clearance resets it.
+   */
+  void setTerrainClearance( const Altitude& clearance, const WGSPoint& position )
+  {
+    _terrainClearance = clearance;
+    _obstruction = position;
+  };
+
   reachable getReachable();
 
   /**
@@ -188,6 +215,8 @@ class ReachablePoint
   Distance     _distance;
   short        _bearing;
   Altitude     _arrivalAlt;
+  Altitude     _terrainClearance;
+  WGSPoint     _obstruction;
 };
 
 #endif /* REACHABLE_POINT_H */
@@ -0,0 +1,103 @@
+/***********************************************************************
+**
+**   redrawscheduler.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include "redrawscheduler.h"
+
+RedrawScheduler::RedrawScheduler( const int frameBudget,
+                                  const int minDelay,
+                                  const int maxDelay ) :
+  m_frameBudget(frameBudget),
+  m_minDelay(minDelay),
+  m_maxDelay(maxDelay)
+{
+  for( int i = 0; i < LayerCount; i++ )
+    {
+      m_cost[i] = 0.0;
+      m_measured[i] = false;
+    }
+
+  resetStatistics();
+}
+
+RedrawScheduler::~RedrawScheduler()
+{
+}
+
+void RedrawScheduler::addDrawTime( const Layer layer, const int msecs )
+{
+  if( m_measured[layer] == false )
+    {
+      m_cost[layer] = msecs;
+      m_measured[layer] = true;
+      return;
+    }
+
+  // Moving average, a single slow drawing shall not change the delays
+  // too much.
+  m_cost[layer] = ( 3.0 * m_cost[layer] + msecs ) / 4.0;
+}
+
+void RedrawScheduler::addFrame( const int msecs )
+{
+  m_frames++;
+  m_frameTimeSum += msecs;
+  m_lastFrameTime = msecs;
+  m_maxFrameTime  = qMax( m_maxFrameTime, msecs );
+}
+
+int RedrawScheduler::drawCost( const Layer fromLayer ) const
+{
+  double cost = 0.0;
+
+  // All layer groups above the first one must be redrawn too.
+  for( int i = fromLayer; i < LayerCount; i++ )
+    {
+      cost += m_cost[i];
+    }
+
+  return static_cast<int> (ceil( cost ));
+}
+
+int RedrawScheduler::delay( const Layer fromLayer ) const
+{
+  const int cost = drawCost( fromLayer );
+
+  if( fromLayer == Information )
+    {
+      // Use the rest of the frame budget to collect further requests.
+      // The delay is at least as long as the drawing, so that at most
+      // the half of the time is spent with drawing.
+      return qMin( qMax( m_frameBudget - cost, cost ), m_maxDelay );
+    }
+
+  // Expensive layers are deferred the longer the more they cost.
+  return qBound( m_minDelay, 2 * cost, m_maxDelay );
+}
+
+int RedrawScheduler::longDelay() const
+{
+  // A redraw must be possible, before the long delay expires again.
+  return qMax( m_maxDelay, 2 * drawCost( Base ) );
+}
+
+void RedrawScheduler::resetStatistics()
+{
+  m_frames = 0;
+  m_frameTimeSum = 0;
+  m_maxFrameTime = 0;
+  m_lastFrameTime = 0;
+}
@@ -0,0 +1,152 @@
+/***********************************************************************
+**
+**   redrawscheduler.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class RedrawScheduler
+*
+* \author Axel Pauli
+*
+* \brief Adapts the delays of the map redraws to the measured drawing costs.
+*
+* The map is drawn in four layer groups, the base, aero, navigation and
+* information layers. The drawing time of every group is measured and
+* averaged. From these costs the scheduler derives, how long a redraw
+* request is delayed to collect further requests.
+*
+* Redraws of the information layer only, e.g. after a new position, are
+* cheap. They are delayed until the frame budget is used up, so that the
+* display can follow the GPS receiver with several updates per second.
+* Redraws of the lower layers are expensive. Their delay grows with their
+* cost, so that a slow device is not blocked by map drawings. In both cases
+* at most the half of the time is spent with drawing.
+*
+* Furthermore the scheduler collects statistics about the drawn frames.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef REDRAW_SCHEDULER_H
+#define REDRAW_SCHEDULER_H
+
+#include <QtGlobal>
+
+class RedrawScheduler
+{
+ public:
+
+  /** The separately measured layer groups in drawing order. */
+  enum Layer
+  {
+    Base,
+    Aero,
+    Navigation,
+    Information,
+    LayerCount
+  };
+
+  /**
+   * \param frameBudget The intended time in ms between two redraws of the
+   *                    information layer.
+   * \param minDelay The minimum delay in ms of a redraw of the lower layers.
+   * \param maxDelay The maximum delay in ms of a redraw request.
+   */
+  RedrawScheduler( const int frameBudget, const int minDelay, const int maxDelay );
+
+  virtual ~RedrawScheduler();
+
+  /**
+   * Stores the drawing time of a layer group.
+   */
+  void addDrawTime( const Layer layer, const int msecs );
+
+  /**
+   * Stores the drawing time of a complete map redraw.
+   */
+  void addFrame( const int msecs );
+
+  /**
+   * \return The average time in ms to redraw the map from the passed layer
+   *         group on.
+   */
+  int drawCost( const Layer fromLayer ) const;
+
+  /**
+   * \return The delay in ms of a redraw request from the passed layer on.
+   */
+  int delay( const Layer fromLayer ) const;
+
+  /**
+   * \return The minimum time in ms between two redraws from the passed
+   *         layer on.
+   */
+  int interval( const Layer fromLayer ) const
+  {
+    return drawCost( fromLayer ) + delay( fromLayer );
+  };
+
+  /**
+   * \return The time in ms, after which a redraw is executed in every case,
+   *         even if further requests are coming in.
+   */
+  int longDelay() const;
+
+  /** \return The number of drawn frames. */
+  int frames() const
+  {
+    return m_frames;
+  };
+
+  /** \return The average drawing time in ms of all frames. */
+  double averageFrameTime() const
+  {
+    return m_frames > 0 ? double(m_frameTimeSum) / double(m_frames) : 0.0;
+  };
+
+  /** \return The longest drawing time in ms of a frame. */
+  int maxFrameTime() const
+  {
+    return m_maxFrameTime;
+  };
+
+  /** \return The drawing time in ms of the last frame. */
+  int lastFrameTime() const
+  {
+    return m_lastFrameTime;
+  };
+
+  /** Resets the frame statistics. The measured layer costs are kept. */
+  void resetStatistics();
+
+ private:
+
+  /** Average drawing times in ms of the layer groups. */
+  double m_cost[LayerCount];
+
+  /** Set, if the layer group has been measured. */
+  bool m_measured[LayerCount];
+
+  int m_frameBudget;
+  int m_minDelay;
+  int m_maxDelay;
+
+  int m_frames;
+  qint64 m_frameTimeSum;
+  int m_maxFrameTime;
+  int m_lastFrameTime;
+};
+
+#endif /* REDRAW_SCHEDULER_H */
@@ -93,21 +93,21 @@
 //=================================================================================
 // Compiled file versions. Increment this value, if you change the compiled format.
 //=================================================================================
-#define FILE_VERSION_GROUND_C   104
-#define FILE_VERSION_TERRAIN_C  104
-#define FILE_VERSION_MAP_C      103
+#define FILE_VERSION_GROUND_C   105
+#define FILE_VERSION_TERRAIN_C  105
+#define FILE_VERSION_MAP_C      104
 
 // Version definition for compiled airspace files.
-#define FILE_VERSION_AIRSPACE_C 2
+#define FILE_VERSION_AIRSPACE_C 3
 
 // Version definition for compiled airfield files.
-#define FILE_VERSION_AIRFIELD_C 2
+#define FILE_VERSION_AIRFIELD_C 3
 
 // Version definition for compiled navigation aid files.
-#define FILE_VERSION_NAV_AIDS_C 2
+#define FILE_VERSION_NAV_AIDS_C 3
 
 // Version definition for compiled hotspot files.
-#define FILE_VERSION_HOTSPOT_C 2
+#define FILE_VERSION_HOTSPOT_C 3
 
 /******************************************************************************
  * Definition of map element types
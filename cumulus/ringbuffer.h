@@ -0,0 +1,227 @@
+/***********************************************************************
+**
+**   ringbuffer.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <QVector>
+
+/**
+ * \class RingBuffer
+ *
+ * \author Axel Pauli
+ *
+ * \brief Template for a ring buffer with a fixed capacity.
+ *
+ * The ring buffer keeps the last added items in a contiguous array, which is
+ * allocated once in the constructor. Adding an item is O(1), if the buffer is
+ * full, the oldest item is overwritten. The items are accessed in reverse
+ * order of their adding, the newest item has the index 0 and the oldest item
+ * the index count() - 1.
+ *
+ * If the items have a member \e time and are added in chronological order,
+ * \ref countAfter determines the items of a time range by a binary search.
+ *
+ * \date 2016
+ *
+ * \version 1.0
+ */
+
+template <class type>
+class RingBuffer
+{
+
+public:
+
+  /**
+   * Constructor
+   *
+   * @param capacity the maximum number of items in the buffer.
+   */
+  RingBuffer( const int capacity=10 );
+
+  virtual ~RingBuffer();
+
+  /**
+   * Adds an item as newest one to the buffer. If the buffer is full, the
+   * oldest item is overwritten.
+   *
+   * @param elem Item to be added.
+   */
+  void add( const type &elem );
+
+  /**
+   * Removes all items. The capacity is kept.
+   */
+  void clear()
+  {
+    m_head  = -1;
+    m_count = 0;
+  };
+
+  /**
+   * @return The capacity of the buffer.
+   */
+  int capacity() const
+  {
+    return m_items.size();
+  };
+
+  /**
+   * @return The number of items in the buffer.
+   */
+  int count() const
+  {
+    return m_count;
+  };
+
+  int size() const
+  {
+    return m_count;
+  };
+
+  bool isEmpty() const
+  {
+    return m_count == 0;
+  };
+
+  /**
+   * @param i Index of the item, 0 is the newest item.
+   *
+   * @return The item at the index i.
+   */
+  const type& at( const int i ) const
+  {
+    return m_items.at( position(i) );
+  };
+
+  type& operator[]( const int i )
+  {
+    return m_items[position(i)];
+  };
+
+  const type& operator[]( const int i ) const
+  {
+    return m_items.at( position(i) );
+  };
+
+  /**
+   * @return The newest item. The buffer must not be empty.
+   */
+  const type& first() const
+  {
+    return at( 0 );
+  };
+
+  /**
+   * @return The oldest item. The buffer must not be empty.
+   */
+  const type& last() const
+  {
+    return at( m_count - 1 );
+  };
+
+  /**
+   * Counts the items, which are younger than the passed time limit. The items
+   * must have a member \e time and must be added in chronological order.
+   * Because the items are sorted by their time, a binary search is used.
+   *
+   * @param limit The time limit, the time type must be comparable with the
+   *              time member of the items.
+   *
+   * @return The number of items with a time greater than limit. These are
+   *         the items with the indexes 0 ... result - 1.
+   */
+  template <class Time>
+  int countAfter( const Time& limit ) const
+  {
+    int lower = 0;
+    int upper = m_count;
+
+    while( lower < upper )
+      {
+        const int middle = (lower + upper) / 2;
+
+        if( at( middle ).time > limit )
+          {
+            lower = middle + 1;
+          }
+        else
+          {
+            upper = middle;
+          }
+      }
+
+    return lower;
+  };
+
+private:
+
+  /** Maps an item index to its position in the array. */
+  int position( const int i ) const
+  {
+    const int pos = m_head - i;
+
+    return ( pos < 0 ) ? pos + m_items.size() : pos;
+  };
+
+  /** Array with the items, its size is the capacity. */
+  QVector<type> m_items;
+
+  /** Array position of the newest item. */
+  int m_head;
+
+  /** Number of items in the buffer. */
+  int m_count;
+};
+
+
+/**
+ * IMPLEMENTATION
+ * ====================================================================
+ *
+ * The implementation is stored in the header file because it is a template.
+ */
+
+template <class type>
+RingBuffer<type>::RingBuffer( const int capacity ) :
+  m_items( qMax(capacity, 1) ),
+  m_head(-1),
+  m_count(0)
+{
+}
+
+template <class type>
+RingBuffer<type>::~RingBuffer()
+{
+}
+
+template <class type>
+void RingBuffer<type>::add( const type &elem )
+{
+  if( ++m_head == m_items.size() )
+    {
+      m_head = 0;
+    }
+
+  m_items[m_head] = elem;
+
+  if( m_count < m_items.size() )
+    {
+      m_count++;
+    }
+}
+
+#endif
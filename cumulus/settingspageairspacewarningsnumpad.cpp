@@ -108,6 +108,29 @@ SettingsPageAirspaceWarningsNumPad::SettingsPageAirspaceWarningsNumPad(QWidget *
   mVGroupLayout->addWidget(m_belowWarnDistVN, row, 2);
   row++;
 
+  QGroupBox* lookAheadGroup = new QGroupBox(tr("Look-ahead"), this);
+  topLayout->addWidget(lookAheadGroup);
+
+  QHBoxLayout* lookAheadLayout = new QHBoxLayout(lookAheadGroup);
+
+  lbl = new QLabel(tr("Incursion warning time (0=off)"), lookAheadGroup);
+  lookAheadLayout->addWidget(lbl);
+
+  m_lookAheadTime = new NumberEditor( lookAheadGroup );
+  m_lookAheadTime->setDecimalVisible( false );
+  m_lookAheadTime->setPmVisible( false );
+  m_lookAheadTime->setMaxLength(3);
+  m_lookAheadTime->setSuffix( " s" );
+  m_lookAheadTime->setRange( 0, 600 );
+  QRegExpValidator* tValidator = new QRegExpValidator( QRegExp( "([0-9]{1,3})" ), this );
+  m_lookAheadTime->setValidator( tValidator );
+  lookAheadLayout->addWidget(m_lookAheadTime);
+  lookAheadLayout->addStretch(10);
+
+  // The look-ahead belongs to the warnings
+  connect( m_enableWarning, SIGNAL(toggled(bool)),
+           lookAheadGroup, SLOT(setEnabled(bool)) );
+
   topLayout->addSpacing(20);
   topLayout->addStretch(10);
 
@@ -182,6 +205,8 @@ void SettingsPageAirspaceWarningsNumPad::slot_load()
       m_belowWarnDistVN->setValue((int) rint(awd.verBelowVeryClose.getFeet()));
     }
 
+  m_lookAheadTime->setValue( conf->getAirspaceLookAheadTime() );
+
   // save loaded values for change control
   m_horiWarnDistValue    = m_horiWarnDist->value();
   m_horiWarnDistVNValue  = m_horiWarnDistVN->value();
@@ -191,6 +216,8 @@ void SettingsPageAirspaceWarningsNumPad::slot_load()
 
   m_belowWarnDistValue   = m_belowWarnDist->value();
   m_belowWarnDistVNValue = m_belowWarnDistVN->value();
+
+  m_lookAheadTimeValue   = m_lookAheadTime->value();
 }
 
 /**
@@ -222,6 +249,8 @@ void SettingsPageAirspaceWarningsNumPad::slot_defaults()
       m_belowWarnDist->setValue( 700 );
       m_belowWarnDistVN->setValue( 350 );
     }
+
+  m_lookAheadTime->setValue( 60 );
 }
 
 void SettingsPageAirspaceWarningsNumPad::slot_save()
@@ -252,6 +281,7 @@ void SettingsPageAirspaceWarningsNumPad::slot_save()
     }
 
   conf->setAirspaceWarningDistances( awd );
+  conf->setAirspaceLookAheadTime( m_lookAheadTime->value() );
   close();
 }
 
@@ -111,6 +111,9 @@ public:
   NumberEditor*  m_belowWarnDist;
   NumberEditor*  m_belowWarnDistVN;
 
+  /** Look ahead time for the incursion prediction in seconds */
+  NumberEditor*  m_lookAheadTime;
+
   QPushButton *m_defaults;
 
   // here are the fetched configuration items stored to have control about
@@ -121,6 +124,7 @@ public:
   int m_aboveWarnDistVNValue;
   int m_belowWarnDistValue;
   int m_belowWarnDistVNValue;
+  int m_lookAheadTimeValue;
 };
 
 #endif /* SettingsPageAirSpaceWarningsNumPad_h */
@@ -178,6 +178,13 @@ SettingsPageInformation::SettingsPageInformation( QWidget *parent ) :
   topLayout->addWidget( inverseInfoDisplay, row, 1, 1, 2 );
   row++;
 
+  checkTerrainClearance = new QCheckBox(tr("Terrain Check"), this);
+  checkTerrainClearance->setObjectName("checkTerrain");
+  checkTerrainClearance->setChecked(false);
+  checkTerrainClearance->setToolTip(tr("Check the terrain along the glide paths to the nearest sites"));
+  topLayout->addWidget( checkTerrainClearance, row, 0 );
+  row++;
+
   topLayout->setRowStretch ( row, 10 );
   topLayout->setColumnStretch( 2, 10 );
 
@@ -267,6 +274,7 @@ void SettingsPageInformation::load()
   checkAlarmSound->setChecked( conf->getAlarmSoundOn() );
   checkFlarmAlarms->setChecked( conf->getPopupFlarmAlarms() );
   calculateNearestSites->setChecked( conf->getNearestSiteCalculatorSwitch() );
+  checkTerrainClearance->setChecked( conf->getNearestSiteTerrainCheck() );
   inverseInfoDisplay->setChecked( conf->getBlackBgInfoDisplay() );
 }
 
@@ -287,6 +295,7 @@ void SettingsPageInformation::save()
   conf->setAlarmSoundOn( checkAlarmSound->isChecked() );
   conf->setPopupFlarmAlarms( checkFlarmAlarms->isChecked() );
   conf->setNearestSiteCalculatorSwitch( calculateNearestSites->isChecked() );
+  conf->setNearestSiteTerrainCheck( checkTerrainClearance->isChecked() );
   conf->setBlackBgInfoDisplay( inverseInfoDisplay->isChecked() );
 }
 
@@ -306,6 +315,7 @@ void SettingsPageInformation::slot_setFactoryDefault()
   checkFlarmAlarms->setChecked( true );
   inverseInfoDisplay->setChecked( false );
   calculateNearestSites->setChecked(NEAREST_SITE_CALCULATOR_DEFAULT);
+  checkTerrainClearance->setChecked(NEAREST_SITE_TERRAIN_CHECK_DEFAULT);
 }
 
 #ifndef ANDROID
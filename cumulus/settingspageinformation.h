@@ -114,6 +114,7 @@ class SettingsPageInformation : public QWidget
   QCheckBox*   checkAlarmSound;
   QCheckBox*   checkFlarmAlarms;
   QCheckBox*   calculateNearestSites;
+  QCheckBox*   checkTerrainClearance;
   QCheckBox*   inverseInfoDisplay;
 
   QPushButton* buttonReset;
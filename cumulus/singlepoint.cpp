@@ -21,7 +21,9 @@
 
 SinglePoint::SinglePoint() :
   BaseMapElement(),
-  elevation(0.0)
+  elevation(0.0),
+  m_store(0),
+  m_storeIndex(-1)
 {
 }
 
@@ -40,14 +42,141 @@ SinglePoint::SinglePoint( const QString& n,
   shortName(shortName),
   curPos(pos),
   elevation(elevation),
-  comment(comment)
+  comment(comment),
+  m_store(0),
+  m_storeIndex(-1)
 {
 }
 
+SinglePoint::SinglePoint( const SinglePoint& other ) :
+  BaseMapElement( other ),
+  elevation(0.0),
+  m_store(0),
+  m_storeIndex(-1)
+{
+  copyFrom( other );
+}
+
 SinglePoint::~SinglePoint()
 {
 }
 
+SinglePoint& SinglePoint::operator=( const SinglePoint& other )
+{
+  if( this == &other )
+    {
+      return *this;
+    }
+
+  BaseMapElement::operator=( other );
+
+  m_store = 0;
+  m_storeIndex = -1;
+
+  copyFrom( other );
+  return *this;
+}
+
+void SinglePoint::copyFrom( const SinglePoint& other )
+{
+  // The accessors of the other point fetch its data also from its store.
+  name        = other.getName();
+  typeID      = other.getTypeID();
+  country     = other.getCountry();
+  wgsPosition = other.getWGSPosition();
+  position    = other.getPosition();
+  shortName   = other.getWPName();
+  curPos      = other.curPos;
+  elevation   = other.getElevation();
+  comment     = other.getComment();
+  m_icao      = other.getICAO();
+}
+
+void SinglePoint::attach( PointStore* store, const int index )
+{
+  m_store = store;
+  m_storeIndex = index;
+
+  // The data are kept by the store now.
+  name      = QString();
+  country   = QString();
+  shortName = QString();
+  comment   = QString();
+  m_icao    = QString();
+}
+
+void SinglePoint::setName( QString value )
+{
+  if( m_store )
+    {
+      m_store->setText( m_storeIndex, PointStore::Name, value );
+    }
+  else
+    {
+      name = value;
+    }
+}
+
+void SinglePoint::setTypeID( const objectType value )
+{
+  if( m_store )
+    {
+      m_store->setType( m_storeIndex, value );
+    }
+  else
+    {
+      typeID = value;
+    }
+}
+
+void SinglePoint::setCountry( QString value )
+{
+  if( m_store )
+    {
+      m_store->setText( m_storeIndex, PointStore::Country, value.toUpper().left(2) );
+    }
+  else
+    {
+      BaseMapElement::setCountry( value );
+    }
+}
+
+void SinglePoint::setICAO( const QString& value )
+{
+  if( m_store )
+    {
+      m_store->setText( m_storeIndex, PointStore::Icao, value );
+    }
+  else
+    {
+      m_icao = value;
+    }
+}
+
+void SinglePoint::setWPName( const QString& newName )
+{
+  if( m_store )
+    {
+      m_store->setText( m_storeIndex, PointStore::ShortName, newName );
+    }
+  else
+    {
+      shortName = newName;
+    }
+}
+
+void SinglePoint::setComment( QString value )
+{
+  if( m_store )
+    {
+      m_store->setText( m_storeIndex, PointStore::Comment, value );
+    }
+  else
+    {
+      comment = value;
+    }
+}
+
 bool SinglePoint::drawMapElement( QPainter* targetP )
 {
   if( ! isVisible() )
@@ -56,18 +185,20 @@ bool SinglePoint::drawMapElement( QPainter* targetP )
       return false;
     }
 
-  curPos = glMapMatrix->map( position );
+  curPos = glMapMatrix->map( getPosition() );
 
   targetP->setPen( QPen( Qt::black, 2 ) );
 
-  QPixmap pixmap = glConfig->getPixmap( typeID, false );
+  const objectType type = getTypeID();
+
+  QPixmap pixmap = glConfig->getPixmap( type, false );
 
   int xoff = pixmap.size().width() / 2;
   int yoff = pixmap.size().height() / 2;
 
-  if( typeID == BaseMapElement::City ||
-      typeID == BaseMapElement::Thermal ||
-      typeID == BaseMapElement::Turnpoint )
+  if( type == BaseMapElement::City ||
+      type == BaseMapElement::Thermal ||
+      type == BaseMapElement::Turnpoint )
    {
      // The lower end of the flag shall directly point to the point at the map.
      yoff = pixmap.size().height();
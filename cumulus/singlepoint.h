@@ -25,6 +25,10 @@
  * UltraLight, HangGlider, Parachute, Balloon, Village
  * or Landmark. Consists only of a name and a position.
  *
+ * A point of a map point list can be attached to the \ref PointStore of its
+ * list. Then its positions, type, elevation and texts are kept only in the
+ * store and the accessors of the point read and write the store.
+ *
  * \see BaseMapElement#objectType
  * \see Airfield
  * \see Gliderfield
@@ -38,7 +42,11 @@
 #ifndef SINGLE_POINT_H
 #define SINGLE_POINT_H
 
+#include <QList>
+#include <QPolygon>
+
 #include "basemapelement.h"
+#include "pointstore.h"
 #include "wgspoint.h"
 
 class SinglePoint : public BaseMapElement
@@ -72,11 +80,90 @@ class SinglePoint : public BaseMapElement
               const QString country = "",
               const QString comment = "",
               const unsigned short secID=0 );
+  /**
+   * Copy constructor. The copy of an attached point is detached.
+   */
+  SinglePoint( const SinglePoint& other );
+
   /**
    * Destructor
    */
   virtual ~SinglePoint();
 
+  /**
+   * Assignment operator. The target point is detached.
+   */
+  SinglePoint& operator=( const SinglePoint& other );
+
+  /**
+   * Attaches the point to a point store. The point data are already
+   * contained in the store, the own copies are released.
+   *
+   * @param store The store of the point list
+   * @param index The index of the point in the list
+   */
+  void attach( PointStore* store, const int index );
+
+  /**
+   * @return True, if the point data are kept in a point store.
+   */
+  bool isAttached() const
+    {
+      return m_store != static_cast<PointStore *> (0);
+    };
+
+  /**
+   * @return The name of the element.
+   */
+  virtual QString getName() const
+    {
+      return m_store ? m_store->text( m_storeIndex, PointStore::Name ) : name;
+    };
+
+  /**
+   * @param value The new name of the element.
+   */
+  virtual void setName( QString value );
+
+  /**
+   * @return The type of the element.
+   */
+  virtual objectType getTypeID() const
+    {
+      return m_store ? m_store->type( m_storeIndex ) : typeID;
+    };
+
+  /**
+   * @param value The new type of the element.
+   */
+  virtual void setTypeID( const objectType value );
+
+  /**
+   * @return The country code of the element.
+   */
+  virtual QString getCountry() const
+    {
+      return m_store ? m_store->text( m_storeIndex, PointStore::Country ) : country;
+    };
+
+  /**
+   * @param value The new country code of the element.
+   */
+  virtual void setCountry( QString value );
+
+  /**
+   * @return The ICAO code of the element.
+   */
+  QString getICAO() const
+    {
+      return m_store ? m_store->text( m_storeIndex, PointStore::Icao ) : m_icao;
+    };
+
+  /**
+   * @param value The new ICAO code of the element.
+   */
+  void setICAO( const QString& value );
+
   /**
    * Draws the element into the given painter. Reimplemented from
    * \ref BaseMapElement.
@@ -91,7 +178,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual QPoint getPosition() const
     {
-      return position;
+      return m_store ? m_store->position( m_storeIndex ) : position;
     };
 
   /**
@@ -99,7 +186,14 @@ class SinglePoint : public BaseMapElement
    */
   virtual void setPosition( const QPoint& value )
     {
-      position = value;
+      if( m_store )
+        {
+          m_store->setPosition( m_storeIndex, value );
+        }
+      else
+        {
+          position = value;
+        }
     };
 
   /**
@@ -107,7 +201,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual WGSPoint getWGSPosition() const
     {
-      return wgsPosition;
+      return m_store ? m_store->wgsPosition( m_storeIndex ) : wgsPosition;
     };
 
   /**
@@ -115,7 +209,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual WGSPoint* getWGSPositionPtr()
     {
-      return &wgsPosition;
+      return &getWGSPositionRef();
     };
 
   /**
@@ -123,7 +217,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual WGSPoint& getWGSPositionRef()
     {
-      return wgsPosition;
+      return m_store ? m_store->wgsPositionRef( m_storeIndex ) : wgsPosition;
     };
 
   /**
@@ -131,7 +225,14 @@ class SinglePoint : public BaseMapElement
    */
   virtual void setWGSPosition( const WGSPoint& value )
     {
-      wgsPosition = value;
+      if( m_store )
+        {
+          m_store->setWGSPosition( m_storeIndex, value );
+        }
+      else
+        {
+          wgsPosition = value;
+        }
     };
 
   /**
@@ -139,16 +240,13 @@ class SinglePoint : public BaseMapElement
    */
   virtual QString getWPName() const
     {
-      return shortName;
+      return m_store ? m_store->text( m_storeIndex, PointStore::ShortName ) : shortName;
     };
 
   /**
    * @param newName The new short name of the element.
    */
-  virtual void setWPName( const QString& newName )
-    {
-      shortName = newName;
-    };
+  virtual void setWPName( const QString& newName );
 
   /**
    * @return the position in the current map.
@@ -171,7 +269,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual float getElevation() const
     {
-      return elevation;
+      return m_store ? m_store->elevation( m_storeIndex ) : elevation;
     };
 
   /**
@@ -179,7 +277,14 @@ class SinglePoint : public BaseMapElement
    */
   virtual void setElevation( const float value )
     {
-      elevation = value;
+      if( m_store )
+        {
+          m_store->setElevation( m_storeIndex, value );
+        }
+      else
+        {
+          elevation = value;
+        }
     };
 
   /**
@@ -191,7 +296,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual bool isVisible() const
     {
-      return glMapMatrix->isVisible(position);
+      return glMapMatrix->isVisible( getPosition() );
     };
 
   /**
@@ -199,7 +304,7 @@ class SinglePoint : public BaseMapElement
    */
   virtual QString getComment() const
     {
-      return comment;
+      return m_store ? m_store->text( m_storeIndex, PointStore::Comment ) : comment;
     };
 
   /**
@@ -207,10 +312,19 @@ class SinglePoint : public BaseMapElement
    *
    * @param newValue New country code of the element.
    */
-  virtual void setComment( QString value )
-    {
-      comment = value;
-    };
+  virtual void setComment( QString value );
+
+  /**
+   * Projects the WGS positions of the list elements starting at index first
+   * and sets their projected positions. All positions are projected at once.
+   *
+   * @param list The list with the elements derived from SinglePoint.
+   * @param first The index of the first element to be projected.
+   * @param projection The projection to be used.
+   */
+  template<class T> static void projectPositions( QList<T>& list,
+                                                  const int first,
+                                                  ProjectionBase* projection );
 
  protected:
   /**
@@ -242,6 +356,55 @@ class SinglePoint : public BaseMapElement
    */
   QString comment;
 
+  /**
+   * The ICAO code of the point.
+   */
+  QString m_icao;
+
+ private:
+
+  /**
+   * Takes over the data of another point. The point is detached.
+   */
+  void copyFrom( const SinglePoint& other );
+
+  /**
+   * The store, which keeps the point data, or null, if the point keeps its
+   * data itself.
+   */
+  PointStore* m_store;
+
+  /**
+   * The index of the point in the store.
+   */
+  int m_storeIndex;
 };
 
+template<class T>
+void SinglePoint::projectPositions( QList<T>& list,
+                                    const int first,
+                                    ProjectionBase* projection )
+{
+  const int count = list.size() - first;
+
+  if( count <= 0 )
+    {
+      return;
+    }
+
+  QPolygon points( count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      points[i] = list.at( first + i ).getWGSPosition();
+    }
+
+  MapMatrix::wgsToMap( projection, points.constData(), points.data(), count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      list[first + i].setPosition( points.at(i) );
+    }
+}
+
 #endif
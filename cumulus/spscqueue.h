@@ -0,0 +1,149 @@
+/***********************************************************************
+**
+**   spscqueue.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class SpscQueue
+*
+* \author Axel Pauli
+*
+* \brief Lock free queue for one producer and one consumer thread.
+*
+* The queue is a ring buffer with a fixed capacity. The producer thread
+* is the only one, which advances the write index, the consumer thread is
+* the only one, which advances the read index. Therefore no lock is
+* necessary. The indices are published with release semantic and read with
+* acquire semantic, so that an item is completely written, before the
+* consumer can see it.
+*
+* The element type must be copyable by assignment, it should be a POD type
+* to keep the copies cheap.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <QAtomicInt>
+
+template<class T> class SpscQueue
+{
+ public:
+
+  /**
+   * \param capacity The number of items, the queue can take. It is rounded
+   *                 up to a power of two.
+   */
+  SpscQueue( const int capacity )
+  {
+    int size = 2;
+
+    // One slot is always kept free to distinguish a full from an empty queue.
+    while( size < capacity + 1 )
+      {
+        size <<= 1;
+      }
+
+    m_items = new T[size];
+    m_mask  = size - 1;
+  };
+
+  virtual ~SpscQueue()
+  {
+    delete [] m_items;
+  };
+
+  /**
+   * Appends an item to the queue. Must be called by the producer thread only.
+   *
+   * \return False, if the queue is full. The item is not appended then.
+   */
+  bool push( const T& item )
+  {
+    const int tail = load( m_tail );
+    const int next = (tail + 1) & m_mask;
+
+    if( next == load( m_head ) )
+      {
+        return false;
+      }
+
+    m_items[tail] = item;
+
+    // Publish the item to the consumer.
+    m_tail.fetchAndStoreRelease( next );
+    return true;
+  };
+
+  /**
+   * Takes the oldest item from the queue. Must be called by the consumer
+   * thread only.
+   *
+   * \return False, if the queue is empty.
+   */
+  bool pop( T& item )
+  {
+    const int head = load( m_head );
+
+    if( head == load( m_tail ) )
+      {
+        return false;
+      }
+
+    item = m_items[head];
+
+    // Release the slot to the producer.
+    m_head.fetchAndStoreRelease( (head + 1) & m_mask );
+    return true;
+  };
+
+  /** \return True, if the queue contains no items. */
+  bool isEmpty() const
+  {
+    return load( m_head ) == load( m_tail );
+  };
+
+  /** \return The number of items, the queue can take. */
+  int capacity() const
+  {
+    return m_mask;
+  };
+
+ private:
+
+  Q_DISABLE_COPY ( SpscQueue )
+
+  /** Reads an index with acquire semantic, available in Qt4 and Qt5. */
+  static int load( const QAtomicInt& index )
+  {
+    return const_cast<QAtomicInt&> (index).fetchAndAddAcquire( 0 );
+  };
+
+  /** The ring buffer. */
+  T* m_items;
+
+  /** Size of the ring buffer minus one, used to wrap the indices. */
+  int m_mask;
+
+  /** Index of the next item to be read, advanced by the consumer. */
+  QAtomicInt m_head;
+
+  /** Index of the next item to be written, advanced by the producer. */
+  QAtomicInt m_tail;
+};
+
+#endif /* SPSC_QUEUE_H */
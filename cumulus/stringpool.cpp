@@ -0,0 +1,54 @@
+/***********************************************************************
+**
+**   stringpool.cpp
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include "stringpool.h"
+
+StringPool::StringPool() :
+  m_hits(0),
+  m_sharedBytes(0)
+{
+}
+
+StringPool::~StringPool()
+{
+}
+
+QString StringPool::intern( const QString& str )
+{
+  if( str.isEmpty() )
+    {
+      // Empty strings do not allocate character data.
+      return QString();
+    }
+
+  QSet<QString>::const_iterator it = m_pool.constFind( str );
+
+  if( it != m_pool.constEnd() )
+    {
+      m_hits++;
+      m_sharedBytes += str.size() * sizeof(QChar);
+      return *it;
+    }
+
+  m_pool.insert( str );
+  return str;
+}
+
+void StringPool::clear()
+{
+  m_pool.clear();
+  m_hits = 0;
+  m_sharedBytes = 0;
+}
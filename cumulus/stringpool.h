@@ -0,0 +1,90 @@
+/***********************************************************************
+**
+**   stringpool.h
+**
+**   This file is part of Cumulus.
+**
+************************************************************************
+**
+**   Copyright (c):  2016 by Axel Pauli <kflog.cumulus@gmail.com>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+* \class StringPool
+*
+* \author Axel Pauli
+*
+* \brief Pool of shared strings to avoid equal copies in point lists.
+*
+* Many records of a point or airspace file contain the same string values,
+* e.g. the country code or the radio channel. A string read from a file
+* owns its own characters. If it is passed through \ref intern, the copy
+* already stored in the pool is returned instead and the read string can
+* be released. Because QString is implicitly shared, all records refer then
+* to the same character data.
+*
+* The pool is not thread safe. Every loader uses its own pool.
+*
+* \date 2016
+*
+* \version 1.0
+*/
+
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#include <QSet>
+#include <QString>
+
+class StringPool
+{
+ public:
+
+  StringPool();
+
+  virtual ~StringPool();
+
+  /**
+   * \param str The string to be pooled.
+   * \return The pooled string, which is equal to the passed one.
+   */
+  QString intern( const QString& str );
+
+  /** Removes all strings from the pool and resets the statistics. */
+  void clear();
+
+  /** \return The number of different strings in the pool. */
+  int size() const
+  {
+    return m_pool.size();
+  };
+
+  /** \return The number of calls, which have returned a pooled string. */
+  int hits() const
+  {
+    return m_hits;
+  };
+
+  /**
+   * \return The character bytes, which are shared because of pool hits
+   *         instead of being stored in an own copy.
+   */
+  qint64 sharedBytes() const
+  {
+    return m_sharedBytes;
+  };
+
+ private:
+
+  QSet<QString> m_pool;
+
+  int m_hits;
+
+  qint64 m_sharedBytes;
+};
+
+#endif /* STRING_POOL_H */
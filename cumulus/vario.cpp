@@ -29,7 +29,7 @@ Vario::Vario(QObject* parent) :
   m_TEKOn(false),
   m_energyAlt(0.0),
   m_TekAdjust(0.0),
-  m_sampleList( LimitedList<AltSample>( 61 ) )
+  m_sampleList( 61 )
 {
   GeneralConfig *conf = GeneralConfig::instance();
 
@@ -35,7 +35,7 @@
 #include <QTimer>
 
 #include "altitude.h"
-#include "limitedlist.h"
+#include "ringbuffer.h"
 #include "speed.h"
 
 /** Default integration time in seconds for variometer calculation. */
@@ -123,7 +123,7 @@ private:
   };
 
   // List of altitude samples
-  LimitedList<AltSample> m_sampleList;
+  RingBuffer<AltSample> m_sampleList;
 
 private slots:
 
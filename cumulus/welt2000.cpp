@@ -31,6 +31,7 @@
 #include "wgspoint.h"
 #include "generalconfig.h"
 #include "distance.h"
+#include "stringpool.h"
 
 #include "welt2000.h"
 
@@ -271,24 +272,8 @@ bool Welt2000::load( QList<Airfield>& airfieldList,
           return parse( w2PathTxt, airfieldList, gliderfieldList, outlandingList, true );
         }
 
-      // Check, if the projection has been changed in the meantime
-      ProjectionBase *currentProjection = _globalMapMatrix->getProjection();
-
-      if( ! MapContents::compareProjections( h_projection, currentProjection ) )
-        {
-          qDebug( "W2000: Projection has been changed --> reparse welt2000.txt" );
-          // Projection has changed in the meantime
-          if(  h_projection )
-            {
-              delete h_projection;
-              h_projection = 0;
-            }
-
-          QFile::remove( w2PathTxc );
-          return parse( w2PathTxt, airfieldList, gliderfieldList, outlandingList, true );
-        }
-
-      // Nothing has been changed, read in compiled file
+      // Nothing has been changed, read in compiled file. A changed projection
+      // does not matter, because the file contains WGS84 coordinates.
       if( ! readCompiledFile( w2PathTxc, airfieldList, gliderfieldList, outlandingList ) )
         {
           // reading of compiled file failed, let's parse the source
@@ -1421,10 +1406,8 @@ bool Welt2000::parse( QString& path,
           ShortSave(outbuf, icao.trimmed().toUtf8());
           // GPS name
           ShortSave(outbuf, gpsName.toUtf8());
-          // WGS84 coordinates
+          // WGS84 coordinates, the projection is done during reading
           outbuf << wgsPos;
-          // projected WGS84 coordinates
-          outbuf << position;
           // elevation in meters
           outbuf << qint16( elevation);
           // frequency written as e.g. 126.575, is reduced to 16 bits
@@ -1560,7 +1543,6 @@ bool Welt2000::readCompiledFile( QString &path,
   QString icao;
   QString gpsName;
   WGSPoint wgsPos;
-  QPoint position;
   qint16 elevation;
   quint16 inFrequency;
   quint16 rwDir; // 0...36, one value in every byte
@@ -1654,6 +1636,14 @@ bool Welt2000::readCompiledFile( QString &path,
 
   uint counter = 0;
 
+  // Country codes and comments are repeated in many records.
+  StringPool pool;
+
+  // List positions of the first new elements
+  const int afStart = airfieldList.size();
+  const int glStart = gliderfieldList.size();
+  const int olStart = outlandingList.size();
+
   while( ! in.atEnd() )
     {
       counter++;
@@ -1666,7 +1656,6 @@ bool Welt2000::readCompiledFile( QString &path,
       ShortLoad(in, utf8_temp);
       gpsName=QString::fromUtf8(utf8_temp);
       in >> wgsPos;
-      in >> position;
       in >> elevation;
       in >> inFrequency;
 
@@ -1734,7 +1723,8 @@ bool Welt2000::readCompiledFile( QString &path,
         }
 
       Airfield af( afName, icao, gpsName, (BaseMapElement::objectType) afType,
-                   wgsPos, position, rwyList, elevation, frequency, country, comment );
+                   wgsPos, QPoint(), rwyList, elevation, frequency,
+                   pool.intern( country ), pool.intern( comment ) );
 
       if( afType == BaseMapElement::Gliderfield )
         {
@@ -1755,8 +1745,17 @@ bool Welt2000::readCompiledFile( QString &path,
 
   inFile.close();
 
-  qDebug( "W2000: %d airfields read from %s in %dms",
-          counter, basename(path.toLatin1().data()), t.elapsed() );
+  // The file contains only WGS84 coordinates. The projected positions are
+  // calculated for all read elements at once.
+  ProjectionBase* projection = _globalMapMatrix->getProjection();
+
+  SinglePoint::projectPositions( airfieldList, afStart, projection );
+  SinglePoint::projectPositions( gliderfieldList, glStart, projection );
+  SinglePoint::projectPositions( outlandingList, olStart, projection );
+
+  qDebug( "W2000: %d airfields read from %s in %dms, string pool %d entries, %d hits",
+          counter, basename(path.toLatin1().data()), t.elapsed(),
+          pool.size(), pool.hits() );
 
   return true;
 }
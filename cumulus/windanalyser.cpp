@@ -21,36 +21,42 @@
 #include "windanalyser.h"
 #include "mapcalc.h"
 #include "generalconfig.h"
+#include "nmeabenchmark.h"
 
 /*
   About Wind analysis
 
-  Currently, the wind is analyzed by finding the minimum and the maximum
-  ground speeds measured while flying a circle. The direction of the wind is taken
-  to be the direction in which the speed reaches it's maximum value, the speed
-  is half the difference between the maximum and the minimum speeds measured.
-  A quality parameter, based on the number of circles already flown (the first
-  circles are taken to be less accurate) and the angle between the headings at
-  minimum and maximum speeds, is calculated in order to be able to weigh the
-  resulting measurement. This method do not more work for wind speeds < 5Km/h.
-
-  There are other options for determining the wind speed. You could for instance
-  add all the vectors in a circle, and take the resulting vector as the wind speed.
-  This is a more complex method, but because it is based on more heading/speed
-  measurements by the GPS, it is probably more accurate. If equipped with
-  instruments that pass along airspeed, the calculations can be compensated for
-  changes in airspeed, resulting in better measurements. We are now assuming
-  the pilot flies in perfect circles with constant airspeed, which is of course
-  not a safe assumption.
-  The quality indication we are calculation can also be approached differently,
-  by calculating how constant the speed in the circle would be if corrected for
-  the wind speed we just derived. The more constant, the better. This is again
-  more CPU intensive, but may produce better results.
+  While circling with constant airspeed, the ground speed vectors lay on a
+  circle. Its center is the wind vector, its radius is the airspeed. The
+  wind is analyzed by a least squares fit of a circle to all ground speed
+  vectors measured during the last flown circle. The fit uses the algebraic
+  distance of Kasa, which leads to a linear equation system. Its
+  coefficients are running sums over the samples, so that a sample can be
+  added to and removed from the sliding window in constant time.
+
+  Formerly only the minimum and the maximum ground speeds of a circle were
+  used. The fit takes every sample into account and is therefore less
+  sensitive to single bad GPS headings. The first wind is available after one
+  circle, afterwards a new wind is calculated every half circle.
+
+  The quality of a measurement is derived from the mean deviation of the
+  samples from the fitted circle. Not round circles and changes of the
+  airspeed increase the deviation. Therefore the first circles need no
+  special treatment any more.
 
   Some of the errors made here will be averaged-out by the WindStore, which keeps
   a number of wind measurements and calculates a weighted average based on quality.
 */
 
+// Minimum number of samples in the fit window
+#define FIT_MIN_SAMPLES 6
+
+// Minimum airspeed in m/s of a plausible circle
+#define FIT_MIN_AIRSPEED 5.0
+
+// Relative deviation from the fitted circle per quality step
+#define FIT_QUALITY_STEP 0.02
+
 WindAnalyser::WindAnalyser(QObject* parent) :
   QObject(parent),
   active(false),
@@ -62,10 +68,13 @@ WindAnalyser::WindAnalyser(QObject* parent) :
   satCnt(0),
   minSatCnt(4),
   ciclingMode(false),
-  gpsStatus(GpsNmea::notConnected)
+  gpsStatus(GpsNmea::notConnected),
+  fitDegrees(0),
+  fitPending(0)
 {
   // Initialization
   minSatCnt = GeneralConfig::instance()->getWindMinSatCount();
+  fitSums.clear();
 }
 
 WindAnalyser::~WindAnalyser()
@@ -74,6 +83,8 @@ WindAnalyser::~WindAnalyser()
 /** Called if a new sample is available in the sample list. */
 void WindAnalyser::slot_newSample()
 {
+  BENCHMARK_STAGE( NmeaBenchmark::Wind );
+
   if( ! active )
     {
       return; // do only work if we are in active mode
@@ -81,10 +92,12 @@ void WindAnalyser::slot_newSample()
 
   Vector &curVec = calculator->samplelist[0].vector;
 
+  int diff = 0;
+
   // circle detection
   if( lastHeading != -1 )
     {
-      int diff = abs( curVec.getAngleDeg() - lastHeading );
+      diff = abs( curVec.getAngleDeg() - lastHeading );
 
       if( diff > 180 )
         {
@@ -98,45 +111,78 @@ void WindAnalyser::slot_newSample()
     }
   else
     {
-      minVector = curVec;
-      maxVector = curVec;
+      _resetFit();
     }
 
   lastHeading = curVec.getAngleDeg();
 
-  if( curVec.getSpeed().getMps() < minVector.getSpeed().getMps() )
-    {
-      // New minimum speed detected
-      minVector = curVec;
-    }
-
-  if( curVec.getSpeed().getMps() > maxVector.getSpeed().getMps() )
-    {
-      // New maximum speed detected
-      maxVector = curVec;
-    }
-
-  /*
-  qDebug( "curVec: %.3f/%dGrad, minVec: %.3f/%dGrad, maxVec: %.3f/%dGrad",
-         curVec.getSpeed().getKph(), curVec.getAngleDeg(),
-         minVector.getSpeed().getKph(), minVector.getAngleDeg(),
-         maxVector.getSpeed().getKph(), maxVector.getAngleDeg() );
-  */
+  _addFitSample( curVec, diff );
 
   if( circleDegrees > 360 )
     {
       // full circle made!
-      // increase the number of circles flown (used to determine the quality)
       circleCount++;
+      circleDegrees = 0;
+      circleSectors = 0;
+    }
 
-      // calculate the wind for this circle
+  if( fitDegrees >= 360 && fitPending >= 180 )
+    {
+      // The window covers a full circle and a half circle has been flown
+      // since the last calculation.
       _calcWind();
+      fitPending = 0;
+    }
+}
 
-      circleDegrees = 0;
-      circleSectors = 0;
+void WindAnalyser::FitSums::clear()
+{
+  n = x = y = xx = yy = xy = z = xz = yz = zz = 0.0;
+}
+
+void WindAnalyser::FitSums::add( const double vx, const double vy, const double sign )
+{
+  const double vz = vx * vx + vy * vy;
+
+  n  += sign;
+  x  += sign * vx;
+  y  += sign * vy;
+  xx += sign * vx * vx;
+  yy += sign * vy * vy;
+  xy += sign * vx * vy;
+  z  += sign * vz;
+  xz += sign * vx * vz;
+  yz += sign * vy * vz;
+  zz += sign * vz * vz;
+}
+
+void WindAnalyser::_resetFit()
+{
+  fitSamples.clear();
+  fitSums.clear();
+  fitDegrees = 0;
+  fitPending = 0;
+}
 
-      minVector = curVec;
-      maxVector = curVec;
+void WindAnalyser::_addFitSample( Vector& vector, const int turn )
+{
+  FitSample sample;
+  sample.x    = vector.getXMps();
+  sample.y    = vector.getYMps();
+  sample.turn = turn;
+
+  fitSamples.append( sample );
+  fitSums.add( sample.x, sample.y, 1.0 );
+  fitDegrees += turn;
+  fitPending += turn;
+
+  // The turn of the first sample lays before the window.
+  while( fitSamples.size() > 1 && fitDegrees - fitSamples.at(1).turn >= 360 )
+    {
+      const FitSample& first = fitSamples.first();
+      fitSums.add( first.x, first.y, -1.0 );
+      fitSamples.removeFirst();
+      fitDegrees -= fitSamples.first().turn;
     }
 }
 
@@ -191,59 +237,78 @@ void WindAnalyser::slot_newFlightMode( Calculator::FlightMode newFlightMode )
 
 void WindAnalyser::_calcWind()
 {
-  // int degreePerStep = circleDegrees / circleSectors;
-
-  int aDiff = rint(MapCalc::angleDiff( minVector.getAngleDeg(), maxVector.getAngleDeg() ));
+  const FitSums& s = fitSums;
 
-  /*
-    Determine quality.
-
-    Currently, we are using the question how well the min and the max vectors
-    are on opposing sides of the circle to determine the quality. 140 degrees is
-    the minimum separation, 180 is ideal.
-    Furthermore, the first two circles are considered to be of lesser quality.
-  */
-
-  int quality = 5 - ((180 - abs( aDiff )) / 8);
-
-  if( circleCount < 2 )
+  if( s.n < FIT_MIN_SAMPLES )
     {
-      quality--;
+      return;
     }
 
-  if( circleCount < 1 )
+  // The circle (x-a)^2 + (y-b)^2 = r^2 is written as
+  // x^2 + y^2 = p*x + q*y + c with p = 2a, q = 2b and c = r^2 - a^2 - b^2.
+  // The normal equations of the least squares problem are solved by
+  // Cramer's rule.
+  const double det = s.xx * (s.yy * s.n - s.y * s.y)
+                   - s.xy * (s.xy * s.n - s.y * s.x)
+                   + s.x  * (s.xy * s.y - s.yy * s.x);
+
+  if( fabs( det ) < 1E-9 )
     {
-      quality--;
+      // Degenerated sample distribution, e.g. all samples are equal.
+      return;
     }
 
-  // qDebug() << "WindQuality=" << quality;
+  const double p = ( s.xz * (s.yy * s.n - s.y * s.y)
+                   - s.xy * (s.yz * s.n - s.y * s.z)
+                   + s.x  * (s.yz * s.y - s.yy * s.z) ) / det;
 
-  if( quality < 1 )
+  const double q = ( s.xx * (s.yz * s.n - s.z * s.y)
+                   - s.xz * (s.xy * s.n - s.y * s.x)
+                   + s.x  * (s.xy * s.z - s.yz * s.x) ) / det;
+
+  // The third normal equation is n*c = z - p*x - q*y.
+  const double c = ( s.z - p * s.x - q * s.y ) / s.n;
+
+  const double a = p / 2.0;
+  const double b = q / 2.0;
+  const double r2 = c + a * a + b * b;
+
+  if( r2 < FIT_MIN_AIRSPEED * FIT_MIN_AIRSPEED )
     {
-      return; // Measurement quality too low
+      return; // No plausible airspeed
     }
 
-  // 5 is maximum quality, make sure we honor that.
-  quality = qMin( quality, 5 );
+  const double r = sqrt( r2 );
+
+  // Sum of the squared algebraic distances. An algebraic distance is about
+  // 2r times the geometric distance of a sample from the circle.
+  const double res = s.zz + p * p * s.xx + q * q * s.yy + c * c * s.n
+               - 2.0 * p * s.xz - 2.0 * q * s.yz - 2.0 * c * s.z
+               + 2.0 * p * q * s.xy + 2.0 * p * c * s.x + 2.0 * q * c * s.y;
 
-  // Invert maxVector angle
-  maxVector.setAngle( MapCalc::normalize( maxVector.getAngleDeg() + 180 ) );
+  const double deviation = sqrt( qMax( res, 0.0 ) / s.n ) / ( 2.0 * r );
 
-  // take both directions for min and max vector into account
   /*
-  qDebug( "maxAngle=%d/%.0f minAngle=%d/%.0f",
-           maxVector.getAngleDeg(), maxVector.getSpeed().getKph(),
-           minVector.getAngleDeg(), minVector.getSpeed().getKph() );
+    Determine quality.
+
+    The mean deviation of the samples from the fitted circle relative to the
+    airspeed is used. Every two percent of deviation reduce the quality by one.
   */
+  int quality = 5 - static_cast<int> ( deviation / r / FIT_QUALITY_STEP );
 
-  // create a vector object for the resulting wind
-  Vector result;
+  // qDebug() << "WindQuality=" << quality << "Deviation=" << deviation;
 
-  // the direction of the wind is the direction where the greatest speed occurred
-  result.setAngle( ( maxVector.getAngleDeg() + minVector.getAngleDeg() ) / 2);
+  if( quality < 1 )
+    {
+      return; // Measurement quality too low
+    }
+
+  // 5 is maximum quality, make sure we honor that.
+  quality = qMin( quality, 5 );
 
-  // The speed of the wind is half the difference between the minimum and the maximum speeds.
-  result.setSpeed( (maxVector.getSpeed().getMps() - minVector.getSpeed().getMps()) / 2.0 );
+  // The circle center is the vector the wind blows to. The wind direction
+  // is the direction the wind comes from.
+  Vector result( -a, -b );
 
   // Let the world know about our measurement!
   // qDebug("### ComputedWind: %dGrad/%.0fKm/h", result.getAngleDeg(), result.getSpeed().getKph());
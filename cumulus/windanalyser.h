@@ -24,7 +24,8 @@
  * \brief wind analyzer
  *
  * The wind analyzer processes the list of flight samples looking
- * for wind speed and direction.
+ * for wind speed and direction. During circling a circle is fitted to the
+ * ground speed vectors of the last flown circle.
  *
  * \date 2002-2010
  */
@@ -32,6 +33,7 @@
 #ifndef WINDANALYSER_H
 #define WINDANALYSER_H
 
+#include <QList>
 #include <QObject>
 
 #include "vector.h"
@@ -83,6 +85,39 @@ public slots:
 
 private:
 
+  /** A ground speed vector of the fit window in m/s. */
+  struct FitSample
+  {
+    double x;
+    double y;
+
+    /** Heading change in degrees since the previous sample. */
+    int turn;
+  };
+
+  /**
+   * Running sums over the fit window. They allow to add and to remove
+   * a sample in constant time.
+   */
+  struct FitSums
+  {
+    double n, x, y, xx, yy, xy, z, xz, yz, zz;
+
+    void clear();
+
+    /** Adds a sample with sign 1.0 and removes it with sign -1.0. */
+    void add( const double x, const double y, const double sign );
+  };
+
+  /** Clears the fit window. */
+  void _resetFit();
+
+  /**
+   * Adds a ground speed vector to the fit window. The oldest samples are
+   * removed, as long as the window still covers a full circle.
+   */
+  void _addFitSample( Vector& vector, const int turn );
+
   void _calcWind();
 
   /** active is set to true or false by the slot_newFlightMode slot. */
@@ -96,8 +131,12 @@ private:
   int minSatCnt;
   bool ciclingMode;
   GpsNmea::GpsStatus gpsStatus;
-  Vector minVector;
-  Vector maxVector;
+
+  /** Ground speed vectors of about the last flown circle. */
+  QList<FitSample> fitSamples;
+  FitSums fitSums;
+  int fitDegrees; // Degrees covered by the fit window
+  int fitPending; // Degrees flown since the last wind calculation
 };
 
 #endif
@@ -29,8 +29,16 @@
 // No idea what a sensible value would be...
 #define MAX_MEASUREMENTS 1800
 
+// Altitude band in meters of a cached wind result
+#define CACHE_ALTITUDE_BAND 25.0
+
+// Time slot in seconds of the cached wind results
+#define CACHE_TIME_SLOT 10
+
 WindMeasurementList::WindMeasurementList() :
-  LimitedList<WindMeasurement>( MAX_MEASUREMENTS )
+  RingBuffer<WindMeasurement>( MAX_MEASUREMENTS ),
+  m_cacheSlot(-1),
+  m_cacheSize(0)
 {
 }
 
@@ -47,37 +55,41 @@ Vector WindMeasurementList::getWind( const Altitude& alt,
                                      const int timeWindow,
                                      const int altRange )
 {
-// relative weight for each factor in percent
-#define REL_FACTOR_QUALITY 100
-#define REL_FACTOR_ALTITUDE 100
-#define REL_FACTOR_TIME 200
-
-  // counts the number of calls to prevent endless recursion.
-  static short entry = 0;
-
-  Vector result;
-
   if( size() == 0 )
     {
       // Measurement list is empty.
-      return result;
+      return Vector();
     }
 
-  entry++;
+  const int slot = QTime(0, 0).secsTo( QTime::currentTime() ) / CACHE_TIME_SLOT;
 
-  QTime dauer;
-  dauer.start();
+  if( slot != m_cacheSlot || size() != m_cacheSize )
+    {
+      // The time weights have changed or the list has been modified.
+      m_windCache.clear();
+      m_cacheSlot = slot;
+      m_cacheSize = size();
+    }
 
-  GeneralConfig *conf = GeneralConfig::instance();
+  const int band = static_cast<int> (floor( alt.getMeters() / CACHE_ALTITUDE_BAND ));
+
+  const qint64 key = ( static_cast<qint64> (band) * 65536 + timeWindow ) * 65536 + altRange;
 
-  double usedAltRange = 0;
+  QHash<qint64, Vector>::const_iterator it = m_windCache.constFind( key );
 
-  if( altRange == 0 )
+  if( it != m_windCache.constEnd() )
     {
-      // Take the default altitude range from the configuration
-      usedAltRange  = static_cast<double>(conf->getWindAltitudeRange()) / 2.0;  // 1000m
+      return it.value();
     }
-  else
+
+  GeneralConfig *conf = GeneralConfig::instance();
+
+  // The default altitude range is taken from the configuration
+  const double defaultAltRange = static_cast<double>(conf->getWindAltitudeRange()) / 2.0;  // 1000m
+
+  double usedAltRange = defaultAltRange;
+
+  if( altRange != 0 )
     {
       usedAltRange = altRange / 2.0;
     }
@@ -91,18 +103,57 @@ Vector WindMeasurementList::getWind( const Altitude& alt,
       timeRange = conf->getWindTimeRange(); // 600s
     }
 
+  // All requests of an altitude band get the wind of its middle.
+  Altitude bandAlt;
+  bandAlt.setMeters( (band + 0.5) * CACHE_ALTITUDE_BAND );
+
+  Vector result = calculateWind( bandAlt, timeRange, usedAltRange );
+
+  if( ! result.isValid() && timeWindow < 3600 )
+    {
+      // If there is no younger wind available make a second round with a time
+      // window of one hour.
+      result = calculateWind( bandAlt, 3600, defaultAltRange );
+
+      if( ! result.isValid() )
+        {
+          // If there is no younger wind available make a second round with a time
+          // window of two hour.
+          result = calculateWind( bandAlt, 7200, defaultAltRange );
+        }
+    }
+
+  m_windCache.insert( key, result );
+
+  return result;
+}
+
+Vector WindMeasurementList::calculateWind( const Altitude& alt,
+                                           const int timeRange,
+                                           const double altRange ) const
+{
+// relative weight for each factor in percent
+#define REL_FACTOR_QUALITY 100
+#define REL_FACTOR_ALTITUDE 100
+#define REL_FACTOR_TIME 200
+
+  Vector result;
+
   int total_quality = 0;
   int quality = 0, q_quality = 0, a_quality = 0, t_quality = 0;
-  QTime now = QTime::currentTime();
+  QDateTime now = QDateTime::currentDateTime();
 
   double altDiff  = 0.0;
   double timeDiff = 0.0;
 
-  for( int i = 0; i < count(); i++ )
+  // Only the measurements inside of the time window are considered.
+  const int measurements = countAfter( now.addSecs( -timeRange ) );
+
+  for( int i = 0; i < measurements; i++ )
     {
       const WindMeasurement& wm = at( i );
 
-      altDiff = (alt - wm.altitude).getMeters() / usedAltRange;
+      altDiff = (alt - wm.altitude).getMeters() / altRange;
       timeDiff = fabs( (double) wm.time.secsTo(now) / (double) timeRange );
 
       if( (fabs(altDiff) < 1.0) && (timeDiff < 1.0) )
@@ -127,8 +178,8 @@ Vector WindMeasurementList::getWind( const Altitude& alt,
           /*
           qDebug("i=%d alt=%f qual=%d wind=%d/%f (%d, %d, %d)",
                   i, wm.altitude.getMeters(), quality,
-                  value(i).vector.getAngleDeg(),
-                  value(i).vector.getSpeed().getKph(),
+                  wm.vector.getAngleDeg(),
+                  wm.vector.getSpeed().getKph(),
                   q_quality, a_quality, t_quality );
           */
 
@@ -137,7 +188,7 @@ Vector WindMeasurementList::getWind( const Altitude& alt,
               continue;
             }
 
-          result.add( value(i).vector * quality );
+          result.add( wm.vector * quality );
           total_quality += quality;
 
           /*
@@ -154,28 +205,6 @@ Vector WindMeasurementList::getWind( const Altitude& alt,
       result = result / total_quality;
     }
 
-  /*
-  qDebug( "Round=%d, Alt=%f, WindResult=%d/%f",
-          entry, alt.getMeters(),
-          result.getAngleDeg(), result.getSpeed().getKph() );
-  */
-
-  if( ! result.isValid() && entry == 1 && timeWindow < 3600 )
-    {
-      // If there is no younger wind available make a second round with a time
-      // window of one hour.
-      result = getWind( alt, 3600 );
-
-      if( ! result.isValid() )
-        {
-          // If there is no younger wind available make a second round with a time
-          // window of two hour.
-          result = getWind( alt, 7200 );
-        }
-    }
-
-  entry--;
-
   return result;
 }
 
@@ -188,41 +217,13 @@ void WindMeasurementList::addMeasurement( const Vector& vector,
   wind.vector = vector;
   wind.quality = quality;
   wind.altitude = alt;
-  wind.time = QTime::currentTime();
+  wind.time = QDateTime::currentDateTime();
 
-  // Add item to limited list.
+  // Add item to the ring buffer, the oldest item is dropped, if it is full.
   add( wind );
 
-  qSort( begin(), end(), WindMeasurement::lessThan );
-}
-
-/**
- * getLeastImportantItem is called to identify the item that should be
- * removed if the list is too full. Reimplemented from LimitedList.
- */
-int WindMeasurementList::getLeastImportantItemIndex() const
-{
-  int maxscore = 0;
-  int score = 0;
-  int foundItem = LimitedList<WindMeasurement>::size() - 1;
-
-  for( int i = foundItem; i >= 0; i-- )
-    {
-      // Calculate the score of this item. The item with the highest score is the
-      // least important one. We may need to adjust the proportion of the quality
-      // and the elapsed time. Currently one quality-point (scale: 0 to 5) and
-      // the elapsed time are used for the core value.
-      score = 6 - LimitedList<WindMeasurement>::at( i ).quality;
-      score *= LimitedList<WindMeasurement>::at( i ).time.secsTo( QTime::currentTime() );
-
-      if( score > maxscore )
-        {
-          maxscore = score;
-          foundItem = i;
-        }
-  }
-
-  return foundItem;
+  // The cached results do not consider the new measurement.
+  m_windCache.clear();
 }
 
 bool WindMeasurement::operator < (const WindMeasurement& other) const
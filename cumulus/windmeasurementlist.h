@@ -19,9 +19,10 @@
 #ifndef WIND_MEASUREMENT_LIST_H
 #define WIND_MEASUREMENT_LIST_H
 
-#include <QTime>
+#include <QDateTime>
+#include <QHash>
 
-#include "limitedlist.h"
+#include "ringbuffer.h"
 #include "altitude.h"
 #include "vector.h"
 
@@ -41,7 +42,7 @@ public:
 
   Vector vector;
   int quality;
-  QTime time;
+  QDateTime time;
   Altitude altitude;
 
   bool operator < (const WindMeasurement& other) const;
@@ -60,14 +61,20 @@ public:
  *
  * \brief A list containing single wind measurements.
  *
- * \see LimitedList
+ * \see RingBuffer
  *
  * The WindMeasurementList is a list that contains and
- * processes wind measurements.
+ * processes wind measurements. The measurements are kept in the order of
+ * their creation, so that the measurements of a time window are found by
+ * a binary search. If the list is full, the oldest measurement is dropped.
+ *
+ * The results of \ref getWind are cached per altitude band of 25m and per
+ * time slot of 10s, because the wind is requested at every position fix.
+ * A new measurement discards the cached results.
  *
  * \date 2002-2014
  */
-class WindMeasurementList : public LimitedList<WindMeasurement>
+class WindMeasurementList : public RingBuffer<WindMeasurement>
 {
 
 public:
@@ -95,12 +102,24 @@ public:
   /** Adds the wind vector vector with quality quality to the list. */
   void addMeasurement( const Vector& vector, const Altitude& alt, int quality );
 
-protected:
+private:
+
   /**
-   * getLeastImportantItem is called to identify the item that should be
-   * removed if the list is too full. Reimplemented from \ref LimitedList.
+   * Calculates the weighted mean wind vector of the measurements inside
+   * of the time window and the altitude range.
    */
-  virtual int getLeastImportantItemIndex() const;
+  Vector calculateWind( const Altitude& alt,
+                        const int timeRange,
+                        const double altRange ) const;
+
+  /** Cached results of getWind, the key contains the request arguments. */
+  QHash<qint64, Vector> m_windCache;
+
+  /** The time slot of the cached results. */
+  int m_cacheSlot;
+
+  /** The list size at the caching of the results. */
+  int m_cacheSize;
 };
 
 #endif
@@ -25,6 +25,7 @@ CONFIG += flarm
 
 HEADERS = \
   gpsclient.h \
+  ../cumulus/forwardbatch.h \
   ../cumulus/ipc.h \
   ../cumulus/protocol.h \
   ../cumulus/signalhandler.h
@@ -32,6 +33,7 @@ HEADERS = \
 SOURCES = \
   gpsclient.cpp \
   gpsmain.cpp \
+  ../cumulus/forwardbatch.cpp \
   ../cumulus/ipc.cpp \
   ../cumulus/signalhandler.cpp
 
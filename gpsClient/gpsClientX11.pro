@@ -37,6 +37,7 @@ CONFIG += flarm
 
 HEADERS = \
   gpsclient.h \
+  ../cumulus/forwardbatch.h \
   ../cumulus/ipc.h \
   ../cumulus/protocol.h \
   ../cumulus/signalhandler.h
@@ -44,6 +45,7 @@ HEADERS = \
 SOURCES = \
   gpsclient.cpp \
   gpsmain.cpp \
+  ../cumulus/forwardbatch.cpp \
   ../cumulus/ipc.cpp \
   ../cumulus/signalhandler.cpp
 
@@ -33,6 +33,7 @@
 #include "gpscon.h"
 #include "protocol.h"
 #include "ipc.h"
+#include "forwardbatch.h"
 
 #ifdef FLARM
 #include "flarmbase.h"
@@ -61,6 +62,9 @@
 // Define connection lost timeout in milli seconds
 #define TO_CONLOST  10000
 
+// Define the batch size in bytes, which forces a transfer to the server
+#define MAX_BATCH_SIZE 8192
+
 
 GpsClient::GpsClient( const ushort portIn )
 {
@@ -256,6 +260,9 @@ bool GpsClient::readGpsData()
 
       readSentenceFromBuffer();
 
+      // Send all sentences of this read as one batch to the server.
+      flushForwardMsgs();
+
 #ifdef FLARM
 
       if( ! activateTimeout )
@@ -525,11 +532,7 @@ void GpsClient::readSentenceFromBuffer()
           // processing is desired.
           if( checkGpsMessageFilter( record ) == true && forwardGpsData == true )
             {
-              QByteArray ba;
-              ba.append( MSG_GPS_DATA );
-              ba.append( ' ' );
-              ba.append( record );
-              writeForwardMsg( ba.data() );
+              writeForwardMsg( ForwardBatch::GpsData, record, strlen(record) );
             }
         }
 
@@ -695,6 +698,9 @@ uchar GpsClient::calcCheckSum( const char *sentence )
 // Timeout controller
 void GpsClient::toController()
 {
+  // Send a pending rest of the forward channel.
+  flushForwardMsgs();
+
   // Null time is used to switch off the timeout control.
   if( last.isNull() )
     {
@@ -724,7 +730,7 @@ void GpsClient::toController()
         {
           // connection is lost, send only one message to the server
           connectionLost = true;
-          writeForwardMsg( MSG_CON_OFF );
+          writeForwardMsg( ForwardBatch::ConnectionOff );
         }
 
 #ifdef ERROR_LOG
@@ -971,45 +977,63 @@ void GpsClient::writeServerMsg( const char *msg )
 }
 
 /**
- * Sends a data message via the forward channel to the server. The protocol consists
- * of two parts. First the message length is transmitted as unsigned integer,
- * after that the actual message as 8 bit character string.
+ * Sends a data message via the forward channel to the server. The messages
+ * are collected in a batch, see class ForwardBatch. GPS sentences are sent
+ * together, when the current read of the GPS data is processed. All other
+ * messages are sent immediately.
  */
-void GpsClient::writeForwardMsg( const char *msg )
+void GpsClient::writeForwardMsg( const ForwardBatch::Type type,
+                                 const char *msg,
+                                 const int length )
 {
-  static QString method = "GpsClient::writeForwardMsg():";
+  fwdBatch.append( type, msg, length );
 
-  // The message to be transfered starts with the message length.
-  uint msgLen = strlen( msg );
+#ifdef DEBUG
+  qDebug() << "GpsClient::writeForwardMsg():" << type
+           << QByteArray( msg, qMax(length, 0) );
+#endif
 
-  QByteArray ba = QByteArray::fromRawData( (const char *) &msgLen, sizeof(msgLen) );
-  ba.append( msg );
+  if( type != ForwardBatch::GpsData || fwdBatch.size() >= MAX_BATCH_SIZE )
+    {
+      flushForwardMsgs();
+    }
+}
 
-  // We use non blocking IO for the transfer. Therefore we have to consider some
-  // special return codes.
-  int done = clientForward.writeMsg( (char *) ba.data(), ba.size() );
+/**
+ * Sends all collected messages as one batch via the forward channel to the
+ * server. A batch frame consists of two parts. First the batch length is
+ * transmitted as unsigned integer, after that the batch data. The unsent
+ * tail of a partly written frame is sent first.
+ */
+void GpsClient::flushForwardMsgs()
+{
+  static QString method = "GpsClient::flushForwardMsgs():";
 
-  if( done < 0 )
+  if( fwdBatch.isEmpty() && fwdBatch.hasPending() == false )
     {
-      if( errno == EWOULDBLOCK )
-        {
-          // The write call would block because the transfer queue is full.
-          // In this case we discard the message.
-          qWarning() << method
-                      << "Write would block, drop Message!";
-        }
-      else
-        {
-          // Fatal error occurred, make shutdown of process.
-          setShutdownFlag(true);
-        }
+      return;
     }
 
-#ifdef DEBUG
-  qDebug() << method << msg;
-#endif
+  // We use non blocking IO for the transfer. If the transfer queue is full,
+  // only whole batches are discarded.
+  int dropped = fwdBatch.send( clientForward.getSock() );
 
-  return;
+  if( dropped < 0 )
+    {
+      // Fatal error occurred, make shutdown of process.
+      qWarning() << method << "write() returns with ERROR: errno="
+                 << errno << strerror(errno);
+
+      setShutdownFlag(true);
+    }
+  else if( dropped > 0 )
+    {
+      // The write call would block because the transfer queue is full.
+      qWarning() << method
+                 << "Write would block, drop"
+                 << dropped
+                 << "Messages!";
+    }
 }
 
 /**
@@ -1152,10 +1176,8 @@ void GpsClient::getFlarmFlightList()
               // times in dependency of the UART transfer speed and the amount of
               // entries. If the time is too long, a timeout will raise an error
               // box in the GUI thread.
-              QByteArray ba( MSG_FLARM_FLIGHT_LIST_RES );
-              ba.append( " " );
-              ba.append( buffer );
-              writeForwardMsg( ba.data() );
+              writeForwardMsg( ForwardBatch::FlarmFlightList,
+                               buffer, strlen(buffer) );
               flights++;
             }
           else
@@ -1173,27 +1195,26 @@ void GpsClient::getFlarmFlightList()
         }
     }
 
-  QByteArray ba( MSG_FLARM_FLIGHT_LIST_RES );
+  QByteArray ba;
 
   if( flights == 0 )
     {
       // The flight list in Flarm is empty.
-      ba.append( " Empty" );
+      ba.append( "Empty" );
     }
   else
     {
       // All flight headers are transfered.
-      ba.append( " End" );
+      ba.append( "End" );
     }
 
-  writeForwardMsg( ba.data() );
+  writeForwardMsg( ForwardBatch::FlarmFlightList, ba.data(), ba.size() );
 }
 
 void GpsClient::flarmFlightListError()
 {
-  QByteArray ba( MSG_FLARM_FLIGHT_LIST_RES );
-  ba.append( " Error" );
-  writeForwardMsg( ba.data() );
+  QByteArray ba( "Error" );
+  writeForwardMsg( ForwardBatch::FlarmFlightList, ba.data(), ba.size() );
 }
 
 void GpsClient::getFlarmIgcFiles(QString& args)
@@ -1322,19 +1343,17 @@ void GpsClient::getFlarmIgcFiles(QString& args)
 
 void GpsClient::flarmFlightDowloadInfo( QString info )
 {
-  QString msg = QString("%1 %2").arg(MSG_FLARM_FLIGHT_DOWNLOAD_INFO).arg(info);
+  QByteArray ba = info.toLatin1();
 
-  writeForwardMsg( msg.toLatin1().data() );
+  writeForwardMsg( ForwardBatch::FlarmDownloadInfo, ba.data(), ba.size() );
 }
 
 /** Reports the flight download progress to the calling application. */
 void GpsClient::flarmFlightDowloadProgress( const int idx, const int progress )
 {
-  QString msg = QString("%1 %2,%3").arg(MSG_FLARM_FLIGHT_DOWNLOAD_PROGRESS)
-                                   .arg(idx)
-                                   .arg(progress);
+  QByteArray ba = QString("%1,%2").arg(idx).arg(progress).toLatin1();
 
-  writeForwardMsg( msg.toLatin1().data() );
+  writeForwardMsg( ForwardBatch::FlarmDownloadProgress, ba.data(), ba.size() );
 }
 
 bool GpsClient::flarmReset()
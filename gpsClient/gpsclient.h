@@ -52,6 +52,7 @@
 #include <QTime>
 
 #include "ipc.h"
+#include "forwardbatch.h"
 
 //++++++++++++++++++++++ CLASS GpsClient +++++++++++++++++++++++++++
 
@@ -170,7 +171,11 @@ public:
 
   void writeServerMsg( const char *msg );
 
-  void writeForwardMsg( const char *msg );
+  void writeForwardMsg( const ForwardBatch::Type type,
+                        const char *msg=0,
+                        const int length=0 );
+
+  void flushForwardMsgs();
 
   uint getBaudrate( int rate );
 
@@ -249,6 +254,9 @@ public:
   // IPC instance to server process as message forward channel
   Ipc::Client clientForward;
 
+  // Collected messages for the forward channel
+  ForwardBatch fwdBatch;
+
   // used as timeout control supervision for the GPS device connection
   QTime last;
 
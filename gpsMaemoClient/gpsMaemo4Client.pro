@@ -17,6 +17,7 @@ QT -= gui # Only the core module is used.
 
 HEADERS = \
   gpsmaemoclient.h \
+  ../cumulus/forwardbatch.h \
   ../cumulus/ipc.h \
   ../cumulus/protocol.h \
   ../cumulus/signalhandler.h
@@ -24,6 +25,7 @@ HEADERS = \
 SOURCES = \
   gpsmaemoclient.cpp \
   gpsmaemomain.cpp \
+  ../cumulus/forwardbatch.cpp \
   ../cumulus/ipc.cpp \
   ../cumulus/signalhandler.cpp
 
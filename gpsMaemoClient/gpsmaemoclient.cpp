@@ -36,6 +36,7 @@ using namespace std;
 #include "gpsmaemoclient.h"
 #include "protocol.h"
 #include "ipc.h"
+#include "forwardbatch.h"
 
 // #define DEBUG 1
 
@@ -403,7 +404,7 @@ void GpsMaemoClient::handleGpsdRunning()
 
   // Sends a message to Cumulus to signal that the GPS connection is established.
   // LibLocation reports not any data before a GPS fix.
-  writeForwardMsg( MSG_CON_ON );
+  writeForwardMsg( ForwardBatch::ConnectionOn );
 
 #ifdef MAEMO4
 
@@ -562,7 +563,7 @@ void GpsMaemoClient::handleGpsdLocationChanged( LocationGPSDevice *device )
 
   if( ! device )
     {
-      writeForwardMsg( MSG_CON_OFF );
+      writeForwardMsg( ForwardBatch::ConnectionOff );
       // Device is lost, set retry timeout to make a restart.
       startTimer(RETRY_TO);
       return;
@@ -734,10 +735,10 @@ void GpsMaemoClient::handleGpsdLocationChanged( LocationGPSDevice *device )
             << climb
             << epc;
 
-      QString sentence0 = QString( MSG_GPS_DATA ) + " " + list0.join( ",") + "\n";
+      QByteArray sentence0 = QString( list0.join( ",") + "\n" ).toAscii();
 
       // store the new sentence in the queue
-      writeForwardMsg( sentence0.toAscii().data() );
+      writeForwardMsg( ForwardBatch::GpsData, sentence0.data(), sentence0.size() );
    }
 
    QString satellitesInView = "0";
@@ -780,10 +781,10 @@ void GpsMaemoClient::handleGpsdLocationChanged( LocationGPSDevice *device )
          }
      }
 
-   QString sentence1 = QString( MSG_GPS_DATA ) + " " + list1.join( ",") + "\n";
+   QByteArray sentence1 = QString( list1.join( ",") + "\n" ).toAscii();
 
    // write the new sentence in the forward channel
-   writeForwardMsg( sentence1.toAscii().data() );
+   writeForwardMsg( ForwardBatch::GpsData, sentence1.data(), sentence1.size() );
 }
 #endif
 
@@ -948,6 +949,15 @@ void GpsMaemoClient::toController()
   qDebug() << "GpsMaemoClient::toController()";
 #endif
 
+  if( fwdBatch.hasPending() )
+    {
+      // Send a pending rest of the forward channel.
+      if( fwdBatch.send( clientForward.getSock() ) < 0 )
+        {
+          setShutdownFlag(true);
+        }
+    }
+
   if( timeSpan == 0 )
     {
       // Do nothing if time span is set to zero.
@@ -963,7 +973,7 @@ void GpsMaemoClient::toController()
         {
           // connection is lost, send only one message to the server
           connectionLost = true;
-          writeForwardMsg( MSG_CON_OFF );
+          writeForwardMsg( ForwardBatch::ConnectionOff );
         }
 
       if( gpsIsRunning == false )
@@ -1158,43 +1168,37 @@ void GpsMaemoClient::writeServerMsg( const char *msg )
 }
 
 /**
- * Sends a data message via the forward channel to the server. The protocol consists
- * of two parts. First the message length is transmitted as unsigned integer,
- * after that the actual message as 8 bit character string.
+ * Sends a data message via the forward channel to the server. The message is
+ * transfered as a batch with a single message, see class ForwardBatch. The
+ * frame consists of two parts. First the batch length is transmitted as
+ * unsigned integer, after that the batch data.
  */
-void GpsMaemoClient::writeForwardMsg( const char *msg )
+void GpsMaemoClient::writeForwardMsg( const ForwardBatch::Type type,
+                                      const char *msg,
+                                      const int length )
 {
   static QString method = "GpsMaemoClient::writeForwardMsg():";
 
-  // The message to be transfered starts with the message length.
-  uint msgLen = strlen( msg );
-
-  QByteArray ba = QByteArray::fromRawData( (const char *) &msgLen, sizeof(msgLen) );
-  ba.append( msg );
+  fwdBatch.append( type, msg, length );
 
-  // We use non blocking IO for the transfer. Therefore we have to consider some
-  // special return codes.
-  int done = clientForward.writeMsg( (char *) ba.data(), ba.size() );
+  // We use non blocking IO for the transfer. If the transfer queue is full,
+  // the message is discarded. The unsent tail of a partly written frame is
+  // sent first.
+  int dropped = fwdBatch.send( clientForward.getSock() );
 
-  if( done < 0 )
+  if( dropped < 0 )
     {
-      if( errno == EAGAIN || errno == EWOULDBLOCK )
-        {
-          // The write call would block because the transfer queue is full.
-          // In this case we discard the message.
-          qWarning() << method
-                     << "Queue is blocked, drop Message! Errno="
-                     << errno;
-        }
-      else
-        {
-          // Fatal error occurred, make shutdown of process.
-          setShutdownFlag(true);
-        }
+      // Fatal error occurred, make shutdown of process.
+      setShutdownFlag(true);
+    }
+  else if( dropped > 0 )
+    {
+      // The write call would block because the transfer queue is full.
+      qWarning() << method << "Queue is blocked, drop Message!";
     }
 
 #ifdef DEBUG
-  qDebug() << method << msg;
+  qDebug() << method << type << QByteArray( msg, qMax(length, 0) );
 #endif
 
   return;
@@ -1431,11 +1435,7 @@ void GpsMaemoClient::readSentenceFromBuffer()
             {
               // Write sentence in the forward channel, if checksum is ok.
               // qDebug( "GpsMaemo: Extracted NMEA Record: %s", record );
-              QByteArray ba;
-              ba.append( MSG_GPS_DATA );
-              ba.append( ' ' );
-              ba.append( record );
-              writeForwardMsg( ba.data() );
+              writeForwardMsg( ForwardBatch::GpsData, record, strlen(record) );
             }
         }
 
@@ -58,6 +58,7 @@ extern "C" {
 }
 
 #include "ipc.h"
+#include "forwardbatch.h"
 
 class QTime;
 
@@ -175,7 +176,9 @@ private:
 
   void writeServerMsg( const char *msg );
 
-  void writeForwardMsg( const char *msg );
+  void writeForwardMsg( const ForwardBatch::Type type,
+                        const char *msg=0,
+                        const int length=0 );
 
   /** Setup timeout controller. */
   void startTimer( uint milliSec );
@@ -207,6 +210,9 @@ private:
   // IPC instance to server process as message forward channel
   Ipc::Client clientForward;
 
+  // Batch of the forward channel, reused for every message
+  ForwardBatch fwdBatch;
+
   // used as timeout control for fix and connection
   QTime last;
 